@@ -3,10 +3,18 @@
 #include <QRandomGenerator>
 #include <QColor>
 #include <QPen>
+#include <QPolygonF>
 #include "../core/brush-engine.h"
 
+// 圆头和圆角最多用多少段折线逼近
+static const int MAX_ARC_STEPS = 64;
+// 比这更近的相邻点在生成轮廓时合并
+static const qreal MIN_OUTLINE_SEGMENT = 1e-3;
+
 BrushEngine::BrushEngine(QObject *parent)
     : QObject(parent)
+    , m_stableCount(0)
+    , m_chunkSegments(0)
     , m_isDrawing(false)
     , m_currentWidth(2.0)
     , m_currentColor(Qt::black)
@@ -245,7 +253,11 @@ void BrushEngine::beginStroke(const QPointF& pos, qreal pressure)
     m_isDrawing = true;
     m_points.clear();
     m_strokePens.clear();
-    m_strokePath = QPainterPath();
+    m_pointWidths.clear();
+    m_stableChunks.clear();
+    m_tailPath = QPainterPath();
+    m_stableCount = 0;
+    m_chunkSegments = 0;
     m_positionBuffer.clear();
     m_pressureBuffer.clear();
     
@@ -271,6 +283,9 @@ void BrushEngine::beginStroke(const QPointF& pos, qreal pressure)
     // 计算初始宽度和颜色
     m_currentWidth = calculateWidth(point);
     m_currentColor = calculateColor(point);
+    m_pointWidths.append(m_currentWidth);
+    
+    extendStroke(false);
     
     emit strokeStarted();
 }
@@ -318,12 +333,18 @@ void BrushEngine::addPoint(const QPointF& pos, qreal pressure,
     m_currentWidth = calculateWidth(point);
     m_currentColor = calculateColor(point);
     
+    // 每段的笔刷只取决于段终点，加点时确定一次，之后不再重新计算
+    QColor penColor = m_currentColor;
+    penColor.setAlphaF(m_currentProfile.opacity);
+    m_strokePens.append(QPen(penColor, m_currentWidth, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
+    m_pointWidths.append(m_currentWidth);
+    
     m_lastPosition = pos;
     m_lastTimestamp = currentTime;
     m_lastPressure = pressure;
     
-    // 实时生成路径以支持预览
-    generateStrokePath();
+    // 只追加新稳定的段并重建尾部，每个点的开销与笔画长度无关
+    extendStroke(false);
     
     emit strokeUpdated();
 }
@@ -335,7 +356,7 @@ void BrushEngine::endStroke()
     }
     
     m_isDrawing = false;
-    generateStrokePath();
+    extendStroke(true);
     
     emit strokeEnded();
 }
@@ -459,51 +480,214 @@ qreal BrushEngine::calculatePressureEffect(qreal pressure) const
     return qMax(0.1, effect);
 }
 
-void BrushEngine::generateStrokePath()
+int BrushEngine::smoothingRadius() const
+{
+    // 与applyGaussianSmoothing使用的邻域半径一致
+    return m_currentProfile.smoothing > 0 ? qCeil(m_currentProfile.smoothing * 2.0) : 0;
+}
+
+QPointF BrushEngine::smoothedPosition(int index) const
 {
-    if (m_points.size() < 2) {
+    if (m_currentProfile.smoothing <= 0) {
+        return m_points[index].position;
+    }
+    return applyGaussianSmoothing(m_points, index);
+}
+
+void BrushEngine::appendSegment(QPainterPath &path, const QPointF &from, const QPointF &to)
+{
+    // 计算控制点（贝塞尔曲线）
+    QPointF controlPoint1 = from + (to - from) * 0.3;
+    QPointF controlPoint2 = to - (to - from) * 0.3;
+    path.cubicTo(controlPoint1, controlPoint2, to);
+}
+
+void BrushEngine::extendStroke(bool finish)
+{
+    if (m_points.isEmpty()) {
         return;
     }
     
-    m_strokePath = QPainterPath();
-    m_strokePens.clear();
-    
-    // 使用平滑后的点生成路径
-    QVector<BrushPoint> smoothedPoints;
-    for (const BrushPoint& point : m_points) {
-        smoothedPoints.append(point);
+    QRectF updateRect = m_tailPath.controlPointRect();
+    
+    // 右侧已有radius个邻居的点平滑结果不再变化，追加到稳定部分；结束笔画时全部追加
+    const int stableEnd = finish ? m_points.size() : m_points.size() - smoothingRadius();
+    while (m_stableCount < stableEnd) {
+        const QPointF pos = smoothedPosition(m_stableCount);
+        if (m_stableCount == 0) {
+            m_stableChunks.append(QPainterPath(pos));
+        } else {
+            // 新块从上一块的终点开始
+            if (m_chunkSegments >= CHUNK_SEGMENTS) {
+                m_stableChunks.append(QPainterPath(m_lastStablePosition));
+                m_chunkSegments = 0;
+            }
+            appendSegment(m_stableChunks.last(), m_lastStablePosition, pos);
+            m_chunkSegments++;
+            updateRect |= QRectF(m_lastStablePosition, pos).normalized();
+        }
+        m_lastStablePosition = pos;
+        m_stableCount++;
     }
     
-    if (smoothedPoints.isEmpty()) {
-        return;
+    // 尾部的点按目前已有的邻居临时平滑，最多radius段
+    m_tailPath = QPainterPath();
+    if (m_stableCount < m_points.size()) {
+        int index = m_stableCount;
+        QPointF previous = m_lastStablePosition;
+        if (m_stableCount == 0) {
+            previous = smoothedPosition(0);
+            index = 1;
+        }
+        m_tailPath.moveTo(previous);
+        for (; index < m_points.size(); ++index) {
+            const QPointF pos = smoothedPosition(index);
+            appendSegment(m_tailPath, previous, pos);
+            previous = pos;
+        }
     }
+    updateRect |= m_tailPath.controlPointRect();
+    m_updateRect = updateRect;
+}
+
+QPainterPath BrushEngine::getStrokePath() const
+{
+    // 把各块和尾部接成一条路径：所有段都是三次曲线，跳过每块开头的moveTo
+    QPainterPath path;
+    auto appendPath = [&path](const QPainterPath &part) {
+        if (part.elementCount() == 0) {
+            return;
+        }
+        if (path.elementCount() == 0) {
+            path.moveTo(part.elementAt(0).x, part.elementAt(0).y);
+        }
+        for (int i = 1; i + 2 < part.elementCount(); i += 3) {
+            path.cubicTo(part.elementAt(i).x, part.elementAt(i).y,
+                         part.elementAt(i + 1).x, part.elementAt(i + 1).y,
+                         part.elementAt(i + 2).x, part.elementAt(i + 2).y);
+        }
+    };
     
-    // 生成路径和笔刷
-    m_strokePath.moveTo(smoothedPoints[0].position);
-    
-    for (int i = 1; i < smoothedPoints.size(); ++i) {
-        const BrushPoint& prevPoint = smoothedPoints[i-1];
-        const BrushPoint& currPoint = smoothedPoints[i];
-        
-        // 计算控制点（贝塞尔曲线）
-        QPointF controlPoint1 = prevPoint.position + (currPoint.position - prevPoint.position) * 0.3;
-        QPointF controlPoint2 = currPoint.position - (currPoint.position - prevPoint.position) * 0.3;
-        
-        m_strokePath.cubicTo(controlPoint1, controlPoint2, currPoint.position);
-        
-        // 为每个段创建笔刷
-        QPen pen = QPen(calculateColor(currPoint), calculateWidth(currPoint), Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin);
-        // QPen没有setOpacity方法，透明度在QColor中设置
-        QColor penColor = calculateColor(currPoint);
-        penColor.setAlphaF(m_currentProfile.opacity);
-        pen.setColor(penColor);
-        m_strokePens.append(pen);
+    for (const QPainterPath &chunk : m_stableChunks) {
+        appendPath(chunk);
     }
+    appendPath(m_tailPath);
+    return path;
 }
 
-QPainterPath BrushEngine::getStrokePath() const
+// 从角度from开始按sweep旋转，追加圆弧上的点（不含起点）
+static void appendArc(QPolygonF &polygon, const QPointF &center, qreal radius,
+                      qreal from, qreal sweep, qreal tolerance)
+{
+    // 弦高不超过容差时每步的最大角度
+    const qreal ratio = qBound(-1.0, 1.0 - tolerance / qMax(radius, tolerance), 1.0);
+    const qreal maxStep = qMax(2.0 * qAcos(ratio), M_PI / MAX_ARC_STEPS);
+    const int steps = qBound(1, qCeil(qAbs(sweep) / maxStep), MAX_ARC_STEPS);
+    for (int k = 1; k <= steps; ++k) {
+        const qreal angle = from + sweep * k / steps;
+        polygon.append(center + QPointF(qCos(angle), qSin(angle)) * radius);
+    }
+}
+
+static qreal vectorAngle(const QPointF &v)
 {
-    return m_strokePath;
+    return qAtan2(v.y(), v.x());
+}
+
+QPainterPath BrushEngine::getStrokeOutline(qreal tolerance) const
+{
+    QVector<QPointF> positions;
+    positions.reserve(m_points.size());
+    for (int i = 0; i < m_points.size(); ++i) {
+        positions.append(smoothedPosition(i));
+    }
+    return buildOutline(positions, m_pointWidths, tolerance);
+}
+
+QPainterPath BrushEngine::buildOutline(const QVector<QPointF> &points, const QVector<qreal> &widths,
+                                       qreal tolerance)
+{
+    QPainterPath outline;
+    outline.setFillRule(Qt::WindingFill);
+    if (points.isEmpty() || widths.size() != points.size()) {
+        return outline;
+    }
+    
+    // 去掉重合的点，否则无法确定方向
+    QVector<QPointF> centers;
+    QVector<qreal> radii;
+    centers.reserve(points.size());
+    radii.reserve(points.size());
+    for (int i = 0; i < points.size(); ++i) {
+        if (!centers.isEmpty() && QLineF(centers.last(), points[i]).length() < MIN_OUTLINE_SEGMENT) {
+            radii.last() = qMax(radii.last(), widths[i] / 2.0);
+            continue;
+        }
+        centers.append(points[i]);
+        radii.append(qMax(widths[i] / 2.0, 0.0));
+    }
+    
+    const int count = centers.size();
+    if (count == 1) {
+        outline.addEllipse(centers.first(), radii.first(), radii.first());
+        return outline;
+    }
+    
+    // 每段的单位方向和左法线
+    QVector<QPointF> normals(count - 1);
+    QVector<qreal> turns(count);    // 各顶点处的转角，正值向左转
+    for (int i = 0; i < count - 1; ++i) {
+        const QPointF d = centers[i + 1] - centers[i];
+        const qreal length = qSqrt(QPointF::dotProduct(d, d));
+        normals[i] = QPointF(-d.y(), d.x()) / length;
+    }
+    for (int i = 1; i < count - 1; ++i) {
+        const QPointF &a = normals[i - 1];
+        const QPointF &b = normals[i];
+        turns[i] = qAtan2(a.x() * b.y() - a.y() * b.x(), QPointF::dotProduct(a, b));
+    }
+    
+    QPolygonF polygon;
+    polygon.reserve(count * 4);
+    
+    // 左侧，正向：外侧转角加圆弧，内侧经过中心点连接，避免反向的小环在非零规则下挖出空洞
+    polygon.append(centers[0] + normals[0] * radii[0]);
+    for (int i = 1; i < count - 1; ++i) {
+        const QPointF &center = centers[i];
+        const qreal radius = radii[i];
+        polygon.append(center + normals[i - 1] * radius);
+        if (turns[i] < 0) {
+            appendArc(polygon, center, radius, vectorAngle(normals[i - 1]), turns[i], tolerance);
+        } else if (turns[i] > 0) {
+            polygon.append(center);
+            polygon.append(center + normals[i] * radius);
+        }
+    }
+    polygon.append(centers[count - 1] + normals[count - 2] * radii[count - 1]);
+    
+    // 结束端的圆头
+    appendArc(polygon, centers[count - 1], radii[count - 1], vectorAngle(normals[count - 2]), -M_PI, tolerance);
+    
+    // 右侧，反向
+    for (int i = count - 2; i >= 1; --i) {
+        const QPointF &center = centers[i];
+        const qreal radius = radii[i];
+        polygon.append(center - normals[i] * radius);
+        if (turns[i] > 0) {
+            appendArc(polygon, center, radius, vectorAngle(-normals[i]), -turns[i], tolerance);
+        } else if (turns[i] < 0) {
+            polygon.append(center);
+            polygon.append(center - normals[i - 1] * radius);
+        }
+    }
+    polygon.append(centers[0] - normals[0] * radii[0]);
+    
+    // 起始端的圆头，回到第一个点
+    appendArc(polygon, centers[0], radii[0], vectorAngle(-normals[0]), -M_PI, tolerance);
+    
+    outline.addPolygon(polygon);
+    outline.closeSubpath();
+    return outline;
 }
 
 QVector<QPen> BrushEngine::getStrokePens() const
@@ -518,7 +702,7 @@ void BrushEngine::updatePreview(const QPointF& currentPos)
     }
     
     // 创建预览路径
-    m_previewPath = m_strokePath;
+    m_previewPath = getStrokePath();
     
     // 添加到当前位置的预览线段
     if (!m_points.isEmpty()) {
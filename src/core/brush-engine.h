@@ -72,6 +72,9 @@ class BrushEngine : public QObject
     Q_OBJECT
 
 public:
+    // 稳定部分每块的最大段数，绘制时按块的范围裁剪
+    static const int CHUNK_SEGMENTS = 256;
+    
     explicit BrushEngine(QObject *parent = nullptr);
     ~BrushEngine();
 
@@ -93,6 +96,20 @@ public:
     QPainterPath getStrokePath() const;
     QVector<QPen> getStrokePens() const;
     
+    // 增量结果：稳定部分不再随新点变化，按块存放，每块最多CHUNK_SEGMENTS段；
+    // 尾部是还在平滑窗口内的几段，每次加点后重建
+    const QVector<QPainterPath> &stableChunks() const { return m_stableChunks; }
+    const QPainterPath &tailPath() const { return m_tailPath; }
+    int stablePointCount() const { return m_stableCount; }
+    // 上一次加点时变化的区域（路径中心线的范围，不含线宽）
+    QRectF lastUpdateRect() const { return m_updateRect; }
+    
+    // 变宽轮廓：按每个点的宽度生成左右偏移线，圆头圆角，整条笔画是一个填充路径
+    QPainterPath getStrokeOutline(qreal tolerance = 0.1) const;
+    QVector<qreal> getPointWidths() const { return m_pointWidths; }
+    static QPainterPath buildOutline(const QVector<QPointF> &points, const QVector<qreal> &widths,
+                                     qreal tolerance = 0.1);
+    
     // 实时预览
     void updatePreview(const QPointF& currentPos);
     QPainterPath getPreviewPath() const;
@@ -121,7 +138,10 @@ private:
     qreal calculatePressureEffect(qreal pressure) const;
     
     // 路径生成
-    void generateStrokePath();
+    void extendStroke(bool finish);
+    int smoothingRadius() const;
+    QPointF smoothedPosition(int index) const;
+    static void appendSegment(QPainterPath &path, const QPointF &from, const QPointF &to);
     void generatePreviewPath();
     
     // 平滑算法
@@ -135,8 +155,14 @@ private:
     BrushProfile m_currentProfile;
     QVector<BrushPoint> m_points;
     QVector<QPen> m_strokePens;
-    QPainterPath m_strokePath;
+    QVector<qreal> m_pointWidths;   // 每个点的宽度，与m_points一一对应
+    QVector<QPainterPath> m_stableChunks;
+    QPainterPath m_tailPath;
     QPainterPath m_previewPath;
+    int m_stableCount;              // 已进入稳定部分的点数
+    int m_chunkSegments;            // 最后一块中的段数
+    QPointF m_lastStablePosition;
+    QRectF m_updateRect;
     
     // 状态变量
     bool m_isDrawing;
@@ -0,0 +1,356 @@
+#include <QList>
+#include <QPolygonF>
+#include <QtMath>
+#include <algorithm>
+#include "../core/curve-fitter.h"
+
+// 小于这个距离的相邻点视为重合
+static const qreal MIN_POINT_DISTANCE = 1e-6;
+// 估计切线和转角时向两侧取点的最小距离（容差的倍数），避免采样抖动被当成尖角
+static const qreal TANGENT_SPAN_FACTOR = 2.0;
+// 最大误差在容差平方的这个倍数以内时先尝试修正参数，否则直接拆分
+static const qreal REPARAMETERIZE_ERROR_FACTOR = 4.0;
+static const int MAX_REPARAMETERIZE_ITERATIONS = 4;
+// 控制点到弦的距离不超过容差的这个比例时输出直线
+static const qreal STRAIGHT_FACTOR = 0.25;
+
+namespace {
+
+struct Cubic {
+    QPointF p[4];
+};
+
+}
+
+static qreal distanceBetween(const QPointF &a, const QPointF &b)
+{
+    const QPointF d = b - a;
+    return qSqrt(QPointF::dotProduct(d, d));
+}
+
+static QPointF unit(const QPointF &v)
+{
+    const qreal l = qSqrt(QPointF::dotProduct(v, v));
+    return l > 0 ? v / l : QPointF();
+}
+
+static QPointF bezierPoint(const Cubic &c, qreal t)
+{
+    const qreal u = 1.0 - t;
+    return c.p[0] * (u * u * u) + c.p[1] * (3 * u * u * t) + c.p[2] * (3 * u * t * t) + c.p[3] * (t * t * t);
+}
+
+static QPointF bezierDerivative(const Cubic &c, qreal t)
+{
+    const qreal u = 1.0 - t;
+    return (c.p[1] - c.p[0]) * (3 * u * u) + (c.p[2] - c.p[1]) * (6 * u * t) + (c.p[3] - c.p[2]) * (3 * t * t);
+}
+
+static QPointF bezierSecondDerivative(const Cubic &c, qreal t)
+{
+    return (c.p[2] - 2 * c.p[1] + c.p[0]) * (6 * (1.0 - t)) + (c.p[3] - 2 * c.p[2] + c.p[1]) * (6 * t);
+}
+
+// 从index向direction方向走到距离不小于span的点（不越过[first, last]，wrap时绕回），返回单位方向
+static QPointF walkDirection(const QVector<QPointF> &points, int index, int direction,
+                             int first, int last, bool wrap, qreal span)
+{
+    const int n = points.size();
+    const QPointF origin = points[index];
+    QPointF target = origin;
+    int i = index;
+    for (int step = 0; step < n - 1; ++step) {
+        i += direction;
+        if (wrap) {
+            i = (i + n) % n;
+        } else if (i < first || i > last) {
+            break;
+        }
+        target = points[i];
+        if (distanceBetween(origin, target) >= span) {
+            break;
+        }
+    }
+    return unit(target - origin);
+}
+
+// 两侧方向偏离直线超过threshold（弧度）的点是尖角候选，连续的候选只保留偏离最大的一个
+static QVector<int> findCorners(const QVector<QPointF> &points, bool closed, qreal span, qreal threshold)
+{
+    const int n = points.size();
+    const int first = closed ? 0 : 1;
+    const int last = closed ? n - 1 : n - 2;
+    QVector<int> corners;
+    int runBest = -1;
+    qreal runDeviation = 0.0;
+    for (int i = first; i <= last + 1; ++i) {
+        qreal deviation = 0.0;
+        if (i <= last) {
+            const QPointF back = walkDirection(points, i, -1, 0, n - 1, closed, span);
+            const QPointF forward = walkDirection(points, i, 1, 0, n - 1, closed, span);
+            deviation = qAcos(qBound(-1.0, -QPointF::dotProduct(back, forward), 1.0));
+        }
+        if (deviation > threshold) {
+            if (runBest < 0 || deviation > runDeviation) {
+                runBest = i;
+                runDeviation = deviation;
+            }
+        } else if (runBest >= 0) {
+            corners.append(runBest);
+            runBest = -1;
+        }
+    }
+    return corners;
+}
+
+// 弦长参数化
+static QVector<qreal> chordLengthParameters(const QVector<QPointF> &points, int first, int last)
+{
+    QVector<qreal> u(last - first + 1);
+    u[0] = 0.0;
+    for (int i = first + 1; i <= last; ++i) {
+        u[i - first] = u[i - first - 1] + distanceBetween(points[i - 1], points[i]);
+    }
+    const qreal total = u.last();
+    for (int i = 1; i < u.size(); ++i) {
+        u[i] = total > 0 ? u[i] / total : qreal(i) / (u.size() - 1);
+    }
+    return u;
+}
+
+// 端点和切线方向固定，最小二乘求两个控制点沿切线的距离
+static Cubic generateBezier(const QVector<QPointF> &points, int first, int last, const QVector<qreal> &u,
+                            const QPointF &tHat1, const QPointF &tHat2)
+{
+    const QPointF p0 = points[first];
+    const QPointF p3 = points[last];
+    qreal c00 = 0.0, c01 = 0.0, c11 = 0.0, x0 = 0.0, x1 = 0.0;
+    for (int i = first; i <= last; ++i) {
+        const qreal t = u[i - first];
+        const qreal s = 1.0 - t;
+        const qreal b0 = s * s * s, b1 = 3 * s * s * t, b2 = 3 * s * t * t, b3 = t * t * t;
+        const QPointF a0 = tHat1 * b1;
+        const QPointF a1 = tHat2 * b2;
+        c00 += QPointF::dotProduct(a0, a0);
+        c01 += QPointF::dotProduct(a0, a1);
+        c11 += QPointF::dotProduct(a1, a1);
+        const QPointF rest = points[i] - (p0 * (b0 + b1) + p3 * (b2 + b3));
+        x0 += QPointF::dotProduct(a0, rest);
+        x1 += QPointF::dotProduct(a1, rest);
+    }
+
+    const qreal determinant = c00 * c11 - c01 * c01;
+    qreal alpha1 = 0.0;
+    qreal alpha2 = 0.0;
+    if (qAbs(determinant) > 1e-12) {
+        alpha1 = (x0 * c11 - x1 * c01) / determinant;
+        alpha2 = (c00 * x1 - c01 * x0) / determinant;
+    }
+
+    // 控制点距离为负或过小时退回到弦长的三分之一
+    const qreal chord = distanceBetween(p0, p3);
+    const qreal epsilon = 1e-6 * chord;
+    if (alpha1 < epsilon || alpha2 < epsilon) {
+        alpha1 = alpha2 = chord / 3.0;
+    }
+    return {{p0, p0 + tHat1 * alpha1, p3 + tHat2 * alpha2, p3}};
+}
+
+// 各点到曲线上对应参数处的最大平方距离，split返回误差最大的点
+static qreal maxError(const QVector<QPointF> &points, int first, int last, const Cubic &curve,
+                      const QVector<qreal> &u, int *split)
+{
+    qreal result = 0.0;
+    *split = (first + last) / 2;
+    for (int i = first + 1; i < last; ++i) {
+        const QPointF d = bezierPoint(curve, u[i - first]) - points[i];
+        const qreal error = QPointF::dotProduct(d, d);
+        if (error >= result) {
+            result = error;
+            *split = i;
+        }
+    }
+    return result;
+}
+
+// 牛顿迭代：把每个点的参数移到曲线上离它最近的位置
+static void reparameterize(const QVector<QPointF> &points, int first, const Cubic &curve, QVector<qreal> &u)
+{
+    for (int i = 0; i < u.size(); ++i) {
+        const QPointF d = bezierPoint(curve, u[i]) - points[first + i];
+        const QPointF d1 = bezierDerivative(curve, u[i]);
+        const qreal numerator = QPointF::dotProduct(d, d1);
+        const qreal denominator = QPointF::dotProduct(d1, d1) + QPointF::dotProduct(d, bezierSecondDerivative(curve, u[i]));
+        if (qAbs(denominator) > 1e-12) {
+            u[i] = qBound(0.0, u[i] - numerator / denominator, 1.0);
+        }
+    }
+}
+
+// tHat1从起点指向曲线内，tHat2从终点指向曲线内
+static void fitCubic(const QVector<QPointF> &points, int first, int last, const QPointF &tHat1, const QPointF &tHat2,
+                     qreal errorSquared, qreal span, QVector<Cubic> &result)
+{
+    if (last - first == 1) {
+        const qreal d = distanceBetween(points[first], points[last]) / 3.0;
+        result.append({{points[first], points[first] + tHat1 * d, points[last] + tHat2 * d, points[last]}});
+        return;
+    }
+
+    QVector<qreal> u = chordLengthParameters(points, first, last);
+    Cubic curve = generateBezier(points, first, last, u, tHat1, tHat2);
+    int split = 0;
+    qreal error = maxError(points, first, last, curve, u, &split);
+    if (error <= errorSquared) {
+        result.append(curve);
+        return;
+    }
+    if (error <= errorSquared * REPARAMETERIZE_ERROR_FACTOR) {
+        for (int i = 0; i < MAX_REPARAMETERIZE_ITERATIONS; ++i) {
+            reparameterize(points, first, curve, u);
+            curve = generateBezier(points, first, last, u, tHat1, tHat2);
+            error = maxError(points, first, last, curve, u, &split);
+            if (error <= errorSquared) {
+                result.append(curve);
+                return;
+            }
+        }
+    }
+
+    // 在误差最大处拆分，拆分点两侧共用一条切线保持光滑
+    const QPointF back = walkDirection(points, split, -1, first, last, false, span);
+    const QPointF forward = walkDirection(points, split, 1, first, last, false, span);
+    QPointF center = unit(back - forward);
+    if (center.isNull()) {
+        center = back;
+    }
+    fitCubic(points, first, split, tHat1, center, errorSquared, span, result);
+    fitCubic(points, split, last, -center, tHat2, errorSquared, span, result);
+}
+
+static bool isStraight(const Cubic &curve, qreal tolerance)
+{
+    const QPointF chord = curve.p[3] - curve.p[0];
+    const qreal length = qSqrt(QPointF::dotProduct(chord, chord));
+    if (length <= 0) {
+        return false;
+    }
+    const QPointF direction = chord / length;
+    for (int i = 1; i < 3; ++i) {
+        const QPointF d = curve.p[i] - curve.p[0];
+        const qreal along = QPointF::dotProduct(d, direction);
+        const qreal across = qAbs(d.x() * direction.y() - d.y() * direction.x());
+        if (across > tolerance * STRAIGHT_FACTOR || along < 0 || along > length) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void appendFit(QPainterPath &path, QVector<QPointF> points, bool closed, qreal tolerance, qreal cornerAngle)
+{
+    const qreal span = TANGENT_SPAN_FACTOR * tolerance;
+    const int n = points.size();
+    QVector<int> corners = findCorners(points, closed, span, qDegreesToRadians(cornerAngle));
+
+    // 闭合路径从第一个尖角开始；没有尖角时起点处两侧共用一条切线
+    bool smoothClosed = false;
+    QPointF closedTangent;
+    if (closed) {
+        if (corners.isEmpty()) {
+            smoothClosed = true;
+            const QPointF forward = walkDirection(points, 0, 1, 0, n - 1, true, span);
+            const QPointF back = walkDirection(points, 0, -1, 0, n - 1, true, span);
+            closedTangent = unit(forward - back);
+            if (closedTangent.isNull()) {
+                closedTangent = forward;
+            }
+        } else {
+            const int shift = corners.first();
+            std::rotate(points.begin(), points.begin() + shift, points.end());
+            for (int &corner : corners) {
+                corner -= shift;
+            }
+        }
+        points.append(points.first());
+    }
+
+    const int last = points.size() - 1;
+    QVector<int> breaks;
+    breaks.append(0);
+    for (int corner : corners) {
+        if (corner > 0 && corner < last) {
+            breaks.append(corner);
+        }
+    }
+    breaks.append(last);
+
+    QVector<Cubic> curves;
+    for (int k = 0; k + 1 < breaks.size(); ++k) {
+        const int first = breaks[k];
+        const int end = breaks[k + 1];
+        const QPointF tHat1 = smoothClosed && first == 0 ? closedTangent
+                                                        : walkDirection(points, first, 1, first, end, false, span);
+        const QPointF tHat2 = smoothClosed && end == last ? -closedTangent
+                                                         : walkDirection(points, end, -1, first, end, false, span);
+        fitCubic(points, first, end, tHat1, tHat2, tolerance * tolerance, span, curves);
+    }
+
+    path.moveTo(points.first());
+    for (const Cubic &curve : curves) {
+        if (isStraight(curve, tolerance)) {
+            path.lineTo(curve.p[3]);
+        } else {
+            path.cubicTo(curve.p[1], curve.p[2], curve.p[3]);
+        }
+    }
+    if (closed) {
+        path.closeSubpath();
+    }
+}
+
+QPainterPath CurveFitter::fitPolyline(const QVector<QPointF> &points, bool closed, qreal tolerance, qreal cornerAngle)
+{
+    QPainterPath result;
+    tolerance = qMax(tolerance, MIN_POINT_DISTANCE);
+
+    QVector<QPointF> unique;
+    unique.reserve(points.size());
+    for (const QPointF &point : points) {
+        if (unique.isEmpty() || distanceBetween(unique.last(), point) > MIN_POINT_DISTANCE) {
+            unique.append(point);
+        }
+    }
+    if (closed) {
+        while (unique.size() > 1 && distanceBetween(unique.last(), unique.first()) <= MIN_POINT_DISTANCE) {
+            unique.removeLast();
+        }
+        closed = unique.size() > 2;
+    }
+
+    if (unique.isEmpty()) {
+        return result;
+    }
+    if (unique.size() == 1) {
+        result.moveTo(unique.first());
+        return result;
+    }
+    appendFit(result, unique, closed, tolerance, cornerAngle);
+    return result;
+}
+
+QPainterPath CurveFitter::fitPath(const QPainterPath &path, qreal tolerance, qreal cornerAngle)
+{
+    QPainterPath result;
+    result.setFillRule(path.fillRule());
+    const QList<QPolygonF> polygons = path.toSubpathPolygons();
+    for (const QPolygonF &polygon : polygons) {
+        QVector<QPointF> points(polygon.begin(), polygon.end());
+        const bool closed = points.size() > 2 && points.first() == points.last();
+        if (closed) {
+            points.removeLast();
+        }
+        result.addPath(fitPolyline(points, closed, tolerance, cornerAngle));
+    }
+    return result;
+}
@@ -0,0 +1,25 @@
+#ifndef CURVE_FITTER_H
+#define CURVE_FITTER_H
+
+#include <QPainterPath>
+#include <QVector>
+#include <QPointF>
+
+/**
+ * 曲线拟合器
+ * 把密集的折线（手绘笔画、展平的路径）拟合成尽量少的三次贝塞尔曲线：
+ * 先按转角找出尖角把折线分段，每段用最小二乘求控制点（Schneider方法），
+ * 误差超出容差时用牛顿迭代修正参数，仍不满足再在误差最大处拆分
+ */
+class CurveFitter
+{
+public:
+    // 拟合一条折线，与原折线上各点的距离不超过tolerance；转角超过cornerAngle（度）的点保留为尖角
+    static QPainterPath fitPolyline(const QVector<QPointF> &points, bool closed,
+                                    qreal tolerance, qreal cornerAngle = 60.0);
+
+    // 逐个子路径展平后拟合，保留子路径结构和填充规则
+    static QPainterPath fitPath(const QPainterPath &path, qreal tolerance, qreal cornerAngle = 60.0);
+};
+
+#endif // CURVE_FITTER_H
@@ -6,6 +6,15 @@
 #include <QPaintEvent>
 #include "../core/drawing-canvas.h"
 #include "../ui/drawingview.h"
+#include "../ui/drawingscene.h"
+#include "../core/drawing-document.h"
+
+// 内容包围盒：DrawingScene直接取文档图形表，其他场景遍历图形项
+static QRectF contentBounds(QGraphicsScene *scene)
+{
+    DrawingScene *drawingScene = qobject_cast<DrawingScene*>(scene);
+    return drawingScene ? drawingScene->document()->bounds() : scene->itemsBoundingRect();
+}
 
 DrawingCanvas::DrawingCanvas(QWidget *parent)
     : QWidget(parent)
@@ -75,7 +84,7 @@ void DrawingCanvas::fitToWindow()
         return;
     }
     
-    QRectF contentRect = m_scene->itemsBoundingRect();
+    QRectF contentRect = contentBounds(m_scene);
     
     // 如果内容矩形有效，使用它；否则使用场景矩形
     if (!contentRect.isEmpty()) {
@@ -97,7 +106,7 @@ void DrawingCanvas::centerOnContent()
         return;
     }
     
-    QRectF contentRect = m_scene->itemsBoundingRect();
+    QRectF contentRect = contentBounds(m_scene);
     
     // 如果内容矩形有效，居中到内容；否则居中到场景中心
     if (!contentRect.isEmpty()) {
@@ -12,67 +12,211 @@ DrawingDocument::~DrawingDocument()
     clear();
 }
 
+int DrawingDocument::slotOf(Handle handle)
+{
+    return int(handle & 0xffffffffu);
+}
+
+bool DrawingDocument::isValid(Handle handle) const
+{
+    const int slot = slotOf(handle);
+    return handle != InvalidHandle && slot < m_generations.size()
+           && m_generations[slot] == quint32(handle >> 32) && m_shapes[slot];
+}
+
+DrawingShape *DrawingDocument::shape(Handle handle) const
+{
+    return isValid(handle) ? m_shapes[slotOf(handle)] : nullptr;
+}
+
 void DrawingDocument::addItem(DrawingShape *item)
 {
-    if (!item) {
+    if (!item || item->m_document == this) {
         return;
     }
-    
-    m_items.push_back(item);
+    if (item->m_document) {
+        item->m_document->removeItem(item);
+    }
+
+    int slot;
+    if (!m_freeSlots.isEmpty()) {
+        slot = m_freeSlots.takeLast();
+    } else {
+        slot = m_generations.size();
+        m_generations.append(1);
+        m_shapes.append(nullptr);
+        m_data.handles.append(InvalidHandle);
+        m_data.bounds.append(QRectF());
+        m_data.transforms.append(QTransform());
+        m_data.styles.append(-1);
+        m_data.contentVersions.append(0);
+        m_dirty.append(0);
+    }
+    m_shapes[slot] = item;
+    m_data.handles[slot] = (Handle(m_generations[slot]) << 32) | Handle(slot);
+    ++m_count;
     item->setDocument(this);
+    item->setStyleTable(&m_styles);
+    item->m_documentHandle = m_data.handles[slot];
+    markDirty(item);
+    emit itemAdded(item);
 }
- 
+
 
 void DrawingDocument::removeItem(DrawingShape *item)
 {
-    if (!item) {
+    if (!item || item->m_document != this || !isValid(item->m_documentHandle)) {
         return;
     }
-    
-    for (auto it = m_items.begin(); it != m_items.end(); ++it) {
-        if (*it == item) {
-            // 然后清除文档引用和从列表中移除
-            item->setDocument(nullptr);
-            m_items.erase(it);
-            break;
+
+    // 槽位的代数加一，旧句柄随之失效；脏列表中的槽位在refresh时跳过
+    const int slot = slotOf(item->m_documentHandle);
+    m_shapes[slot] = nullptr;
+    m_data.handles[slot] = InvalidHandle;
+    m_data.bounds[slot] = QRectF();
+    m_data.styles[slot] = -1;
+    ++m_generations[slot];
+    m_freeSlots.append(slot);
+    --m_count;
+    item->setDocument(nullptr);
+    item->setStyleTable(nullptr);
+    item->m_documentHandle = InvalidHandle;
+    emit itemRemoved(item);
+}
+
+std::vector<DrawingShape*> DrawingDocument::items() const
+{
+    std::vector<DrawingShape*> result;
+    result.reserve(m_count);
+    for (DrawingShape *item : m_shapes) {
+        if (item) {
+            result.push_back(item);
         }
     }
+    return result;
 }
 
-std::vector<DrawingShape*> DrawingDocument::items() const
+void DrawingDocument::markDirty(DrawingShape *item)
+{
+    if (!item || item->m_document != this) {
+        return;
+    }
+
+    const int slot = slotOf(item->m_documentHandle);
+    if (!m_dirty[slot]) {
+        m_dirty[slot] = 1;
+        m_dirtySlots.append(slot);
+    }
+    emit itemChanged(item);
+    // 子图形的场景坐标随父图形变化
+    for (QGraphicsItem *child : item->childItems()) {
+        DrawingShape *childShape = dynamic_cast<DrawingShape*>(child);
+        if (childShape) {
+            markDirty(childShape);
+        }
+    }
+}
+
+void DrawingDocument::markStackingChanged(DrawingShape *item)
 {
-    return m_items;
+    if (item && item->m_document == this) {
+        emit stackingChanged(item);
+    }
 }
 
-void DrawingDocument::clear()
+void DrawingDocument::refresh() const
 {
-    // 先发送所有移除信号
-    for (DrawingShape *item : m_items) {
+    for (int slot : m_dirtySlots) {
+        m_dirty[slot] = 0;
+        DrawingShape *item = m_shapes[slot];
+        if (!item) {
+            continue;
+        }
+        m_data.bounds[slot] = item->sceneBoundingRect();
+        m_data.transforms[slot] = item->transform() * item->sceneTransform();
+        m_data.styles[slot] = item->styleId();
+        m_data.contentVersions[slot] = item->contentVersion();
     }
-    
-    // 然后清除文档引用和列表
-    for (DrawingShape *item : m_items) {
+    m_dirtySlots.clear();
+}
+
+void DrawingDocument::clear()
+{
+    // 清除文档引用，槽位全部作废
+    for (DrawingShape *item : m_shapes) {
         if (item) {
             item->setDocument(nullptr);
+            item->setStyleTable(nullptr);
+            item->m_documentHandle = InvalidHandle;
         }
     }
-    m_items.clear();
-    
+    m_data = Snapshot();
+    m_shapes.clear();
+    m_generations.clear();
+    m_freeSlots.clear();
+    m_dirty.clear();
+    m_dirtySlots.clear();
+    m_count = 0;
 }
 
 QRectF DrawingDocument::bounds() const
 {
-    QRectF result;
-    for (DrawingShape *item : m_items) {
-        if (item) {
-            if (result.isEmpty()) {
-                result = item->boundingRect();
-            } else {
-                result |= item->boundingRect();
-            }
+    refresh();
+    qreal minX = 0;
+    qreal minY = 0;
+    qreal maxX = 0;
+    qreal maxY = 0;
+    bool first = true;
+    const DrawingShape *const *shapes = m_shapes.constData();
+    const QRectF *bounds = m_data.bounds.constData();
+    for (int slot = 0; slot < m_shapes.size(); ++slot) {
+        if (!shapes[slot]) {
+            continue;
+        }
+        const QRectF &rect = bounds[slot];
+        if (first) {
+            minX = rect.left();
+            minY = rect.top();
+            maxX = rect.right();
+            maxY = rect.bottom();
+            first = false;
+        } else {
+            minX = qMin(minX, rect.left());
+            minY = qMin(minY, rect.top());
+            maxX = qMax(maxX, rect.right());
+            maxY = qMax(maxY, rect.bottom());
+        }
+    }
+    return first ? QRectF() : QRectF(QPointF(minX, minY), QPointF(maxX, maxY));
+}
+
+QVector<DrawingShape*> DrawingDocument::itemsInRect(const QRectF &rect) const
+{
+    refresh();
+    QVector<DrawingShape*> result;
+    DrawingShape *const *shapes = m_shapes.constData();
+    const QRectF *bounds = m_data.bounds.constData();
+    for (int slot = 0; slot < m_shapes.size(); ++slot) {
+        const QRectF &box = bounds[slot];
+        if (shapes[slot] && box.left() <= rect.right() && box.right() >= rect.left()
+            && box.top() <= rect.bottom() && box.bottom() >= rect.top()) {
+            result.append(shapes[slot]);
         }
     }
     return result;
 }
 
+QVector<DrawingShape*> DrawingDocument::itemsWithStyle(int style) const
+{
+    // 文档中的图形都登记在文档的样式表里，使用者列表就是结果，不需要扫描槽位
+    if (!m_styles.isValid(style)) {
+        return QVector<DrawingShape*>();
+    }
+    return m_styles.users(style);
+}
 
+DrawingDocument::Snapshot DrawingDocument::snapshot() const
+{
+    refresh();
+    return m_data;
+}
@@ -4,12 +4,20 @@
 #include <QObject>
 #include <vector>
 #include <QRectF>
-
+#include <QTransform>
+#include <QVector>
+#include "../core/style-table.h"
 
 
 class DrawingShape;
 
 
+/**
+ * 文档图形表 - 场景中全部图形的紧凑数组
+ * 包围盒、变换、样式编号和外观版本号按槽位分别存放在连续数组中，批量查询只做数组循环，不经过虚函数；
+ * 图形变化时只登记为脏，下次查询前重新读取。图形用句柄（槽位加代数）引用，删除后旧句柄失效。
+ * 文档持有共享样式表，图形加入文档时把样式登记到表中，离开时带走自己的样式
+ */
 class DrawingDocument : public QObject
 {
     Q_OBJECT
@@ -18,20 +26,75 @@ class DrawingDocument : public QObject
     friend class RemoveItemCommand;
 
 public:
+    // 低32位为槽位，高32位为槽位的代数，槽位复用后旧句柄不会指到新图形
+    typedef quint64 Handle;
+    static const Handle InvalidHandle = ~Handle(0);
+
+    // 快照：各数组按槽位对齐，空槽的句柄为InvalidHandle；数组隐式共享，可以交给其他线程只读。
+    // 快照不保存图形指针，需要图形时用shape(handle)取，图形删除后得到nullptr
+    struct Snapshot {
+        QVector<Handle> handles;
+        QVector<QRectF> bounds;          // 场景坐标包围盒
+        QVector<QTransform> transforms;  // 本地几何到场景的变换
+        QVector<int> styles;
+        QVector<quint32> contentVersions;
+    };
+
     explicit DrawingDocument(QObject *parent = nullptr);
     ~DrawingDocument();
 
     void addItem(DrawingShape *item);
     void removeItem(DrawingShape *item);
     std::vector<DrawingShape*> items() const;
-    
+    int count() const { return m_count; }
+
+    // 文档内图形共用的样式表
+    StyleTable *styleTable() { return &m_styles; }
+    const StyleTable *styleTable() const { return &m_styles; }
+
+    bool isValid(Handle handle) const;
+    DrawingShape *shape(Handle handle) const;
+
+    // 图形的变换、几何或样式变化后调用，子图形一起登记
+    void markDirty(DrawingShape *item);
+    // 图形的Z值或父图形变化后调用
+    void markStackingChanged(DrawingShape *item);
+
     void clear();
+    // 全部图形的场景包围盒
     QRectF bounds() const;
-    
+    // 场景包围盒与rect相交的图形
+    QVector<DrawingShape*> itemsInRect(const QRectF &rect) const;
+    // 使用指定样式的图形，直接取样式表的使用者列表
+    QVector<DrawingShape*> itemsWithStyle(int style) const;
+    Snapshot snapshot() const;
+
+signals:
+    // 图形加入文档
+    void itemAdded(DrawingShape *item);
+    // 图形离开文档；图形可能正在析构，接收方只能把指针当作键使用
+    void itemRemoved(DrawingShape *item);
+    // 图形的变换、几何、样式、可见性或透明度变化，同一图形可能连续多次发出
+    void itemChanged(DrawingShape *item);
+    // 层叠顺序变化
+    void stackingChanged(DrawingShape *item);
 
 private:
-    std::vector<DrawingShape*> m_items;
+    static int slotOf(Handle handle);
+    // 重新读取脏图形的数据
+    void refresh() const;
+
+    StyleTable m_styles;
+    int m_count = 0;
+    QVector<quint32> m_generations;
+    QVector<int> m_freeSlots;
+    // 按槽位存放的图形，空槽为nullptr
+    QVector<DrawingShape*> m_shapes;
+    // 按槽位存放的图形数据，查询前由refresh更新
+    mutable Snapshot m_data;
+    mutable QVector<char> m_dirty;
+    mutable QVector<int> m_dirtySlots;
 };
 
 
-#endif // DRAWING_DOCUMENT_H
\ No newline at end of file
+#endif // DRAWING_DOCUMENT_H
@@ -88,6 +88,7 @@ void DrawingGroup::addItem(DrawingShape *item)
     }
 
     m_currentBounds = combinedBounds;
+    geometryChanged();
 }
 
 void DrawingGroup::removeItem(DrawingShape *item)
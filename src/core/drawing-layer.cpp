@@ -9,6 +9,7 @@ DrawingLayer::DrawingLayer(const QString &name, QObject *parent)
     , m_visible(true)
     , m_opacity(1.0)
     , m_locked(false)
+    , m_renderCacheEnabled(false)
     , m_scene(nullptr)
 {
 }
@@ -65,6 +66,19 @@ void DrawingLayer::setOpacity(qreal opacity)
     }
 }
 
+void DrawingLayer::setRenderCacheEnabled(bool enabled)
+{
+    if (m_renderCacheEnabled != enabled) {
+        m_renderCacheEnabled = enabled;
+        
+        for (DrawingShape *shape : m_shapes) {
+            if (shape) {
+                shape->setRenderCacheEnabled(enabled);
+            }
+        }
+    }
+}
+
 void DrawingLayer::addShape(DrawingShape *shape)
 {
     if (shape && !m_shapes.contains(shape)) {
@@ -78,6 +92,9 @@ void DrawingLayer::addShape(DrawingShape *shape)
         // 应用图层属性到图形
         shape->setVisible(m_visible);
         shape->setOpacity(m_opacity);
+        if (m_renderCacheEnabled) {
+            shape->setRenderCacheEnabled(true);
+        }
         
         // 发出对象添加信号
         emit shapeAdded(shape);
@@ -34,6 +34,10 @@ public:
     bool isLocked() const { return m_locked; }
     void setLocked(bool locked) { m_locked = locked; }
     
+    // 栅格缓存：对图层中所有图形（包括之后加入的）生效
+    bool isRenderCacheEnabled() const { return m_renderCacheEnabled; }
+    void setRenderCacheEnabled(bool enabled);
+    
     // 图层内容管理
     void addShape(DrawingShape *shape);
     void removeShape(DrawingShape *shape);
@@ -63,6 +67,7 @@ private:
     bool m_visible;
     qreal m_opacity;
     bool m_locked;
+    bool m_renderCacheEnabled;
     QList<DrawingShape*> m_shapes;
     QTransform m_layerTransform;
     DrawingScene *m_scene;
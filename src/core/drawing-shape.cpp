@@ -7,6 +7,8 @@
 #include <QPointer>
 #include <QUuid>
 #include <QAtomicInt>
+#include <QtMath>
+#include <cmath>
 
 #include "../core/drawing-shape.h"
 #include "../core/drawing-document.h"
@@ -14,6 +16,24 @@
 #include "../ui/drawingview.h"
 #include "../core/toolbase.h"
 #include "../ui/drawingscene.h"
+#include "../core/shape-render-cache.h"
+#include "../core/patheditor.h"
+#include "../tools/node-handle-layer.h"
+#include "../ui/tile-renderer.h"
+
+// 细节层次：默认屏幕误差（像素）、最深的缩小层级、启用简化的最少路径元素数
+static const qreal DEFAULT_LOD_TOLERANCE = 0.5;
+static const int MAX_LOD_LEVEL = 16;
+static const int LOD_MIN_ELEMENTS = 16;
+static qreal lodToleranceSetting = DEFAULT_LOD_TOLERANCE;
+
+// 全局递增的外观版本号，地址被复用的新图形也不会与旧图形的版本相同
+static quint32 nextContentVersion()
+{
+    static QAtomicInt counter(1);
+    return quint32(counter.fetchAndAddRelaxed(1));
+}
+
 // BezierControlPointCommand 实现
 BezierControlPointCommand::BezierControlPointCommand(DrawingScene *scene, DrawingPath *path, int pointIndex, 
                                                    const QPointF &oldPos, const QPointF &newPos, QUndoCommand *parent)
@@ -25,14 +45,8 @@ BezierControlPointCommand::BezierControlPointCommand(DrawingScene *scene, Drawin
 void BezierControlPointCommand::undo()
 {
     if (m_path && m_path->scene() == m_scene) {
-        // 恢复到旧位置
-        QVector<QPointF> controlPoints = m_path->controlPoints();
-        if (m_pointIndex < controlPoints.size()) {
-            controlPoints[m_pointIndex] = m_oldPos;
-            m_path->setControlPoints(controlPoints);
-            m_path->updatePathFromControlPoints();
-            m_path->update();
-        }
+        // 恢复到旧位置，只改一个控制点，不复制整个数组
+        m_path->setNodePoint(m_pointIndex, m_oldPos);
     }
 }
 
@@ -40,14 +54,7 @@ void BezierControlPointCommand::redo()
 {
     if (m_path && m_path->scene() == m_scene) {
         // 应用到新位置
-        QVector<QPointF> controlPoints = m_path->controlPoints();
-        if (m_pointIndex < controlPoints.size()) {
-            controlPoints[m_pointIndex] = m_newPos;
-            m_path->setControlPoints(controlPoints);
-            m_path->updatePathFromControlPoints();
-            m_path->update();
-        }
-        
+        m_path->setNodePoint(m_pointIndex, m_newPos);
     }
 }
 
@@ -57,12 +64,13 @@ DrawingShape::DrawingShape(ShapeType type, QGraphicsItem *parent)
     : QGraphicsItem(parent)
     , m_id(generateUniqueId())
     , m_type(type)
-    , m_fillBrush(Qt::white)
-    , m_strokePen(QPen(Qt::black, 1.0))
     , m_showSelectionIndicator(true)
     , m_isMoving(false)
     , m_moveStartPos(0, 0)
 {
+    m_contentVersion = nextContentVersion();
+    m_detachedPen = QPen(Qt::black, 1.0);
+    m_detachedBrush = QBrush(Qt::white);
     setFlags(QGraphicsItem::ItemIsSelectable | 
              QGraphicsItem::ItemIsMovable | 
              QGraphicsItem::ItemSendsGeometryChanges);
@@ -77,13 +85,25 @@ DrawingShape::~DrawingShape()
         setGraphicsEffect(nullptr);
     }
     
-    // 清除可能存在的吸附指示器（防止悬空指针）
+    // 清除可能存在的吸附指示器和吸附点（防止悬空指针）
     if (scene()) {
         DrawingScene *drawingScene = qobject_cast<DrawingScene*>(scene());
         if (drawingScene) {
             drawingScene->clearSnapIndicators();
+            drawingScene->removeSnapPoints(this);
         }
     }
+    
+    if (m_renderCacheEnabled) {
+        ShapeRenderCache::instance()->remove(this);
+    }
+    
+    if (m_document) {
+        m_document->removeItem(this);
+    }
+    if (m_styleTable) {
+        m_styleTable->release(this);
+    }
 }
 
 QString DrawingShape::generateUniqueId()
@@ -117,15 +137,95 @@ void DrawingShape::bakeTransform(const QTransform &transform)
     setTransform(newMatrix);
 }
 
+void DrawingShape::setShapeStyle(const QPen &pen, const QBrush &brush)
+{
+    if (m_styleTable) {
+        m_styleTable->assign(this, pen, brush);
+    } else {
+        m_detachedPen = pen;
+        m_detachedBrush = brush;
+    }
+    styleChanged();
+}
+
+void DrawingShape::styleChanged()
+{
+    m_styleRevision++;
+    update();
+    notifyObjectStateChanged();
+}
+
+void DrawingShape::setStyleTable(StyleTable *table)
+{
+    if (table == m_styleTable) {
+        return;
+    }
+    const QPen pen = strokePen();
+    const QBrush brush = fillBrush();
+    if (m_styleTable) {
+        m_styleTable->release(this);
+    }
+    m_styleTable = table;
+    if (m_styleTable) {
+        m_styleTable->assign(this, pen, brush);
+        m_detachedPen = QPen();
+        m_detachedBrush = QBrush();
+    } else {
+        m_detachedPen = pen;
+        m_detachedBrush = brush;
+    }
+}
+
 void DrawingShape::notifyObjectStateChanged()
 {
     // 通知场景对象状态已变化
     if (scene()) {
         DrawingScene *drawingScene = qobject_cast<DrawingScene*>(scene());
         if (drawingScene) {
+            drawingScene->invalidateSnapPoints(this);
             emit drawingScene->objectStateChanged(this);
         }
     }
+    
+    // 样式和变换的修改都经过这里
+    invalidateRenderCache();
+    if (m_document) {
+        m_document->markDirty(this);
+    }
+}
+
+void DrawingShape::invalidateSnapPoints()
+{
+    DrawingScene *drawingScene = qobject_cast<DrawingScene*>(scene());
+    if (drawingScene) {
+        drawingScene->invalidateSnapPoints(this);
+    }
+}
+
+void DrawingShape::geometryChanged()
+{
+    invalidateSnapPoints();
+    invalidateRenderCache();
+    if (m_document) {
+        m_document->markDirty(this);
+    }
+}
+
+void DrawingShape::setRenderCacheEnabled(bool enabled)
+{
+    if (m_renderCacheEnabled != enabled) {
+        invalidateRenderCache();
+        m_renderCacheEnabled = enabled;
+        update();
+    }
+}
+
+void DrawingShape::invalidateRenderCache()
+{
+    m_contentVersion = nextContentVersion();
+    if (m_renderCacheEnabled) {
+        ShapeRenderCache::instance()->remove(this);
+    }
 }
 
 void DrawingShape::rotateAroundAnchor(double angle, const QPointF &center)
@@ -216,28 +316,25 @@ QPainterPath DrawingShape::transformedShape() const
 void DrawingShape::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
 {
     Q_UNUSED(option)
-    Q_UNUSED(widget)
-    
-    // 保存当前变换状态
-    painter->save();
-    
-    // 应用变换矩阵
-    painter->setTransform(m_transform, true);
-    
-    // 绘制填充
-    painter->setBrush(m_fillBrush);
-    painter->setPen(Qt::NoPen);
-    paintShape(painter);
     
-    // 绘制描边，使用cosmetic画笔确保线宽不随缩放变化
-    painter->setBrush(Qt::NoBrush);
-    QPen cosmeticPen = m_strokePen;
-    cosmeticPen.setCosmetic(true);  // 设置为cosmetic画笔，线宽不受变换影响
-    painter->setPen(cosmeticPen);
-    paintShape(painter);
-    
-    // 恢复变换状态
-    painter->restore();
+    // 分块渲染的视图由后台线程按层叠顺序绘制图形内容，这里只绘制尚未进入快照的图形和选择指示器
+    TileRenderer *tileRenderer = TileRenderer::forViewport(widget);
+    if (!tileRenderer || !tileRenderer->rendersShape(this)) {
+        // 保存当前变换状态
+        painter->save();
+        
+        // 应用变换矩阵
+        painter->setTransform(m_transform, true);
+        
+        // 只有屏幕绘制使用栅格缓存，导出和打印（widget为空）始终按矢量绘制；
+        // 选中的图形通常正在编辑，不缓存
+        if (!m_renderCacheEnabled || !widget || isSelected() || !paintCached(painter)) {
+            paintContent(painter);
+        }
+        
+        // 恢复变换状态
+        painter->restore();
+    }
     
     // 绘制选择指示器（在场景坐标系中）
     // 只有当m_showSelectionIndicator为true且图形被选中时才绘制
@@ -265,6 +362,80 @@ void DrawingShape::paint(QPainter *painter, const QStyleOptionGraphicsItem *opti
 
 
 
+void DrawingShape::paintVectorContent(QPainter *painter)
+{
+    painter->save();
+    painter->setTransform(m_transform, true);
+    paintContent(painter);
+    painter->restore();
+}
+
+void DrawingShape::paintContent(QPainter *painter)
+{
+    // 绘制填充
+    painter->setBrush(fillBrush());
+    painter->setPen(Qt::NoPen);
+    paintShape(painter);
+    
+    // 绘制描边，使用cosmetic画笔确保线宽不随缩放变化
+    painter->setBrush(Qt::NoBrush);
+    QPen cosmeticPen = strokePen();
+    cosmeticPen.setCosmetic(true);  // 设置为cosmetic画笔，线宽不受变换影响
+    painter->setPen(cosmeticPen);
+    paintShape(painter);
+}
+
+bool DrawingShape::paintCached(QPainter *painter)
+{
+    // 图块按统一比例渲染，只用于不含非均匀缩放和透视的变换
+    const QTransform world = painter->worldTransform();
+    if (!world.isAffine()) {
+        return false;
+    }
+    const qreal scaleX = qSqrt(world.m11() * world.m11() + world.m12() * world.m12());
+    const qreal scaleY = qSqrt(world.m21() * world.m21() + world.m22() * world.m22());
+    if (!(scaleX > 0) || qAbs(scaleX - scaleY) > 0.01 * qMax(scaleX, scaleY)) {
+        return false;
+    }
+
+    ShapeRenderCache *cache = ShapeRenderCache::instance();
+    const int bucket = ShapeRenderCache::zoomBucket(scaleX);
+    const ShapeRenderCache::Tile *tile = cache->find(this, bucket, m_styleRevision);
+
+    ShapeRenderCache::Tile rendered;
+    if (!tile) {
+        const QRectF bounds = localBounds();
+        const qreal scale = ShapeRenderCache::bucketScale(bucket);
+        // 边缘留出描边和抗锯齿的宽度（像素）
+        const int margin = qCeil(qMax<qreal>(1.0, strokePen().widthF()) / 2.0) + 2;
+        const qreal width = bounds.width() * scale + 2 * margin;
+        const qreal height = bounds.height() * scale + 2 * margin;
+        if (bounds.isEmpty() || width > ShapeRenderCache::MAX_TILE_SIZE || height > ShapeRenderCache::MAX_TILE_SIZE) {
+            return false;
+        }
+
+        rendered.pixmap = QPixmap(qCeil(width), qCeil(height));
+        rendered.pixmap.fill(Qt::transparent);
+        rendered.rect = QRectF(bounds.left() - margin / scale, bounds.top() - margin / scale,
+                               rendered.pixmap.width() / scale, rendered.pixmap.height() / scale);
+
+        QPainter tilePainter(&rendered.pixmap);
+        tilePainter.setRenderHints(painter->renderHints());
+        tilePainter.scale(scale, scale);
+        tilePainter.translate(-rendered.rect.topLeft());
+        paintContent(&tilePainter);
+        tilePainter.end();
+
+        // 超出预算时仍然使用这次渲染的结果
+        tile = cache->insert(this, bucket, m_styleRevision, rendered)
+             ? cache->find(this, bucket, m_styleRevision) : &rendered;
+    }
+
+    painter->setRenderHint(QPainter::SmoothPixmapTransform, true);
+    painter->drawPixmap(tile->rect, tile->pixmap, QRectF(tile->pixmap.rect()));
+    return true;
+}
+
 QVariant DrawingShape::itemChange(GraphicsItemChange change, const QVariant &value)
 {
     if (change == ItemPositionChange && scene()) {
@@ -292,8 +463,30 @@ QVariant DrawingShape::itemChange(GraphicsItemChange change, const QVariant &val
     } else if (change == ItemTransformHasChanged || change == ItemPositionHasChanged) {
         // 通知对象状态已变化
         notifyObjectStateChanged();
-    } else if (change == ItemParentHasChanged) {
+    } else if (change == ItemSceneChange) {
+        // 离开原场景时从它的吸附点索引和文档图形表中删除
+        DrawingScene *drawingScene = qobject_cast<DrawingScene*>(scene());
+        if (drawingScene) {
+            drawingScene->removeSnapPoints(this);
+            drawingScene->document()->removeItem(this);
+        }
+    } else if (change == ItemSceneHasChanged || change == ItemVisibleHasChanged) {
+        DrawingScene *drawingScene = qobject_cast<DrawingScene*>(scene());
+        if (change == ItemSceneHasChanged && drawingScene) {
+            drawingScene->document()->addItem(this);
+        } else if (change == ItemVisibleHasChanged && m_document) {
+            m_document->markDirty(this);
+        }
+        invalidateSnapPoints();
+    } else if (change == ItemOpacityHasChanged) {
+        if (m_document) {
+            m_document->markDirty(this);
+        }
+    } else if (change == ItemZValueHasChanged || change == ItemParentHasChanged) {
         // 老的手柄系统已移除，不再需要更新手柄状态
+        if (m_document) {
+            m_document->markStackingChanged(this);
+        }
     }
     
     return QGraphicsItem::itemChange(change, value);
@@ -422,6 +615,7 @@ void DrawingRectangle::setRectangle(const QRectF &rect)
     // 只有当矩形真正发生变化时才更新
     if (m_rect != rect) {
         prepareGeometryChange();
+        geometryChanged();
         m_rect = rect;
         update(); // 直接赋值需要手动调用update()
     }
@@ -432,6 +626,7 @@ void DrawingRectangle::setCornerRadius(qreal radius)
     // 只有当圆角半径真正发生变化时才更新
     if (qAbs(m_cornerRadius - radius) > 0.001) {
         m_cornerRadius = radius;
+        invalidateRenderCache();
         update(); // 直接赋值需要手动调用update()
     }
 }
@@ -467,6 +662,7 @@ void DrawingRectangle::setNodePoint(int index, const QPointF &pos)
             qreal distance = localPos.x() - m_rect.left();
             qreal maxRadius = qMin(m_rect.width(), m_rect.height()) / 2.0;
             m_cornerRadius = qBound(0.0, distance, maxRadius);
+            invalidateRenderCache();
             update();
             break;
         }
@@ -625,6 +821,7 @@ void DrawingEllipse::setEllipse(const QRectF &rect)
 {
     if (m_rect != rect) {
         prepareGeometryChange();
+        geometryChanged();
         m_rect = rect;
         update();
     }
@@ -878,125 +1075,155 @@ DrawingPath::DrawingPath(QGraphicsItem *parent)
 {
 }
 
+DrawingPath::~DrawingPath()
+{
+    // 手柄层是子项，在这里先删除，让它断开与路径的关联
+    delete m_nodeHandleLayer;
+}
+
 void DrawingPath::setMarker(const QString &markerId, const QPixmap &markerPixmap, const QTransform &markerTransform)
 {
     m_markerId = markerId;
     m_markerPixmap = markerPixmap;
     m_markerTransform = markerTransform;
+    invalidateRenderCache();
     update(); // 触发重绘以显示Marker
 }
 
 // 视觉反馈和高亮方法实现
+// 节点高亮只重绘手柄层中的两个手柄，路径高亮才需要重绘路径本身
 void DrawingPath::highlightNode(int index)
 {
-    if (index >= 0 && index < m_controlPoints.size()) {
-        m_highlightedNode = index;
+    if (index < 0 || index >= m_controlPoints.size() || (index == m_highlightedNode && !m_highlightedPath)) {
+        return;
+    }
+    const int previous = m_highlightedNode;
+    m_highlightedNode = index;
+    if (m_highlightedPath) {
         m_highlightedPath = false;
+        invalidateRenderCache();
         update();
     }
+    if (m_nodeHandleLayer) {
+        m_nodeHandleLayer->updateNode(previous);
+        m_nodeHandleLayer->updateNode(index);
+    }
 }
 
 void DrawingPath::highlightPath(const QPointF& point)
 {
+    Q_UNUSED(point);
+    if (m_highlightedPath) {
+        return;
+    }
+    const int previous = m_highlightedNode;
     m_highlightedPath = true;
     m_highlightedNode = -1;
+    invalidateRenderCache();
     update();
+    if (m_nodeHandleLayer) {
+        m_nodeHandleLayer->updateNode(previous);
+    }
 }
 
 void DrawingPath::clearHighlights()
 {
+    // 悬停时每次移动都会清除所有图形的高亮，没有高亮时不触发重绘
+    if (m_highlightedNode < 0 && !m_highlightedPath) {
+        return;
+    }
+    const int previous = m_highlightedNode;
     m_highlightedNode = -1;
-    m_highlightedPath = false;
-    update();
+    if (m_highlightedPath) {
+        m_highlightedPath = false;
+        invalidateRenderCache();
+        update();
+    }
+    if (m_nodeHandleLayer) {
+        m_nodeHandleLayer->updateNode(previous);
+    }
 }
 
-int DrawingPath::findNodeAt(const QPointF& pos, qreal threshold) const
+const PointGrid &DrawingPath::nodeGrid() const
 {
-    QPointF localPos = mapFromScene(pos);
-    
-    for (int i = 0; i < m_controlPoints.size(); ++i) {
-        QPointF distance = localPos - m_controlPoints[i];
-        qreal squaredDistance = distance.x() * distance.x() + distance.y() * distance.y();
-        if (squaredDistance <= threshold * threshold) {
-            return i;
-        }
+    if (!m_nodeGridValid) {
+        m_nodeGrid.build(m_controlPoints);
+        m_nodeGridValid = true;
     }
-    return -1;
+    return m_nodeGrid;
+}
+
+int DrawingPath::findNodeAt(const QPointF& pos, qreal threshold) const
+{
+    return nodeGrid().first(mapFromScene(pos), threshold);
 }
 
 bool DrawingPath::isPointOnPath(const QPointF& pos, qreal threshold) const
 {
-    QPointF localPos = mapFromScene(pos);
-    
-    // 创建一个稍大的路径来检测点击
-    QPainterPathStroker stroker;
-    stroker.setWidth(threshold * 2);
-    QPainterPath widenedPath = stroker.createStroke(m_path);
-    
-    return widenedPath.contains(localPos);
+    if (!m_hitTestBvhValid) {
+        m_hitTestBvh.build(displayPath());
+        m_hitTestBvhValid = true;
+    }
+    return m_hitTestBvh.hitTest(mapFromScene(pos), threshold);
 }
 
 QRectF DrawingPath::localBounds() const
 {
-    // 获取路径本身的边界框
-    QRectF pathBounds = m_path.boundingRect();
-    
-    // 如果有控制点，需要扩展边界框以包含所有控制点
-    if (!m_controlPoints.isEmpty()) {
-        QRectF controlBounds;
-        bool firstPoint = true;
-        
-        for (const QPointF &point : m_controlPoints) {
-            if (firstPoint) {
-                controlBounds = QRectF(point, QSizeF(1, 1));
-                firstPoint = false;
-            } else {
-                controlBounds = controlBounds.united(QRectF(point, QSizeF(1, 1)));
-            }
-        }
-        
-        // 为控制点添加一些边距，确保圆形控制点完全可见
-        const qreal margin = 7.0; // 控制点半径4.0 + 额外边距
-        controlBounds.adjust(-margin, -margin, margin, margin);
-        
-        // 返回路径边界框和控制点边界框的并集
-        return pathBounds.united(controlBounds);
+    // 路径在控制多边形的凸包内，控制点包围盒已包含路径，不需要生成路径
+    if (m_controlPoints.isEmpty()) {
+        return QRectF();
     }
     
-    return pathBounds;
+    // 每个控制点按1x1计，再加一些边距，确保圆形控制点完全可见
+    const qreal margin = 7.0; // 控制点半径4.0 + 额外边距
+    return m_controlPointBounds.adjusted(-margin, -margin, margin + 1, margin + 1);
 }
 
 void DrawingPath::setPath(const QPainterPath &path)
 {
-    if (m_path != path) {
-        prepareGeometryChange();
-        m_path = path;
-        
-        // 保存原始路径元素信息，用于节点编辑
-        m_pathElements.clear();
-        for (int i = 0; i < path.elementCount(); ++i) {
-            const QPainterPath::Element &elem = path.elementAt(i);
-            m_pathElements.append(elem);
-        }
-        
-        // 提取所有类型的元素作为控制点，但标记它们的类型
-        m_controlPoints.clear();
-        m_controlPointTypes.clear();
-        for (int i = 0; i < path.elementCount(); ++i) {
-            const QPainterPath::Element &elem = path.elementAt(i);
-            m_controlPoints.append(QPointF(elem.x, elem.y));
-            m_controlPointTypes.append(elem.type);
-        }
-        
-        update();
+    // 所有类型的元素都作为控制点，命令字节记录元素类型；路径本身不保存，需要时重新生成
+    const int count = path.elementCount();
+    QVector<QPointF> points(count);
+    QByteArray commands(count, Qt::Uninitialized);
+    for (int i = 0; i < count; ++i) {
+        const QPainterPath::Element &elem = path.elementAt(i);
+        points[i] = QPointF(elem.x, elem.y);
+        commands[i] = char(elem.type);
+    }
+    
+    if (points != m_controlPoints || commands != m_controlPointCommands || path.fillRule() != m_fillRule) {
+        m_controlPoints = points;
+        m_controlPointCommands = commands;
+        m_fillRule = path.fillRule();
+        updatePathFromControlPoints();
     }
 }
 
+void DrawingPath::setControlPointTypes(const QVector<QPainterPath::ElementType> &types)
+{
+    QByteArray commands(types.size(), Qt::Uninitialized);
+    for (int i = 0; i < types.size(); ++i) {
+        commands[i] = char(types[i]);
+    }
+    if (commands != m_controlPointCommands) {
+        m_controlPointCommands = commands;
+        updatePathFromControlPoints();
+    }
+}
+
+QVector<QPainterPath::ElementType> DrawingPath::controlPointTypes() const
+{
+    QVector<QPainterPath::ElementType> types(m_controlPointCommands.size());
+    for (int i = 0; i < m_controlPointCommands.size(); ++i) {
+        types[i] = QPainterPath::ElementType(m_controlPointCommands[i]);
+    }
+    return types;
+}
+
 QPainterPath DrawingPath::transformedShape() const
 {
     // 直接返回路径，应用变换
-    QPainterPath path = m_path;
-    path = m_transform.map(path);
+    QPainterPath path = m_transform.map(displayPath());
     path.setFillRule(Qt::WindingFill);
     return path;
 }
@@ -1040,6 +1267,9 @@ void DrawingPath::mousePressEvent(QGraphicsSceneMouseEvent *event)
         int nearestPoint = findNearestControlPoint(event->scenePos());
         if (nearestPoint != -1) {
             m_activeControlPoint = nearestPoint;
+            if (m_nodeHandleLayer) {
+                m_nodeHandleLayer->updateNode(nearestPoint);
+            }
             m_dragStartPos = event->scenePos();
             // 保存原始控制点位置
             m_originalControlPoints = m_controlPoints;
@@ -1101,7 +1331,11 @@ void DrawingPath::mouseReleaseEvent(QGraphicsSceneMouseEvent *event)
         }
         
         // 结束拖动
+        const int released = m_activeControlPoint;
         m_activeControlPoint = -1;
+        if (m_nodeHandleLayer) {
+            m_nodeHandleLayer->updateNode(released);
+        }
         event->accept();
         return;
     }
@@ -1115,6 +1349,27 @@ int DrawingPath::findNearestControlPoint(const QPointF &scenePos) const
     int nearestIndex = -1;
     qreal minDistance = 10.0; // 阈值距离
     
+    // 阈值按变换的最小缩放换算到本地坐标，在网格中取候选点后按场景距离比较
+    const QTransform toScene = m_transform * sceneTransform();
+    const qreal trace = toScene.m11() * toScene.m11() + toScene.m12() * toScene.m12()
+                        + toScene.m21() * toScene.m21() + toScene.m22() * toScene.m22();
+    const qreal determinant = toScene.m11() * toScene.m22() - toScene.m12() * toScene.m21();
+    const qreal minScale = qSqrt(qMax<qreal>(0, (trace - qSqrt(qMax<qreal>(0, trace * trace - 4 * determinant * determinant))) / 2));
+    if (toScene.isAffine() && minScale > 1e-9) {
+        const qreal radius = minDistance / minScale;
+        const QPointF localPos = toScene.inverted().map(scenePos);
+        QVector<int> candidates;
+        nodeGrid().query(QRectF(localPos - QPointF(radius, radius), localPos + QPointF(radius, radius)), candidates);
+        for (int i : candidates) {
+            const qreal distance = QLineF(scenePos, toScene.map(m_controlPoints[i])).length();
+            if (distance < minDistance || (distance == minDistance && nearestIndex >= 0 && i < nearestIndex)) {
+                minDistance = distance;
+                nearestIndex = i;
+            }
+        }
+        return nearestIndex;
+    }
+    
     for (int i = 0; i < m_controlPoints.size(); ++i) {
         // 首先应用DrawingTransform变换
         QPointF transformedPoint = m_transform.map(m_controlPoints[i]);
@@ -1152,35 +1407,75 @@ void DrawingPath::setControlPoints(const QVector<QPointF> &points)
 
 void DrawingPath::updatePathFromControlPoints()
 {
-    if (m_controlPoints.isEmpty() || m_controlPointTypes.isEmpty()) {
-        return;
+    // 只作废派生数据，路径在下次绘制或查询时按控制点重新生成
+    prepareGeometryChange();
+    geometryChanged();
+    if (m_controlPoints.isEmpty()) {
+        m_controlPointBounds = QRectF();
+    } else {
+        qreal minX = m_controlPoints.first().x();
+        qreal minY = m_controlPoints.first().y();
+        qreal maxX = minX;
+        qreal maxY = minY;
+        for (const QPointF &point : m_controlPoints) {
+            minX = qMin(minX, point.x());
+            minY = qMin(minY, point.y());
+            maxX = qMax(maxX, point.x());
+            maxY = qMax(maxY, point.y());
+        }
+        m_controlPointBounds = QRectF(QPointF(minX, minY), QPointF(maxX, maxY));
+    }
+    m_path = QPainterPath();
+    m_pathValid = false;
+    m_lodPaths.clear();
+    m_hitTestBvhValid = false;
+    m_nodeGridValid = false;
+    if (m_nodeHandleLayer) {
+        m_nodeHandleLayer->refresh();
+    }
+    update();
+}
+
+const QPainterPath &DrawingPath::displayPath() const
+{
+    if (m_pathValid) {
+        return m_path;
     }
+    m_pathValid = true;
+    m_path = QPainterPath();
+    m_path.setFillRule(m_fillRule);
+    if (m_controlPoints.isEmpty() || m_controlPointCommands.isEmpty()) {
+        return m_path;
+    }
+    m_path.reserve(m_controlPoints.size());
     
-    QPainterPath newPath;
+    const QPointF *points = m_controlPoints.constData();
+    const char *commands = m_controlPointCommands.constData();
+    const int commandCount = m_controlPointCommands.size();
     
     // 根据控制点类型重建路径
     for (int i = 0; i < m_controlPoints.size(); ) {
         // 确保索引在有效范围内
-        if (i >= m_controlPointTypes.size()) {
+        if (i >= commandCount) {
             break;
         }
         
-        QPainterPath::ElementType type = m_controlPointTypes[i];
-        QPointF point = m_controlPoints[i];
+        const int type = commands[i];
+        const QPointF &point = points[i];
         
         if (type == QPainterPath::MoveToElement) {
-            newPath.moveTo(point);
+            m_path.moveTo(point);
             i++;
         } else if (type == QPainterPath::LineToElement) {
-            newPath.lineTo(point);
+            m_path.lineTo(point);
             i++;
         } else if (type == QPainterPath::CurveToElement) {
             // 曲线需要3个点：当前点和接下来的两个点
             if (i + 2 < m_controlPoints.size() && 
-                i + 2 < m_controlPointTypes.size() &&
-                m_controlPointTypes[i + 1] == QPainterPath::CurveToDataElement &&
-                m_controlPointTypes[i + 2] == QPainterPath::CurveToDataElement) {
-                newPath.cubicTo(point, m_controlPoints[i + 1], m_controlPoints[i + 2]);
+                i + 2 < commandCount &&
+                commands[i + 1] == QPainterPath::CurveToDataElement &&
+                commands[i + 2] == QPainterPath::CurveToDataElement) {
+                m_path.cubicTo(point, points[i + 1], points[i + 2]);
                 i += 3; // 跳过已经处理的三个控制点
             } else {
                 // 数据不完整，跳过当前点
@@ -1188,19 +1483,10 @@ void DrawingPath::updatePathFromControlPoints()
             }
         } else if (type == QPainterPath::CurveToDataElement) {
             // 检查是否是QuadTo（某些Qt版本中可能使用不同的枚举值）
-            if (i > 0 && i < m_controlPointTypes.size()) {
-                QPainterPath::ElementType prevType = m_controlPointTypes[i-1];
-                if (prevType == QPainterPath::LineToElement && 
-                    i + 1 < m_controlPointTypes.size()) {
-                    // 这可能是QuadTo的情况：LineTo + CurveToDataElement
-                    QPointF endPoint = m_controlPoints[i];
-                    QPointF nextPoint = m_controlPoints[i + 1];
-                    newPath.quadTo(point, endPoint);
-                    i += 2;
-                } else {
-                    // 真正的CurveToDataElement，跳过
-                    i++;
-                }
+            if (i > 0 && commands[i - 1] == QPainterPath::LineToElement && i + 1 < commandCount) {
+                // 这可能是QuadTo的情况：LineTo + CurveToDataElement
+                m_path.quadTo(point, point);
+                i += 2;
             } else {
                 // 真正的CurveToDataElement，跳过
                 i++;
@@ -1210,17 +1496,16 @@ void DrawingPath::updatePathFromControlPoints()
             i++;
         }
     }
-    
-    // 直接更新内部路径，不调用setPath避免无限循环
-    prepareGeometryChange();
-    m_path = newPath;
-    update();
+    return m_path;
 }
 
 void DrawingPath::setShowControlPolygon(bool show)
 {
+    // 控制点由手柄层绘制，路径本身的外观不变
     m_showControlPolygon = show;
-    update(); // 触发重绘
+    if (m_nodeHandleLayer) {
+        m_nodeHandleLayer->setVisible(show);
+    }
 }
 
 bool DrawingPath::showControlPolygon() const
@@ -1228,20 +1513,101 @@ bool DrawingPath::showControlPolygon() const
     return m_showControlPolygon;
 }
 
+void DrawingPath::setLodTolerance(qreal pixels)
+{
+    lodToleranceSetting = qMax<qreal>(0, pixels);
+}
+
+qreal DrawingPath::lodTolerance()
+{
+    return lodToleranceSetting;
+}
+
+QPainterPath DrawingPath::lodPath(const QTransform &world) const
+{
+    const QPainterPath &path = displayPath();
+    const qreal tolerance = lodToleranceSetting;
+    if (!(tolerance > 0) || !world.isAffine() || path.elementCount() < LOD_MIN_ELEMENTS) {
+        return path;
+    }
+    
+    // 取两个方向中较大的缩放，保证任一方向的误差都不超过容差
+    const qreal scale = qMax(qSqrt(world.m11() * world.m11() + world.m12() * world.m12()),
+                             qSqrt(world.m21() * world.m21() + world.m22() * world.m22()));
+    if (!(scale > 0) || scale > 0.5) {
+        return path;
+    }
+    
+    // 第k层的局部误差为tolerance * 2^k，2^k不超过1/scale，屏幕误差不超过tolerance像素
+    const int level = qMin(MAX_LOD_LEVEL, int(std::floor(std::log2(1.0 / scale))));
+    if (m_lodPathsTolerance != tolerance) {
+        m_lodPaths.clear();
+        m_lodPathsTolerance = tolerance;
+    }
+    
+    QHash<int, QPainterPath>::const_iterator it = m_lodPaths.constFind(level);
+    if (it != m_lodPaths.constEnd()) {
+        return it.value();
+    }
+    
+    QPainterPath simplified = PathEditor::simplifyForDisplay(path, std::ldexp(tolerance, level));
+    // 简化效果不明显时保留原路径（曲线由绘制引擎展平，通常更快）
+    if (simplified.elementCount() * 2 > path.elementCount()) {
+        simplified = path;
+    }
+    m_lodPaths.insert(level, simplified);
+    return simplified;
+}
+
+bool DrawingPath::paintSubPixel(QPainter *painter, const QTransform &world) const
+{
+    if (!(lodToleranceSetting > 0) || !world.isAffine()) {
+        return false;
+    }
+    
+    // 用控制点包围盒判断，不需要为缩得很小的路径生成QPainterPath
+    const QRectF deviceBounds = world.mapRect(m_controlPointBounds);
+    if (deviceBounds.width() >= 1 || deviceBounds.height() >= 1) {
+        return false;
+    }
+    
+    // 不足一个像素的路径只按当前画笔（描边）或画刷（填充）的颜色画一个像素
+    const QBrush brush = painter->pen().style() != Qt::NoPen ? painter->pen().brush() : painter->brush();
+    if (brush.style() == Qt::NoBrush) {
+        return true;
+    }
+    QColor color = brush.color();
+    if (brush.gradient() && !brush.gradient()->stops().isEmpty()) {
+        color = brush.gradient()->stops().first().second;
+    }
+    
+    painter->save();
+    painter->resetTransform();
+    painter->fillRect(QRectF(deviceBounds.center() - QPointF(0.5, 0.5), QSizeF(1, 1)), color);
+    painter->restore();
+    return true;
+}
+
 void DrawingPath::paintShape(QPainter *painter)
 {
-    // 如果路径被高亮，使用高亮样式
-    if (m_highlightedPath) {
-        QPen originalPen = painter->pen();
-        QPen highlightPen = originalPen;
-        highlightPen.setWidth(highlightPen.width() + 2);
-        highlightPen.setColor(highlightPen.color().lighter(150));
-        painter->setPen(highlightPen);
-        painter->drawPath(m_path);
-        painter->setPen(originalPen);
-    } else {
-        // 绘制主路径
-        painter->drawPath(m_path);
+    // 缩小显示时按屏幕尺寸选择简化路径，不足一个像素的路径只画一个点
+    const QTransform world = painter->worldTransform();
+    if (!paintSubPixel(painter, world)) {
+        const QPainterPath displayPath = lodPath(world);
+        
+        // 如果路径被高亮，使用高亮样式
+        if (m_highlightedPath) {
+            QPen originalPen = painter->pen();
+            QPen highlightPen = originalPen;
+            highlightPen.setWidth(highlightPen.width() + 2);
+            highlightPen.setColor(highlightPen.color().lighter(150));
+            painter->setPen(highlightPen);
+            painter->drawPath(displayPath);
+            painter->setPen(originalPen);
+        } else {
+            // 绘制主路径
+            painter->drawPath(displayPath);
+        }
     }
     
     // 绘制Marker（如果有）
@@ -1259,112 +1625,7 @@ void DrawingPath::paintShape(QPainter *painter)
         painter->restore();
     }
     
-    // 如果启用了控制点连线，则绘制连接线
-    if (m_showControlPolygon) {
-        QPen oldPen = painter->pen();
-        QBrush oldBrush = painter->brush();
-        
-        // 设置虚线样式
-        QPen controlPen(Qt::DashLine);
-        controlPen.setColor(QColor(100, 100, 255, 128)); // 半透明蓝色
-        controlPen.setWidth(1);
-        controlPen.setCosmetic(true); // 确保线宽不受变换影响
-        
-        painter->setPen(controlPen);
-        painter->setBrush(Qt::NoBrush);  // 不填充
-        
-        // 绘制控制点连线 - 按照贝塞尔曲线的规范连接起点和控制点
-        if (m_controlPoints.size() >= 2) {
-            // 遍历所有贝塞尔段
-            for (int i = 0; i < m_controlPoints.size() - 1; ) {
-                // 检查是否可以形成一个三次贝塞尔曲线 (起点, 控制点1, 控制点2, 终点)
-                if (i + 3 < m_controlPoints.size()) {
-                    // 绘制起点到第一个控制点的连线
-                    painter->drawLine(m_controlPoints[i], m_controlPoints[i+1]);
-                    // 绘制第二个控制点到终点的连线
-                    painter->drawLine(m_controlPoints[i+2], m_controlPoints[i+3]);
-                    i += 3; // 移动到下一个段的起点
-                } 
-                // 检查是否可以形成一个二次贝塞尔曲线 (起点, 控制点, 终点)
-                else if (i + 2 < m_controlPoints.size()) {
-                    // 绘制起点到控制点的连线
-                    painter->drawLine(m_controlPoints[i], m_controlPoints[i+1]);
-                    // 绘制控制点到终点的连线
-                    painter->drawLine(m_controlPoints[i+1], m_controlPoints[i+2]);
-                    i += 2; // 移动到下一个段的起点
-                }
-                // 否则，是直线段
-                else {
-                    painter->drawLine(m_controlPoints[i], m_controlPoints[i+1]);
-                    i += 1;
-                }
-            }
-        }
-        
-        // 绘制控制点（圆形，以区别于方形节点）
-        QPen pointPen(Qt::SolidLine);
-        pointPen.setColor(QColor(100, 100, 255, 200)); // 更不透明的蓝色
-        pointPen.setWidth(1);
-        pointPen.setCosmetic(true);
-        
-        QBrush pointBrush(QColor(200, 200, 255, 180)); // 浅蓝色填充
-        
-        painter->setPen(pointPen);
-        painter->setBrush(pointBrush);
-        
-        // 绘制所有控制点为圆形 - 使用固定大小，不受缩放影响
-        const qreal pointRadius = 4.0; // 控制点半径
-        for (int i = 0; i < m_controlPoints.size(); ++i) {
-            const QPointF &point = m_controlPoints[i];
-            
-            // 如果是高亮的节点，使用高亮样式
-            if (i == m_highlightedNode) {
-                QPen highlightPen(Qt::SolidLine);
-                highlightPen.setColor(QColor(255, 100, 100, 255)); // 红色高亮
-                highlightPen.setWidth(2);
-                highlightPen.setCosmetic(true);
-                
-                QBrush highlightBrush(QColor(255, 200, 200, 200)); // 浅红色填充
-                
-                painter->setPen(highlightPen);
-                painter->setBrush(highlightBrush);
-            } else {
-                QPen pointPen(Qt::SolidLine);
-                pointPen.setColor(QColor(100, 100, 255, 200)); // 蓝色普通点
-                pointPen.setWidth(1);
-                pointPen.setCosmetic(true);
-                
-                QBrush pointBrush(QColor(200, 200, 255, 180)); // 浅蓝色填充
-                
-                painter->setPen(pointPen);
-                painter->setBrush(pointBrush);
-            }
-            
-            // 保存当前变换状态
-            painter->save();
-            
-            // 获取当前变换的缩放因子
-            QTransform currentTransform = painter->transform();
-            
-            // 计算缩放因子（使用变换矩阵的缩放部分）
-            qreal scaleX = qSqrt(currentTransform.m11() * currentTransform.m11() + currentTransform.m21() * currentTransform.m21());
-            qreal scaleY = qSqrt(currentTransform.m12() * currentTransform.m12() + currentTransform.m22() * currentTransform.m22());
-            
-            // 移动到控制点位置并应用反向缩放
-            painter->translate(point);
-            painter->scale(1.0/qMax(scaleX, 0.01), 1.0/qMax(scaleY, 0.01));
-            
-            // 绘制固定大小的圆
-            painter->drawEllipse(QPointF(0, 0), pointRadius, pointRadius);
-            
-            // 恢复变换状态
-            painter->restore();
-        }
-        
-        // 恢复原始画笔和画刷
-        painter->setPen(oldPen);
-        painter->setBrush(oldBrush);
-    }
+    // 控制点和控制点连线由节点手柄层绘制，见NodeHandleLayer
 }
 
 // DrawingText
@@ -1395,6 +1656,7 @@ void DrawingText::setText(const QString &text)
 {
     if (m_text != text) {
         prepareGeometryChange();
+        geometryChanged();
         m_text = text;
         update();
     }
@@ -1404,6 +1666,7 @@ void DrawingText::setFont(const QFont &font)
 {
     if (m_font != font) {
         prepareGeometryChange();
+        geometryChanged();
         m_font = font;
         m_fontSize = font.pointSizeF();
         update();
@@ -1414,6 +1677,7 @@ void DrawingText::setPosition(const QPointF &pos)
 {
     if (m_position != pos) {
         prepareGeometryChange();
+        geometryChanged();
         m_position = pos;
         update();
     }
@@ -1511,11 +1775,13 @@ void DrawingText::paintShape(QPainter *painter)
     painter->setFont(m_font);
     
     // 文本颜色应该使用填充色而不是描边色
-    if (m_fillBrush != Qt::NoBrush) {
-        painter->setPen(QPen(m_fillBrush.color()));
-    } else if (m_strokePen.style() != Qt::NoPen) {
+    const QBrush fill = fillBrush();
+    const QPen stroke = strokePen();
+    if (fill != Qt::NoBrush) {
+        painter->setPen(QPen(fill.color()));
+    } else if (stroke.style() != Qt::NoPen) {
         // 如果没有填充色，使用描边色
-        painter->setPen(m_strokePen.color());
+        painter->setPen(stroke.color());
     } else {
         // 默认使用黑色
         painter->setPen(QPen(Qt::black));
@@ -1560,6 +1826,7 @@ void DrawingText::mouseDoubleClickEvent(QGraphicsSceneMouseEvent *event)
     if (event->button() == Qt::LeftButton) {
         // 双击进入编辑模式
         m_editing = !m_editing;
+        invalidateRenderCache();
         update();
         event->accept();
         return;
@@ -1585,13 +1852,15 @@ DrawingPath* DrawingText::convertToPath() const
     path->setPos(pos());
     
     // 设置样式 - 文本应该有填充色
-    if (m_fillBrush != Qt::NoBrush) {
+    const QBrush fill = fillBrush();
+    const QPen stroke = strokePen();
+    if (fill != Qt::NoBrush) {
         // 如果有填充色，使用填充色
-        path->setFillBrush(m_fillBrush);
+        path->setFillBrush(fill);
         path->setStrokePen(Qt::NoPen); // 移除描边
-    } else if (m_strokePen.style() != Qt::NoPen) {
+    } else if (stroke.style() != Qt::NoPen) {
         // 如果没有填充色但有描边色，使用描边色作为填充
-        path->setFillBrush(QBrush(m_strokePen.color()));
+        path->setFillBrush(QBrush(stroke.color()));
         path->setStrokePen(Qt::NoPen);
     } else {
         // 默认使用黑色填充
@@ -1626,10 +1895,18 @@ QRectF DrawingLine::localBounds() const
     return QRectF(m_line.p1(), m_line.p2()).normalized().adjusted(-m_lineWidth/2, -m_lineWidth/2, m_lineWidth/2, m_lineWidth/2);
 }
 
+QPainterPath DrawingLine::transformedShape() const
+{
+    QPainterPath path(m_line.p1());
+    path.lineTo(m_line.p2());
+    return m_transform.map(path);
+}
+
 void DrawingLine::setLine(const QLineF &line)
 {
     if (m_line != line) {
         prepareGeometryChange();
+        geometryChanged();
         m_line = line;
         update();
     }
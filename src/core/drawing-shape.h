@@ -11,13 +11,19 @@
 #include <QGraphicsSceneMouseEvent>
 #include <QFont>
 #include <QUndoCommand>
+#include <QHash>
+#include <QByteArray>
 #include <memory>
+#include "../core/segment-bvh.h"
+#include "../core/point-grid.h"
+#include "../core/style-table.h"
 
 class DrawingDocument;
 
 class SelectionIndicator;
 class DrawingScene;
 class DrawingPath;
+class NodeHandleLayer;
 
 // 添加EditHandle的前向声明以避免循环包含
 class EditHandle;
@@ -82,7 +88,7 @@ public:
     // 获取本地边界框（未变换）
     virtual QRectF localBounds() const = 0;
     
-    void updateShape(){prepareGeometryChange();}// 更新形状（重新计算边界等）
+    void updateShape(){prepareGeometryChange(); geometryChanged();}// 更新形状（重新计算边界等）
     // QGraphicsItem重写
     int type() const override { 
         if (m_type == Group) {
@@ -101,26 +107,46 @@ public:
     // 视觉反馈和高亮支持
     virtual void highlightNode(int index) { Q_UNUSED(index); }
     virtual void highlightPath(const QPointF& point) { Q_UNUSED(point); }
-    virtual void clearHighlights() { m_highlightedNode = -1; m_highlightedPath = false; update(); }
+    virtual void clearHighlights()
+    {
+        if (m_highlightedNode < 0 && !m_highlightedPath) {
+            return;
+        }
+        m_highlightedNode = -1;
+        m_highlightedPath = false;
+        invalidateRenderCache();
+        update();
+    }
+    int highlightedNode() const { return m_highlightedNode; }
     
     // 获取节点在指定位置的索引
     virtual int findNodeAt(const QPointF& pos, qreal threshold = 5.0) const { Q_UNUSED(pos); Q_UNUSED(threshold); return -1; }
     virtual bool isPointOnPath(const QPointF& pos, qreal threshold = 5.0) const { Q_UNUSED(pos); Q_UNUSED(threshold); return false; }
     
-    // 样式属性
-    void setFillBrush(const QBrush &brush) { m_fillBrush = brush; update(); notifyObjectStateChanged(); }
-    QBrush fillBrush() const { return m_fillBrush; }
+    // 样式属性 - 在文档中时保存在文档的共享样式表中，样式相同的图形共用一条记录；
+    // 不在文档中时（新建尚未加入场景、被撤销移出场景）由图形自己保存
+    void setFillBrush(const QBrush &brush) { setShapeStyle(strokePen(), brush); }
+    QBrush fillBrush() const { return m_styleTable ? m_styleTable->brush(m_style) : m_detachedBrush; }
     
-    void setStrokePen(const QPen &pen) { m_strokePen = pen; update(); notifyObjectStateChanged(); }
-    QPen strokePen() const { return m_strokePen; }
+    void setStrokePen(const QPen &pen) { setShapeStyle(pen, fillBrush()); }
+    QPen strokePen() const { return m_styleTable ? m_styleTable->pen(m_style) : m_detachedPen; }
+    
+    // 样式表中的样式编号，同一编号的图形外观相同；不在文档中时为-1
+    int styleId() const { return m_style; }
+    // 保存样式的样式表，不在文档中时为nullptr
+    StyleTable *styleTable() const { return m_styleTable; }
+    // 画笔或画刷每变化一次加一，栅格缓存的图块按它区分
+    quint32 styleRevision() const { return m_styleRevision; }
     
     // 网格对齐支持
     void setGridAlignmentEnabled(bool enabled) { m_gridAlignmentEnabled = enabled; }
     bool isGridAlignmentEnabled() const { return m_gridAlignmentEnabled; }
     
-    // 文档关联
+    // 文档关联：加入DrawingScene时登记到场景的文档图形表
     void setDocument(DrawingDocument *doc) { m_document = doc; }
     DrawingDocument* document() const { return m_document; }
+    // 在文档中的句柄（DrawingDocument::Handle），未登记时为全1
+    quint64 documentHandle() const { return m_documentHandle; }
     
     // 形状类型
     ShapeType shapeType() const { return m_type; }
@@ -149,16 +175,30 @@ public:
     
     // 通知状态变化
     void notifyObjectStateChanged();
+    // 几何变化后让场景重新计算吸附点
+    void invalidateSnapPoints();
+    
+    // 栅格缓存：开启后按缩放档位缓存渲染结果，外观变化时丢弃
+    void setRenderCacheEnabled(bool enabled);
+    bool isRenderCacheEnabled() const { return m_renderCacheEnabled; }
+    void invalidateRenderCache();
+    // 外观版本号，每次外观变化后取新值，分块渲染据此判断是否需要重新录制
+    quint32 contentVersion() const { return m_contentVersion; }
     
     // 🌟 将变换烘焙到图形的内部几何结构中
     virtual void bakeTransform(const QTransform &transform);
 
 // 渲染
     void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+    // 按图形自身的变换按矢量绘制内容，不含选择指示器；分块渲染录制快照时使用
+    void paintVectorContent(QPainter *painter);
     
 protected:
     QVariant itemChange(GraphicsItemChange change, const QVariant &value) override;
     
+    // 几何形状变化：吸附点和栅格缓存都要更新
+    void geometryChanged();
+    
     // 鼠标事件处理（用于跟踪移动）
     void mousePressEvent(QGraphicsSceneMouseEvent *event) override;
     void mouseMoveEvent(QGraphicsSceneMouseEvent *event) override;
@@ -167,11 +207,14 @@ protected:
     // 子类需要实现的绘制方法（在本地坐标系中）
     virtual void paintShape(QPainter *painter) = 0;
     
+    // 在本地坐标系中绘制填充和描边
+    void paintContent(QPainter *painter);
+    // 通过栅格缓存绘制，不适合缓存时返回false
+    bool paintCached(QPainter *painter);
+    
     QString m_id;           // 对象唯一标识符
     ShapeType m_type;
     QTransform m_transform;  // 直接使用Qt的变换系统
-    QBrush m_fillBrush;
-    QPen m_strokePen;
     DrawingDocument *m_document = nullptr;
     
     // 编辑把手系统（已弃用）
@@ -186,6 +229,10 @@ protected:
     // 避免递归吸附的标志
     bool m_applyingSnap = false;
     
+    // 栅格缓存
+    bool m_renderCacheEnabled = false;
+    quint32 m_contentVersion;
+    
     // 移动跟踪
     bool m_isMoving = false;
     bool m_transformStarted = false;
@@ -194,6 +241,26 @@ protected:
     // 视觉反馈状态
     int m_highlightedNode = -1;
     bool m_highlightedPath = false;
+    
+private:
+    friend class StyleTable;
+    friend class DrawingDocument;
+    
+    void setShapeStyle(const QPen &pen, const QBrush &brush);
+    // 换到另一张样式表（加入或离开文档时由DrawingDocument调用），外观不变；table为nullptr时由图形自己保存
+    void setStyleTable(StyleTable *table);
+    // 外观样式已变化（本图形改样式或样式表修改了它使用的样式）
+    void styleChanged();
+    
+    // 样式编号和在该样式使用者列表中的位置，由StyleTable维护
+    StyleTable *m_styleTable = nullptr;
+    int m_style = -1;
+    int m_styleUser = -1;
+    quint32 m_styleRevision = 0;
+    // 不在文档中时的样式；在文档中时为默认值，不占额外内存
+    QPen m_detachedPen;
+    QBrush m_detachedBrush;
+    quint64 m_documentHandle = ~quint64(0);
 };
 
 // DrawingRectangle
@@ -224,6 +291,7 @@ public:
         m_fRatioY = ratioY; 
         // 更新实际的圆角半径
         m_cornerRadius = qMin(m_rect.width() * m_fRatioX, m_rect.height() * m_fRatioY);
+        invalidateRenderCache();
         update(); // 直接赋值需要手动调用update()
     }
     qreal cornerRadiusRatioX() const { return m_fRatioX; }
@@ -315,27 +383,37 @@ class DrawingPath : public DrawingShape
 {
 public:
     explicit DrawingPath(QGraphicsItem *parent = nullptr);
+    ~DrawingPath() override;
     
     QRectF localBounds() const override;
     void setPath(const QPainterPath &path);
-    QPainterPath path() const { return m_path; }
+    // 由控制点和命令生成的路径，首次使用时生成并缓存
+    QPainterPath path() const { return displayPath(); }
     
     // 重写变换形状方法
     QPainterPath transformedShape() const override;
     
     // 控制点相关
     void setControlPoints(const QVector<QPointF> &points);
-    QVector<QPointF> controlPoints() const { return m_controlPoints; }
+    const QVector<QPointF> &controlPoints() const { return m_controlPoints; }
     void updatePathFromControlPoints();
     
-    // 控制点类型相关 - 用于保存原始路径元素信息
-    void setControlPointTypes(const QVector<QPainterPath::ElementType> &types) { m_controlPointTypes = types; }
-    QVector<QPainterPath::ElementType> controlPointTypes() const { return m_controlPointTypes; }
+    // 控制点类型相关 - 每个控制点一个字节，取值为QPainterPath::ElementType
+    void setControlPointTypes(const QVector<QPainterPath::ElementType> &types);
+    QVector<QPainterPath::ElementType> controlPointTypes() const;
+    const QByteArray &controlPointCommands() const { return m_controlPointCommands; }
     
     // 控制点连线显示
     void setShowControlPolygon(bool show);
     bool showControlPolygon() const;
     
+    // 节点手柄层：节点编辑时由NodeHandleLayer统一绘制控制点，路径本身不再绘制
+    void setNodeHandleLayer(NodeHandleLayer *layer) { m_nodeHandleLayer = layer; }
+    NodeHandleLayer *nodeHandleLayer() const { return m_nodeHandleLayer; }
+    int activeControlPoint() const { return m_activeControlPoint; }
+    // 控制点的网格索引（本地坐标，未应用m_transform），控制点变化后首次访问时重建
+    const PointGrid &nodeGrid() const;
+    
     // 编辑点相关 - 路径的控制点
     QVector<QPointF> getNodePoints() const override;
     void setNodePoint(int index, const QPointF &pos) override;
@@ -356,6 +434,12 @@ public:
     void setMarker(const QString &markerId, const QPixmap &markerPixmap, const QTransform &markerTransform);
     bool hasMarker() const { return !m_markerId.isEmpty(); }
     QString markerId() const { return m_markerId; }
+    
+    // 细节层次：缩小显示时按屏幕误差（像素）绘制简化路径，0表示始终绘制完整路径
+    static void setLodTolerance(qreal pixels);
+    static qreal lodTolerance();
+    // 按世界变换选择的显示路径，缩小时为对应层级的简化路径，屏幕误差不超过容差
+    QPainterPath lodPath(const QTransform &world) const;
 
 protected:
     void paintShape(QPainter *painter) override;
@@ -370,10 +454,28 @@ private:
     int findNearestControlPoint(const QPointF &scenePos) const;
     bool isPointNearControlPoint(const QPointF &scenePos, const QPointF &controlPoint, qreal threshold = 10.0) const;
     
-    QPainterPath m_path;
-    QVector<QPainterPath::Element> m_pathElements; // 原始路径元素，保存曲线信息
-    QVector<QPointF> m_controlPoints;  // 控制点，用于编辑
-    QVector<QPainterPath::ElementType> m_controlPointTypes; // 控制点类型
+    // 按控制点和命令生成路径，控制点修改后首次调用时重新生成
+    const QPainterPath &displayPath() const;
+    
+    // 不足一个像素的路径只画一个点
+    bool paintSubPixel(QPainter *painter, const QTransform &world) const;
+    
+    // 几何数据只保存一份：控制点坐标加每点一个字节的命令，路径按需生成
+    QVector<QPointF> m_controlPoints;
+    QByteArray m_controlPointCommands;
+    Qt::FillRule m_fillRule = Qt::OddEvenFill;
+    QRectF m_controlPointBounds; // 控制点包围盒，包含整条路径
+    mutable QPainterPath m_path;
+    mutable bool m_pathValid = false;
+    // 各缩小层级的简化路径，路径修改或容差改变时清空
+    mutable QHash<int, QPainterPath> m_lodPaths;
+    mutable qreal m_lodPathsTolerance = 0;
+    // 命中测试用的线段包围盒层次，首次查询时建立，路径修改时作废
+    mutable SegmentBvh m_hitTestBvh;
+    mutable bool m_hitTestBvhValid = false;
+    mutable PointGrid m_nodeGrid;
+    mutable bool m_nodeGridValid = false;
+    NodeHandleLayer *m_nodeHandleLayer = nullptr;
     
     // Marker相关
     QString m_markerId;
@@ -443,11 +545,13 @@ public:
     explicit DrawingLine(const QLineF &line = QLineF(0, 0, 100, 100), QGraphicsItem *parent = nullptr);
     
     QRectF localBounds() const override;
+    // 直线本身的线段（不闭合），不是包围盒
+    QPainterPath transformedShape() const override;
     void setLine(const QLineF &line);
     QLineF line() const { return m_line; }
     
     // 线条属性
-    void setLineWidth(qreal width) { m_lineWidth = width; update(); }
+    void setLineWidth(qreal width) { m_lineWidth = width; invalidateRenderCache(); update(); }
     qreal lineWidth() const { return m_lineWidth; }
     
     // 编辑点相关 - 直线的两个端点
@@ -490,13 +594,14 @@ public:
     void clearPoints() { m_points.clear(); update(); }
     
     // 线条属性
-    void setLineWidth(qreal width) { m_lineWidth = width; update(); }
+    void setLineWidth(qreal width) { m_lineWidth = width; invalidateRenderCache(); update(); }
     qreal lineWidth() const { return m_lineWidth; }
     
     // 闭合属性
     void setClosed(bool closed) { 
         // qDebug() << "DrawingPolyline::setClosed called with:" << closed << "from" << m_closed;
         m_closed = closed; 
+        invalidateRenderCache();
         update(); 
     }
     bool isClosed() const { return m_closed; }
@@ -550,7 +655,7 @@ public:
     void clearPoints() { m_points.clear(); update(); }
     
     // 填充属性
-    void setFillRule(Qt::FillRule rule) { m_fillRule = rule; update(); }
+    void setFillRule(Qt::FillRule rule) { m_fillRule = rule; invalidateRenderCache(); update(); }
     Qt::FillRule fillRule() const { return m_fillRule; }
     
     // 编辑点相关 - 多边形的所有顶点
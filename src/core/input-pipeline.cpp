@@ -0,0 +1,187 @@
+#include <QMouseEvent>
+#include <QWidget>
+#include <QtMath>
+#include <QDebug>
+#include "../core/input-pipeline.h"
+
+// 两个采样时间戳相同时使用的最小间隔（秒）
+static const qreal MIN_SAMPLE_INTERVAL = 0.0005;
+// 时间戳间隔过大（如停顿后）时按此间隔处理，避免滤波器跳变
+static const qreal MAX_SAMPLE_INTERVAL = 0.1;
+
+// OneEuroFilter
+OneEuroFilter::OneEuroFilter(qreal minCutoff, qreal beta, qreal derivativeCutoff)
+    : m_minCutoff(minCutoff)
+    , m_beta(beta)
+    , m_derivativeCutoff(derivativeCutoff)
+    , m_initialized(false)
+{
+}
+
+void OneEuroFilter::setParameters(qreal minCutoff, qreal beta)
+{
+    m_minCutoff = qMax(0.01, minCutoff);
+    m_beta = qMax(0.0, beta);
+}
+
+void OneEuroFilter::reset()
+{
+    m_initialized = false;
+    m_derivative = QPointF();
+}
+
+qreal OneEuroFilter::smoothingFactor(qreal cutoff, qreal dt)
+{
+    const qreal tau = 1.0 / (2.0 * M_PI * cutoff);
+    return 1.0 / (1.0 + tau / dt);
+}
+
+QPointF OneEuroFilter::filter(const QPointF &value, qreal dt)
+{
+    if (!m_initialized) {
+        m_initialized = true;
+        m_value = value;
+        m_derivative = QPointF();
+        return value;
+    }
+    
+    dt = qBound(MIN_SAMPLE_INTERVAL, dt, MAX_SAMPLE_INTERVAL);
+    
+    // 先对速度做低通，再由速度决定位置的截止频率
+    const QPointF derivative = (value - m_value) / dt;
+    const qreal derivativeAlpha = smoothingFactor(m_derivativeCutoff, dt);
+    m_derivative += (derivative - m_derivative) * derivativeAlpha;
+    
+    const qreal speed = qSqrt(QPointF::dotProduct(m_derivative, m_derivative));
+    const qreal cutoff = m_minCutoff + m_beta * speed;
+    m_value += (value - m_value) * smoothingFactor(cutoff, dt);
+    return m_value;
+}
+
+// InputPipeline
+InputPipeline::InputPipeline(QObject *parent)
+    : QObject(parent)
+    , m_filterEnabled(true)
+    , m_flushScheduled(false)
+    , m_lastTimestampNs(0)
+    , m_receivedCount(0)
+    , m_deliveredCount(0)
+{
+    m_clock.start();
+}
+
+InputPipeline::~InputPipeline()
+{
+    detach();
+}
+
+void InputPipeline::attach(QWidget *viewport)
+{
+    if (m_viewport == viewport) {
+        return;
+    }
+    detach();
+    m_viewport = viewport;
+    if (m_viewport) {
+        m_viewport->installEventFilter(this);
+    }
+}
+
+void InputPipeline::detach()
+{
+    if (m_viewport) {
+        m_viewport->removeEventFilter(this);
+    }
+    m_viewport = nullptr;
+}
+
+InputSample InputPipeline::makeSample(QMouseEvent *event, const QPointF &scenePos)
+{
+    InputSample sample;
+    sample.rawPosition = scenePos;
+    sample.position = scenePos;
+    sample.receivedNs = m_clock.nsecsElapsed();
+    
+    // 事件时间戳只有毫秒精度，没有时间戳时用收到的时间
+    const quint64 eventTimestamp = event ? event->timestamp() : 0;
+    sample.timestampNs = eventTimestamp > 0 ? qint64(eventTimestamp) * 1000000 : sample.receivedNs;
+    
+    // 鼠标没有压感，按下时压力为1
+    sample.pressure = 1.0;
+    if (event && event->pointCount() > 0) {
+        const qreal pressure = event->point(0).pressure();
+        if (pressure > 0.0) {
+            sample.pressure = qMin(pressure, 1.0);
+        }
+    }
+    return sample;
+}
+
+InputSample InputPipeline::begin(QMouseEvent *event, const QPointF &scenePos)
+{
+    clear();
+    m_filter.reset();
+    m_receivedCount = 1;
+    m_deliveredCount = 1;
+    
+    InputSample sample = makeSample(event, scenePos);
+    if (m_filterEnabled) {
+        sample.position = m_filter.filter(sample.rawPosition, 0.0);
+    }
+    m_lastTimestampNs = sample.timestampNs;
+    return sample;
+}
+
+void InputPipeline::addSample(QMouseEvent *event, const QPointF &scenePos)
+{
+    InputSample sample = makeSample(event, scenePos);
+    if (m_filterEnabled) {
+        const qreal dt = (sample.timestampNs - m_lastTimestampNs) / 1.0e9;
+        sample.position = m_filter.filter(sample.rawPosition, dt);
+    }
+    m_lastTimestampNs = sample.timestampNs;
+    
+    m_pending.append(sample);
+    m_receivedCount++;
+    scheduleFlush();
+}
+
+void InputPipeline::scheduleFlush()
+{
+    if (m_flushScheduled) {
+        return;
+    }
+    m_flushScheduled = true;
+    // 排在本轮已到达的输入事件之后处理，同一帧内的采样合并为一批
+    QMetaObject::invokeMethod(this, [this]() {
+        m_flushScheduled = false;
+        flush();
+    }, Qt::QueuedConnection);
+}
+
+void InputPipeline::flush()
+{
+    if (m_pending.isEmpty()) {
+        return;
+    }
+    
+    // 先交换出来，处理过程中到达的采样进入下一批
+    QVector<InputSample> batch;
+    batch.swap(m_pending);
+    m_deliveredCount += batch.size();
+    emit samplesReady(batch);
+}
+
+void InputPipeline::clear()
+{
+    m_pending.clear();
+}
+
+bool InputPipeline::eventFilter(QObject *watched, QEvent *event)
+{
+    // 重绘前把还没处理的采样画进这一帧
+    if (watched == m_viewport && event->type() == QEvent::Paint && !m_pending.isEmpty()) {
+        flush();
+    }
+    return QObject::eventFilter(watched, event);
+}
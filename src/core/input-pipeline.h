@@ -0,0 +1,112 @@
+#ifndef INPUT_PIPELINE_H
+#define INPUT_PIPELINE_H
+
+#include <QObject>
+#include <QPointF>
+#include <QPointer>
+#include <QVector>
+#include <QElapsedTimer>
+
+class QMouseEvent;
+class QWidget;
+
+/**
+ * 一个输入采样点
+ */
+struct InputSample {
+    QPointF position;      // 滤波后的场景坐标
+    QPointF rawPosition;   // 原始场景坐标
+    qreal pressure;        // 压力 (0.0 - 1.0)
+    qint64 timestampNs;    // 事件时间戳（纳秒）
+    qint64 receivedNs;     // 收到事件的时间（纳秒，InputPipeline的时钟），用于测量延迟
+};
+
+/**
+ * One-Euro滤波器
+ * 低速时截止频率低，去掉手抖；高速时截止频率随速度升高，减少滞后
+ */
+class OneEuroFilter
+{
+public:
+    OneEuroFilter(qreal minCutoff = 1.5, qreal beta = 0.02, qreal derivativeCutoff = 1.0);
+    
+    void setParameters(qreal minCutoff, qreal beta);
+    qreal minCutoff() const { return m_minCutoff; }
+    qreal beta() const { return m_beta; }
+    
+    void reset();
+    // dt为与上一个采样的间隔（秒）
+    QPointF filter(const QPointF &value, qreal dt);
+    
+private:
+    static qreal smoothingFactor(qreal cutoff, qreal dt);
+    
+    qreal m_minCutoff;
+    qreal m_beta;
+    qreal m_derivativeCutoff;
+    bool m_initialized;
+    QPointF m_value;
+    QPointF m_derivative;
+};
+
+/**
+ * 绘图输入管线 - 画笔、钢笔和橡皮擦工具共用
+ * 每个原始采样都保留并带时间戳，经自适应滤波后按批交给工具；
+ * 一轮事件循环中到达的采样合并为一批，在视口重绘前处理完
+ */
+class InputPipeline : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit InputPipeline(QObject *parent = nullptr);
+    ~InputPipeline();
+    
+    // 绑定视口：视口重绘前先处理完待处理的采样
+    void attach(QWidget *viewport);
+    void detach();
+    
+    // 滤波设置
+    void setFilterEnabled(bool enabled) { m_filterEnabled = enabled; }
+    bool isFilterEnabled() const { return m_filterEnabled; }
+    void setFilterParameters(qreal minCutoff, qreal beta) { m_filter.setParameters(minCutoff, beta); }
+    qreal filterMinCutoff() const { return m_filter.minCutoff(); }
+    qreal filterBeta() const { return m_filter.beta(); }
+    
+    // 开始新的笔画，返回第一个采样（立即处理，不进入批次）
+    InputSample begin(QMouseEvent *event, const QPointF &scenePos);
+    // 添加采样，在本轮事件循环结束或视口重绘前通过samplesReady交给工具
+    void addSample(QMouseEvent *event, const QPointF &scenePos);
+    // 立即交出所有待处理的采样（用于鼠标释放时）
+    void flush();
+    // 丢弃待处理的采样
+    void clear();
+    
+    int pendingCount() const { return m_pending.size(); }
+    int receivedCount() const { return m_receivedCount; }
+    int deliveredCount() const { return m_deliveredCount; }
+    // 管线使用的时钟（纳秒）
+    qint64 elapsedNs() const { return m_clock.nsecsElapsed(); }
+
+signals:
+    void samplesReady(const QVector<InputSample> &samples);
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+    InputSample makeSample(QMouseEvent *event, const QPointF &scenePos);
+    void scheduleFlush();
+    
+    QPointer<QWidget> m_viewport;
+    QElapsedTimer m_clock;
+    OneEuroFilter m_filter;
+    bool m_filterEnabled;
+    bool m_flushScheduled;
+    qint64 m_lastTimestampNs;
+    QVector<InputSample> m_pending;
+    int m_receivedCount;
+    int m_deliveredCount;
+};
+
+#endif // INPUT_PIPELINE_H
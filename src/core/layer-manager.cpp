@@ -30,6 +30,7 @@ LayerManager::LayerManager(QObject *parent)
     , m_layerPanel(nullptr)
     , m_activeLayer(nullptr)
     , m_layerCounter(1)
+    , m_renderCacheEnabled(false)
 {
     // 暂时不做任何初始化
 }
@@ -377,6 +378,14 @@ void LayerManager::setLayerOpacity(DrawingLayer *layer, qreal opacity)
     emit layerChanged(layer);
 }
 
+void LayerManager::setRenderCacheEnabled(bool enabled)
+{
+    m_renderCacheEnabled = enabled;
+    for (DrawingLayer *layer : m_layers) {
+        layer->setRenderCacheEnabled(enabled);
+    }
+}
+
 void LayerManager::setActiveLayer(DrawingLayer *layer)
 {
     if (m_activeLayer == layer) {
@@ -485,6 +494,9 @@ void LayerManager::connectLayer(DrawingLayer *layer)
     connect(layer, &DrawingLayer::shapeRemoved, this, [this, layer]() {
         emit layerContentChanged(layer);
     });
+    
+    // 新图层沿用当前的栅格缓存设置
+    layer->setRenderCacheEnabled(m_renderCacheEnabled);
 }
 
 void LayerManager::disconnectLayer(DrawingLayer *layer)
@@ -48,6 +48,10 @@ public:
     void setLayerLocked(DrawingLayer *layer, bool locked);
     void setLayerOpacity(DrawingLayer *layer, qreal opacity);
     
+    // 栅格缓存开关，作用于所有图层和之后新建的图层
+    void setRenderCacheEnabled(bool enabled);
+    bool isRenderCacheEnabled() const { return m_renderCacheEnabled; }
+    
     // 图层选择
     void setActiveLayer(DrawingLayer *layer);
     void setActiveLayer(int index);
@@ -93,6 +97,7 @@ private:
     QList<DrawingLayer*> m_layers;
     DrawingLayer *m_activeLayer;
     int m_layerCounter;  // 用于生成唯一图层名称
+    bool m_renderCacheEnabled;
 };
 
 #endif // LAYER_MANAGER_H
\ No newline at end of file
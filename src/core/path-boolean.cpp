@@ -0,0 +1,663 @@
+#include <QThread>
+#include <QThreadPool>
+#include <QVector>
+#include <QHash>
+#include <QtMath>
+#include <QDebug>
+#include <algorithm>
+#include <numeric>
+#include "../core/path-boolean.h"
+
+// 量化后坐标的最大绝对值，保证中间结果在double中仍然精确
+static const qint64 MAX_COORDINATE = qint64(1) << 30;
+// 每个单位最多细分的份数
+static const qreal MAX_SCALE = 1024.0;
+// 每条曲线最多展平的段数
+static const int MAX_CURVE_STEPS = 256;
+// 消除取整后残余交叉的最大轮数
+static const int MAX_SPLIT_PASSES = 8;
+// 并行时每个线程至少分到的操作数
+static const int MIN_OPERANDS_PER_BATCH = 32;
+
+namespace {
+
+// 原始线段：直线或三次曲线，输出时据此还原曲线
+struct Source {
+    QPointF p[4];
+    bool curve;
+    int steps;
+};
+
+// 量化后的边，y0 < y1；t0/t1为两端在原始线段上的参数
+struct Edge {
+    qint64 x0, y0, x1, y1;
+    qreal t0, t1;
+    int source;
+    int operand;
+    int winding;
+};
+
+struct IntPoint {
+    qint64 x, y;
+    bool operator==(const IntPoint &other) const { return x == other.x && y == other.y; }
+    bool operator!=(const IntPoint &other) const { return !(*this == other); }
+};
+
+// 结果边界在一个水平带内的一段
+struct Piece {
+    qint64 xb, yb, xt, yt;
+    int edge;
+    bool insideRight;   // 结果区域在这一段的x正方向一侧
+};
+
+// 沿轮廓走过的一段
+struct Traversal {
+    IntPoint start;
+    IntPoint end;
+    qreal ts, te;
+    int source;
+};
+
+}
+
+static QPointF cubicPoint(const QPointF p[4], qreal t)
+{
+    const qreal u = 1.0 - t;
+    return p[0] * (u * u * u) + p[1] * (3 * u * u * t) + p[2] * (3 * u * t * t) + p[3] * (t * t * t);
+}
+
+static QPointF cubicDerivative(const QPointF p[4], qreal t)
+{
+    const qreal u = 1.0 - t;
+    return (p[1] - p[0]) * (3 * u * u) + (p[2] - p[1]) * (6 * u * t) + (p[3] - p[2]) * (3 * t * t);
+}
+
+static qreal xAt(const Edge &e, qint64 y)
+{
+    if (y <= e.y0) {
+        return e.x0;
+    }
+    if (y >= e.y1) {
+        return e.x1;
+    }
+    return e.x0 + qreal(e.x1 - e.x0) * qreal(y - e.y0) / qreal(e.y1 - e.y0);
+}
+
+static qreal tAt(const Edge &e, qint64 y)
+{
+    return e.t0 + (e.t1 - e.t0) * qreal(y - e.y0) / qreal(e.y1 - e.y0);
+}
+
+/**
+ * 一组操作数的扫描线布尔运算
+ */
+class BooleanSweep
+{
+public:
+    BooleanSweep(PathEditor::BooleanOperation op, qreal tolerance, bool positiveOnly = false)
+        : m_op(op), m_tolerance(tolerance), m_scale(1.0), m_positiveOnly(positiveOnly)
+    {
+    }
+
+    QPainterPath run(const QList<QPainterPath> &operands)
+    {
+        m_fillRules.clear();
+        QRectF bounds;
+        for (const QPainterPath &path : operands) {
+            m_fillRules.append(path.fillRule());
+            bounds |= path.controlPointRect();
+        }
+
+        // 取2的幂作为缩放，量化不引入额外的舍入
+        const qreal extent = qMax(qMax(qAbs(bounds.left()), qAbs(bounds.right())),
+                                  qMax(qAbs(bounds.top()), qAbs(bounds.bottom())));
+        const qreal scale = qMin(MAX_SCALE, qreal(MAX_COORDINATE) / qMax(extent, 1.0));
+        m_scale = qPow(2.0, qFloor(std::log2(scale)));
+
+        for (int i = 0; i < operands.size(); ++i) {
+            addOperand(operands[i], i);
+        }
+
+        for (int pass = 0; pass < MAX_SPLIT_PASSES; ++pass) {
+            if (!splitCrossings()) {
+                break;
+            }
+        }
+
+        collectPieces(operands.size());
+        return buildPath();
+    }
+
+private:
+    template<typename BeamFunc, typename CrossingFunc>
+    void sweep(BeamFunc beam, CrossingFunc crossing) const;
+
+    void addOperand(const QPainterPath &path, int operand);
+    void addSource(const Source &source, int operand);
+    void addEdge(const QPointF &a, const QPointF &b, qreal ta, qreal tb, int source, int operand);
+    bool splitCrossings();
+    void collectPieces(int operandCount);
+    QPainterPath buildPath() const;
+
+    IntPoint quantize(const QPointF &point) const
+    {
+        return {qRound64(point.x() * m_scale), qRound64(point.y() * m_scale)};
+    }
+    QPointF toPoint(const IntPoint &point) const
+    {
+        return QPointF(point.x / m_scale, point.y / m_scale);
+    }
+
+    PathEditor::BooleanOperation m_op;
+    qreal m_tolerance;
+    qreal m_scale;
+    bool m_positiveOnly;     // 忽略填充规则，只有环绕数为正才算在内
+    QVector<Qt::FillRule> m_fillRules;
+    QVector<Source> m_sources;
+    QVector<Edge> m_edges;
+    QVector<Piece> m_pieces;
+};
+
+template<typename BeamFunc, typename CrossingFunc>
+void BooleanSweep::sweep(BeamFunc beam, CrossingFunc crossing) const
+{
+    QVector<qint64> ys;
+    ys.reserve(m_edges.size() * 2);
+    for (const Edge &e : m_edges) {
+        ys.append(e.y0);
+        ys.append(e.y1);
+    }
+    std::sort(ys.begin(), ys.end());
+    ys.erase(std::unique(ys.begin(), ys.end()), ys.end());
+
+    QVector<int> order(m_edges.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [this](int a, int b) { return m_edges[a].y0 < m_edges[b].y0; });
+
+    QVector<int> active;
+    QVector<qreal> bottom;
+    QVector<qreal> top;
+    int next = 0;
+    for (int i = 0; i + 1 < ys.size(); ++i) {
+        const qint64 yb = ys[i];
+        const qint64 yt = ys[i + 1];
+
+        int kept = 0;
+        for (int k = 0; k < active.size(); ++k) {
+            if (m_edges[active[k]].y1 > yb) {
+                active[kept++] = active[k];
+            }
+        }
+        active.resize(kept);
+        while (next < order.size() && m_edges[order[next]].y0 == yb) {
+            active.append(order[next++]);
+        }
+
+        bottom.resize(active.size());
+        top.resize(active.size());
+        for (int k = 0; k < active.size(); ++k) {
+            bottom[k] = xAt(m_edges[active[k]], yb);
+            top[k] = xAt(m_edges[active[k]], yt);
+        }
+
+        // 上一带结束时已按x排好，这里只需把新加入的边插入到位
+        for (int k = 1; k < active.size(); ++k) {
+            for (int j = k; j > 0 && (bottom[j - 1] > bottom[j] || (bottom[j - 1] == bottom[j] && top[j - 1] > top[j])); --j) {
+                std::swap(active[j - 1], active[j]);
+                std::swap(bottom[j - 1], bottom[j]);
+                std::swap(top[j - 1], top[j]);
+            }
+        }
+
+        beam(active, bottom, top, yb, yt);
+
+        // 按顶部x重新排序：每次交换都是带内的一个交叉
+        for (int k = 1; k < active.size(); ++k) {
+            for (int j = k; j > 0 && top[j - 1] > top[j]; --j) {
+                crossing(active[j - 1], active[j]);
+                std::swap(active[j - 1], active[j]);
+                std::swap(bottom[j - 1], bottom[j]);
+                std::swap(top[j - 1], top[j]);
+            }
+        }
+    }
+}
+
+void BooleanSweep::addOperand(const QPainterPath &path, int operand)
+{
+    QPointF current;
+    QPointF subpathStart;
+    bool open = false;
+
+    auto closeSubpath = [&]() {
+        if (open && current != subpathStart) {
+            addSource({{current, subpathStart, QPointF(), QPointF()}, false, 1}, operand);
+        }
+        open = false;
+    };
+
+    for (int i = 0; i < path.elementCount(); ++i) {
+        const QPainterPath::Element &element = path.elementAt(i);
+        const QPointF point(element.x, element.y);
+        switch (element.type) {
+        case QPainterPath::MoveToElement:
+            closeSubpath();
+            current = subpathStart = point;
+            open = true;
+            break;
+        case QPainterPath::LineToElement:
+            addSource({{current, point, QPointF(), QPointF()}, false, 1}, operand);
+            current = point;
+            break;
+        case QPainterPath::CurveToElement: {
+            if (i + 2 >= path.elementCount()) {
+                break;
+            }
+            const QPointF c2(path.elementAt(i + 1).x, path.elementAt(i + 1).y);
+            const QPointF end(path.elementAt(i + 2).x, path.elementAt(i + 2).y);
+            addSource({{current, point, c2, end}, true, 1}, operand);
+            current = end;
+            i += 2;
+            break;
+        }
+        default:
+            break;
+        }
+    }
+    closeSubpath();
+}
+
+void BooleanSweep::addSource(const Source &input, int operand)
+{
+    Source source = input;
+    if (source.curve) {
+        // 展平误差上界：max|B''| / (8 n^2)
+        const QPointF d1 = source.p[0] - 2 * source.p[1] + source.p[2];
+        const QPointF d2 = source.p[1] - 2 * source.p[2] + source.p[3];
+        const qreal m = qMax(qSqrt(QPointF::dotProduct(d1, d1)), qSqrt(QPointF::dotProduct(d2, d2)));
+        source.steps = qBound(1, qCeil(qSqrt(0.75 * m / m_tolerance)), MAX_CURVE_STEPS);
+    }
+
+    const int index = m_sources.size();
+    m_sources.append(source);
+
+    if (!source.curve) {
+        addEdge(source.p[0], source.p[1], 0.0, 1.0, index, operand);
+        return;
+    }
+    QPointF previous = source.p[0];
+    for (int k = 1; k <= source.steps; ++k) {
+        const qreal t = qreal(k) / source.steps;
+        const QPointF point = k == source.steps ? source.p[3] : cubicPoint(source.p, t);
+        addEdge(previous, point, qreal(k - 1) / source.steps, t, index, operand);
+        previous = point;
+    }
+}
+
+void BooleanSweep::addEdge(const QPointF &a, const QPointF &b, qreal ta, qreal tb, int source, int operand)
+{
+    const IntPoint p = quantize(a);
+    const IntPoint q = quantize(b);
+    // 水平边不改变扫描带内的环绕数，直接丢弃
+    if (p.y == q.y) {
+        return;
+    }
+    // 向y减小方向的边记+1，有向面积为正的轮廓内部环绕数为+1
+    if (p.y < q.y) {
+        m_edges.append({p.x, p.y, q.x, q.y, ta, tb, source, operand, -1});
+    } else {
+        m_edges.append({q.x, q.y, p.x, p.y, tb, ta, source, operand, 1});
+    }
+}
+
+bool BooleanSweep::splitCrossings()
+{
+    QVector<QPair<int, int>> crossings;
+    sweep([](const QVector<int> &, const QVector<qreal> &, const QVector<qreal> &, qint64, qint64) {},
+          [&crossings](int a, int b) { crossings.append(qMakePair(a, b)); });
+    if (crossings.isEmpty()) {
+        return false;
+    }
+
+    QHash<int, QVector<IntPoint>> splits;
+    for (const auto &pair : crossings) {
+        const Edge &a = m_edges[pair.first];
+        const Edge &b = m_edges[pair.second];
+        const qreal rx = a.x1 - a.x0, ry = a.y1 - a.y0;
+        const qreal sx = b.x1 - b.x0, sy = b.y1 - b.y0;
+        const qreal denominator = rx * sy - ry * sx;
+        if (denominator == 0.0) {
+            continue;
+        }
+        const qreal t = ((b.x0 - a.x0) * sy - (b.y0 - a.y0) * sx) / denominator;
+        IntPoint point{qRound64(a.x0 + rx * t), qRound64(a.y0 + ry * t)};
+
+        // 交点取整后落在某条边的端点高度上时，直接吸附到该端点
+        for (const Edge *e : {&a, &b}) {
+            if (point.y <= e->y0) {
+                point = {e->x0, e->y0};
+            } else if (point.y >= e->y1) {
+                point = {e->x1, e->y1};
+            }
+        }
+        if (point.y > a.y0 && point.y < a.y1) {
+            splits[pair.first].append(point);
+        }
+        if (point.y > b.y0 && point.y < b.y1) {
+            splits[pair.second].append(point);
+        }
+    }
+    if (splits.isEmpty()) {
+        return false;
+    }
+
+    // 在交点处把边打断，相交的两条边共享同一个整数顶点
+    for (auto it = splits.begin(); it != splits.end(); ++it) {
+        QVector<IntPoint> &points = it.value();
+        std::sort(points.begin(), points.end(), [](const IntPoint &p, const IntPoint &q) { return p.y < q.y; });
+        points.erase(std::unique(points.begin(), points.end(),
+                                 [](const IntPoint &p, const IntPoint &q) { return p.y == q.y; }), points.end());
+
+        const Edge original = m_edges[it.key()];
+        IntPoint from{original.x0, original.y0};
+        qreal tFrom = original.t0;
+        for (int k = 0; k <= points.size(); ++k) {
+            const IntPoint to = k < points.size() ? points[k] : IntPoint{original.x1, original.y1};
+            const qreal tTo = k < points.size() ? tAt(original, to.y) : original.t1;
+            const Edge piece{from.x, from.y, to.x, to.y, tFrom, tTo, original.source, original.operand, original.winding};
+            if (k == 0) {
+                m_edges[it.key()] = piece;
+            } else {
+                m_edges.append(piece);
+            }
+            from = to;
+            tFrom = tTo;
+        }
+    }
+    return true;
+}
+
+void BooleanSweep::collectPieces(int operandCount)
+{
+    QVector<int> winding(operandCount, 0);
+    int insideCount = 0;
+
+    auto isInside = [this](int operand, int w) {
+        if (m_positiveOnly) {
+            return w > 0;
+        }
+        return m_fillRules[operand] == Qt::WindingFill ? w != 0 : (w & 1) != 0;
+    };
+    auto result = [&]() {
+        switch (m_op) {
+        case PathEditor::Union:
+            return insideCount > 0;
+        case PathEditor::Intersection:
+            return insideCount == operandCount;
+        case PathEditor::Subtraction:
+            return insideCount == 1 && isInside(0, winding[0]);
+        case PathEditor::Xor:
+            return (insideCount & 1) != 0;
+        }
+        return false;
+    };
+
+    sweep([&](const QVector<int> &active, const QVector<qreal> &bottom, const QVector<qreal> &top, qint64 yb, qint64 yt) {
+        // 从左到右累计各操作数的环绕数，结果内外发生变化的位置就是边界
+        for (int k = 0; k < active.size();) {
+            const qint64 xb = qRound64(bottom[k]);
+            const qint64 xt = qRound64(top[k]);
+            const bool before = result();
+            // 重合的边作为一组处理，不产生零宽的边界
+            int end = k;
+            while (end < active.size() && qRound64(bottom[end]) == xb && qRound64(top[end]) == xt) {
+                const Edge &e = m_edges[active[end]];
+                const bool wasInside = isInside(e.operand, winding[e.operand]);
+                winding[e.operand] += e.winding;
+                insideCount += int(isInside(e.operand, winding[e.operand])) - int(wasInside);
+                ++end;
+            }
+            const bool after = result();
+            if (before != after) {
+                m_pieces.append({xb, yb, xt, yt, active[k], after});
+            }
+            k = end;
+        }
+    }, [](int, int) {});
+}
+
+QPainterPath BooleanSweep::buildPath() const
+{
+    QPainterPath path;
+    path.setFillRule(Qt::OddEvenFill);
+    if (m_pieces.isEmpty()) {
+        return path;
+    }
+
+    // 端点编号：2k为第k段的底端，2k+1为顶端
+    struct Endpoint {
+        qint64 y, x;
+        int id;
+    };
+    QVector<Endpoint> endpoints;
+    endpoints.reserve(m_pieces.size() * 2);
+    for (int k = 0; k < m_pieces.size(); ++k) {
+        endpoints.append({m_pieces[k].yb, m_pieces[k].xb, 2 * k});
+        endpoints.append({m_pieces[k].yt, m_pieces[k].xt, 2 * k + 1});
+    }
+    std::sort(endpoints.begin(), endpoints.end(), [](const Endpoint &a, const Endpoint &b) {
+        return a.y != b.y ? a.y < b.y : (a.x != b.x ? a.x < b.x : a.id < b.id);
+    });
+
+    // 每段的走向使区域始终在左侧：外轮廓有向面积为正，洞为负
+    auto entry = [this](int piece) {
+        return m_pieces[piece].insideRight ? 2 * piece + 1 : 2 * piece;
+    };
+
+    // 同一高度上：同一点处走出的端点与走入的端点直接相连，其余按x顺序两两用水平线相连
+    QVector<int> partner(endpoints.size(), -1);
+    auto link = [&partner](int a, int b) {
+        partner[a] = b;
+        partner[b] = a;
+    };
+    for (int i = 0; i < endpoints.size();) {
+        int levelEnd = i;
+        while (levelEnd < endpoints.size() && endpoints[levelEnd].y == endpoints[i].y) {
+            ++levelEnd;
+        }
+        QVector<int> leftovers;
+        for (int j = i; j < levelEnd;) {
+            int groupEnd = j;
+            QVector<int> outgoing;
+            QVector<int> incoming;
+            while (groupEnd < levelEnd && endpoints[groupEnd].x == endpoints[j].x) {
+                const int id = endpoints[groupEnd].id;
+                (entry(id >> 1) == id ? incoming : outgoing).append(id);
+                ++groupEnd;
+            }
+            const int through = qMin(outgoing.size(), incoming.size());
+            for (int k = 0; k < through; ++k) {
+                link(outgoing[k], incoming[k]);
+            }
+            const QVector<int> &rest = outgoing.size() > through ? outgoing : incoming;
+            int k = through;
+            for (; k + 1 < rest.size(); k += 2) {
+                link(rest[k], rest[k + 1]);
+            }
+            if (k < rest.size()) {
+                leftovers.append(rest[k]);
+            }
+            j = groupEnd;
+        }
+        for (int k = 0; k + 1 < leftovers.size(); k += 2) {
+            link(leftovers[k], leftovers[k + 1]);
+        }
+        i = levelEnd;
+    }
+
+    auto traversal = [this](int endpoint) {
+        const Piece &piece = m_pieces[endpoint >> 1];
+        const Edge &e = m_edges[piece.edge];
+        const IntPoint bottom{piece.xb, piece.yb};
+        const IntPoint top{piece.xt, piece.yt};
+        const qreal tb = tAt(e, piece.yb);
+        const qreal tt = tAt(e, piece.yt);
+        // 从底端走入则向上走
+        if ((endpoint & 1) == 0) {
+            return Traversal{bottom, top, tb, tt, e.source};
+        }
+        return Traversal{top, bottom, tt, tb, e.source};
+    };
+    // 同一条原始线段上、参数连续且方向一致的相邻段可以合并
+    auto joinable = [this](const Traversal &a, const Traversal &b) {
+        if (a.source != b.source || (a.te - a.ts) * (b.te - b.ts) <= 0) {
+            return false;
+        }
+        const qreal step = 1.0 / m_sources[a.source].steps;
+        return qAbs(b.ts - a.te) <= step + 1e-9;
+    };
+
+    QVector<bool> used(m_pieces.size(), false);
+    QVector<Traversal> contour;
+    for (int start = 0; start < m_pieces.size(); ++start) {
+        if (used[start]) {
+            continue;
+        }
+        contour.clear();
+        int endpoint = entry(start);
+        while (!used[endpoint >> 1]) {
+            used[endpoint >> 1] = true;
+            contour.append(traversal(endpoint));
+            endpoint = partner[endpoint ^ 1];
+            if (endpoint < 0) {
+                break;
+            }
+        }
+
+        // 从一个不能与前一段合并的位置开始，避免一条曲线被起点切成两段
+        const int n = contour.size();
+        int first = 0;
+        for (int i = 0; i < n; ++i) {
+            if (!joinable(contour[(i + n - 1) % n], contour[i])) {
+                first = i;
+                break;
+            }
+        }
+
+        path.moveTo(toPoint(contour[first].start));
+        IntPoint last = contour[first].start;
+        for (int i = 0; i < n;) {
+            const Traversal &runStart = contour[(first + i) % n];
+            int runEnd = i;
+            while (runEnd + 1 < n && joinable(contour[(first + runEnd) % n], contour[(first + runEnd + 1) % n])) {
+                ++runEnd;
+            }
+            const Traversal &runLast = contour[(first + runEnd) % n];
+
+            if (runStart.start != last) {
+                path.lineTo(toPoint(runStart.start));
+            }
+            const Source &source = m_sources[runStart.source];
+            const QPointF from = toPoint(runStart.start);
+            const QPointF to = toPoint(runLast.end);
+            if (source.curve) {
+                // 取原曲线在[ts, te]上的一段，端点对齐到量化后的点
+                const qreal span = (runLast.te - runStart.ts) / 3.0;
+                const QPointF c1 = from + cubicDerivative(source.p, runStart.ts) * span;
+                const QPointF c2 = to - cubicDerivative(source.p, runLast.te) * span;
+                path.cubicTo(c1, c2, to);
+            } else {
+                path.lineTo(to);
+            }
+            last = runLast.end;
+            i = runEnd + 1;
+        }
+        path.closeSubpath();
+    }
+    return path;
+}
+
+QPainterPath PathBoolean::combine(const QList<QPainterPath> &operands,
+                                  PathEditor::BooleanOperation op,
+                                  qreal tolerance,
+                                  bool parallel)
+{
+    if (operands.isEmpty()) {
+        return QPainterPath();
+    }
+    tolerance = qMax(tolerance, 1e-4);
+
+    // 交集和差集依赖全部操作数的相对关系，只能整体计算
+    if (!parallel || op == PathEditor::Intersection || op == PathEditor::Subtraction
+        || operands.size() < 2 * MIN_OPERANDS_PER_BATCH) {
+        return BooleanSweep(op, tolerance).run(operands);
+    }
+
+    // 按包围盒重叠求连通分组（并查集），不同分组的结果互不影响
+    const int count = operands.size();
+    QVector<QRectF> bounds(count);
+    QVector<int> parent(count);
+    for (int i = 0; i < count; ++i) {
+        bounds[i] = operands[i].controlPointRect();
+        parent[i] = i;
+    }
+    auto find = [&parent](int i) {
+        while (parent[i] != i) {
+            parent[i] = parent[parent[i]];
+            i = parent[i];
+        }
+        return i;
+    };
+    QVector<int> order(count);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&bounds](int a, int b) { return bounds[a].left() < bounds[b].left(); });
+    for (int i = 0; i < count; ++i) {
+        const QRectF &a = bounds[order[i]];
+        for (int j = i + 1; j < count && bounds[order[j]].left() <= a.right(); ++j) {
+            const QRectF &b = bounds[order[j]];
+            if (b.top() <= a.bottom() && a.top() <= b.bottom()) {
+                parent[find(order[i])] = find(order[j]);
+            }
+        }
+    }
+
+    QHash<int, QList<QPainterPath>> groups;
+    for (int i = 0; i < count; ++i) {
+        groups[find(i)].append(operands[i]);
+    }
+
+    // 分组合并成大致均匀的批次，每个批次一次扫描
+    const int threads = qMax(1, QThread::idealThreadCount());
+    const int batchSize = qMax(MIN_OPERANDS_PER_BATCH, count / (threads * 2));
+    QVector<QList<QPainterPath>> batches(1);
+    for (const QList<QPainterPath> &group : std::as_const(groups)) {
+        if (batches.last().size() >= batchSize) {
+            batches.append(QList<QPainterPath>());
+        }
+        batches.last().append(group);
+    }
+
+    QVector<QPainterPath> results(batches.size());
+    {
+        QThreadPool pool;
+        pool.setMaxThreadCount(threads);
+        for (int b = 0; b < batches.size(); ++b) {
+            pool.start([&results, &batches, b, op, tolerance]() {
+                results[b] = BooleanSweep(op, tolerance).run(batches[b]);
+            });
+        }
+        pool.waitForDone();
+    }
+
+    QPainterPath result;
+    result.setFillRule(Qt::OddEvenFill);
+    for (const QPainterPath &part : results) {
+        result.addPath(part);
+    }
+    return result;
+}
+
+QPainterPath PathBoolean::positiveFill(const QPainterPath &path, qreal tolerance)
+{
+    return BooleanSweep(PathEditor::Union, qMax(tolerance, 1e-4), true).run(QList<QPainterPath>() << path);
+}
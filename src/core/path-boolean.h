@@ -0,0 +1,30 @@
+#ifndef PATH_BOOLEAN_H
+#define PATH_BOOLEAN_H
+
+#include <QPainterPath>
+#include <QList>
+#include "../core/patheditor.h"
+
+/**
+ * 多路径布尔运算引擎
+ * 曲线展平后量化到整数坐标，用一次扫描线处理全部操作数；
+ * 输出时把仍落在同一条原始曲线上的连续边还原为三次贝塞尔曲线；
+ * 输出轮廓方向一致：外轮廓有向面积为正，洞为负
+ */
+class PathBoolean
+{
+public:
+    // Union：在任一操作数内；Intersection：在全部操作数内；
+    // Subtraction：第一个操作数减去其余所有；Xor：在奇数个操作数内
+    // 每个操作数按自身的填充规则判断内外，结果使用奇偶填充
+    // tolerance为曲线展平误差；parallel时把包围盒互不相交的分组放到多个线程（只对Union/Xor有效）
+    static QPainterPath combine(const QList<QPainterPath> &operands,
+                                PathEditor::BooleanOperation op,
+                                qreal tolerance = 0.1,
+                                bool parallel = false);
+
+    // 只保留环绕数为正的区域（按有向面积为正的方向计），用于清理偏移和描边轮廓的自相交
+    static QPainterPath positiveFill(const QPainterPath &path, qreal tolerance = 0.1);
+};
+
+#endif // PATH_BOOLEAN_H
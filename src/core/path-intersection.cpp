@@ -0,0 +1,595 @@
+#include <QSet>
+#include <QtMath>
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+#include <queue>
+#include <set>
+#include <vector>
+#include "../core/path-intersection.h"
+
+// 每个单调段展平的最大段数
+static const int MAX_FLATTEN_STEPS = 256;
+static const int MAX_NEWTON_ITERATIONS = 8;
+// 线段参数允许的越界量，端点处的交点不会因为舍入被漏掉
+static const qreal PARAMETER_EPSILON = 1e-9;
+// 扫描线上y之差在此以内视为经过同一点
+static const qreal COINCIDENT_EPSILON = 1e-9;
+
+namespace {
+
+// 路径中的一段：直线只用p[0]、p[1]
+struct Curve {
+    QPointF p[4];
+    bool line;
+};
+
+// 展平后的线段，a在左（x相同时a在上）
+struct Segment {
+    QPointF a;
+    QPointF b;
+    qreal ta;           // a、b在所属曲线上的参数
+    qreal tb;
+    qreal low;          // 所属单调段的参数范围，求精时不越出
+    qreal high;
+    qreal slope;
+    int curve;
+    int path;
+    int chain;          // 所属子路径
+    int index;          // 在子路径中的序号
+    bool vertical;
+};
+
+struct Chain {
+    int count;
+    bool closed;
+};
+
+// 同一x上先交换交点两侧的线段，再插入新线段、处理竖直线段，最后删除结束的线段
+enum EventKind {
+    CrossingEvent,
+    StartEvent,
+    VerticalEvent,
+    EndEvent
+};
+
+struct Event {
+    qreal x;
+    int kind;
+    int a;
+    int b;
+};
+
+struct LaterEvent {
+    bool operator()(const Event &a, const Event &b) const
+    {
+        return a.x > b.x || (a.x == b.x && a.kind > b.kind);
+    }
+};
+
+}
+
+static qreal cross(const QPointF &a, const QPointF &b)
+{
+    return a.x() * b.y() - a.y() * b.x();
+}
+
+static QPointF curvePoint(const Curve &c, qreal t)
+{
+    if (c.line) {
+        return c.p[0] + (c.p[1] - c.p[0]) * t;
+    }
+    const qreal u = 1.0 - t;
+    return c.p[0] * (u * u * u) + c.p[1] * (3 * u * u * t) + c.p[2] * (3 * u * t * t) + c.p[3] * (t * t * t);
+}
+
+static QPointF curveDerivative(const Curve &c, qreal t)
+{
+    if (c.line) {
+        return c.p[1] - c.p[0];
+    }
+    const qreal u = 1.0 - t;
+    return (c.p[1] - c.p[0]) * (3 * u * u) + (c.p[2] - c.p[1]) * (6 * u * t) + (c.p[3] - c.p[2]) * (3 * t * t);
+}
+
+// 导数分量a(1-t)² + 2b(1-t)t + ct²在(0,1)内的根
+static void appendDerivativeRoots(qreal a, qreal b, qreal c, QVector<qreal> &roots)
+{
+    const qreal qa = a - 2 * b + c;
+    const qreal qb = 2 * (b - a);
+    const qreal qc = a;
+    auto append = [&roots](qreal t) {
+        if (t > 1e-9 && t < 1.0 - 1e-9) {
+            roots.append(t);
+        }
+    };
+    if (qAbs(qa) < 1e-12) {
+        if (qAbs(qb) > 1e-12) {
+            append(-qc / qb);
+        }
+        return;
+    }
+    const qreal discriminant = qb * qb - 4 * qa * qc;
+    if (discriminant < 0) {
+        return;
+    }
+    const qreal root = qSqrt(discriminant);
+    append((-qb + root) / (2 * qa));
+    append((-qb - root) / (2 * qa));
+}
+
+class IntersectionSweep
+{
+public:
+    IntersectionSweep(qreal tolerance, bool selfIntersections)
+        : m_tolerance(tolerance), m_selfIntersections(selfIntersections), m_sweepX(0.0), m_status(StatusOrder{this})
+    {
+    }
+
+    void addPath(const QPainterPath &path, int index);
+    QVector<PathIntersection::Hit> run();
+
+private:
+    // 扫描线状态的排序：树中存放槽位，按槽位上的线段在当前扫描x处的y比较；也可以直接与y值比较
+    struct StatusOrder {
+        typedef void is_transparent;
+        const IntersectionSweep *sweep;
+
+        bool operator()(int slot, int other) const
+        {
+            return sweep->before(sweep->m_occupant[slot], sweep->m_occupant[other], sweep->m_sweepX);
+        }
+        bool operator()(int slot, qreal y) const { return sweep->yAt(sweep->m_occupant[slot], sweep->m_sweepX) < y; }
+        bool operator()(qreal y, int slot) const { return y < sweep->yAt(sweep->m_occupant[slot], sweep->m_sweepX); }
+    };
+    typedef std::multiset<int, StatusOrder> Status;
+
+    void addCurve(const Curve &curve, int path, int chain, int &index);
+    void addSegment(const QPointF &a, const QPointF &b, qreal ta, qreal tb, qreal low, qreal high,
+                    int curve, int path, int chain, int &index);
+    void finishChain(int chain, int count, const QPointF &start, const QPointF &end);
+
+    qreal yAt(int s, qreal x) const;
+    bool before(int s, int other, qreal x) const;
+    bool sharesVertex(int s1, int s2) const;
+    bool test(int s1, int s2, QPointF *point);
+    void check(int lower, int upper);
+    void checkCoincident(Status::iterator node, qreal x);
+    void report(int s1, int s2, const QPointF &point, qreal t1, qreal t2);
+    QPointF refine(int s1, int s2, qreal t1, qreal t2, const QPointF &estimate) const;
+
+    void processStart(int s);
+    void processVertical(int s);
+    void processEnd(int s);
+    void processCrossing(int lower, int upper);
+
+    qreal m_tolerance;
+    bool m_selfIntersections;
+    qreal m_sweepX;
+
+    QVector<Curve> m_curves;
+    QVector<Segment> m_segments;
+    QVector<Chain> m_chains;
+
+    // 扫描线状态：按当前x处的y排序的平衡树，插入、删除和查找相邻线段都不随活动线段数增长。
+    // 交点处交换相邻的两条线段时只交换两个槽位的占用者，树的结构不变；
+    // 每条线段在树中的节点记在m_node中，不在树中时为end()
+    Status m_status;
+    QVector<int> m_occupant;
+    std::vector<Status::iterator> m_node;
+    std::priority_queue<Event, std::vector<Event>, LaterEvent> m_crossings;
+    QSet<quint64> m_tested;
+    QVector<PathIntersection::Hit> m_hits;
+};
+
+void IntersectionSweep::addPath(const QPainterPath &path, int index)
+{
+    int chain = -1;
+    int count = 0;
+    QPointF start;
+    QPointF current;
+    for (int i = 0; i < path.elementCount(); ++i) {
+        const QPainterPath::Element &element = path.elementAt(i);
+        const QPointF point(element.x, element.y);
+        if (element.type == QPainterPath::MoveToElement || chain < 0) {
+            if (chain >= 0) {
+                finishChain(chain, count, start, current);
+            }
+            chain = m_chains.size();
+            m_chains.append({0, false});
+            count = 0;
+            start = current = point;
+            if (element.type == QPainterPath::MoveToElement) {
+                continue;
+            }
+        }
+        if (element.type == QPainterPath::LineToElement) {
+            addCurve({{current, point, QPointF(), QPointF()}, true}, index, chain, count);
+            current = point;
+        } else if (element.type == QPainterPath::CurveToElement && i + 2 < path.elementCount()) {
+            const QPointF c2(path.elementAt(i + 1).x, path.elementAt(i + 1).y);
+            const QPointF end(path.elementAt(i + 2).x, path.elementAt(i + 2).y);
+            addCurve({{current, point, c2, end}, false}, index, chain, count);
+            current = end;
+            i += 2;
+        }
+    }
+    if (chain >= 0) {
+        finishChain(chain, count, start, current);
+    }
+}
+
+void IntersectionSweep::finishChain(int chain, int count, const QPointF &start, const QPointF &end)
+{
+    m_chains[chain].count = count;
+    m_chains[chain].closed = count > 2 && start == end;
+}
+
+void IntersectionSweep::addCurve(const Curve &curve, int path, int chain, int &index)
+{
+    const int curveIndex = m_curves.size();
+    m_curves.append(curve);
+    if (curve.line) {
+        addSegment(curve.p[0], curve.p[1], 0.0, 1.0, 0.0, 1.0, curveIndex, path, chain, index);
+        return;
+    }
+
+    // 在x、y的极值处拆成单调段，单调段上的弦与曲线只在端点相交
+    QVector<qreal> splits;
+    const QPointF d0 = curve.p[1] - curve.p[0];
+    const QPointF d1 = curve.p[2] - curve.p[1];
+    const QPointF d2 = curve.p[3] - curve.p[2];
+    appendDerivativeRoots(d0.x(), d1.x(), d2.x(), splits);
+    appendDerivativeRoots(d0.y(), d1.y(), d2.y(), splits);
+    splits.append(0.0);
+    splits.append(1.0);
+    std::sort(splits.begin(), splits.end());
+
+    // 展平段数按二阶差分估计，与整条曲线的弦高误差对应
+    const QPointF dd1 = curve.p[0] - 2 * curve.p[1] + curve.p[2];
+    const QPointF dd2 = curve.p[1] - 2 * curve.p[2] + curve.p[3];
+    const qreal dd = qMax(qSqrt(QPointF::dotProduct(dd1, dd1)), qSqrt(QPointF::dotProduct(dd2, dd2)));
+    const qreal totalSteps = qSqrt(0.75 * dd / m_tolerance);
+
+    for (int k = 0; k + 1 < splits.size(); ++k) {
+        const qreal low = splits[k];
+        const qreal high = splits[k + 1];
+        if (high - low <= 1e-12) {
+            continue;
+        }
+        const int steps = qBound(1, qCeil(totalSteps * (high - low)), MAX_FLATTEN_STEPS);
+        QPointF previous = curvePoint(curve, low);
+        qreal previousT = low;
+        for (int step = 1; step <= steps; ++step) {
+            const qreal t = step == steps ? high : low + (high - low) * step / steps;
+            const QPointF point = curvePoint(curve, t);
+            addSegment(previous, point, previousT, t, low, high, curveIndex, path, chain, index);
+            previous = point;
+            previousT = t;
+        }
+    }
+}
+
+void IntersectionSweep::addSegment(const QPointF &a, const QPointF &b, qreal ta, qreal tb, qreal low, qreal high,
+                                   int curve, int path, int chain, int &index)
+{
+    if (a == b) {
+        return;
+    }
+    Segment segment;
+    const bool forward = a.x() < b.x() || (a.x() == b.x() && a.y() < b.y());
+    segment.a = forward ? a : b;
+    segment.b = forward ? b : a;
+    segment.ta = forward ? ta : tb;
+    segment.tb = forward ? tb : ta;
+    segment.low = low;
+    segment.high = high;
+    segment.vertical = segment.a.x() == segment.b.x();
+    segment.slope = segment.vertical ? 0.0 : (segment.b.y() - segment.a.y()) / (segment.b.x() - segment.a.x());
+    segment.curve = curve;
+    segment.path = path;
+    segment.chain = chain;
+    segment.index = index++;
+    m_segments.append(segment);
+}
+
+qreal IntersectionSweep::yAt(int s, qreal x) const
+{
+    const Segment &segment = m_segments[s];
+    if (x <= segment.a.x()) {
+        return segment.a.y();
+    }
+    if (x >= segment.b.x()) {
+        return segment.b.y();
+    }
+    return segment.a.y() + (x - segment.a.x()) * segment.slope;
+}
+
+// 在x处s排在other之前：y较小，y相同时x右侧y较小（斜率较小）
+bool IntersectionSweep::before(int s, int other, qreal x) const
+{
+    const qreal y = yAt(s, x);
+    const qreal otherY = yAt(other, x);
+    if (y != otherY) {
+        return y < otherY;
+    }
+    return m_segments[s].slope < m_segments[other].slope;
+}
+
+// 同一子路径中首尾相接的两段只在公共顶点处接触
+bool IntersectionSweep::sharesVertex(int s1, int s2) const
+{
+    const Segment &a = m_segments[s1];
+    const Segment &b = m_segments[s2];
+    if (a.chain != b.chain) {
+        return false;
+    }
+    const int difference = qAbs(a.index - b.index);
+    return difference == 1 || (m_chains[a.chain].closed && difference == m_chains[a.chain].count - 1);
+}
+
+bool IntersectionSweep::test(int s1, int s2, QPointF *point)
+{
+    if (sharesVertex(s1, s2)) {
+        return false;
+    }
+    const Segment &a = m_segments[s1];
+    const Segment &b = m_segments[s2];
+    const QPointF r = a.b - a.a;
+    const QPointF q = b.b - b.a;
+    const qreal denominator = cross(r, q);
+    // 平行或共线的线段不计交点
+    if (qAbs(denominator) <= 1e-12 * qSqrt(QPointF::dotProduct(r, r) * QPointF::dotProduct(q, q))) {
+        return false;
+    }
+    const QPointF offset = b.a - a.a;
+    const qreal t = cross(offset, q) / denominator;
+    const qreal u = cross(offset, r) / denominator;
+    if (t < -PARAMETER_EPSILON || t > 1.0 + PARAMETER_EPSILON || u < -PARAMETER_EPSILON || u > 1.0 + PARAMETER_EPSILON) {
+        return false;
+    }
+    *point = a.a + r * qBound(0.0, t, 1.0);
+
+    // 每对线段只报告一次：相邻关系会反复出现
+    const quint64 key = (quint64(quint32(qMin(s1, s2))) << 32) | quint32(qMax(s1, s2));
+    if (!m_tested.contains(key)) {
+        m_tested.insert(key);
+        report(s1, s2, *point, qBound(0.0, t, 1.0), qBound(0.0, u, 1.0));
+    }
+    return true;
+}
+
+// lower在状态中紧挨在upper之前；交点之后两者的顺序由斜率决定，需要时安排在交点处交换
+void IntersectionSweep::check(int lower, int upper)
+{
+    QPointF point;
+    if (!test(lower, upper, &point)) {
+        return;
+    }
+    const Segment &a = m_segments[lower];
+    const Segment &b = m_segments[upper];
+    if (a.slope > b.slope && point.x() < qMin(a.b.x(), b.b.x())) {
+        m_crossings.push({qMax(point.x(), m_sweepX), CrossingEvent, lower, upper});
+    }
+}
+
+// 多条线段经过同一端点时，端点所在的线段不一定与之相邻，逐个测试y相同的线段
+void IntersectionSweep::checkCoincident(Status::iterator node, qreal x)
+{
+    const int s = m_occupant[*node];
+    const qreal y = yAt(s, x);
+    const qreal epsilon = COINCIDENT_EPSILON * (1.0 + qAbs(y));
+    QPointF point;
+    // 紧挨着的线段已经由check测试过，从隔一个的位置开始
+    Status::reverse_iterator below(node);
+    if (below != m_status.rend()) {
+        for (++below; below != m_status.rend() && qAbs(yAt(m_occupant[*below], x) - y) <= epsilon; ++below) {
+            test(m_occupant[*below], s, &point);
+        }
+    }
+    Status::iterator above = std::next(node);
+    if (above != m_status.end()) {
+        for (++above; above != m_status.end() && qAbs(yAt(m_occupant[*above], x) - y) <= epsilon; ++above) {
+            test(s, m_occupant[*above], &point);
+        }
+    }
+}
+
+void IntersectionSweep::report(int s1, int s2, const QPointF &point, qreal t1, qreal t2)
+{
+    const Segment &a = m_segments[s1];
+    const Segment &b = m_segments[s2];
+    if (a.path == b.path && !m_selfIntersections) {
+        return;
+    }
+    const QPointF refined = refine(s1, s2, a.ta + (a.tb - a.ta) * t1, b.ta + (b.tb - b.ta) * t2, point);
+    m_hits.append({refined, qMin(a.path, b.path), qMax(a.path, b.path)});
+}
+
+// 两条原始曲线上的牛顿迭代：求C1(t) = C2(s)，参数不越出各自的单调段
+QPointF IntersectionSweep::refine(int s1, int s2, qreal t1, qreal t2, const QPointF &estimate) const
+{
+    const Segment &a = m_segments[s1];
+    const Segment &b = m_segments[s2];
+    const Curve &c1 = m_curves[a.curve];
+    const Curve &c2 = m_curves[b.curve];
+    if (c1.line && c2.line) {
+        return estimate;
+    }
+
+    const QPointF initial = curvePoint(c1, t1) - curvePoint(c2, t2);
+    qreal error = QPointF::dotProduct(initial, initial);
+    for (int i = 0; i < MAX_NEWTON_ITERATIONS && error > 1e-20; ++i) {
+        const QPointF f = curvePoint(c1, t1) - curvePoint(c2, t2);
+        const QPointF d1 = curveDerivative(c1, t1);
+        const QPointF d2 = -curveDerivative(c2, t2);
+        const qreal determinant = cross(d1, d2);
+        if (qAbs(determinant) < 1e-12) {
+            break;
+        }
+        t1 = qBound(a.low, t1 + cross(-f, d2) / determinant, a.high);
+        t2 = qBound(b.low, t2 + cross(d1, -f) / determinant, b.high);
+        const QPointF next = curvePoint(c1, t1) - curvePoint(c2, t2);
+        error = QPointF::dotProduct(next, next);
+    }
+
+    // 不收敛时保留线段交点（误差不超过展平容差）
+    const QPointF refined = (curvePoint(c1, t1) + curvePoint(c2, t2)) / 2.0;
+    const QPointF moved = refined - estimate;
+    if (error > QPointF::dotProduct(initial, initial) || QPointF::dotProduct(moved, moved) > 4 * m_tolerance * m_tolerance) {
+        return estimate;
+    }
+    return refined;
+}
+
+void IntersectionSweep::processStart(int s)
+{
+    // 交换只发生在树中的线段之间，未开始的线段仍占用与自己编号相同的槽位；
+    // 树按m_sweepX比较，开始事件的x就是线段左端点
+    const Status::iterator node = m_status.insert(s);
+    m_node[s] = node;
+    if (node != m_status.begin()) {
+        check(m_occupant[*std::prev(node)], s);
+    }
+    const Status::iterator after = std::next(node);
+    if (after != m_status.end()) {
+        check(s, m_occupant[*after]);
+    }
+    checkCoincident(node, m_segments[s].a.x());
+}
+
+// 竖直线段不进入状态，直接与当前x处y落在其范围内的线段求交
+void IntersectionSweep::processVertical(int s)
+{
+    const Segment &segment = m_segments[s];
+    const qreal x = segment.a.x();
+    const qreal top = segment.a.y() - m_tolerance;
+    const qreal bottom = segment.b.y() + m_tolerance;
+    QPointF point;
+    for (Status::iterator it = m_status.lower_bound(top); it != m_status.end() && yAt(m_occupant[*it], x) <= bottom; ++it) {
+        test(s, m_occupant[*it], &point);
+    }
+}
+
+void IntersectionSweep::processEnd(int s)
+{
+    const Status::iterator node = m_node[s];
+    if (node == m_status.end()) {
+        return;
+    }
+    checkCoincident(node, m_segments[s].b.x());
+    const Status::iterator after = m_status.erase(node);
+    m_node[s] = m_status.end();
+    if (after != m_status.begin() && after != m_status.end()) {
+        check(m_occupant[*std::prev(after)], m_occupant[*after]);
+    }
+}
+
+void IntersectionSweep::processCrossing(int lower, int upper)
+{
+    // 安排之后顺序可能已经变化，只处理仍然相邻且仍需交换的一对
+    const Status::iterator lowerNode = m_node[lower];
+    const Status::iterator upperNode = m_node[upper];
+    if (lowerNode == m_status.end() || upperNode == m_status.end() || std::next(lowerNode) != upperNode
+        || m_segments[lower].slope <= m_segments[upper].slope) {
+        return;
+    }
+    m_occupant[*lowerNode] = upper;
+    m_occupant[*upperNode] = lower;
+    m_node[upper] = lowerNode;
+    m_node[lower] = upperNode;
+    if (lowerNode != m_status.begin()) {
+        check(m_occupant[*std::prev(lowerNode)], upper);
+    }
+    const Status::iterator after = std::next(upperNode);
+    if (after != m_status.end()) {
+        check(lower, m_occupant[*after]);
+    }
+}
+
+QVector<PathIntersection::Hit> IntersectionSweep::run()
+{
+    QVector<Event> events;
+    events.reserve(m_segments.size() * 2);
+    for (int s = 0; s < m_segments.size(); ++s) {
+        const Segment &segment = m_segments[s];
+        if (segment.vertical) {
+            events.append({segment.a.x(), VerticalEvent, s, -1});
+        } else {
+            events.append({segment.a.x(), StartEvent, s, -1});
+            events.append({segment.b.x(), EndEvent, s, -1});
+        }
+    }
+    std::sort(events.begin(), events.end(), [](const Event &a, const Event &b) {
+        return a.x < b.x || (a.x == b.x && a.kind < b.kind);
+    });
+
+    // 每条线段开始时占用与自己编号相同的槽位
+    m_occupant.resize(m_segments.size());
+    std::iota(m_occupant.begin(), m_occupant.end(), 0);
+    m_node.assign(m_segments.size(), m_status.end());
+    int next = 0;
+    while (next < events.size() || !m_crossings.empty()) {
+        // 交换事件在同一x上排在最前
+        if (!m_crossings.empty() && (next == events.size() || m_crossings.top().x <= events[next].x)) {
+            const Event event = m_crossings.top();
+            m_crossings.pop();
+            m_sweepX = event.x;
+            processCrossing(event.a, event.b);
+            continue;
+        }
+        const Event &event = events[next++];
+        m_sweepX = event.x;
+        switch (event.kind) {
+        case StartEvent: processStart(event.a); break;
+        case VerticalEvent: processVertical(event.a); break;
+        case EndEvent: processEnd(event.a); break;
+        }
+    }
+
+    // 交点落在展平顶点上时会被相邻的两段各报告一次，按路径对和距离合并
+    std::sort(m_hits.begin(), m_hits.end(), [](const PathIntersection::Hit &a, const PathIntersection::Hit &b) {
+        if (a.first != b.first) return a.first < b.first;
+        if (a.second != b.second) return a.second < b.second;
+        return a.point.x() < b.point.x();
+    });
+    QVector<PathIntersection::Hit> result;
+    result.reserve(m_hits.size());
+    int groupStart = 0;
+    for (const PathIntersection::Hit &hit : m_hits) {
+        if (!result.isEmpty() && (result.last().first != hit.first || result.last().second != hit.second)) {
+            groupStart = result.size();
+        }
+        bool duplicate = false;
+        for (int k = result.size() - 1; k >= groupStart && hit.point.x() - result[k].point.x() <= m_tolerance; --k) {
+            const QPointF d = hit.point - result[k].point;
+            if (QPointF::dotProduct(d, d) <= m_tolerance * m_tolerance) {
+                duplicate = true;
+                break;
+            }
+        }
+        if (!duplicate) {
+            result.append(hit);
+        }
+    }
+    return result;
+}
+
+QVector<PathIntersection::Hit> PathIntersection::findAll(const QList<QPainterPath> &paths, qreal tolerance,
+                                                         bool selfIntersections)
+{
+    IntersectionSweep sweep(qMax(tolerance, 1e-4), selfIntersections);
+    for (int i = 0; i < paths.size(); ++i) {
+        sweep.addPath(paths[i], i);
+    }
+    return sweep.run();
+}
+
+QList<QPointF> PathIntersection::intersections(const QPainterPath &path1, const QPainterPath &path2, qreal tolerance)
+{
+    QList<QPointF> points;
+    for (const Hit &hit : findAll(QList<QPainterPath>() << path1 << path2, tolerance)) {
+        points.append(hit.point);
+    }
+    return points;
+}
@@ -0,0 +1,32 @@
+#ifndef PATH_INTERSECTION_H
+#define PATH_INTERSECTION_H
+
+#include <QPainterPath>
+#include <QPointF>
+#include <QVector>
+#include <QList>
+
+/**
+ * 路径求交引擎
+ * 曲线在x、y极值处拆成单调段后展平，用Bentley-Ottmann扫描线一次求出所有线段交点；
+ * 交点来自曲线时在原曲线上用牛顿迭代求精
+ */
+class PathIntersection
+{
+public:
+    struct Hit {
+        QPointF point;
+        int first;      // 输入路径的下标，first <= second，相等表示自相交
+        int second;
+    };
+
+    // 一次扫描求出所有路径两两之间的交点；tolerance为曲线展平误差，也用于合并重复的交点
+    static QVector<Hit> findAll(const QList<QPainterPath> &paths, qreal tolerance = 0.1,
+                                bool selfIntersections = false);
+
+    // 两条路径之间的交点
+    static QList<QPointF> intersections(const QPainterPath &path1, const QPainterPath &path2,
+                                        qreal tolerance = 0.1);
+};
+
+#endif // PATH_INTERSECTION_H
@@ -0,0 +1,435 @@
+#include <QVector>
+#include <QList>
+#include <QtMath>
+#include "../core/path-offset.h"
+#include "../core/path-boolean.h"
+#include "../core/patheditor.h"
+
+// 曲线偏移按误差二分的最大深度
+static const int MAX_SUBDIVISION_DEPTH = 8;
+// 检查曲线偏移后是否反向的采样数
+static const int INVERSION_SAMPLES = 16;
+// 偏移后反向的曲线展平的最大段数
+static const int MAX_CHORDS = 64;
+
+namespace {
+
+// 直线用p[0]、p[1]，三次曲线用p[0..3]
+struct Segment {
+    QPointF p[4];
+    bool curve;
+};
+
+struct Subpath {
+    QPointF start;
+    QVector<Segment> segments;
+    bool closed;
+};
+
+}
+
+static qreal length(const QPointF &v)
+{
+    return qSqrt(QPointF::dotProduct(v, v));
+}
+
+static qreal cross(const QPointF &a, const QPointF &b)
+{
+    return a.x() * b.y() - a.y() * b.x();
+}
+
+static QPointF unit(const QPointF &v)
+{
+    const qreal l = length(v);
+    return l > 0 ? v / l : QPointF();
+}
+
+// 区域在行进方向左侧（有向面积为正）时指向区域外的单位法向
+static QPointF normalOf(const QPointF &tangent)
+{
+    const QPointF t = unit(tangent);
+    return QPointF(t.y(), -t.x());
+}
+
+static QPointF rotate(const QPointF &v, qreal angle)
+{
+    const qreal c = qCos(angle);
+    const qreal s = qSin(angle);
+    return QPointF(v.x() * c - v.y() * s, v.x() * s + v.y() * c);
+}
+
+static QPointF cubicPoint(const QPointF p[4], qreal t)
+{
+    const qreal u = 1.0 - t;
+    return p[0] * (u * u * u) + p[1] * (3 * u * u * t) + p[2] * (3 * u * t * t) + p[3] * (t * t * t);
+}
+
+static QPointF cubicDerivative(const QPointF p[4], qreal t)
+{
+    const qreal u = 1.0 - t;
+    return (p[1] - p[0]) * (3 * u * u) + (p[2] - p[1]) * (6 * u * t) + (p[3] - p[2]) * (3 * t * t);
+}
+
+static QPointF cubicSecondDerivative(const QPointF p[4], qreal t)
+{
+    return (p[2] - 2 * p[1] + p[0]) * (6 * (1.0 - t)) + (p[3] - 2 * p[2] + p[1]) * (6 * t);
+}
+
+static void splitCubic(const QPointF p[4], QPointF left[4], QPointF right[4])
+{
+    const QPointF p01 = (p[0] + p[1]) / 2, p12 = (p[1] + p[2]) / 2, p23 = (p[2] + p[3]) / 2;
+    const QPointF p012 = (p01 + p12) / 2, p123 = (p12 + p23) / 2;
+    const QPointF middle = (p012 + p123) / 2;
+    left[0] = p[0]; left[1] = p01; left[2] = p012; left[3] = middle;
+    right[0] = middle; right[1] = p123; right[2] = p23; right[3] = p[3];
+}
+
+static QPointF startPoint(const Segment &s)
+{
+    return s.p[0];
+}
+
+static QPointF endPoint(const Segment &s)
+{
+    return s.curve ? s.p[3] : s.p[1];
+}
+
+// 曲线端点处控制点重合时，切线取下一个不重合的控制点
+static QPointF startTangent(const Segment &s)
+{
+    if (!s.curve) {
+        return s.p[1] - s.p[0];
+    }
+    for (int i = 1; i < 4; ++i) {
+        if (s.p[i] != s.p[0]) {
+            return s.p[i] - s.p[0];
+        }
+    }
+    return QPointF();
+}
+
+static QPointF endTangent(const Segment &s)
+{
+    if (!s.curve) {
+        return s.p[1] - s.p[0];
+    }
+    for (int i = 2; i >= 0; --i) {
+        if (s.p[i] != s.p[3]) {
+            return s.p[3] - s.p[i];
+        }
+    }
+    return QPointF();
+}
+
+static Segment reversedSegment(const Segment &s)
+{
+    if (!s.curve) {
+        return {{s.p[1], s.p[0], QPointF(), QPointF()}, false};
+    }
+    return {{s.p[3], s.p[2], s.p[1], s.p[0]}, true};
+}
+
+static bool lineIntersection(const QPointF &a, const QPointF &da, const QPointF &b, const QPointF &db, QPointF *result)
+{
+    const qreal denominator = cross(da, db);
+    if (qAbs(denominator) <= 1e-9 * length(da) * length(db)) {
+        return false;
+    }
+    *result = a + da * (cross(b - a, db) / denominator);
+    return true;
+}
+
+static QVector<Subpath> subpathsOf(const QPainterPath &path)
+{
+    QVector<Subpath> subpaths;
+    QPointF current;
+    for (int i = 0; i < path.elementCount(); ++i) {
+        const QPainterPath::Element &element = path.elementAt(i);
+        const QPointF point(element.x, element.y);
+        if (element.type == QPainterPath::MoveToElement || subpaths.isEmpty()) {
+            subpaths.append({point, QVector<Segment>(), false});
+            current = point;
+            if (element.type == QPainterPath::MoveToElement) {
+                continue;
+            }
+        }
+        if (element.type == QPainterPath::LineToElement) {
+            if (point != current) {
+                subpaths.last().segments.append({{current, point, QPointF(), QPointF()}, false});
+            }
+            current = point;
+        } else if (element.type == QPainterPath::CurveToElement && i + 2 < path.elementCount()) {
+            const QPointF c2(path.elementAt(i + 1).x, path.elementAt(i + 1).y);
+            const QPointF end(path.elementAt(i + 2).x, path.elementAt(i + 2).y);
+            if (current != point || current != c2 || current != end) {
+                subpaths.last().segments.append({{current, point, c2, end}, true});
+            }
+            current = end;
+            i += 2;
+        }
+    }
+    for (Subpath &subpath : subpaths) {
+        subpath.closed = !subpath.segments.isEmpty() && endPoint(subpath.segments.last()) == subpath.start;
+    }
+    return subpaths;
+}
+
+// 曲率半径小于偏移距离（或有尖点）时偏移曲线会反向
+static bool invertsWhenOffset(const QPointF p[4], qreal distance)
+{
+    for (int i = 0; i <= INVERSION_SAMPLES; ++i) {
+        const qreal t = qreal(i) / INVERSION_SAMPLES;
+        const QPointF first = cubicDerivative(p, t);
+        const qreal speed = length(first);
+        if (speed <= 1e-12) {
+            return true;
+        }
+        const qreal curvature = cross(first, cubicSecondDerivative(p, t)) / (speed * speed * speed);
+        if (1.0 + distance * curvature <= 0.0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 偏移后会反向的曲线改为折线，折线顶点处走内侧连接（经过原顶点），结果由正环绕数清理
+static QVector<Segment> prepareSide(const QVector<Segment> &segments, qreal distance, qreal tolerance)
+{
+    QVector<Segment> result;
+    result.reserve(segments.size());
+    for (const Segment &s : segments) {
+        if (!s.curve || !invertsWhenOffset(s.p, distance)) {
+            result.append(s);
+            continue;
+        }
+        const QPointF d1 = s.p[0] - 2 * s.p[1] + s.p[2];
+        const QPointF d2 = s.p[1] - 2 * s.p[2] + s.p[3];
+        const qreal m = qMax(length(d1), length(d2));
+        const int steps = qBound(1, qCeil(qSqrt(0.75 * m / tolerance)), MAX_CHORDS);
+        QPointF previous = s.p[0];
+        for (int k = 1; k <= steps; ++k) {
+            const QPointF point = k == steps ? s.p[3] : cubicPoint(s.p, qreal(k) / steps);
+            if (point != previous) {
+                result.append({{previous, point, QPointF(), QPointF()}, false});
+            }
+            previous = point;
+        }
+    }
+    return result;
+}
+
+// 圆弧：以center为圆心，从center + from开始转过sweep弧度，每段不超过90度
+static void appendArc(QPainterPath &path, const QPointF &center, const QPointF &from, qreal sweep)
+{
+    const int pieces = qMax(1, qCeil(qAbs(sweep) / (M_PI / 2) - 1e-9));
+    const qreal step = sweep / pieces;
+    const qreal k = 4.0 / 3.0 * qTan(step / 4.0);
+    QPointF r0 = from;
+    for (int i = 0; i < pieces; ++i) {
+        const QPointF r1 = rotate(r0, step);
+        path.cubicTo(center + r0 + rotate(r0, M_PI / 2) * k,
+                     center + r1 - rotate(r1, M_PI / 2) * k,
+                     center + r1);
+        r0 = r1;
+    }
+}
+
+// Tiller-Hanson：控制多边形各边平移后求交得到偏移曲线，误差超出容差时二分
+static void appendOffsetCubic(QPainterPath &path, const QPointF p[4], qreal distance, qreal tolerance, int depth)
+{
+    const Segment segment{{p[0], p[1], p[2], p[3]}, true};
+    const QPointF n0 = normalOf(startTangent(segment));
+    const QPointF n3 = normalOf(endTangent(segment));
+    QPointF q[4];
+    q[0] = p[0] + n0 * distance;
+    q[1] = p[1] + n0 * distance;
+    q[2] = p[2] + n3 * distance;
+    q[3] = p[3] + n3 * distance;
+
+    const QPointF leg0 = p[1] - p[0];
+    const QPointF leg1 = p[2] - p[1];
+    const QPointF leg2 = p[3] - p[2];
+    if (length(leg1) > 0) {
+        const QPointF middle = p[1] + normalOf(leg1) * distance;
+        if (length(leg0) > 0) {
+            lineIntersection(q[0], leg0, middle, leg1, &q[1]);
+        }
+        if (length(leg2) > 0) {
+            lineIntersection(q[3], leg2, middle, leg1, &q[2]);
+        }
+    }
+
+    qreal error = 0.0;
+    for (int i = 1; i < 4; ++i) {
+        const qreal t = i / 4.0;
+        const QPointF derivative = cubicDerivative(p, t);
+        if (length(derivative) <= 0) {
+            continue;
+        }
+        const QPointF exact = cubicPoint(p, t) + normalOf(derivative) * distance;
+        error = qMax(error, length(cubicPoint(q, t) - exact));
+    }
+    if (error > tolerance && depth < MAX_SUBDIVISION_DEPTH) {
+        QPointF left[4];
+        QPointF right[4];
+        splitCubic(p, left, right);
+        appendOffsetCubic(path, left, distance, tolerance, depth + 1);
+        appendOffsetCubic(path, right, distance, tolerance, depth + 1);
+        return;
+    }
+    path.cubicTo(q[1], q[2], q[3]);
+}
+
+// 拐角：外侧按连接方式补齐，内侧经过原顶点连接
+static void appendJoin(QPainterPath &path, const QPointF &vertex, const QPointF &incoming, const QPointF &outgoing,
+                       qreal distance, Qt::PenJoinStyle join, qreal miterLimit)
+{
+    const QPointF na = normalOf(incoming);
+    const QPointF nb = normalOf(outgoing);
+    const qreal turn = cross(unit(incoming), unit(outgoing));
+    const qreal along = QPointF::dotProduct(unit(incoming), unit(outgoing));
+    const QPointF end = vertex + nb * distance;
+
+    if (qAbs(turn) < 1e-9 && along > 0) {
+        path.lineTo(end);
+        return;
+    }
+    // 内侧拐角；折返（转角180度）按外侧处理
+    if (turn * distance < 0 && qAbs(turn) >= 1e-9) {
+        path.lineTo(vertex);
+        path.lineTo(end);
+        return;
+    }
+
+    switch (join) {
+    case Qt::RoundJoin: {
+        const qreal sweep = qAbs(turn) < 1e-9 ? (distance > 0 ? M_PI : -M_PI) : qAtan2(turn, along);
+        appendArc(path, vertex, na * distance, sweep);
+        break;
+    }
+    case Qt::MiterJoin:
+    case Qt::SvgMiterJoin: {
+        const qreal cosine = QPointF::dotProduct(na, nb);
+        if (cosine > -1.0 + 1e-9 && qSqrt(2.0 / (1.0 + cosine)) <= miterLimit) {
+            path.lineTo(vertex + (na + nb) * (distance / (1.0 + cosine)));
+        }
+        path.lineTo(end);
+        break;
+    }
+    default:
+        path.lineTo(end);
+        break;
+    }
+}
+
+// 沿一串线段的一侧偏移，调用前当前点应在第一段偏移后的起点
+static void appendSide(QPainterPath &path, const QVector<Segment> &segments, qreal distance, bool closed,
+                       Qt::PenJoinStyle join, qreal miterLimit, qreal tolerance)
+{
+    for (int i = 0; i < segments.size(); ++i) {
+        const Segment &s = segments[i];
+        if (s.curve) {
+            appendOffsetCubic(path, s.p, distance, tolerance, 0);
+        } else {
+            path.lineTo(s.p[1] + normalOf(s.p[1] - s.p[0]) * distance);
+        }
+        if (i + 1 < segments.size()) {
+            appendJoin(path, endPoint(s), endTangent(s), startTangent(segments[i + 1]), distance, join, miterLimit);
+        } else if (closed) {
+            appendJoin(path, endPoint(s), endTangent(s), startTangent(segments.first()), distance, join, miterLimit);
+        }
+    }
+}
+
+// 线端：当前点在end + n*halfWidth，结束于end - n*halfWidth
+static void appendCap(QPainterPath &path, const QPointF &end, const QPointF &tangent, qreal halfWidth, Qt::PenCapStyle cap)
+{
+    const QPointF n = normalOf(tangent);
+    const QPointF t = unit(tangent);
+    switch (cap) {
+    case Qt::RoundCap:
+        appendArc(path, end, n * halfWidth, M_PI);
+        break;
+    case Qt::SquareCap:
+        path.lineTo(end + (n + t) * halfWidth);
+        path.lineTo(end + (t - n) * halfWidth);
+        path.lineTo(end - n * halfWidth);
+        break;
+    default:
+        path.lineTo(end - n * halfWidth);
+        break;
+    }
+}
+
+static QPointF sideStart(const QVector<Segment> &segments, qreal distance)
+{
+    return startPoint(segments.first()) + normalOf(startTangent(segments.first())) * distance;
+}
+
+QPainterPath PathOffset::offset(const QPainterPath &path, qreal distance,
+                                Qt::PenJoinStyle join, qreal miterLimit, qreal tolerance)
+{
+    tolerance = qMax(tolerance, 1e-4);
+
+    // 先规范化区域：去掉自交，外轮廓与洞的方向一致，法向统一指向区域外
+    const QPainterPath region = PathBoolean::combine(QList<QPainterPath>() << path, PathEditor::Union, tolerance);
+    if (qFuzzyIsNull(distance) || region.isEmpty()) {
+        return region;
+    }
+
+    QPainterPath raw;
+    raw.setFillRule(Qt::WindingFill);
+    for (const Subpath &subpath : subpathsOf(region)) {
+        if (subpath.segments.isEmpty()) {
+            continue;
+        }
+        const QVector<Segment> segments = prepareSide(subpath.segments, distance, tolerance);
+        raw.moveTo(sideStart(segments, distance));
+        appendSide(raw, segments, distance, true, join, miterLimit, tolerance);
+        raw.closeSubpath();
+    }
+    return PathBoolean::positiveFill(raw, tolerance);
+}
+
+QPainterPath PathOffset::outline(const QPainterPath &path, qreal width,
+                                 Qt::PenJoinStyle join, Qt::PenCapStyle cap, qreal miterLimit, qreal tolerance)
+{
+    const qreal halfWidth = width / 2.0;
+    if (halfWidth <= 0) {
+        return QPainterPath();
+    }
+    tolerance = qMax(tolerance, 1e-4);
+
+    // 每条子路径两侧各偏移半个线宽：闭合的得到内外两圈，开放的用线端连成一圈
+    QPainterPath raw;
+    raw.setFillRule(Qt::WindingFill);
+    for (const Subpath &subpath : subpathsOf(path)) {
+        if (subpath.segments.isEmpty()) {
+            continue;
+        }
+        QVector<Segment> reversed;
+        reversed.reserve(subpath.segments.size());
+        for (int i = subpath.segments.size() - 1; i >= 0; --i) {
+            reversed.append(reversedSegment(subpath.segments[i]));
+        }
+        const QVector<Segment> forward = prepareSide(subpath.segments, halfWidth, tolerance);
+        const QVector<Segment> backward = prepareSide(reversed, halfWidth, tolerance);
+
+        if (subpath.closed) {
+            raw.moveTo(sideStart(forward, halfWidth));
+            appendSide(raw, forward, halfWidth, true, join, miterLimit, tolerance);
+            raw.closeSubpath();
+            raw.moveTo(sideStart(backward, halfWidth));
+            appendSide(raw, backward, halfWidth, true, join, miterLimit, tolerance);
+            raw.closeSubpath();
+        } else {
+            raw.moveTo(sideStart(forward, halfWidth));
+            appendSide(raw, forward, halfWidth, false, join, miterLimit, tolerance);
+            appendCap(raw, endPoint(forward.last()), endTangent(forward.last()), halfWidth, cap);
+            appendSide(raw, backward, halfWidth, false, join, miterLimit, tolerance);
+            appendCap(raw, endPoint(backward.last()), endTangent(backward.last()), halfWidth, cap);
+            raw.closeSubpath();
+        }
+    }
+    return PathBoolean::positiveFill(raw, tolerance);
+}
@@ -0,0 +1,28 @@
+#ifndef PATH_OFFSET_H
+#define PATH_OFFSET_H
+
+#include <QPainterPath>
+
+/**
+ * 路径偏移引擎
+ * 逐段求偏移：直线平移，曲线按Tiller-Hanson方法得到偏移曲线并按误差细分；
+ * 拐角按连接方式补齐，内侧经过原顶点连接，最后按正环绕数求并清理自相交
+ */
+class PathOffset
+{
+public:
+    // 区域偏移：distance>0向外扩，<0向内缩；按路径的填充规则确定区域
+    static QPainterPath offset(const QPainterPath &path, qreal distance,
+                               Qt::PenJoinStyle join = Qt::RoundJoin,
+                               qreal miterLimit = 4.0,
+                               qreal tolerance = 0.1);
+
+    // 描边轮廓：宽度为width的描边覆盖的区域，端点按cap处理
+    static QPainterPath outline(const QPainterPath &path, qreal width,
+                                Qt::PenJoinStyle join = Qt::RoundJoin,
+                                Qt::PenCapStyle cap = Qt::RoundCap,
+                                qreal miterLimit = 4.0,
+                                qreal tolerance = 0.1);
+};
+
+#endif // PATH_OFFSET_H
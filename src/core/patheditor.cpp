@@ -1,7 +1,13 @@
 #include <QDebug>
 #include <QVector2D>
+#include <QPolygonF>
 #include <qmath.h>
 #include "../core/patheditor.h"
+#include "../core/path-boolean.h"
+#include "../core/path-offset.h"
+#include "../core/curve-fitter.h"
+#include "../core/polyline-simplifier.h"
+#include "../core/path-intersection.h"
 #include "../core/drawing-shape.h"
 
 PathEditor::PathEditor(QObject *parent)
@@ -13,143 +19,74 @@ QPainterPath PathEditor::booleanOperation(const QPainterPath &path1,
                                          const QPainterPath &path2, 
                                          BooleanOperation op)
 {
-    // 检查路径是否为空
-    if (path1.isEmpty() && path2.isEmpty()) {
-        return QPainterPath();
-    }
-    if (path1.isEmpty()) {
-        return path2;
-    }
-    if (path2.isEmpty()) {
-        return path1;
-    }
-    
-    
-    
-    // Qt实现的布尔运算（回退方案）
-    // qDebug() << "Performing boolean operation, op:" << op;
-    
-    // 创建路径副本并确保使用正确的填充规则
-    QPainterPath p1 = path1;
-    QPainterPath p2 = path2;
-    
-    // 对于布尔运算，使用 OddEvenFill 填充规则通常更可靠
-    p1.setFillRule(Qt::OddEvenFill);
-    p2.setFillRule(Qt::OddEvenFill);
-    
-    QPainterPath result;
-    
-    // 执行布尔运算
-    switch (op) {
-    case Union:
-        // qDebug() << "Performing union operation";
-        result = p1.united(p2);
-        break;
-    case Intersection:
-        // qDebug() << "Performing intersection operation";
-        result = p1.intersected(p2);
-        break;
-    case Subtraction:
-        // qDebug() << "Performing subtraction operation";
-        result = p1.subtracted(p2);
-        break;
-    case Xor:
-        // qDebug() << "Performing XOR operation";
-        // XOR 可以通过 (A U B) - (A ∩ B) 实现
-        result = p1.united(p2).subtracted(p1.intersected(p2));
-        break;
-    }
-    
-    // 确保结果也使用正确的填充规则
-    result.setFillRule(Qt::OddEvenFill);
-    
-    // qDebug() << "Boolean operation result isEmpty:" << result.isEmpty();
-    // qDebug() << "Result elementCount:" << result.elementCount();
-    
-    return result;
+    return booleanOperation(QList<QPainterPath>() << path1 << path2, op);
 }
 
-QPainterPath PathEditor::simplifyPath(const QPainterPath &path, qreal tolerance)
+QPainterPath PathEditor::booleanOperation(const QList<QPainterPath> &paths, BooleanOperation op)
+{
+    // 原生扫描线引擎一次处理全部操作数，异或也只需一次扫描
+    return PathBoolean::combine(paths, op, 0.1, paths.size() > 1);
+}
+
+QPainterPath PathEditor::simplifyPath(const QPainterPath &path, qreal tolerance, SimplifyMethod method)
 {
     if (path.elementCount() < 3) {
         return path;
     }
     
-    // 对于画笔路径（密集的直线段），使用非常小的容差值
-    qreal adjustedTolerance = tolerance;
-    // 根据路径点密度调整容差
-    if (path.elementCount() > 50) {
-        adjustedTolerance = qMin(tolerance, 0.5); // 密集路径使用较小容差
-    } else {
-        adjustedTolerance = qMin(tolerance, 2.0); // 稀疏路径可以稍大容差
-    }
+    QPainterPath result;
+    result.setFillRule(path.fillRule());
+    
+    // 连续直线段的顶点，第一个点已经写入结果（子路径起点或曲线终点）
+    QVector<QPointF> run;
+    auto flushRun = [&]() {
+        if (run.size() > 1) {
+            const QVector<int> kept = PolylineSimplifier::simplify(run.constData(), run.size(), tolerance, method);
+            for (int k = 1; k < kept.size(); ++k) {
+                result.lineTo(run[kept[k]]);
+            }
+        }
+        run.clear();
+    };
     
-    // 将路径转换为点列表
-    QList<QPointF> points;
     for (int i = 0; i < path.elementCount(); ++i) {
         const QPainterPath::Element &elem = path.elementAt(i);
-        if (elem.type == QPainterPath::MoveToElement || 
-            elem.type == QPainterPath::LineToElement) {
-            points.append(QPointF(elem.x, elem.y));
+        const QPointF point(elem.x, elem.y);
+        if (elem.type == QPainterPath::MoveToElement) {
+            flushRun();
+            result.moveTo(point);
+            run.append(point);
+        } else if (elem.type == QPainterPath::LineToElement) {
+            run.append(point);
+        } else if (elem.type == QPainterPath::CurveToElement && i + 2 < path.elementCount()) {
+            // 曲线段原样保留，端点是相邻直线段的固定点
+            flushRun();
+            const QPointF end(path.elementAt(i + 2).x, path.elementAt(i + 2).y);
+            result.cubicTo(point, QPointF(path.elementAt(i + 1).x, path.elementAt(i + 1).y), end);
+            run.append(end);
+            i += 2;
         }
     }
+    flushRun();
     
-    // 如果点数太少，直接返回
-    if (points.size() < 3) {
-        return path;
-    }
-    
-    // 使用Douglas-Peucker算法简化
-    QList<QPointF> simplifiedPoints = douglasPeucker(points, adjustedTolerance);
-    
-    // 确保保留足够的点以维持形状
-    int minPoints = qMax(3, points.size() / 10); // 至少保留10%的点
-    if (simplifiedPoints.size() < minPoints) {
-        // 如果简化后的点太少，使用均匀采样
-        simplifiedPoints.clear();
-        int step = points.size() / minPoints;
-        for (int i = 0; i < points.size(); i += step) {
-            simplifiedPoints.append(points[i]);
-        }
-        // 确保包含最后一个点
-        if (simplifiedPoints.last() != points.last()) {
-            simplifiedPoints.append(points.last());
-        }
-    }
-    
-    // 重建路径
+    return result;
+}
+
+QPainterPath PathEditor::simplifyForDisplay(const QPainterPath &path, qreal tolerance)
+{
     QPainterPath result;
-    if (simplifiedPoints.size() > 0) {
-        result.moveTo(simplifiedPoints[0]);
-        
-        // 对于画笔路径，使用平滑的连接
-        if (simplifiedPoints.size() > 2) {
-            for (int i = 1; i < simplifiedPoints.size(); ++i) {
-                if (i == simplifiedPoints.size() - 1) {
-                    // 最后一个点，直接连接
-                    result.lineTo(simplifiedPoints[i]);
-                } else {
-                    // 使用二次贝塞尔曲线创建平滑过渡
-                    QPointF prev = simplifiedPoints[i-1];
-                    QPointF curr = simplifiedPoints[i];
-                    QPointF next = simplifiedPoints[i+1];
-                    
-                    // 计算控制点，使曲线更平滑
-                    QPointF control1 = prev + (curr - prev) * 0.7;
-                    QPointF control2 = curr + (next - curr) * 0.3;
-                    QPointF midPoint = (control1 + control2) * 0.5;
-                    
-                    result.quadTo(midPoint, curr);
-                }
-            }
-        } else {
-            // 只有两个点，直接连接
-            result.lineTo(simplifiedPoints[1]);
-        }
-        
-        if (path.fillRule() == Qt::WindingFill) {
-            result.closeSubpath();
+    result.setFillRule(path.fillRule());
+    
+    // 曲线先展平为折线，再逐个子路径简化，保留子路径结构（孔洞）和填充规则
+    const QList<QPolygonF> polygons = path.toSubpathPolygons();
+    for (const QPolygonF &polygon : polygons) {
+        QVector<QPointF> points(polygon.begin(), polygon.end());
+        const bool closed = points.size() > 2 && points.first() == points.last();
+        if (closed) {
+            points.removeLast();
         }
+        const QVector<QPointF> simplified = PolylineSimplifier::simplify(points, tolerance);
+        result.addPath(fromPolygon(QList<QPointF>(simplified.begin(), simplified.end()), closed));
     }
     
     return result;
@@ -205,64 +142,25 @@ QPainterPath PathEditor::convertToCurve(const QPainterPath &path)
     if (path.elementCount() < 2) {
         return path;
     }
-    
-    QPainterPath result;
-    QList<QPointF> points;
-    
-    // 提取路径点
-    for (int i = 0; i < path.elementCount(); ++i) {
-        const QPainterPath::Element &elem = path.elementAt(i);
-        if (elem.type == QPainterPath::MoveToElement || 
-            elem.type == QPainterPath::LineToElement) {
-            points.append(QPointF(elem.x, elem.y));
-        }
-    }
-    
-    if (points.size() < 2) {
-        return path;
-    }
-    
-    result.moveTo(points[0]);
-    
-    if (points.size() == 2) {
-        result.lineTo(points[1]);
-    } else {
-        // 将直线段转换为曲线
-        for (int i = 1; i < points.size(); ++i) {
-            QPointF prev = points[i - 1];
-            QPointF curr = points[i];
-            QPointF next = (i < points.size() - 1) ? points[i + 1] : points[i];
-            
-            // 计算控制点
-            QPointF cp1 = prev + (curr - prev) * 0.67;
-            QPointF cp2 = curr - (next - curr) * 0.33;
-            
-            result.cubicTo(cp1, cp2, curr);
-        }
-    }
-    
-    return result;
+    // 按误差拟合，尖角保留，平滑部分合并成尽量少的曲线
+    return fitCurve(path, 0.5);
 }
 
-QPainterPath PathEditor::offsetPath(const QPainterPath &path, qreal distance)
+QPainterPath PathEditor::fitCurve(const QPainterPath &path, qreal tolerance)
 {
-    QPainterPathStroker stroker;
-    stroker.setWidth(distance * 2);
-    stroker.setCapStyle(Qt::RoundCap);
-    stroker.setJoinStyle(Qt::RoundJoin);
-    
-    QPainterPath offset = stroker.createStroke(path);
-    return offset;
+    return CurveFitter::fitPath(path, tolerance);
 }
 
-QPainterPath PathEditor::outlinePath(const QPainterPath &path, qreal width)
+QPainterPath PathEditor::offsetPath(const QPainterPath &path, qreal distance,
+                                    Qt::PenJoinStyle join, qreal miterLimit)
 {
-    QPainterPathStroker stroker;
-    stroker.setWidth(width);
-    stroker.setCapStyle(Qt::RoundCap);
-    stroker.setJoinStyle(Qt::RoundJoin);
-    
-    return stroker.createStroke(path);
+    return PathOffset::offset(path, distance, join, miterLimit);
+}
+
+QPainterPath PathEditor::outlinePath(const QPainterPath &path, qreal width,
+                                     Qt::PenJoinStyle join, Qt::PenCapStyle cap, qreal miterLimit)
+{
+    return PathOffset::outline(path, width, join, cap, miterLimit);
 }
 
 bool PathEditor::pathsIntersect(const QPainterPath &path1, const QPainterPath &path2)
@@ -277,23 +175,11 @@ QPainterPath PathEditor::getIntersection(const QPainterPath &path1, const QPaint
 
 QList<QPointF> PathEditor::getIntersectionPoints(const QPainterPath &path1, const QPainterPath &path2)
 {
-    QList<QPointF> intersections;
-    
-    // 简化实现：使用边界框检测
-    QRectF bounds1 = path1.controlPointRect();
-    QRectF bounds2 = path2.controlPointRect();
-    
-    if (!bounds1.intersects(bounds2)) {
-        return intersections;
+    // 包围盒不相交时不必展平
+    if (!path1.controlPointRect().intersects(path2.controlPointRect())) {
+        return QList<QPointF>();
     }
-    
-    // 更精确的检测需要更复杂的算法，这里返回边界框交点作为示例
-    QRectF intersection = bounds1.intersected(bounds2);
-    if (!intersection.isEmpty()) {
-        intersections.append(intersection.center());
-    }
-    
-    return intersections;
+    return PathIntersection::intersections(path1, path2);
 }
 
 QPainterPath PathEditor::fromPolygon(const QList<QPointF> &points, bool closed)
@@ -436,71 +322,6 @@ bool PathEditor::pointInPolygon(const QPointF &point, const QList<QPointF> &poly
     return inside;
 }
 
-QList<QPointF> PathEditor::douglasPeucker(const QList<QPointF> &points, qreal epsilon)
-{
-    if (points.size() <= 2) {
-        return points;
-    }
-    
-    // 找到距离直线最远的点
-    qreal maxDistance = 0;
-    int maxIndex = 0;
-    
-    for (int i = 1; i < points.size() - 1; ++i) {
-        qreal distance = 0;
-        // 计算点到直线的距离
-        QPointF p1 = points[0];
-        QPointF p2 = points.last();
-        QPointF p = points[i];
-        
-        qreal A = p.y() - p1.y();
-        qreal B = p1.x() - p.x();
-        qreal C = p.x() - p1.x();
-        qreal D = p.y() - p1.y();
-        qreal dot = A * A + B * B;
-        qreal len_sq = C * C + D * D;
-        qreal param = -1;
-        
-        if (len_sq != 0) {
-            param = dot / len_sq;
-        }
-        
-        QPointF xx;
-        if (param < 0) {
-            xx = p1;
-        } else if (param > 1) {
-            xx = p2;
-        } else {
-            xx = QPointF(p1.x() + param * C, p1.y() + param * D);
-        }
-        
-        qreal dx = p.x() - xx.x();
-        qreal dy = p.y() - xx.y();
-        distance = qSqrt(dx * dx + dy * dy);
-        
-        if (distance > maxDistance) {
-            maxDistance = distance;
-            maxIndex = i;
-        }
-    }
-    
-    // 如果最大距离大于阈值，递归简化
-    if (maxDistance > epsilon) {
-        QList<QPointF> left = points.mid(0, maxIndex + 1);
-        QList<QPointF> right = points.mid(maxIndex);
-        
-        QList<QPointF> leftResult = douglasPeucker(left, epsilon);
-        QList<QPointF> rightResult = douglasPeucker(right, epsilon);
-        
-        leftResult.removeLast();
-        leftResult.append(rightResult);
-        
-        return leftResult;
-    } else {
-        return QList<QPointF>() << points.first() << points.last();
-    }
-}
-
 QPointF PathEditor::bezierPoint(const QPointF &p0, const QPointF &p1, 
                                 const QPointF &p2, const QPointF &p3, qreal t)
 {
@@ -534,12 +355,7 @@ QPainterPath PathEditor::convexHull(const QPainterPath &path)
 
 QPainterPath PathEditor::buffer(const QPainterPath &path, double distance)
 {
-    // 使用Qt的描边功能
-    QPainterPathStroker stroker;
-    stroker.setWidth(qAbs(distance) * 2);
-    stroker.setCapStyle(Qt::RoundCap);
-    stroker.setJoinStyle(Qt::RoundJoin);
-    return stroker.createStroke(path);
+    return PathOffset::offset(path, distance, Qt::RoundJoin);
 }
 
 double PathEditor::distance(const QPainterPath &path1, const QPainterPath &path2)
@@ -590,8 +406,7 @@ QPointF PathEditor::centroid(const QPainterPath &path)
 
 QList<QPointF> PathEditor::intersections(const QPainterPath &path1, const QPainterPath &path2)
 {
-    // 简单实现：返回空列表
-    return QList<QPointF>();
+    return getIntersectionPoints(path1, path2);
 }
 
 bool PathEditor::isBoostGeometryAvailable()
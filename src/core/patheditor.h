@@ -23,6 +23,11 @@ public:
         Xor             // 异或
     };
     
+    enum SimplifyMethod {
+        DouglasPeucker,     // 按到简化折线的距离保留点
+        VisvalingamWhyatt   // 按相邻三点围成的有效面积删点
+    };
+    
     enum PathOperation {
         Simplify,       // 简化路径
         Smooth,         // 平滑路径
@@ -38,13 +43,26 @@ public:
     static QPainterPath booleanOperation(const QPainterPath &path1, 
                                         const QPainterPath &path2, 
                                         BooleanOperation op);
+    // 多个操作数：差集为第一个减去其余，异或为在奇数个操作数内
+    static QPainterPath booleanOperation(const QList<QPainterPath> &paths, BooleanOperation op);
     
     // 路径操作
-    static QPainterPath simplifyPath(const QPainterPath &path, qreal tolerance = 0.5);
+    // 简化连续的直线段，曲线段和子路径结构保持不变
+    static QPainterPath simplifyPath(const QPainterPath &path, qreal tolerance = 0.5,
+                                     SimplifyMethod method = DouglasPeucker);
+    // 按显示误差简化（曲线展平为折线），用于低缩放比例下的绘制
+    static QPainterPath simplifyForDisplay(const QPainterPath &path, qreal tolerance);
     static QPainterPath smoothPath(const QPainterPath &path, qreal smoothness = 0.5);
     static QPainterPath convertToCurve(const QPainterPath &path);
-    static QPainterPath offsetPath(const QPainterPath &path, qreal distance);
-    static QPainterPath outlinePath(const QPainterPath &path, qreal width);
+    // 折线拟合为尽量少的三次曲线，误差不超过tolerance，尖角保留
+    static QPainterPath fitCurve(const QPainterPath &path, qreal tolerance = 0.5);
+    // 区域偏移：distance>0外扩，<0内缩
+    static QPainterPath offsetPath(const QPainterPath &path, qreal distance,
+                                   Qt::PenJoinStyle join = Qt::RoundJoin, qreal miterLimit = 4.0);
+    // 描边转轮廓
+    static QPainterPath outlinePath(const QPainterPath &path, qreal width,
+                                    Qt::PenJoinStyle join = Qt::RoundJoin,
+                                    Qt::PenCapStyle cap = Qt::RoundCap, qreal miterLimit = 4.0);
     
     // 路径分析
     static bool pathsIntersect(const QPainterPath &path1, const QPainterPath &path2);
@@ -80,7 +98,6 @@ signals:
 private:
     // 辅助函数
     static bool pointInPolygon(const QPointF &point, const QList<QPointF> &polygon);
-    static QList<QPointF> douglasPeucker(const QList<QPointF> &points, qreal epsilon);
     static QPointF bezierPoint(const QPointF &p0, const QPointF &p1, const QPointF &p2, const QPointF &p3, qreal t);
 };
 
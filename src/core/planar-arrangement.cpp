@@ -0,0 +1,549 @@
+#include <QtMath>
+#include <QSet>
+#include <QDebug>
+#include <algorithm>
+#include <limits>
+#include "../core/planar-arrangement.h"
+
+// 网格每边最多的格子数
+static const int MAX_GRID_SIDE = 1024;
+// 顶点合并距离相对窗口尺寸的比例
+static const qreal RELATIVE_EPSILON = 1e-7;
+
+static qreal cross(const QPointF &a, const QPointF &b)
+{
+    return a.x() * b.y() - a.y() * b.x();
+}
+
+static QPointF closestPointOnSegment(const QPointF &point, const QPointF &a, const QPointF &b)
+{
+    const QPointF d = b - a;
+    const qreal lengthSquared = QPointF::dotProduct(d, d);
+    if (lengthSquared <= 0.0) {
+        return a;
+    }
+    const qreal t = qBound(0.0, QPointF::dotProduct(point - a, d) / lengthSquared, 1.0);
+    return a + d * t;
+}
+
+static qreal distance(const QPointF &a, const QPointF &b)
+{
+    return qSqrt(QPointF::dotProduct(a - b, a - b));
+}
+
+PlanarArrangement::PlanarArrangement(const QRectF &window, qreal gapTolerance)
+    : m_window(window.normalized())
+    , m_gapTolerance(qMax(0.0, gapTolerance))
+    , m_cellSize(1.0)
+    , m_gridColumns(1)
+    , m_gridRows(1)
+{
+    m_epsilon = qMax(qMax(m_window.width(), m_window.height()) * RELATIVE_EPSILON, 1e-9);
+}
+
+void PlanarArrangement::addPath(const QPainterPath &path, int source)
+{
+    const QList<QPolygonF> polygons = path.toSubpathPolygons();
+    for (const QPolygonF &polygon : polygons) {
+        if (polygon.size() < 2) {
+            continue;
+        }
+        Polyline polyline;
+        polyline.points = polygon;
+        polyline.closed = polygon.size() > 2 && polygon.first() == polygon.last();
+        polyline.source = source;
+        m_polylines.append(polyline);
+    }
+}
+
+void PlanarArrangement::build()
+{
+    // 只保留与窗口（外扩缺口容差）相交的线段
+    const QRectF bounds = m_window.adjusted(-m_gapTolerance, -m_gapTolerance, m_gapTolerance, m_gapTolerance);
+    for (int p = 0; p < m_polylines.size(); ++p) {
+        const QPolygonF &points = m_polylines[p].points;
+        for (int i = 0; i + 1 < points.size(); ++i) {
+            const QPointF &a = points[i];
+            const QPointF &b = points[i + 1];
+            if (a == b) {
+                continue;
+            }
+            if (qMax(a.x(), b.x()) < bounds.left() || qMin(a.x(), b.x()) > bounds.right() ||
+                qMax(a.y(), b.y()) < bounds.top() || qMin(a.y(), b.y()) > bounds.bottom()) {
+                continue;
+            }
+            m_segments.append({a, b, m_polylines[p].source, p, i});
+        }
+    }
+
+    buildGrid();
+    closeGaps();
+
+    QVector<QVector<Split>> splits(m_segments.size());
+    intersectSegments(splits);
+
+    // 按交点打断线段，合并重合的顶点和边
+    QSet<qint64> edgeKeys;
+    for (int s = 0; s < m_segments.size(); ++s) {
+        QVector<Split> &points = splits[s];
+        points.append({0.0, m_segments[s].a});
+        points.append({1.0, m_segments[s].b});
+        std::sort(points.begin(), points.end(), [](const Split &x, const Split &y) { return x.t < y.t; });
+
+        int previous = -1;
+        for (const Split &split : points) {
+            const int vertex = vertexAt(split.point);
+            if (previous >= 0 && vertex != previous) {
+                const qint64 key = (qint64(qMin(previous, vertex)) << 32) | qint64(qMax(previous, vertex));
+                if (!edgeKeys.contains(key)) {
+                    edgeKeys.insert(key);
+                    m_edgeFrom.append(previous);
+                    m_edgeTo.append(vertex);
+                    m_edgeSources.append(m_segments[s].source);
+                    m_edgeAlive.append(true);
+                }
+            }
+            previous = vertex;
+        }
+    }
+
+    pruneDanglingEdges();
+    buildFaces();
+}
+
+void PlanarArrangement::buildGrid()
+{
+    m_gridRect = m_window.adjusted(-m_gapTolerance, -m_gapTolerance, m_gapTolerance, m_gapTolerance);
+    const qreal width = qMax(m_gridRect.width(), m_epsilon);
+    const qreal height = qMax(m_gridRect.height(), m_epsilon);
+
+    // 平均每个格子大约一条线段
+    const int count = qMax(1, int(m_segments.size()));
+    m_cellSize = qSqrt(width * height / count);
+    m_cellSize = qMax(m_cellSize, qMax(width, height) / MAX_GRID_SIDE);
+    m_gridColumns = qBound(1, qCeil(width / m_cellSize), MAX_GRID_SIDE);
+    m_gridRows = qBound(1, qCeil(height / m_cellSize), MAX_GRID_SIDE);
+
+    m_cells.clear();
+    m_cells.resize(m_gridColumns * m_gridRows);
+    for (int s = 0; s < m_segments.size(); ++s) {
+        insertIntoGrid(s);
+    }
+}
+
+void PlanarArrangement::insertIntoGrid(int segment)
+{
+    const Segment &s = m_segments[segment];
+    const int c0 = columnAt(qMin(s.a.x(), s.b.x()));
+    const int c1 = columnAt(qMax(s.a.x(), s.b.x()));
+    const int r0 = rowAt(qMin(s.a.y(), s.b.y()));
+    const int r1 = rowAt(qMax(s.a.y(), s.b.y()));
+    for (int row = r0; row <= r1; ++row) {
+        for (int column = c0; column <= c1; ++column) {
+            m_cells[cellIndex(column, row)].append(segment);
+        }
+    }
+}
+
+int PlanarArrangement::columnAt(qreal x) const
+{
+    return qBound(0, int(qFloor((x - m_gridRect.left()) / m_cellSize)), m_gridColumns - 1);
+}
+
+int PlanarArrangement::rowAt(qreal y) const
+{
+    return qBound(0, int(qFloor((y - m_gridRect.top()) / m_cellSize)), m_gridRows - 1);
+}
+
+void PlanarArrangement::closeGaps()
+{
+    if (m_gapTolerance <= 0.0) {
+        return;
+    }
+
+    struct Bridge {
+        QPointF from;
+        QPointF to;
+    };
+    QVector<Bridge> bridges;
+
+    const int segmentCount = m_segments.size();
+    for (int s = 0; s < segmentCount; ++s) {
+        const Segment &segment = m_segments[s];
+        const Polyline &polyline = m_polylines[segment.polyline];
+        if (polyline.closed) {
+            continue;
+        }
+
+        // 开放折线的两个端点
+        QVector<QPointF> endpoints;
+        if (segment.index == 0) {
+            endpoints.append(segment.a);
+        }
+        if (segment.index == polyline.points.size() - 2) {
+            endpoints.append(segment.b);
+        }
+
+        for (const QPointF &endpoint : endpoints) {
+            bool connected = false;
+            qreal bestDistance = m_gapTolerance;
+            QPointF bestPoint;
+            bool found = false;
+
+            const int c0 = columnAt(endpoint.x() - m_gapTolerance);
+            const int c1 = columnAt(endpoint.x() + m_gapTolerance);
+            const int r0 = rowAt(endpoint.y() - m_gapTolerance);
+            const int r1 = rowAt(endpoint.y() + m_gapTolerance);
+            for (int row = r0; row <= r1 && !connected; ++row) {
+                for (int column = c0; column <= c1 && !connected; ++column) {
+                    for (int other : m_cells[cellIndex(column, row)]) {
+                        const Segment &candidate = m_segments[other];
+                        // 同一条折线上相邻的线段共享顶点，不算缺口
+                        if (other == s || (candidate.polyline == segment.polyline && qAbs(candidate.index - segment.index) <= 1)) {
+                            continue;
+                        }
+                        const QPointF point = closestPointOnSegment(endpoint, candidate.a, candidate.b);
+                        const qreal d = distance(endpoint, point);
+                        if (d <= m_epsilon) {
+                            connected = true;
+                            break;
+                        }
+                        if (d <= bestDistance) {
+                            bestDistance = d;
+                            bestPoint = point;
+                            found = true;
+                        }
+                    }
+                }
+            }
+
+            if (!connected && found) {
+                bridges.append({endpoint, bestPoint});
+            }
+        }
+    }
+
+    // 缺口连线作为普通线段参与求交
+    for (const Bridge &bridge : bridges) {
+        m_segments.append({bridge.from, bridge.to, -1, -1, 0});
+        insertIntoGrid(m_segments.size() - 1);
+    }
+}
+
+void PlanarArrangement::intersectSegments(QVector<QVector<Split>> &splits) const
+{
+    for (int row = 0; row < m_gridRows; ++row) {
+        for (int column = 0; column < m_gridColumns; ++column) {
+            const QVector<int> &cell = m_cells[cellIndex(column, row)];
+            for (int i = 0; i < cell.size(); ++i) {
+                const Segment &first = m_segments[cell[i]];
+                for (int j = i + 1; j < cell.size(); ++j) {
+                    const Segment &second = m_segments[cell[j]];
+
+                    // 两个包围盒的重叠区域，只在其左上角所在的格子里处理这一对，避免重复
+                    const qreal left = qMax(qMin(first.a.x(), first.b.x()), qMin(second.a.x(), second.b.x()));
+                    const qreal right = qMin(qMax(first.a.x(), first.b.x()), qMax(second.a.x(), second.b.x()));
+                    const qreal top = qMax(qMin(first.a.y(), first.b.y()), qMin(second.a.y(), second.b.y()));
+                    const qreal bottom = qMin(qMax(first.a.y(), first.b.y()), qMax(second.a.y(), second.b.y()));
+                    if (left > right + m_epsilon || top > bottom + m_epsilon) {
+                        continue;
+                    }
+                    if (columnAt(left) != column || rowAt(top) != row) {
+                        continue;
+                    }
+
+                    const QPointF r = first.b - first.a;
+                    const QPointF s = second.b - second.a;
+                    const QPointF offset = second.a - first.a;
+                    const qreal denominator = cross(r, s);
+                    const qreal rLength = qSqrt(QPointF::dotProduct(r, r));
+                    const qreal sLength = qSqrt(QPointF::dotProduct(s, s));
+
+                    if (qAbs(denominator) > 1e-12 * rLength * sLength) {
+                        const qreal t = cross(offset, s) / denominator;
+                        const qreal u = cross(offset, r) / denominator;
+                        const qreal tSlack = m_epsilon / rLength;
+                        const qreal uSlack = m_epsilon / sLength;
+                        if (t < -tSlack || t > 1.0 + tSlack || u < -uSlack || u > 1.0 + uSlack) {
+                            continue;
+                        }
+                        const QPointF point = first.a + r * qBound(0.0, t, 1.0);
+                        splits[cell[i]].append({qBound(0.0, t, 1.0), point});
+                        splits[cell[j]].append({qBound(0.0, u, 1.0), point});
+                        continue;
+                    }
+
+                    // 平行：共线时互相在对方的端点处打断
+                    if (qAbs(cross(r, offset)) > m_epsilon * rLength) {
+                        continue;
+                    }
+                    auto splitAt = [&splits](int index, const Segment &segment, const QPointF &point) {
+                        const QPointF d = segment.b - segment.a;
+                        const qreal t = QPointF::dotProduct(point - segment.a, d) / QPointF::dotProduct(d, d);
+                        if (t > 0.0 && t < 1.0) {
+                            splits[index].append({t, point});
+                        }
+                    };
+                    splitAt(cell[i], first, second.a);
+                    splitAt(cell[i], first, second.b);
+                    splitAt(cell[j], second, first.a);
+                    splitAt(cell[j], second, first.b);
+                }
+            }
+        }
+    }
+}
+
+int PlanarArrangement::vertexAt(const QPointF &point)
+{
+    const qint64 cx = qint64(qFloor(point.x() / m_epsilon));
+    const qint64 cy = qint64(qFloor(point.y() / m_epsilon));
+    auto key = [](qint64 x, qint64 y) {
+        return qint64((quint64(x) * 0x9E3779B97F4A7C15ULL) ^ quint64(y));
+    };
+
+    for (qint64 dy = -1; dy <= 1; ++dy) {
+        for (qint64 dx = -1; dx <= 1; ++dx) {
+            const auto it = m_vertexCells.constFind(key(cx + dx, cy + dy));
+            if (it == m_vertexCells.constEnd()) {
+                continue;
+            }
+            for (int vertex : it.value()) {
+                if (distance(m_vertices[vertex], point) <= m_epsilon) {
+                    return vertex;
+                }
+            }
+        }
+    }
+
+    m_vertices.append(point);
+    m_vertexCells[key(cx, cy)].append(m_vertices.size() - 1);
+    return m_vertices.size() - 1;
+}
+
+void PlanarArrangement::pruneDanglingEdges()
+{
+    // 度为1的顶点所在的边不围成任何面，逐层剥掉
+    QVector<QVector<int>> incident(m_vertices.size());
+    QVector<int> degree(m_vertices.size(), 0);
+    for (int e = 0; e < m_edgeFrom.size(); ++e) {
+        incident[m_edgeFrom[e]].append(e);
+        incident[m_edgeTo[e]].append(e);
+        degree[m_edgeFrom[e]]++;
+        degree[m_edgeTo[e]]++;
+    }
+
+    QVector<int> queue;
+    for (int v = 0; v < degree.size(); ++v) {
+        if (degree[v] == 1) {
+            queue.append(v);
+        }
+    }
+    while (!queue.isEmpty()) {
+        const int vertex = queue.takeLast();
+        if (degree[vertex] != 1) {
+            continue;
+        }
+        for (int e : incident[vertex]) {
+            if (!m_edgeAlive[e]) {
+                continue;
+            }
+            m_edgeAlive[e] = false;
+            const int other = m_edgeFrom[e] == vertex ? m_edgeTo[e] : m_edgeFrom[e];
+            degree[vertex]--;
+            degree[other]--;
+            if (degree[other] == 1) {
+                queue.append(other);
+            }
+            break;
+        }
+    }
+}
+
+void PlanarArrangement::buildFaces()
+{
+    const int halfEdgeCount = m_edgeFrom.size() * 2;
+    auto origin = [this](int halfEdge) {
+        return (halfEdge & 1) ? m_edgeTo[halfEdge >> 1] : m_edgeFrom[halfEdge >> 1];
+    };
+    auto destination = [this](int halfEdge) {
+        return (halfEdge & 1) ? m_edgeFrom[halfEdge >> 1] : m_edgeTo[halfEdge >> 1];
+    };
+
+    // 每个顶点的出边按角度逆时针排序
+    QVector<QVector<int>> outgoing(m_vertices.size());
+    for (int h = 0; h < halfEdgeCount; ++h) {
+        if (m_edgeAlive[h >> 1]) {
+            outgoing[origin(h)].append(h);
+        }
+    }
+    QVector<qreal> angles(halfEdgeCount, 0.0);
+    QVector<int> rotationIndex(halfEdgeCount, -1);
+    for (int v = 0; v < outgoing.size(); ++v) {
+        QVector<int> &edges = outgoing[v];
+        for (int h : edges) {
+            const QPointF d = m_vertices[destination(h)] - m_vertices[v];
+            angles[h] = qAtan2(d.y(), d.x());
+        }
+        std::sort(edges.begin(), edges.end(), [&angles](int x, int y) { return angles[x] < angles[y]; });
+        for (int i = 0; i < edges.size(); ++i) {
+            rotationIndex[edges[i]] = i;
+        }
+    }
+
+    // 面在半边左侧：到达v后取反向半边在逆时针顺序中的前一条
+    m_next.fill(-1, halfEdgeCount);
+    for (int h = 0; h < halfEdgeCount; ++h) {
+        if (!m_edgeAlive[h >> 1]) {
+            continue;
+        }
+        const int twin = h ^ 1;
+        const QVector<int> &edges = outgoing[destination(h)];
+        const int index = rotationIndex[twin];
+        m_next[h] = edges[(index - 1 + edges.size()) % edges.size()];
+    }
+
+    m_halfEdgeCycle.fill(-1, halfEdgeCount);
+    for (int h = 0; h < halfEdgeCount; ++h) {
+        if (!m_edgeAlive[h >> 1] || m_halfEdgeCycle[h] >= 0) {
+            continue;
+        }
+        const int cycle = m_cycles.size();
+        QVector<int> halfEdges;
+        qreal area = 0.0;
+        int current = h;
+        do {
+            m_halfEdgeCycle[current] = cycle;
+            halfEdges.append(current);
+            area += cross(m_vertices[origin(current)], m_vertices[destination(current)]);
+            current = m_next[current];
+        } while (current != h && current >= 0);
+        m_cycles.append(halfEdges);
+        m_cycleAreas.append(area / 2.0);
+    }
+
+    // 连通分量（并查集）
+    m_vertexComponent.resize(m_vertices.size());
+    for (int v = 0; v < m_vertices.size(); ++v) {
+        m_vertexComponent[v] = v;
+    }
+    for (int e = 0; e < m_edgeFrom.size(); ++e) {
+        if (!m_edgeAlive[e]) {
+            continue;
+        }
+        const int a = findComponent(m_edgeFrom[e]);
+        const int b = findComponent(m_edgeTo[e]);
+        if (a != b) {
+            m_vertexComponent[a] = b;
+        }
+    }
+    for (int v = 0; v < m_vertices.size(); ++v) {
+        m_vertexComponent[v] = findComponent(v);
+    }
+}
+
+int PlanarArrangement::findComponent(int vertex) const
+{
+    while (m_vertexComponent[vertex] != vertex) {
+        vertex = m_vertexComponent[vertex];
+    }
+    return vertex;
+}
+
+QPolygonF PlanarArrangement::cyclePolygon(int cycle) const
+{
+    QPolygonF polygon;
+    const QVector<int> &halfEdges = m_cycles[cycle];
+    polygon.reserve(halfEdges.size() + 1);
+    for (int h : halfEdges) {
+        polygon.append(m_vertices[(h & 1) ? m_edgeTo[h >> 1] : m_edgeFrom[h >> 1]]);
+    }
+    if (!polygon.isEmpty()) {
+        polygon.append(polygon.first());
+    }
+    return polygon;
+}
+
+QPainterPath PlanarArrangement::faceAt(const QPointF &point, QList<int> *sources) const
+{
+    auto cycleComponent = [this](int cycle) {
+        const int h = m_cycles[cycle].first();
+        return m_vertexComponent[m_edgeFrom[h >> 1]];
+    };
+
+    // 向右发射射线，找到最近的边；若它属于某个岛的外边界，则排除这个岛继续找
+    QSet<int> excludedComponents;
+    int outerCycle = -1;
+    while (outerCycle < 0) {
+        qreal bestX = std::numeric_limits<qreal>::max();
+        int bestHalfEdge = -1;
+        for (int e = 0; e < m_edgeFrom.size(); ++e) {
+            if (!m_edgeAlive[e] || excludedComponents.contains(m_vertexComponent[m_edgeFrom[e]])) {
+                continue;
+            }
+            const QPointF &a = m_vertices[m_edgeFrom[e]];
+            const QPointF &b = m_vertices[m_edgeTo[e]];
+            if ((a.y() > point.y()) == (b.y() > point.y())) {
+                continue;
+            }
+            const qreal x = a.x() + (point.y() - a.y()) * (b.x() - a.x()) / (b.y() - a.y());
+            if (x > point.x() && x < bestX) {
+                bestX = x;
+                // 取点所在一侧（左侧）的半边
+                bestHalfEdge = cross(b - a, point - a) > 0 ? 2 * e : 2 * e + 1;
+            }
+        }
+        if (bestHalfEdge < 0) {
+            return QPainterPath();
+        }
+
+        const int cycle = m_halfEdgeCycle[bestHalfEdge];
+        if (m_cycleAreas[cycle] > 0) {
+            outerCycle = cycle;
+        } else {
+            excludedComponents.insert(cycleComponent(cycle));
+        }
+    }
+
+    const QPolygonF outer = cyclePolygon(outerCycle);
+    const int outerComponent = cycleComponent(outerCycle);
+
+    // 面内的岛：其他分量的外边界，只取不在别的岛里的
+    QVector<QPolygonF> holes;
+    for (int c = 0; c < m_cycles.size(); ++c) {
+        if (m_cycleAreas[c] >= 0 || cycleComponent(c) == outerComponent) {
+            continue;
+        }
+        const QPolygonF hole = cyclePolygon(c);
+        if (!outer.containsPoint(hole.first(), Qt::OddEvenFill) || hole.containsPoint(point, Qt::OddEvenFill)) {
+            continue;
+        }
+        holes.append(hole);
+    }
+
+    QPainterPath face;
+    face.setFillRule(Qt::OddEvenFill);
+    face.addPolygon(outer);
+    face.closeSubpath();
+    for (int i = 0; i < holes.size(); ++i) {
+        bool nested = false;
+        for (int j = 0; j < holes.size() && !nested; ++j) {
+            nested = i != j && holes[j].containsPoint(holes[i].first(), Qt::OddEvenFill);
+        }
+        if (!nested) {
+            face.addPolygon(holes[i]);
+            face.closeSubpath();
+        }
+    }
+
+    if (sources) {
+        sources->clear();
+        for (int h : m_cycles[outerCycle]) {
+            const int source = m_edgeSources[h >> 1];
+            if (source >= 0 && !sources->contains(source)) {
+                sources->append(source);
+            }
+        }
+    }
+    return face;
+}
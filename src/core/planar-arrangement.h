@@ -0,0 +1,100 @@
+#ifndef PLANAR_ARRANGEMENT_H
+#define PLANAR_ARRANGEMENT_H
+
+#include <QPointF>
+#include <QRectF>
+#include <QPolygonF>
+#include <QPainterPath>
+#include <QVector>
+#include <QList>
+#include <QHash>
+
+/**
+ * 平面划分 - 区域填充用
+ * 把窗口内的折线在交点处打断，建立半边结构并求出所有面；
+ * 开放折线的端点在容差内会连到最近的几何上，用来封住手绘线条之间的小缺口
+ */
+class PlanarArrangement
+{
+public:
+    // 只处理与window相交的线段；gapTolerance为封闭缺口的最大距离（场景坐标）
+    explicit PlanarArrangement(const QRectF &window, qreal gapTolerance = 0.0);
+
+    // 添加一条几何（场景坐标），曲线先展平；source用于追溯来源
+    void addPath(const QPainterPath &path, int source = -1);
+
+    // 求交、建立面
+    void build();
+
+    // 包含point的有界面（含洞，奇偶填充），point在所有面之外时返回空路径
+    // sources返回面的外边界来自哪些输入
+    QPainterPath faceAt(const QPointF &point, QList<int> *sources = nullptr) const;
+
+    int vertexCount() const { return m_vertices.size(); }
+    int edgeCount() const { return m_edgeSources.size(); }
+    int faceCount() const { return m_cycleAreas.size(); }
+
+private:
+    struct Polyline {
+        QPolygonF points;
+        bool closed;
+        int source;
+    };
+    struct Segment {
+        QPointF a;
+        QPointF b;
+        int source;
+        int polyline;
+        int index;      // 在折线中的序号
+    };
+    struct Split {
+        qreal t;
+        QPointF point;
+    };
+
+    // 线段网格
+    void buildGrid();
+    void insertIntoGrid(int segment);
+    int cellIndex(int column, int row) const { return row * m_gridColumns + column; }
+    int columnAt(qreal x) const;
+    int rowAt(qreal y) const;
+
+    void closeGaps();
+    void intersectSegments(QVector<QVector<Split>> &splits) const;
+    int vertexAt(const QPointF &point);
+    void pruneDanglingEdges();
+    void buildFaces();
+    QPolygonF cyclePolygon(int cycle) const;
+    int findComponent(int vertex) const;
+
+    QRectF m_window;
+    qreal m_gapTolerance;
+    qreal m_epsilon;
+
+    QVector<Polyline> m_polylines;
+    QVector<Segment> m_segments;
+
+    // 均匀网格：每个格子记录与其包围盒相交的线段
+    QRectF m_gridRect;
+    qreal m_cellSize;
+    int m_gridColumns;
+    int m_gridRows;
+    QVector<QVector<int>> m_cells;
+
+    // 顶点与边
+    QVector<QPointF> m_vertices;
+    QHash<qint64, QVector<int>> m_vertexCells;
+    QVector<int> m_edgeFrom;
+    QVector<int> m_edgeTo;
+    QVector<int> m_edgeSources;
+    QVector<bool> m_edgeAlive;
+
+    // 半边：2k为edge k的正向，2k+1为反向；m_next给出同一面上的下一条半边
+    QVector<int> m_next;
+    QVector<int> m_halfEdgeCycle;
+    QVector<QVector<int>> m_cycles;       // 每个面边界上的半边
+    QVector<qreal> m_cycleAreas;          // 有向面积，正值为有界面
+    QVector<int> m_vertexComponent;
+};
+
+#endif // PLANAR_ARRANGEMENT_H
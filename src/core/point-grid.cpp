@@ -0,0 +1,167 @@
+#include <QtMath>
+#include "../core/point-grid.h"
+
+// 平均每格的点数
+static const int POINTS_PER_CELL = 2;
+// 每个方向的最多格子数
+static const int MAX_CELLS_PER_SIDE = 2048;
+
+void PointGrid::clear()
+{
+    m_points.clear();
+    m_bounds = QRectF();
+    m_cellStart.clear();
+    m_indices.clear();
+    m_columns = 0;
+    m_rows = 0;
+}
+
+void PointGrid::build(const QVector<QPointF> &points)
+{
+    clear();
+    m_points = points;
+    if (m_points.isEmpty()) {
+        return;
+    }
+
+    // 非有限的坐标不参与包围盒，落到边界格子
+    qreal minX = qInf();
+    qreal minY = qInf();
+    qreal maxX = -qInf();
+    qreal maxY = -qInf();
+    for (const QPointF &point : m_points) {
+        if (qIsFinite(point.x()) && qIsFinite(point.y())) {
+            minX = qMin(minX, point.x());
+            minY = qMin(minY, point.y());
+            maxX = qMax(maxX, point.x());
+            maxY = qMax(maxY, point.y());
+        }
+    }
+    if (minX > maxX) {
+        minX = minY = maxX = maxY = 0.0;
+    }
+    m_bounds = QRectF(QPointF(minX, minY), QPointF(maxX, maxY));
+
+    // 格子边长按面积和点数估计，退化为线段时按长度估计
+    const qreal width = maxX - minX;
+    const qreal height = maxY - minY;
+    const int targetCells = qMax(1, m_points.size() / POINTS_PER_CELL);
+    qreal cellSize = width > 0 && height > 0 ? qSqrt(width * height / targetCells) : qMax(width, height) / targetCells;
+    cellSize = qMax(cellSize, qMax(width, height) / MAX_CELLS_PER_SIDE);
+    m_cellSize = cellSize > 0 ? cellSize : 1.0;
+    m_columns = qBound(1, int(width / m_cellSize) + 1, MAX_CELLS_PER_SIDE);
+    m_rows = qBound(1, int(height / m_cellSize) + 1, MAX_CELLS_PER_SIDE);
+
+    // 计数排序：先数出每格的点数，再按下标顺序放入
+    const int cellCount = m_columns * m_rows;
+    QVector<int> cellOf(m_points.size());
+    m_cellStart.fill(0, cellCount + 1);
+    for (int i = 0; i < m_points.size(); ++i) {
+        cellOf[i] = cellY(m_points[i].y()) * m_columns + cellX(m_points[i].x());
+        m_cellStart[cellOf[i] + 1]++;
+    }
+    for (int c = 0; c < cellCount; ++c) {
+        m_cellStart[c + 1] += m_cellStart[c];
+    }
+    m_indices.resize(m_points.size());
+    QVector<int> fill(m_cellStart.constBegin(), m_cellStart.constEnd() - 1);
+    for (int i = 0; i < m_points.size(); ++i) {
+        m_indices[fill[cellOf[i]]++] = i;
+    }
+}
+
+int PointGrid::cellX(qreal x) const
+{
+    const qreal cell = (x - m_bounds.left()) / m_cellSize;
+    return cell >= 0 ? int(qMin(cell, qreal(m_columns - 1))) : 0;
+}
+
+int PointGrid::cellY(qreal y) const
+{
+    const qreal cell = (y - m_bounds.top()) / m_cellSize;
+    return cell >= 0 ? int(qMin(cell, qreal(m_rows - 1))) : 0;
+}
+
+int PointGrid::first(const QPointF &pos, qreal maxDistance) const
+{
+    if (m_points.isEmpty() || maxDistance < 0) {
+        return -1;
+    }
+    const qreal maxSquared = maxDistance * maxDistance;
+    const int x0 = cellX(pos.x() - maxDistance);
+    const int x1 = cellX(pos.x() + maxDistance);
+    const int y0 = cellY(pos.y() - maxDistance);
+    const int y1 = cellY(pos.y() + maxDistance);
+    int result = -1;
+    for (int y = y0; y <= y1; ++y) {
+        for (int x = x0; x <= x1; ++x) {
+            const int cell = y * m_columns + x;
+            // 格内下标升序，找到第一个即可换下一格
+            for (int k = m_cellStart[cell]; k < m_cellStart[cell + 1]; ++k) {
+                const int index = m_indices[k];
+                if (result >= 0 && index > result) {
+                    break;
+                }
+                const QPointF d = m_points[index] - pos;
+                if (d.x() * d.x() + d.y() * d.y() <= maxSquared) {
+                    result = index;
+                    break;
+                }
+            }
+        }
+    }
+    return result;
+}
+
+int PointGrid::nearest(const QPointF &pos, qreal maxDistance) const
+{
+    if (m_points.isEmpty() || maxDistance <= 0) {
+        return -1;
+    }
+    qreal bestSquared = maxDistance * maxDistance;
+    const int x0 = cellX(pos.x() - maxDistance);
+    const int x1 = cellX(pos.x() + maxDistance);
+    const int y0 = cellY(pos.y() - maxDistance);
+    const int y1 = cellY(pos.y() + maxDistance);
+    int result = -1;
+    for (int y = y0; y <= y1; ++y) {
+        for (int x = x0; x <= x1; ++x) {
+            const int cell = y * m_columns + x;
+            for (int k = m_cellStart[cell]; k < m_cellStart[cell + 1]; ++k) {
+                const int index = m_indices[k];
+                const QPointF d = m_points[index] - pos;
+                const qreal distanceSquared = d.x() * d.x() + d.y() * d.y();
+                if (distanceSquared < bestSquared || (distanceSquared == bestSquared && result >= 0 && index < result)) {
+                    bestSquared = distanceSquared;
+                    result = index;
+                }
+            }
+        }
+    }
+    return result;
+}
+
+void PointGrid::query(const QRectF &rect, QVector<int> &result) const
+{
+    if (m_points.isEmpty() || rect.right() < m_bounds.left() || rect.left() > m_bounds.right()
+        || rect.bottom() < m_bounds.top() || rect.top() > m_bounds.bottom()) {
+        return;
+    }
+    const int x0 = cellX(rect.left());
+    const int x1 = cellX(rect.right());
+    const int y0 = cellY(rect.top());
+    const int y1 = cellY(rect.bottom());
+    for (int y = y0; y <= y1; ++y) {
+        for (int x = x0; x <= x1; ++x) {
+            const int cell = y * m_columns + x;
+            for (int k = m_cellStart[cell]; k < m_cellStart[cell + 1]; ++k) {
+                const int index = m_indices[k];
+                const QPointF &point = m_points[index];
+                if (point.x() >= rect.left() && point.x() <= rect.right()
+                    && point.y() >= rect.top() && point.y() <= rect.bottom()) {
+                    result.append(index);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,47 @@
+#ifndef POINT_GRID_H
+#define POINT_GRID_H
+
+#include <QPointF>
+#include <QRectF>
+#include <QVector>
+
+/**
+ * 点集的均匀网格索引，用于节点拾取和可见节点裁剪
+ * 按点的分布一次建好紧凑的格子表（每格的下标连续存放，格内按下标升序），
+ * 点集变化时整体重建；查询只访问范围覆盖的格子，不分配内存
+ */
+class PointGrid
+{
+public:
+    PointGrid() = default;
+
+    void build(const QVector<QPointF> &points);
+    void clear();
+
+    bool isEmpty() const { return m_points.isEmpty(); }
+    int count() const { return m_points.size(); }
+    // 所有点的包围盒
+    QRectF bounds() const { return m_bounds; }
+
+    // 与pos距离不超过maxDistance的点中下标最小的，没有时返回-1
+    int first(const QPointF &pos, qreal maxDistance) const;
+    // 与pos距离小于maxDistance的点中最近的（距离相同取下标小的），没有时返回-1
+    int nearest(const QPointF &pos, qreal maxDistance) const;
+    // 落在rect内的点的下标追加到result
+    void query(const QRectF &rect, QVector<int> &result) const;
+
+private:
+    int cellX(qreal x) const;
+    int cellY(qreal y) const;
+
+    QVector<QPointF> m_points;
+    QRectF m_bounds;
+    qreal m_cellSize = 1.0;
+    int m_columns = 0;
+    int m_rows = 0;
+    // 第c格的点下标为m_indices[m_cellStart[c] .. m_cellStart[c + 1])
+    QVector<int> m_cellStart;
+    QVector<int> m_indices;
+};
+
+#endif // POINT_GRID_H
@@ -0,0 +1,253 @@
+#include <QPair>
+#include <QtMath>
+#include <algorithm>
+#include "../core/polyline-simplifier.h"
+
+namespace {
+
+struct AreaEntry {
+    qreal area;
+    int index;
+};
+
+// 按面积排序的最小堆，面积和下标放在一起避免比较时间接访问；
+// 记录每个下标在堆中的位置，面积变化时原地调整
+class AreaHeap
+{
+public:
+    explicit AreaHeap(int count)
+        : m_position(count, -1)
+    {
+        m_heap.reserve(count);
+    }
+
+    bool isEmpty() const { return m_heap.isEmpty(); }
+    const AreaEntry &top() const { return m_heap.first(); }
+
+    void append(int index, qreal area)
+    {
+        m_position[index] = m_heap.size();
+        m_heap.append({area, index});
+    }
+
+    // append全部条目后建堆
+    void build()
+    {
+        for (int i = m_heap.size() / 2 - 1; i >= 0; --i) {
+            const AreaEntry entry = m_heap[i];
+            siftDown(i, entry);
+        }
+    }
+
+    void pop()
+    {
+        m_position[m_heap.first().index] = -1;
+        const AreaEntry last = m_heap.takeLast();
+        if (!m_heap.isEmpty()) {
+            siftDown(0, last);
+        }
+    }
+
+    void update(int index, qreal area)
+    {
+        const int position = m_position[index];
+        if (position < 0) {
+            return;
+        }
+        const AreaEntry entry{area, index};
+        if (position > 0 && less(entry, m_heap[(position - 1) / 2])) {
+            siftUp(position, entry);
+        } else {
+            siftDown(position, entry);
+        }
+    }
+
+private:
+    static bool less(const AreaEntry &a, const AreaEntry &b)
+    {
+        return a.area < b.area || (a.area == b.area && a.index < b.index);
+    }
+
+    void place(int position, const AreaEntry &entry)
+    {
+        m_heap[position] = entry;
+        m_position[entry.index] = position;
+    }
+
+    void siftUp(int position, const AreaEntry &entry)
+    {
+        while (position > 0) {
+            const int parent = (position - 1) / 2;
+            if (!less(entry, m_heap[parent])) {
+                break;
+            }
+            place(position, m_heap[parent]);
+            position = parent;
+        }
+        place(position, entry);
+    }
+
+    void siftDown(int position, const AreaEntry &entry)
+    {
+        const int size = m_heap.size();
+        while (true) {
+            int child = 2 * position + 1;
+            if (child >= size) {
+                break;
+            }
+            if (child + 1 < size && less(m_heap[child + 1], m_heap[child])) {
+                child++;
+            }
+            if (!less(m_heap[child], entry)) {
+                break;
+            }
+            place(position, m_heap[child]);
+            position = child;
+        }
+        place(position, entry);
+    }
+
+    QVector<AreaEntry> m_heap;
+    QVector<int> m_position;
+};
+
+}
+
+static void douglasPeucker(const QPointF *points, int count, qreal tolerance, QVector<char> &keep)
+{
+    const qreal toleranceSquared = tolerance * tolerance;
+    // 区间内各点的平方距离先写入临时数组，距离循环里没有分支，便于编译器向量化
+    QVector<qreal> distances(count);
+    qreal *distance = distances.data();
+
+    QVector<QPair<int, int>> ranges;
+    ranges.reserve(64);
+    ranges.append(qMakePair(0, count - 1));
+    while (!ranges.isEmpty()) {
+        const QPair<int, int> range = ranges.takeLast();
+        const int first = range.first + 1;
+        const int n = range.second - first;
+        if (n <= 0) {
+            continue;
+        }
+
+        const qreal ax = points[range.first].x();
+        const qreal ay = points[range.first].y();
+        const qreal sx = points[range.second].x() - ax;
+        const qreal sy = points[range.second].y() - ay;
+        const qreal lengthSquared = sx * sx + sy * sy;
+        const qreal inverse = lengthSquared > 0 ? 1.0 / lengthSquared : 0.0;
+        const QPointF *p = points + first;
+        for (int i = 0; i < n; ++i) {
+            const qreal px = p[i].x() - ax;
+            const qreal py = p[i].y() - ay;
+            // 投影参数限制在线段内，落在线段外时取端点
+            const qreal t = std::min(std::max((px * sx + py * sy) * inverse, 0.0), 1.0);
+            const qreal dx = px - t * sx;
+            const qreal dy = py - t * sy;
+            distance[i] = dx * dx + dy * dy;
+        }
+
+        int maxIndex = 0;
+        qreal maxDistance = distance[0];
+        for (int i = 1; i < n; ++i) {
+            if (distance[i] > maxDistance) {
+                maxDistance = distance[i];
+                maxIndex = i;
+            }
+        }
+        if (maxDistance > toleranceSquared) {
+            const int split = first + maxIndex;
+            keep[split] = 1;
+            ranges.append(qMakePair(range.first, split));
+            ranges.append(qMakePair(split, range.second));
+        }
+    }
+}
+
+static void visvalingamWhyatt(const QPointF *points, int count, qreal tolerance, QVector<char> &keep)
+{
+    auto triangleArea = [points](int a, int b, int c) {
+        const QPointF u = points[b] - points[a];
+        const QPointF v = points[c] - points[a];
+        return qAbs(u.x() * v.y() - u.y() * v.x()) * 0.5;
+    };
+
+    // 双向链表记录删点后的相邻关系
+    QVector<int> previous(count);
+    QVector<int> next(count);
+    for (int i = 0; i < count; ++i) {
+        previous[i] = i - 1;
+        next[i] = i + 1;
+    }
+    AreaHeap heap(count);
+    for (int i = 1; i < count - 1; ++i) {
+        heap.append(i, triangleArea(i - 1, i, i + 1));
+    }
+    heap.build();
+
+    const qreal threshold = tolerance * tolerance;
+    while (!heap.isEmpty()) {
+        const int index = heap.top().index;
+        const qreal removedArea = heap.top().area;
+        if (removedArea >= threshold) {
+            break;
+        }
+        heap.pop();
+
+        keep[index] = 0;
+        const int before = previous[index];
+        const int after = next[index];
+        next[before] = after;
+        previous[after] = before;
+
+        // 相邻点的有效面积不小于刚删除的点，保证删除顺序单调
+        for (int neighbor : {before, after}) {
+            if (neighbor <= 0 || neighbor >= count - 1) {
+                continue;
+            }
+            heap.update(neighbor, qMax(triangleArea(previous[neighbor], neighbor, next[neighbor]), removedArea));
+        }
+    }
+}
+
+QVector<int> PolylineSimplifier::simplify(const QPointF *points, int count, qreal tolerance,
+                                          PathEditor::SimplifyMethod method)
+{
+    QVector<int> kept;
+    if (count <= 2) {
+        for (int i = 0; i < count; ++i) {
+            kept.append(i);
+        }
+        return kept;
+    }
+
+    // Douglas-Peucker从只保留首尾开始加点，Visvalingam-Whyatt从全部保留开始删点
+    QVector<char> keep(count, method == PathEditor::DouglasPeucker ? 0 : 1);
+    keep[0] = 1;
+    keep[count - 1] = 1;
+    if (method == PathEditor::DouglasPeucker) {
+        douglasPeucker(points, count, tolerance, keep);
+    } else {
+        visvalingamWhyatt(points, count, tolerance, keep);
+    }
+
+    for (int i = 0; i < count; ++i) {
+        if (keep[i]) {
+            kept.append(i);
+        }
+    }
+    return kept;
+}
+
+QVector<QPointF> PolylineSimplifier::simplify(const QVector<QPointF> &points, qreal tolerance,
+                                              PathEditor::SimplifyMethod method)
+{
+    QVector<QPointF> result;
+    const QVector<int> kept = simplify(points.constData(), points.size(), tolerance, method);
+    result.reserve(kept.size());
+    for (int index : kept) {
+        result.append(points[index]);
+    }
+    return result;
+}
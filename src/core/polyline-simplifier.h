@@ -0,0 +1,25 @@
+#ifndef POLYLINE_SIMPLIFIER_H
+#define POLYLINE_SIMPLIFIER_H
+
+#include <QPointF>
+#include <QVector>
+#include "../core/patheditor.h"
+
+/**
+ * 折线简化内核
+ * 在连续的点数组上工作，只返回保留点的下标，不复制点数据：
+ * Douglas-Peucker用显式区间栈代替递归，Visvalingam-Whyatt用最小堆按有效面积逐个删除
+ */
+class PolylineSimplifier
+{
+public:
+    // 返回保留点的下标（升序，首尾两点总是保留）
+    // Douglas-Peucker：到保留折线的距离不超过tolerance；Visvalingam-Whyatt：删除有效面积小于tolerance²的点
+    static QVector<int> simplify(const QPointF *points, int count, qreal tolerance,
+                                 PathEditor::SimplifyMethod method = PathEditor::DouglasPeucker);
+
+    static QVector<QPointF> simplify(const QVector<QPointF> &points, qreal tolerance,
+                                     PathEditor::SimplifyMethod method = PathEditor::DouglasPeucker);
+};
+
+#endif // POLYLINE_SIMPLIFIER_H
@@ -0,0 +1,163 @@
+#include <QtMath>
+#include <algorithm>
+#include "../core/segment-bvh.h"
+
+// 叶子中的最多线段数
+static const int LEAF_SIZE = 8;
+// 按中位数二分，深度不超过log2(线段数)，64层足够
+static const int MAX_DEPTH = 64;
+static const int MAX_FLATTEN_STEPS = 1024;
+
+static qreal segmentDistanceSquared(const QPointF &pos, const QPointF &a, const QPointF &b)
+{
+    const qreal sx = b.x() - a.x();
+    const qreal sy = b.y() - a.y();
+    const qreal px = pos.x() - a.x();
+    const qreal py = pos.y() - a.y();
+    const qreal lengthSquared = sx * sx + sy * sy;
+    const qreal t = lengthSquared > 0 ? std::min(std::max((px * sx + py * sy) / lengthSquared, 0.0), 1.0) : 0.0;
+    const qreal dx = px - t * sx;
+    const qreal dy = py - t * sy;
+    return dx * dx + dy * dy;
+}
+
+void SegmentBvh::clear()
+{
+    m_segments.clear();
+    m_nodes.clear();
+}
+
+void SegmentBvh::build(const QPainterPath &path, qreal flattenTolerance)
+{
+    clear();
+    const qreal tolerance = qMax(flattenTolerance, 1e-6);
+
+    // 展平：直线原样保留，曲线的段数按二阶差分估计
+    m_segments.reserve(path.elementCount());
+    QPointF current;
+    for (int i = 0; i < path.elementCount(); ++i) {
+        const QPainterPath::Element &element = path.elementAt(i);
+        const QPointF point(element.x, element.y);
+        if (element.type == QPainterPath::MoveToElement) {
+            current = point;
+        } else if (element.type == QPainterPath::LineToElement) {
+            m_segments.append({current, point});
+            current = point;
+        } else if (element.type == QPainterPath::CurveToElement && i + 2 < path.elementCount()) {
+            const QPointF c1 = point;
+            const QPointF c2(path.elementAt(i + 1).x, path.elementAt(i + 1).y);
+            const QPointF end(path.elementAt(i + 2).x, path.elementAt(i + 2).y);
+            const QPointF dd1 = current - 2 * c1 + c2;
+            const QPointF dd2 = c1 - 2 * c2 + end;
+            const qreal dd = qMax(qSqrt(QPointF::dotProduct(dd1, dd1)), qSqrt(QPointF::dotProduct(dd2, dd2)));
+            const int steps = qBound(1, qCeil(qSqrt(0.75 * dd / tolerance)), MAX_FLATTEN_STEPS);
+            QPointF previous = current;
+            for (int step = 1; step <= steps; ++step) {
+                const qreal t = qreal(step) / steps;
+                const qreal u = 1.0 - t;
+                const QPointF next = step == steps ? end
+                    : current * (u * u * u) + c1 * (3 * u * u * t) + c2 * (3 * u * t * t) + end * (t * t * t);
+                m_segments.append({previous, next});
+                previous = next;
+            }
+            current = end;
+            i += 2;
+        }
+    }
+    if (m_segments.isEmpty()) {
+        return;
+    }
+
+    // 自顶向下建树：沿线段中点范围较长的轴按中位数分成两半
+    struct Range {
+        int node;
+        int begin;
+        int end;
+    };
+    QVector<Range> ranges;
+    ranges.reserve(MAX_DEPTH);
+    m_nodes.reserve(2 * (m_segments.size() / LEAF_SIZE + 1));
+    m_nodes.append(Node());
+    ranges.append({0, 0, m_segments.size()});
+    while (!ranges.isEmpty()) {
+        const Range range = ranges.takeLast();
+        Node node;
+        node.minX = node.minY = qInf();
+        node.maxX = node.maxY = -qInf();
+        qreal centerMinX = qInf();
+        qreal centerMinY = qInf();
+        qreal centerMaxX = -qInf();
+        qreal centerMaxY = -qInf();
+        for (int i = range.begin; i < range.end; ++i) {
+            const Segment &segment = m_segments[i];
+            node.minX = qMin(node.minX, qMin(segment.a.x(), segment.b.x()));
+            node.minY = qMin(node.minY, qMin(segment.a.y(), segment.b.y()));
+            node.maxX = qMax(node.maxX, qMax(segment.a.x(), segment.b.x()));
+            node.maxY = qMax(node.maxY, qMax(segment.a.y(), segment.b.y()));
+            const qreal centerX = segment.a.x() + segment.b.x();
+            const qreal centerY = segment.a.y() + segment.b.y();
+            centerMinX = qMin(centerMinX, centerX);
+            centerMinY = qMin(centerMinY, centerY);
+            centerMaxX = qMax(centerMaxX, centerX);
+            centerMaxY = qMax(centerMaxY, centerY);
+        }
+
+        const int count = range.end - range.begin;
+        if (count <= LEAF_SIZE) {
+            node.first = range.begin;
+            node.count = count;
+            m_nodes[range.node] = node;
+            continue;
+        }
+
+        const bool splitX = centerMaxX - centerMinX >= centerMaxY - centerMinY;
+        const int middle = range.begin + count / 2;
+        std::nth_element(m_segments.begin() + range.begin, m_segments.begin() + middle, m_segments.begin() + range.end,
+                         [splitX](const Segment &a, const Segment &b) {
+            return splitX ? a.a.x() + a.b.x() < b.a.x() + b.b.x()
+                          : a.a.y() + a.b.y() < b.a.y() + b.b.y();
+        });
+
+        node.first = m_nodes.size();
+        node.count = 0;
+        m_nodes[range.node] = node;
+        m_nodes.append(Node());
+        m_nodes.append(Node());
+        ranges.append({node.first, range.begin, middle});
+        ranges.append({node.first + 1, middle, range.end});
+    }
+}
+
+bool SegmentBvh::hitTest(const QPointF &pos, qreal threshold) const
+{
+    if (m_nodes.isEmpty()) {
+        return false;
+    }
+    const qreal thresholdSquared = threshold * threshold;
+    const Node *nodes = m_nodes.constData();
+    const Segment *segments = m_segments.constData();
+
+    int stack[MAX_DEPTH];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const Node &node = nodes[stack[--top]];
+        // 点到包围盒的距离超过阈值时整棵子树都不会命中
+        const qreal dx = qMax(qMax(node.minX - pos.x(), pos.x() - node.maxX), 0.0);
+        const qreal dy = qMax(qMax(node.minY - pos.y(), pos.y() - node.maxY), 0.0);
+        if (dx * dx + dy * dy > thresholdSquared) {
+            continue;
+        }
+        if (node.count > 0) {
+            for (int i = node.first; i < node.first + node.count; ++i) {
+                if (segmentDistanceSquared(pos, segments[i].a, segments[i].b) <= thresholdSquared) {
+                    return true;
+                }
+            }
+        } else if (top + 2 <= MAX_DEPTH) {
+            stack[top++] = node.first;
+            stack[top++] = node.first + 1;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,50 @@
+#ifndef SEGMENT_BVH_H
+#define SEGMENT_BVH_H
+
+#include <QPointF>
+#include <QVector>
+#include <QPainterPath>
+
+/**
+ * 路径线段的包围盒层次结构，用于命中测试
+ * 曲线按容差展平成线段后建树，节点和线段都放在连续数组里；
+ * 查询沿树下降，只对包围盒在阈值范围内的叶子做点到线段的距离测试，不分配内存
+ */
+class SegmentBvh
+{
+public:
+    // 展平曲线的默认容差（本地坐标）
+    static constexpr qreal DEFAULT_FLATTEN_TOLERANCE = 0.05;
+
+    SegmentBvh() = default;
+
+    void build(const QPainterPath &path, qreal flattenTolerance = DEFAULT_FLATTEN_TOLERANCE);
+    void clear();
+
+    bool isEmpty() const { return m_segments.isEmpty(); }
+    int segmentCount() const { return m_segments.size(); }
+
+    // pos到某条线段的距离不超过threshold
+    bool hitTest(const QPointF &pos, qreal threshold) const;
+
+private:
+    struct Segment {
+        QPointF a;
+        QPointF b;
+    };
+
+    // 叶子的count > 0，线段为[first, first + count)；内部节点的count为0，两个子节点为first和first + 1
+    struct Node {
+        qreal minX;
+        qreal minY;
+        qreal maxX;
+        qreal maxY;
+        int first;
+        int count;
+    };
+
+    QVector<Segment> m_segments;
+    QVector<Node> m_nodes;
+};
+
+#endif // SEGMENT_BVH_H
@@ -0,0 +1,67 @@
+#include <cmath>
+#include "../core/shape-render-cache.h"
+
+ShapeRenderCache *ShapeRenderCache::instance()
+{
+    static ShapeRenderCache cache;
+    return &cache;
+}
+
+ShapeRenderCache::ShapeRenderCache()
+    : m_tiles(DEFAULT_BUDGET_KB)
+{
+}
+
+void ShapeRenderCache::setBudget(int kilobytes)
+{
+    m_tiles.setMaxCost(qMax(0, kilobytes));
+}
+
+int ShapeRenderCache::zoomBucket(qreal scale)
+{
+    return qRound(std::log2(scale) * ZOOM_BUCKETS_PER_OCTAVE);
+}
+
+qreal ShapeRenderCache::bucketScale(int bucket)
+{
+    return std::exp2(qreal(bucket) / ZOOM_BUCKETS_PER_OCTAVE);
+}
+
+const ShapeRenderCache::Tile *ShapeRenderCache::find(const DrawingShape *shape, int bucket, quint32 style)
+{
+    return m_tiles.object(Key{ shape, bucket, style });
+}
+
+bool ShapeRenderCache::insert(const DrawingShape *shape, int bucket, quint32 style, const Tile &tile)
+{
+    // 代价按每像素4字节折算为KB
+    const qint64 cost = qMax<qint64>(1, qint64(tile.pixmap.width()) * tile.pixmap.height() * 4 / 1024);
+    if (cost > m_tiles.maxCost()) {
+        return false;
+    }
+
+    const Key key{ shape, bucket, style };
+    QVector<Key> &keys = m_keys[shape];
+    if (!keys.contains(key)) {
+        keys.append(key);
+    }
+    return m_tiles.insert(key, new Tile(tile), cost);
+}
+
+void ShapeRenderCache::remove(const DrawingShape *shape)
+{
+    QHash<const DrawingShape*, QVector<Key>>::iterator it = m_keys.find(shape);
+    if (it == m_keys.end()) {
+        return;
+    }
+    for (const Key &key : it.value()) {
+        m_tiles.remove(key);
+    }
+    m_keys.erase(it);
+}
+
+void ShapeRenderCache::clear()
+{
+    m_tiles.clear();
+    m_keys.clear();
+}
@@ -0,0 +1,71 @@
+#ifndef SHAPE_RENDER_CACHE_H
+#define SHAPE_RENDER_CACHE_H
+
+#include <QCache>
+#include <QHash>
+#include <QVector>
+#include <QPixmap>
+#include <QRectF>
+
+class DrawingShape;
+
+/**
+ * 图形栅格缓存 - 按图形、缩放档位和样式版本缓存渲染结果
+ * 缓存的图块在图形本地坐标系中，移动图形不需要重新渲染；画笔或画刷变化后样式版本不同，旧图块不会再命中；
+ * 缩放按1/4倍频程分档，内存超出预算时按最近最少使用淘汰
+ */
+class ShapeRenderCache
+{
+public:
+    // 缓存的图块，rect为图块覆盖的本地坐标范围
+    struct Tile {
+        QPixmap pixmap;
+        QRectF rect;
+    };
+
+    static const int DEFAULT_BUDGET_KB = 128 * 1024;
+    static const int ZOOM_BUCKETS_PER_OCTAVE = 4;
+    // 超过该边长（像素）的图块不缓存，直接绘制
+    static const int MAX_TILE_SIZE = 2048;
+
+    static ShapeRenderCache *instance();
+
+    void setBudget(int kilobytes);
+    int budget() const { return int(m_tiles.maxCost()); }
+    // 当前占用（KB）
+    int usage() const { return int(m_tiles.totalCost()); }
+    int tileCount() const { return int(m_tiles.size()); }
+
+    // 缩放比例对应的档位和档位的渲染比例
+    static int zoomBucket(qreal scale);
+    static qreal bucketScale(int bucket);
+
+    // 查找图块并标记为最近使用，返回的指针在下一次insert之前有效；style为图形的样式版本
+    const Tile *find(const DrawingShape *shape, int bucket, quint32 style);
+    // 超出预算的图块不会插入，返回false
+    bool insert(const DrawingShape *shape, int bucket, quint32 style, const Tile &tile);
+    // 删除图形的全部图块
+    void remove(const DrawingShape *shape);
+    void clear();
+
+private:
+    ShapeRenderCache();
+
+    struct Key {
+        const DrawingShape *shape;
+        int bucket;
+        quint32 style;
+
+        bool operator==(const Key &other) const
+        {
+            return shape == other.shape && bucket == other.bucket && style == other.style;
+        }
+    };
+    friend size_t qHash(const Key &key, size_t seed) { return qHashMulti(seed, key.shape, key.bucket, key.style); }
+
+    QCache<Key, Tile> m_tiles;
+    // 每个图形插入过的键，删除图形时据此清理
+    QHash<const DrawingShape*, QVector<Key>> m_keys;
+};
+
+#endif // SHAPE_RENDER_CACHE_H
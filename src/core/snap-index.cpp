@@ -0,0 +1,140 @@
+#include <cmath>
+#include "../core/snap-index.h"
+
+// 格子坐标的范围，超出的坐标（包括无穷大和NaN）落到边界格子
+static const qreal CELL_COORDINATE_LIMIT = 1.0e9;
+
+SnapIndex::SnapIndex(qreal cellSize)
+    : m_cellSize(cellSize > 0 ? cellSize : DEFAULT_CELL_SIZE)
+{
+}
+
+void SnapIndex::setPoints(DrawingShape *shape, const QVector<Point> &points)
+{
+    remove(shape);
+    if (!shape) {
+        return;
+    }
+
+    QVector<QPointF> &positions = m_shapePoints[shape];
+    positions.reserve(points.size());
+    for (const Point &point : points) {
+        m_cells[cellKey(point.pos)].append(point);
+        positions.append(point.pos);
+    }
+    m_pointCount += points.size();
+}
+
+void SnapIndex::remove(DrawingShape *shape)
+{
+    QHash<DrawingShape*, QVector<QPointF>>::iterator it = m_shapePoints.find(shape);
+    if (it == m_shapePoints.end()) {
+        return;
+    }
+
+    for (const QPointF &pos : it.value()) {
+        QHash<qint64, QVector<Point>>::iterator cell = m_cells.find(cellKey(pos));
+        if (cell == m_cells.end()) {
+            continue;
+        }
+
+        // 格子内顺序无关，用末尾元素覆盖被删除的点
+        QVector<Point> &cellPoints = cell.value();
+        for (int i = 0; i < cellPoints.size(); ++i) {
+            if (cellPoints[i].shape == shape) {
+                cellPoints[i] = cellPoints.last();
+                cellPoints.removeLast();
+                m_pointCount--;
+                break;
+            }
+        }
+        if (cellPoints.isEmpty()) {
+            m_cells.erase(cell);
+        }
+    }
+    m_shapePoints.erase(it);
+}
+
+void SnapIndex::clear()
+{
+    m_cells.clear();
+    m_shapePoints.clear();
+    m_pointCount = 0;
+}
+
+bool SnapIndex::nearest(const QPointF &pos, qreal maxDistance, const DrawingShape *exclude, Point &result) const
+{
+    if (!(maxDistance > 0) || m_cells.isEmpty()) {
+        return false;
+    }
+
+    qreal bestDistance = maxDistance * maxDistance;
+    bool found = false;
+    auto scan = [&](const QVector<Point> &cellPoints) {
+        for (const Point &point : cellPoints) {
+            if (point.shape == exclude) {
+                continue;
+            }
+            const qreal dx = point.pos.x() - pos.x();
+            const qreal dy = point.pos.y() - pos.y();
+            const qreal distance = dx * dx + dy * dy;
+            if (distance < bestDistance) {
+                bestDistance = distance;
+                result = point;
+                found = true;
+            }
+        }
+    };
+
+    const qint64 minX = cellCoordinate(pos.x() - maxDistance);
+    const qint64 maxX = cellCoordinate(pos.x() + maxDistance);
+    const qint64 minY = cellCoordinate(pos.y() - maxDistance);
+    const qint64 maxY = cellCoordinate(pos.y() + maxDistance);
+
+    // 容差覆盖的格子比已有的格子还多时直接遍历所有格子
+    if ((maxX - minX + 1) * (maxY - minY + 1) > m_cells.size()) {
+        for (const QVector<Point> &cellPoints : m_cells) {
+            scan(cellPoints);
+        }
+        return found;
+    }
+
+    for (qint64 cellX = minX; cellX <= maxX; ++cellX) {
+        for (qint64 cellY = minY; cellY <= maxY; ++cellY) {
+            QHash<qint64, QVector<Point>>::const_iterator cell = m_cells.constFind(cellKey(cellX, cellY));
+            if (cell != m_cells.constEnd()) {
+                scan(cell.value());
+            }
+        }
+    }
+    return found;
+}
+
+QVector<SnapIndex::Point> SnapIndex::points() const
+{
+    QVector<Point> result;
+    result.reserve(m_pointCount);
+    for (const QVector<Point> &cellPoints : m_cells) {
+        result += cellPoints;
+    }
+    return result;
+}
+
+qint64 SnapIndex::cellCoordinate(qreal value) const
+{
+    const qreal cell = std::floor(value / m_cellSize);
+    if (!(cell > -CELL_COORDINATE_LIMIT)) {
+        return qint64(-CELL_COORDINATE_LIMIT);
+    }
+    return qint64(qMin(cell, CELL_COORDINATE_LIMIT));
+}
+
+qint64 SnapIndex::cellKey(const QPointF &pos) const
+{
+    return cellKey(cellCoordinate(pos.x()), cellCoordinate(pos.y()));
+}
+
+qint64 SnapIndex::cellKey(qint64 cellX, qint64 cellY)
+{
+    return qint64((quint64(cellX) << 32) ^ (quint64(cellY) & 0xffffffffull));
+}
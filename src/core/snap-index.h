@@ -0,0 +1,56 @@
+#ifndef SNAP_INDEX_H
+#define SNAP_INDEX_H
+
+#include <QPointF>
+#include <QVector>
+#include <QHash>
+
+class DrawingShape;
+
+/**
+ * 对象吸附点的均匀网格索引
+ * 吸附点按场景坐标落入固定大小的格子，查询只检查容差范围覆盖的几个格子；
+ * 按图形整体替换或删除吸附点，图形移动时只更新它自己的点
+ */
+class SnapIndex
+{
+public:
+    struct Point {
+        QPointF pos;
+        int type = 0;                 // DrawingScene::ObjectSnapType
+        DrawingShape *shape = nullptr;
+    };
+
+    // 默认格子边长（场景坐标），远大于吸附容差，查询通常只涉及1到4个格子
+    static const int DEFAULT_CELL_SIZE = 64;
+
+    explicit SnapIndex(qreal cellSize = DEFAULT_CELL_SIZE);
+
+    // 替换图形的全部吸附点
+    void setPoints(DrawingShape *shape, const QVector<Point> &points);
+    void remove(DrawingShape *shape);
+    void clear();
+
+    bool contains(DrawingShape *shape) const { return m_shapePoints.contains(shape); }
+    int shapeCount() const { return m_shapePoints.size(); }
+    int pointCount() const { return m_pointCount; }
+
+    // 查找与pos距离小于maxDistance的最近吸附点，忽略exclude的点
+    bool nearest(const QPointF &pos, qreal maxDistance, const DrawingShape *exclude, Point &result) const;
+
+    // 全部吸附点，顺序不固定
+    QVector<Point> points() const;
+
+private:
+    qint64 cellKey(const QPointF &pos) const;
+    static qint64 cellKey(qint64 cellX, qint64 cellY);
+    qint64 cellCoordinate(qreal value) const;
+
+    qreal m_cellSize;
+    QHash<qint64, QVector<Point>> m_cells;
+    // 每个图形登记的点的位置，删除时据此找到所在的格子
+    QHash<DrawingShape*, QVector<QPointF>> m_shapePoints;
+    int m_pointCount = 0;
+};
+
+#endif // SNAP_INDEX_H
@@ -0,0 +1,127 @@
+#include "../core/style-table.h"
+#include "../core/drawing-shape.h"
+
+size_t StyleTable::styleHash(const QPen &pen, const QBrush &brush)
+{
+    // 只取常用属性，渐变、纹理和虚线不同的样式在比较时再区分
+    return qHashMulti(0, int(pen.style()), pen.widthF(), int(pen.capStyle()), int(pen.joinStyle()),
+                      pen.color().rgba(), int(pen.brush().style()), pen.isCosmetic(),
+                      int(brush.style()), brush.color().rgba());
+}
+
+int StyleTable::find(const QPen &pen, const QBrush &brush) const
+{
+    const size_t hash = styleHash(pen, brush);
+    for (QMultiHash<size_t, int>::const_iterator it = m_index.constFind(hash); it != m_index.constEnd() && it.key() == hash; ++it) {
+        const Record &record = m_records[it.value()];
+        if (record.pen == pen && record.brush == brush) {
+            return it.value();
+        }
+    }
+    return -1;
+}
+
+int StyleTable::intern(const QPen &pen, const QBrush &brush)
+{
+    const int existing = find(pen, brush);
+    if (existing >= 0) {
+        return existing;
+    }
+
+    int style;
+    if (!m_freeStyles.isEmpty()) {
+        style = m_freeStyles.takeLast();
+    } else {
+        style = m_records.size();
+        m_records.append(Record());
+    }
+    Record &record = m_records[style];
+    record.pen = pen;
+    record.brush = brush;
+    record.hash = styleHash(pen, brush);
+    m_index.insert(record.hash, style);
+    return style;
+}
+
+void StyleTable::attach(DrawingShape *shape, int style)
+{
+    QVector<DrawingShape*> &users = m_records[style].users;
+    shape->m_style = style;
+    shape->m_styleUser = users.size();
+    users.append(shape);
+}
+
+void StyleTable::detach(DrawingShape *shape)
+{
+    const int style = shape->m_style;
+    if (style < 0) {
+        return;
+    }
+    Record &record = m_records[style];
+    // 用最后一个使用者填补空位
+    DrawingShape *last = record.users.takeLast();
+    if (last != shape) {
+        record.users[shape->m_styleUser] = last;
+        last->m_styleUser = shape->m_styleUser;
+    }
+    shape->m_style = -1;
+    shape->m_styleUser = -1;
+
+    if (record.users.isEmpty()) {
+        m_index.remove(record.hash, style);
+        record.pen = QPen();
+        record.brush = QBrush();
+        record.users.squeeze();
+        m_freeStyles.append(style);
+    }
+}
+
+void StyleTable::assign(DrawingShape *shape, const QPen &pen, const QBrush &brush)
+{
+    if (shape->m_style >= 0) {
+        const Record &current = m_records[shape->m_style];
+        if (current.pen == pen && current.brush == brush) {
+            return;
+        }
+    }
+    // 先取得新样式再离开旧样式，新样式不会因为旧样式回收而失效
+    const int style = intern(pen, brush);
+    detach(shape);
+    attach(shape, style);
+}
+
+void StyleTable::release(DrawingShape *shape)
+{
+    detach(shape);
+}
+
+void StyleTable::setStyle(int style, const QPen &pen, const QBrush &brush)
+{
+    if (!isValid(style)) {
+        return;
+    }
+    Record &record = m_records[style];
+    if (record.pen == pen && record.brush == brush) {
+        return;
+    }
+
+    const QVector<DrawingShape*> users = record.users;
+    const int existing = find(pen, brush);
+    if (existing >= 0) {
+        // 已有相同样式时把使用者并过去，这条样式随最后一个使用者离开而回收
+        for (DrawingShape *shape : users) {
+            detach(shape);
+            attach(shape, existing);
+        }
+    } else {
+        m_index.remove(record.hash, style);
+        record.pen = pen;
+        record.brush = brush;
+        record.hash = styleHash(pen, brush);
+        m_index.insert(record.hash, style);
+    }
+
+    for (DrawingShape *shape : users) {
+        shape->styleChanged();
+    }
+}
@@ -0,0 +1,62 @@
+#ifndef STYLE_TABLE_H
+#define STYLE_TABLE_H
+
+#include <QPen>
+#include <QBrush>
+#include <QVector>
+#include <QMultiHash>
+
+class DrawingShape;
+
+/**
+ * 共享样式表 - 图形的填充和描边按值去重后只保存一份
+ * 每条样式记录一组画笔和画刷，以及使用它的图形列表；图形只保存样式编号和自己在列表中的位置。
+ * 修改一条样式时所有使用者一起更新，按样式选择图形只访问使用者列表。
+ * 没有使用者的样式立即回收，编号会被复用。每个文档一张表，由DrawingDocument持有
+ */
+class StyleTable
+{
+public:
+    StyleTable() = default;
+    StyleTable(const StyleTable &) = delete;
+    StyleTable &operator=(const StyleTable &) = delete;
+
+    // 让图形使用与pen和brush相同的样式，没有时新建
+    void assign(DrawingShape *shape, const QPen &pen, const QBrush &brush);
+    // 图形不再使用样式（图形析构时调用）
+    void release(DrawingShape *shape);
+
+    // 与pen和brush相同的样式编号，没有时返回-1
+    int find(const QPen &pen, const QBrush &brush) const;
+    // 修改样式，所有使用者重绘；与已有样式相同时合并到已有样式
+    void setStyle(int style, const QPen &pen, const QBrush &brush);
+
+    bool isValid(int style) const { return style >= 0 && style < m_records.size() && !m_records[style].users.isEmpty(); }
+    QPen pen(int style) const { return m_records[style].pen; }
+    QBrush brush(int style) const { return m_records[style].brush; }
+    // 使用该样式的全部图形，顺序不固定
+    const QVector<DrawingShape*> &users(int style) const { return m_records[style].users; }
+
+    // 正在使用的样式数
+    int styleCount() const { return m_records.size() - m_freeStyles.size(); }
+
+private:
+    struct Record {
+        QPen pen;
+        QBrush brush;
+        size_t hash = 0;
+        QVector<DrawingShape*> users;
+    };
+
+    static size_t styleHash(const QPen &pen, const QBrush &brush);
+    int intern(const QPen &pen, const QBrush &brush);
+    void attach(DrawingShape *shape, int style);
+    void detach(DrawingShape *shape);
+
+    QVector<Record> m_records;
+    QVector<int> m_freeStyles;
+    // 样式哈希到编号，哈希相同的再逐个比较
+    QMultiHash<size_t, int> m_index;
+};
+
+#endif // STYLE_TABLE_H
@@ -0,0 +1,269 @@
+#include <QIODevice>
+#include <QPainterPath>
+#include <QTransform>
+#include <QByteArray>
+#include <QtMath>
+#include <cmath>
+#include <cstring>
+#include "../core/svg-export-writer.h"
+
+// 10的幂，下标为小数位数
+static const double DECIMAL_SCALES[SvgExportWriter::MAX_PRECISION + 1] = {
+    1.0, 1.0e1, 1.0e2, 1.0e3, 1.0e4, 1.0e5, 1.0e6, 1.0e7, 1.0e8, 1.0e9
+};
+static const quint64 DECIMAL_UNITS[SvgExportWriter::MAX_PRECISION + 1] = {
+    1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull,
+    1000000ull, 10000000ull, 100000000ull, 1000000000ull
+};
+
+// 超过该值的数不能按定点换算为64位整数
+static const double FIXED_POINT_LIMIT = 9.0e18;
+
+SvgExportWriter::SvgExportWriter(QIODevice *device, int precision)
+    : m_xml(device)
+    , m_precision(precision < 0 ? DEFAULT_PRECISION : qMin(precision, MAX_PRECISION))
+{
+    m_xml.setAutoFormatting(true);
+    m_xml.setAutoFormattingIndent(2);
+}
+
+QString &SvgExportWriter::buffer()
+{
+    // resize(0)保留已分配的容量
+    m_buffer.resize(0);
+    return m_buffer;
+}
+
+void SvgExportWriter::writeNumber(const QString &name, qreal value)
+{
+    appendNumber(buffer(), value, m_precision);
+    writeBuffer(name);
+}
+
+void SvgExportWriter::writeColor(const QString &name, const QColor &color)
+{
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+    const int components[3] = { color.red(), color.green(), color.blue() };
+
+    char text[8];
+    text[0] = '#';
+    for (int i = 0; i < 3; ++i) {
+        text[1 + i * 2] = HEX_DIGITS[(components[i] >> 4) & 0xf];
+        text[2 + i * 2] = HEX_DIGITS[components[i] & 0xf];
+    }
+    buffer().append(QLatin1String(text, 7));
+    writeBuffer(name);
+}
+
+void SvgExportWriter::writePathData(const QString &name, const QPainterPath &path)
+{
+    appendPathData(buffer(), path, m_precision);
+    writeBuffer(name);
+}
+
+void SvgExportWriter::writePoints(const QString &name, const QVector<QPointF> &points, const QPointF &offset)
+{
+    QString &out = buffer();
+    for (int i = 0; i < points.size(); ++i) {
+        if (i > 0) {
+            out += QLatin1Char(' ');
+        }
+        appendNumber(out, offset.x() + points[i].x(), m_precision);
+        out += QLatin1Char(',');
+        appendNumber(out, offset.y() + points[i].y(), m_precision);
+    }
+    writeBuffer(name);
+}
+
+void SvgExportWriter::writeTransform(const QString &name, const QTransform &transform)
+{
+    if (transform.isIdentity()) {
+        return;
+    }
+    appendTransform(buffer(), transform, m_precision);
+    writeBuffer(name);
+}
+
+// 保留有效数字时对应的小数位数；需要科学计数法时返回-1
+static int significantDecimals(double magnitude)
+{
+    const int digits = SvgExportWriter::SIGNIFICANT_DIGITS;
+    int exponent = int(std::floor(std::log10(magnitude)));
+    // 舍入后进位到下一个数量级，例如999999.5
+    if (digits - 1 - exponent <= SvgExportWriter::MAX_PRECISION
+        && magnitude * DECIMAL_SCALES[qMax(0, digits - 1 - exponent)] + 0.5 >= DECIMAL_SCALES[digits]) {
+        ++exponent;
+    }
+    // 与'g'格式相同：指数小于-4或不小于有效位数时使用科学计数法
+    if (exponent < -4 || exponent >= digits) {
+        return -1;
+    }
+    return digits - 1 - exponent;
+}
+
+int SvgExportWriter::formatNumber(char *buffer, double value, int precision)
+{
+    if (!qIsFinite(value)) {
+        buffer[0] = '0';
+        return 1;
+    }
+
+    if (precision < 0) {
+        if (value == 0) {
+            buffer[0] = '0';
+            return 1;
+        }
+        precision = significantDecimals(qAbs(value));
+        if (precision < 0) {
+            // 极小或极大的数用科学计数法，QByteArray::number始终使用C区域
+            const QByteArray text = QByteArray::number(value, 'g', SIGNIFICANT_DIGITS);
+            const int length = qMin(int(text.size()), NUMBER_BUFFER_SIZE);
+            memcpy(buffer, text.constData(), length);
+            return length;
+        }
+    }
+    precision = qMin(precision, MAX_PRECISION);
+
+    const double scaled = qAbs(value) * DECIMAL_SCALES[precision] + 0.5;
+    if (scaled >= FIXED_POINT_LIMIT) {
+        // 极大的数退回到科学计数法，QByteArray::number始终使用C区域
+        QByteArray text = QByteArray::number(value, 'g', 17);
+        const int length = qMin(int(text.size()), NUMBER_BUFFER_SIZE);
+        memcpy(buffer, text.constData(), length);
+        return length;
+    }
+
+    const quint64 units = quint64(scaled);
+    quint64 integerPart = units / DECIMAL_UNITS[precision];
+    quint64 fractionPart = units % DECIMAL_UNITS[precision];
+
+    char *p = buffer;
+    // 舍入为0的负数不输出负号
+    if (value < 0 && units != 0) {
+        *p++ = '-';
+    }
+
+    char digits[20];
+    int digitCount = 0;
+    do {
+        digits[digitCount++] = char('0' + integerPart % 10);
+        integerPart /= 10;
+    } while (integerPart != 0);
+    while (digitCount > 0) {
+        *p++ = digits[--digitCount];
+    }
+
+    if (fractionPart != 0) {
+        // 去掉末尾的0
+        int fractionDigits = precision;
+        while (fractionPart % 10 == 0) {
+            fractionPart /= 10;
+            --fractionDigits;
+        }
+        *p++ = '.';
+        for (int i = fractionDigits - 1; i >= 0; --i) {
+            p[i] = char('0' + fractionPart % 10);
+            fractionPart /= 10;
+        }
+        p += fractionDigits;
+    }
+
+    return int(p - buffer);
+}
+
+void SvgExportWriter::appendNumber(QString &out, double value, int precision)
+{
+    char text[NUMBER_BUFFER_SIZE];
+    const int length = formatNumber(text, value, precision);
+    out.append(QLatin1String(text, length));
+}
+
+void SvgExportWriter::appendPathData(QString &out, const QPainterPath &path, int precision)
+{
+    const int count = path.elementCount();
+    bool first = true;
+
+    auto appendPoint = [&out, precision](const QPainterPath::Element &element) {
+        appendNumber(out, element.x, precision);
+        out += QLatin1Char(',');
+        appendNumber(out, element.y, precision);
+    };
+
+    for (int i = 0; i < count; ++i) {
+        const QPainterPath::Element &element = path.elementAt(i);
+
+        switch (element.type) {
+            case QPainterPath::MoveToElement:
+            case QPainterPath::LineToElement:
+                if (!first) {
+                    out += QLatin1Char(' ');
+                }
+                out += element.type == QPainterPath::MoveToElement ? QLatin1String("M ") : QLatin1String("L ");
+                appendPoint(element);
+                first = false;
+                break;
+            case QPainterPath::CurveToElement:
+                // 控制点和终点紧随其后
+                if (i + 2 < count) {
+                    if (!first) {
+                        out += QLatin1Char(' ');
+                    }
+                    out += QLatin1String("C ");
+                    appendPoint(element);
+                    out += QLatin1Char(' ');
+                    appendPoint(path.elementAt(i + 1));
+                    out += QLatin1Char(' ');
+                    appendPoint(path.elementAt(i + 2));
+                    first = false;
+                    i += 2; // 跳过已处理的元素
+                }
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+void SvgExportWriter::appendTransform(QString &out, const QTransform &transform, int precision)
+{
+    if (transform.isIdentity()) {
+        return;
+    }
+
+    // 简化实现：只处理基本的变换
+    bool first = true;
+    auto separate = [&out, &first]() {
+        if (!first) {
+            out += QLatin1Char(' ');
+        }
+        first = false;
+    };
+
+    // 检查平移
+    if (!qFuzzyIsNull(transform.dx()) || !qFuzzyIsNull(transform.dy())) {
+        separate();
+        out += QLatin1String("translate(");
+        appendNumber(out, transform.dx(), precision);
+        out += QLatin1Char(',');
+        appendNumber(out, transform.dy(), precision);
+        out += QLatin1Char(')');
+    }
+
+    // 检查旋转
+    if (!qFuzzyIsNull(transform.m12()) || !qFuzzyIsNull(transform.m21())) {
+        separate();
+        out += QLatin1String("rotate(");
+        appendNumber(out, qRadiansToDegrees(qAsin(transform.m21())), precision);
+        out += QLatin1Char(')');
+    }
+
+    // 检查缩放
+    if (!qFuzzyIsNull(transform.m11() - 1) || !qFuzzyIsNull(transform.m22() - 1)) {
+        separate();
+        out += QLatin1String("scale(");
+        appendNumber(out, transform.m11(), precision);
+        out += QLatin1Char(',');
+        appendNumber(out, transform.m22(), precision);
+        out += QLatin1Char(')');
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef SVG_EXPORT_WRITER_H
+#define SVG_EXPORT_WRITER_H
+
+#include <QString>
+#include <QColor>
+#include <QPointF>
+#include <QVector>
+#include <QXmlStreamWriter>
+
+class QIODevice;
+class QPainterPath;
+class QTransform;
+
+/**
+ * SVG导出写入器 - 元素直接流式写入QIODevice，不构建DOM
+ * 数值格式化与区域设置无关，默认与QString::number一样保留6位有效数字，也可指定固定小数位数；属性值使用同一个缓冲区拼接，
+ * 导出过程中不随元素数量产生新的字符串分配
+ */
+class SvgExportWriter
+{
+public:
+    // 默认保留有效数字（负数），0到MAX_PRECISION为固定的小数位数
+    static const int DEFAULT_PRECISION = -1;
+    static const int SIGNIFICANT_DIGITS = 6;
+    static const int MAX_PRECISION = 9;
+    // formatNumber所需的最小缓冲区长度
+    static const int NUMBER_BUFFER_SIZE = 32;
+
+    explicit SvgExportWriter(QIODevice *device, int precision = DEFAULT_PRECISION);
+
+    QXmlStreamWriter &xml() { return m_xml; }
+    int precision() const { return m_precision; }
+    bool hasError() const { return m_xml.hasError(); }
+
+    void writeStartElement(const QString &name) { m_xml.writeStartElement(name); }
+    void writeEndElement() { m_xml.writeEndElement(); }
+    void writeAttribute(const QString &name, const QString &value) { m_xml.writeAttribute(name, value); }
+
+    // 数值属性
+    void writeNumber(const QString &name, qreal value);
+    // 颜色属性，格式为#rrggbb
+    void writeColor(const QString &name, const QColor &color);
+    // 路径数据（d属性）
+    void writePathData(const QString &name, const QPainterPath &path);
+    // 点列表（points属性），每个点加上offset
+    void writePoints(const QString &name, const QVector<QPointF> &points, const QPointF &offset);
+    // 变换属性，单位变换不写出
+    void writeTransform(const QString &name, const QTransform &transform);
+
+    // 复用的属性缓冲区，调用方清空后拼接，再用writeBuffer写出
+    QString &buffer();
+    void writeBuffer(const QString &name) { m_xml.writeAttribute(name, m_buffer); }
+    void appendNumber(qreal value) { appendNumber(m_buffer, value, m_precision); }
+
+    // 格式化数值并去掉末尾的0，不依赖区域设置，返回写入的字符数
+    // precision为负时保留SIGNIFICANT_DIGITS位有效数字（同QString::number的'g'格式），否则按固定小数位
+    static int formatNumber(char *buffer, double value, int precision);
+    static void appendNumber(QString &out, double value, int precision);
+
+    // 路径数据和变换追加到out，out的容量可以在多次调用间复用
+    static void appendPathData(QString &out, const QPainterPath &path, int precision);
+    static void appendTransform(QString &out, const QTransform &transform, int precision);
+
+private:
+    QXmlStreamWriter m_xml;
+    int m_precision;
+    QString m_buffer;
+};
+
+#endif // SVG_EXPORT_WRITER_H
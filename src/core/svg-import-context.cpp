@@ -0,0 +1,110 @@
+#include <QGraphicsEffect>
+#include "../core/svg-import-context.h"
+
+SvgImportContext::SvgImportContext()
+{
+}
+
+SvgImportContext::~SvgImportContext()
+{
+    clear();
+}
+
+QString SvgImportContext::internId(const QString &id)
+{
+    QSet<QString>::const_iterator it = m_ids.constFind(id);
+    if (it != m_ids.constEnd()) {
+        return *it;
+    }
+    return *m_ids.insert(id);
+}
+
+void SvgImportContext::addGradient(const QString &id, const QGradient &gradient)
+{
+    // 设置渐变坐标模式为对象边界框模式，之后每个引用只复制画刷的引用计数
+    QGradient boundingGradient = gradient;
+    boundingGradient.setCoordinateMode(QGradient::ObjectBoundingMode);
+    m_gradients.insert(internId(id), QBrush(boundingGradient));
+}
+
+void SvgImportContext::addPattern(const QString &id, const QBrush &brush)
+{
+    m_patterns.insert(internId(id), brush);
+}
+
+bool SvgImportContext::findPaint(const QString &id, QBrush &brush) const
+{
+    QHash<QString, QBrush>::const_iterator it = m_gradients.constFind(id);
+    if (it != m_gradients.constEnd()) {
+        brush = it.value();
+        return true;
+    }
+
+    return findPattern(id, brush);
+}
+
+bool SvgImportContext::findPattern(const QString &id, QBrush &brush) const
+{
+    QHash<QString, QBrush>::const_iterator it = m_patterns.constFind(id);
+    if (it != m_patterns.constEnd()) {
+        brush = it.value();
+        return true;
+    }
+    return false;
+}
+
+void SvgImportContext::addFilter(const QString &id, QGraphicsEffect *effect)
+{
+    QString key = internId(id);
+    delete m_filters.value(key, nullptr);
+    m_filters.insert(key, effect);
+}
+
+QGraphicsEffect* SvgImportContext::filter(const QString &id) const
+{
+    return m_filters.value(id, nullptr);
+}
+
+void SvgImportContext::addMarker(const QString &id, const QDomElement &element, const QPixmap &pixmap)
+{
+    Marker marker;
+    marker.element = element;
+    marker.pixmap = pixmap;
+    m_markers.insert(internId(id), marker);
+}
+
+bool SvgImportContext::hasMarker(const QString &id) const
+{
+    return m_markers.contains(id);
+}
+
+QDomElement SvgImportContext::markerElement(const QString &id) const
+{
+    return m_markers.value(id).element;
+}
+
+QPixmap SvgImportContext::markerPixmap(const QString &id) const
+{
+    return m_markers.value(id).pixmap;
+}
+
+void SvgImportContext::addDefinedElement(const QString &id, const QDomElement &element)
+{
+    m_definedElements.insert(internId(id), element);
+}
+
+QDomElement SvgImportContext::definedElement(const QString &id) const
+{
+    return m_definedElements.value(id);
+}
+
+void SvgImportContext::clear()
+{
+    qDeleteAll(m_filters);
+    m_filters.clear();
+    m_gradients.clear();
+    m_patterns.clear();
+    m_markers.clear();
+    m_definedElements.clear();
+    m_ids.clear();
+}
@@ -0,0 +1,66 @@
+#ifndef SVG_IMPORT_CONTEXT_H
+#define SVG_IMPORT_CONTEXT_H
+
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QBrush>
+#include <QGradient>
+#include <QPixmap>
+#include <QDomElement>
+
+class QGraphicsEffect;
+
+/**
+ * SVG导入上下文 - 保存一次导入中解析出的资源定义
+ * 由每次导入调用独立持有，多个文档可以同时导入，资源不会残留到下一个文件
+ * id统一驻留，渐变和Pattern画刷只构造一次，所有引用共享同一份数据
+ */
+class SvgImportContext
+{
+public:
+    SvgImportContext();
+    ~SvgImportContext();
+
+    // 返回上下文中保存的同值id，重复引用共享同一份字符串数据
+    QString internId(const QString &id);
+
+    // 渐变按对象边界框模式预先构造为画刷
+    void addGradient(const QString &id, const QGradient &gradient);
+    void addPattern(const QString &id, const QBrush &brush);
+    // 查找渐变或Pattern画刷（渐变优先），找不到时返回false
+    bool findPaint(const QString &id, QBrush &brush) const;
+    bool findPattern(const QString &id, QBrush &brush) const;
+
+    // 滤镜原型由上下文持有，应用到图形时需要克隆
+    void addFilter(const QString &id, QGraphicsEffect *effect);
+    QGraphicsEffect* filter(const QString &id) const;
+
+    void addMarker(const QString &id, const QDomElement &element, const QPixmap &pixmap);
+    bool hasMarker(const QString &id) const;
+    QDomElement markerElement(const QString &id) const;
+    QPixmap markerPixmap(const QString &id) const;
+
+    // use元素可引用的元素
+    void addDefinedElement(const QString &id, const QDomElement &element);
+    QDomElement definedElement(const QString &id) const;
+
+    void clear();
+
+private:
+    Q_DISABLE_COPY(SvgImportContext)
+
+    struct Marker {
+        QDomElement element;
+        QPixmap pixmap;
+    };
+
+    QSet<QString> m_ids;
+    QHash<QString, QBrush> m_gradients;
+    QHash<QString, QBrush> m_patterns;
+    QHash<QString, QGraphicsEffect*> m_filters;
+    QHash<QString, Marker> m_markers;
+    QHash<QString, QDomElement> m_definedElements;
+};
+
+#endif // SVG_IMPORT_CONTEXT_H
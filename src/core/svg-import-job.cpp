@@ -0,0 +1,400 @@
+#include <QFile>
+#include <QCoreApplication>
+#include <QTimer>
+#include <QThread>
+#include <QElapsedTimer>
+#include <QXmlStreamReader>
+#include <QDebug>
+#include "../core/svg-import-job.h"
+#include "../ui/drawingscene.h"
+#include "../core/drawing-shape.h"
+#include "../core/drawing-layer.h"
+#include "../core/drawing-group.h"
+
+// 每个分片最多包含的直接子元素数
+static const int UNIT_ELEMENT_COUNT = 256;
+
+// GUI线程每批创建图形的时间预算（毫秒），超出后让出事件循环
+static const int BATCH_TIME_BUDGET = 12;
+
+SvgImportJob::SvgImportJob(DrawingScene *scene, QObject *parent)
+    : QObject(parent)
+    , m_scene(scene)
+    , m_cancelled(0)
+{
+    // 加载线程常驻一个线程，其余线程用于解析分片
+    m_pool.setMaxThreadCount(qMax(2, QThread::idealThreadCount()));
+
+    m_batchTimer = new QTimer(this);
+    m_batchTimer->setSingleShot(true);
+    m_batchTimer->setInterval(0);
+    connect(m_batchTimer, &QTimer::timeout, this, &SvgImportJob::applyPendingUnits);
+}
+
+SvgImportJob::~SvgImportJob()
+{
+    // 工作线程会回调this，必须等它们结束
+    m_cancelled.storeRelaxed(1);
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+bool SvgImportJob::start(const QString &fileName)
+{
+    if (m_running) {
+        return false;
+    }
+
+    if (!QFile::exists(fileName)) {
+        qDebug() << "无法打开SVG文件:" << fileName;
+        return false;
+    }
+
+    // 同一任务可以再次导入：先等上一次取消后仍在运行的线程结束，
+    // 丢弃它们已投递但尚未处理的回调，再重置全部导入状态
+    m_pool.waitForDone();
+    QCoreApplication::removePostedEvents(this, QEvent::MetaCall);
+    m_cancelled.storeRelaxed(0);
+    m_context.clear();
+    m_units.clear();
+    m_nextUnit = 0;
+    m_nextOperation = 0;
+    m_unitStarted = false;
+    m_frames.clear();
+    m_topFrame = Frame();
+    m_definitionsReady = false;
+    m_loadFinished = false;
+    m_doneElements = 0;
+    m_totalElements = 0;
+    m_shapeCount = 0;
+
+    m_running = true;
+    m_pool.start([this, fileName]() { loadFile(fileName); });
+    return true;
+}
+
+void SvgImportJob::cancel()
+{
+    if (!m_running) {
+        return;
+    }
+
+    // 未开始的分片直接丢弃，正在运行的任务检查标志后尽快返回
+    m_cancelled.storeRelaxed(1);
+    m_pool.clear();
+    m_batchTimer->stop();
+    finish(false);
+}
+
+void SvgImportJob::loadFile(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qDebug() << "无法打开SVG文件:" << fileName;
+        QMetaObject::invokeMethod(this, [this]() { loadFinished(false); }, Qt::QueuedConnection);
+        return;
+    }
+
+    // 第一遍：收集defs和被use引用的元素，资源在GUI线程解析（Pattern和Marker需要绘制像素图）
+    QSharedPointer<QDomDocument> defsDoc(new QDomDocument);
+    QDomElement defsRoot = defsDoc->createElement("svg");
+    defsDoc->appendChild(defsRoot);
+    if (!SvgHandler::collectStreamDefinitions(m_context, &file, *defsDoc, defsRoot)) {
+        QMetaObject::invokeMethod(this, [this]() { loadFinished(false); }, Qt::QueuedConnection);
+        return;
+    }
+    QMetaObject::invokeMethod(this, [this, defsDoc]() { definitionsLoaded(defsDoc); }, Qt::QueuedConnection);
+
+    if (!file.seek(0)) {
+        qDebug() << "无法重新定位SVG文件";
+        QMetaObject::invokeMethod(this, [this]() { loadFinished(false); }, Qt::QueuedConnection);
+        return;
+    }
+
+    // 第二遍：把顶层<g>的直接子元素和根元素下的图形切分为分片，边读边交给线程池
+    QXmlStreamReader reader(&file);
+    reader.setNamespaceProcessing(false);
+
+    QSharedPointer<Unit> unit;
+    int topGroup = -1;
+    int topGroupCount = 0;
+    bool rootSeen = false;
+
+    auto postUnit = [this, &unit]() {
+        if (unit) {
+            QSharedPointer<Unit> loaded = unit;
+            QMetaObject::invokeMethod(this, [this, loaded]() { unitLoaded(loaded); }, Qt::QueuedConnection);
+            unit.reset();
+        }
+    };
+    auto createUnit = [&unit, &topGroup]() {
+        unit.reset(new Unit);
+        unit->topGroup = topGroup;
+        unit->container = unit->document.createElement("g");
+        unit->document.appendChild(unit->container);
+    };
+
+    while (!reader.atEnd() && !m_cancelled.loadRelaxed()) {
+        QXmlStreamReader::TokenType token = reader.readNext();
+
+        if (token == QXmlStreamReader::EndElement) {
+            // 非顶层组的元素都已整体读取或跳过，这里只会遇到顶层</g>和</svg>
+            if (topGroup < 0) {
+                break;
+            }
+            postUnit();
+            topGroup = -1;
+            continue;
+        }
+
+        if (token != QXmlStreamReader::StartElement) {
+            continue;
+        }
+
+        if (!rootSeen) {
+            rootSeen = true;
+            continue;
+        }
+
+        QString tagName = reader.qualifiedName().toString();
+
+        if (topGroup < 0 && tagName == "g") {
+            // 顶层组只读取属性，子元素继续切分
+            postUnit();
+            QDomDocument groupDoc;
+            QDomElement groupElement = SvgHandler::readStreamElement(reader, groupDoc, false);
+            topGroup = topGroupCount++;
+            createUnit();
+            unit->opensGroup = true;
+            unit->group = SvgHandler::parseGroupRecord(groupElement);
+            continue;
+        }
+
+        // defs已在第一遍处理，其他非图形元素不会生成图形
+        if (tagName == "defs" || (tagName != "g" && !SvgHandler::isStreamShapeTag(tagName))) {
+            reader.skipCurrentElement();
+            continue;
+        }
+
+        if (!unit || unit->elementCount >= UNIT_ELEMENT_COUNT) {
+            postUnit();
+            createUnit();
+        }
+        // 嵌套组连同子元素整体放入分片
+        unit->container.appendChild(SvgHandler::readStreamElement(reader, unit->document));
+        unit->elementCount++;
+    }
+    postUnit();
+
+    bool success = !reader.hasError();
+    if (!success) {
+        qDebug() << "解析SVG文件失败:" << reader.errorString()
+                 << "行:" << reader.lineNumber() << "列:" << reader.columnNumber();
+    }
+    QMetaObject::invokeMethod(this, [this, success]() { loadFinished(success); }, Qt::QueuedConnection);
+}
+
+void SvgImportJob::parseUnit(Unit &unit)
+{
+    // 只生成记录，不接触场景；分片文档此时只由当前线程访问
+    for (QDomElement element = unit.container.firstChildElement(); !element.isNull();
+         element = element.nextSiblingElement()) {
+        if (m_cancelled.loadRelaxed()) {
+            return;
+        }
+        appendOperations(element, unit.operations);
+    }
+}
+
+void SvgImportJob::appendOperations(const QDomElement &element, QVector<Operation> &operations)
+{
+    if (element.tagName() == "g") {
+        Operation begin;
+        begin.type = Operation::BeginGroup;
+        begin.group = SvgHandler::parseGroupRecord(element);
+        operations.append(begin);
+
+        for (QDomElement child = element.firstChildElement(); !child.isNull();
+             child = child.nextSiblingElement()) {
+            appendOperations(child, operations);
+        }
+
+        Operation end;
+        end.type = Operation::EndGroup;
+        operations.append(end);
+        return;
+    }
+
+    Operation operation;
+    operation.type = Operation::Shape;
+    try {
+        if (SvgHandler::parseShapeRecord(element, operation.shape)) {
+            operations.append(operation);
+        }
+    } catch (...) {
+        // qDebug() << "解析元素时发生错误:" << element.tagName() << "，跳过";
+    }
+}
+
+void SvgImportJob::definitionsLoaded(QSharedPointer<QDomDocument> defsDoc)
+{
+    if (!m_running) {
+        return;
+    }
+
+    // 资源定义与DOM和流式导入共用同一套函数
+    SvgHandler::parseResourceDefinitions(m_context, defsDoc->documentElement());
+    m_definitionsReady = true;
+    m_batchTimer->start();
+}
+
+void SvgImportJob::unitLoaded(QSharedPointer<Unit> unit)
+{
+    if (!m_running) {
+        return;
+    }
+
+    m_units.append(unit);
+    m_totalElements += unit->elementCount;
+    emit progress(m_doneElements, m_totalElements);
+
+    m_pool.start([this, unit]() {
+        parseUnit(*unit);
+        QMetaObject::invokeMethod(this, [this, unit]() { unitParsed(unit); }, Qt::QueuedConnection);
+    });
+}
+
+void SvgImportJob::unitParsed(QSharedPointer<Unit> unit)
+{
+    if (!m_running) {
+        return;
+    }
+
+    unit->parsed = true;
+    if (!m_batchTimer->isActive()) {
+        m_batchTimer->start();
+    }
+}
+
+void SvgImportJob::loadFinished(bool success)
+{
+    if (!m_running) {
+        return;
+    }
+
+    if (!success) {
+        m_pool.clear();
+        m_batchTimer->stop();
+        finish(false);
+        return;
+    }
+
+    m_loadFinished = true;
+    if (!m_batchTimer->isActive()) {
+        m_batchTimer->start();
+    }
+}
+
+void SvgImportJob::applyPendingUnits()
+{
+    if (!m_running || !m_definitionsReady) {
+        return;
+    }
+
+    // 分片可能乱序完成，只按文档顺序回放，保证图形的层叠顺序与文件一致
+    QElapsedTimer budget;
+    budget.start();
+
+    while (m_nextUnit < m_units.size() && m_units[m_nextUnit]->parsed) {
+        const Unit &unit = *m_units[m_nextUnit];
+        if (!m_unitStarted) {
+            beginUnit(unit);
+            m_unitStarted = true;
+        }
+
+        while (m_nextOperation < unit.operations.size()) {
+            applyOperation(unit.operations[m_nextOperation++]);
+            if (budget.elapsed() >= BATCH_TIME_BUDGET) {
+                emit progress(m_doneElements, m_totalElements);
+                m_batchTimer->start();
+                return;
+            }
+        }
+
+        // 回放完的分片立即释放
+        m_doneElements += unit.elementCount;
+        m_units[m_nextUnit].reset();
+        m_nextUnit++;
+        m_nextOperation = 0;
+        m_unitStarted = false;
+    }
+
+    emit progress(m_doneElements, m_totalElements);
+
+    if (m_loadFinished && m_nextUnit == m_units.size()) {
+        finish(m_shapeCount > 0);
+    }
+}
+
+void SvgImportJob::beginUnit(const Unit &unit)
+{
+    m_frames.clear();
+    if (unit.topGroup < 0) {
+        return;
+    }
+
+    // 同一顶层组的后续分片沿用第一个分片创建的图层或组
+    if (unit.opensGroup) {
+        m_topFrame = Frame();
+        SvgHandler::beginGroupRecord(m_scene, m_context, unit.group, nullptr, m_topFrame.layer, m_topFrame.group);
+    }
+    m_frames.append(m_topFrame);
+}
+
+void SvgImportJob::applyOperation(const Operation &operation)
+{
+    switch (operation.type) {
+    case Operation::BeginGroup: {
+        // 图层中的组直接放到场景，与parseGroupElement一致
+        QGraphicsItem *parentItem = m_frames.isEmpty() ? nullptr : m_frames.last().group;
+        Frame frame;
+        SvgHandler::beginGroupRecord(m_scene, m_context, operation.group, parentItem, frame.layer, frame.group);
+        m_frames.append(frame);
+        break;
+    }
+    case Operation::EndGroup:
+        m_frames.removeLast();
+        break;
+    case Operation::Shape: {
+        DrawingShape *shape = nullptr;
+        try {
+            shape = SvgHandler::createShapeFromRecord(m_context, operation.shape);
+        } catch (...) {
+            // qDebug() << "创建图形时发生错误，跳过";
+        }
+        if (!shape) {
+            break;
+        }
+
+        if (m_frames.isEmpty()) {
+            m_scene->addItem(shape);
+        } else {
+            SvgHandler::addParsedShape(m_scene, shape, m_frames.last().layer, m_frames.last().group);
+        }
+        m_shapeCount++;
+        break;
+    }
+    }
+}
+
+void SvgImportJob::finish(bool success)
+{
+    if (!m_running) {
+        return;
+    }
+
+    m_running = false;
+    m_units.clear();
+    m_frames.clear();
+    emit finished(success);
+}
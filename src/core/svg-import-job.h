@@ -0,0 +1,111 @@
+#ifndef SVG_IMPORT_JOB_H
+#define SVG_IMPORT_JOB_H
+
+#include <QObject>
+#include <QAtomicInt>
+#include <QThreadPool>
+#include <QSharedPointer>
+#include <QVector>
+#include <QDomDocument>
+#include <QDomElement>
+#include "../core/svghandler.h"
+#include "../core/svg-import-context.h"
+
+class QTimer;
+class DrawingScene;
+class DrawingLayer;
+class DrawingGroup;
+
+/**
+ * 并行SVG导入任务
+ * 加载线程流式读取文件并切分为分片，线程池把分片解析为图形记录，
+ * GUI线程按文档顺序分批创建图形，期间事件循环保持响应
+ */
+class SvgImportJob : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SvgImportJob(DrawingScene *scene, QObject *parent = nullptr);
+    ~SvgImportJob();
+
+    // 开始导入，文件无法打开时返回false；结束或取消后可以再次调用
+    bool start(const QString &fileName);
+
+    // 取消导入，已创建的图形保留在场景中
+    void cancel();
+
+    bool isRunning() const { return m_running; }
+    bool isCancelled() const { return m_cancelled.loadRelaxed() != 0; }
+    int shapeCount() const { return m_shapeCount; }
+
+signals:
+    // done为已创建的元素数，total为已读取的元素数（文件读完前会继续增长）
+    void progress(int done, int total);
+    void finished(bool success);
+
+private:
+    // 回放操作：组的开始、结束和图形，按文档顺序排列
+    struct Operation {
+        enum Type { BeginGroup, EndGroup, Shape };
+        Type type = Shape;
+        SvgGroupRecord group;
+        SvgShapeRecord shape;
+    };
+
+    // 工作分片：顶层<g>的一段直接子元素，或根元素下的一段图形元素
+    struct Unit {
+        int topGroup = -1;            // 所属顶层组的序号，-1表示直接位于根元素下
+        bool opensGroup = false;      // 顶层组的第一个分片负责创建组
+        SvgGroupRecord group;
+        QDomDocument document;        // 每个分片独占一个文档，线程间依次移交
+        QDomElement container;
+        int elementCount = 0;
+        QVector<Operation> operations;
+        bool parsed = false;
+    };
+
+    struct Frame {
+        DrawingLayer *layer = nullptr;
+        DrawingGroup *group = nullptr;
+    };
+
+    // 加载线程
+    void loadFile(const QString &fileName);
+    // 工作线程
+    void parseUnit(Unit &unit);
+    void appendOperations(const QDomElement &element, QVector<Operation> &operations);
+
+    // GUI线程
+    void definitionsLoaded(QSharedPointer<QDomDocument> defsDoc);
+    void unitLoaded(QSharedPointer<Unit> unit);
+    void unitParsed(QSharedPointer<Unit> unit);
+    void loadFinished(bool success);
+    void applyPendingUnits();
+    void beginUnit(const Unit &unit);
+    void applyOperation(const Operation &operation);
+    void finish(bool success);
+
+    DrawingScene *m_scene;
+    // 第一遍由加载线程写入定义表，definitionsLoaded之后只在GUI线程访问
+    SvgImportContext m_context;
+    QThreadPool m_pool;
+    QAtomicInt m_cancelled;
+    QTimer *m_batchTimer;
+
+    QVector<QSharedPointer<Unit>> m_units;
+    int m_nextUnit = 0;
+    int m_nextOperation = 0;
+    bool m_unitStarted = false;
+    QVector<Frame> m_frames;
+    Frame m_topFrame;
+
+    bool m_running = false;
+    bool m_definitionsReady = false;
+    bool m_loadFinished = false;
+    int m_doneElements = 0;
+    int m_totalElements = 0;
+    int m_shapeCount = 0;
+};
+
+#endif // SVG_IMPORT_JOB_H
@@ -0,0 +1,470 @@
+#include <qmath.h>
+#include "../core/svg-path-parser.h"
+
+namespace {
+
+// 10的幂，快速路径只用到1e22（这些值都能被double精确表示）
+const double kPowersOf10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+inline bool isPathSpace(char16_t c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f';
+}
+
+inline bool isPathDigit(char16_t c)
+{
+    return c >= '0' && c <= '9';
+}
+
+inline bool isPathCommand(char16_t c)
+{
+    switch (c) {
+    case 'M': case 'm': case 'L': case 'l': case 'H': case 'h': case 'V': case 'v':
+    case 'C': case 'c': case 'S': case 's': case 'Q': case 'q': case 'T': case 't':
+    case 'A': case 'a': case 'Z': case 'z':
+        return true;
+    default:
+        return false;
+    }
+}
+
+inline char16_t toUpperCommand(char16_t c)
+{
+    return (c >= 'a' && c <= 'z') ? char16_t(c - ('a' - 'A')) : c;
+}
+
+/**
+ * 路径数据游标 - 直接在原始字符上前进，不复制任何子串
+ */
+class PathCursor
+{
+public:
+    explicit PathCursor(QStringView data)
+        : m_pos(data.utf16())
+        , m_end(data.utf16() + data.size())
+    {
+    }
+
+    bool atEnd() const { return m_pos >= m_end; }
+    char16_t peek() const { return *m_pos; }
+    void advance() { ++m_pos; }
+
+    // 跳过参数之间的空白和逗号
+    void skipSeparators()
+    {
+        while (m_pos < m_end && (isPathSpace(*m_pos) || *m_pos == ',')) {
+            ++m_pos;
+        }
+    }
+
+    bool atNumberStart() const
+    {
+        if (m_pos >= m_end) {
+            return false;
+        }
+        char16_t c = *m_pos;
+        return isPathDigit(c) || c == '-' || c == '+' || c == '.';
+    }
+
+    // 解析一个数字：符号、整数、小数和指数部分
+    bool readNumber(qreal &value)
+    {
+        skipSeparators();
+
+        const char16_t *start = m_pos;
+        const char16_t *p = m_pos;
+        bool negative = false;
+        if (p < m_end && (*p == '-' || *p == '+')) {
+            negative = (*p == '-');
+            ++p;
+        }
+
+        quint64 mantissa = 0;
+        int significantDigits = 0;
+        int exponent = 0;
+        bool anyDigit = false;
+        bool truncated = false;
+
+        // 整数部分
+        while (p < m_end && isPathDigit(*p)) {
+            anyDigit = true;
+            int digit = *p - '0';
+            if (significantDigits < 19) {
+                mantissa = mantissa * 10 + digit;
+                if (mantissa != 0) {
+                    ++significantDigits;
+                }
+            } else {
+                ++exponent;
+                truncated = true;
+            }
+            ++p;
+        }
+
+        // 小数部分
+        if (p < m_end && *p == '.') {
+            ++p;
+            while (p < m_end && isPathDigit(*p)) {
+                anyDigit = true;
+                int digit = *p - '0';
+                if (significantDigits < 19) {
+                    mantissa = mantissa * 10 + digit;
+                    if (mantissa != 0) {
+                        ++significantDigits;
+                    }
+                    --exponent;
+                } else {
+                    truncated = true;
+                }
+                ++p;
+            }
+        }
+
+        if (!anyDigit) {
+            return false;
+        }
+
+        // 指数部分，'e'后面必须有数字，否则不属于这个数字
+        if (p < m_end && (*p == 'e' || *p == 'E')) {
+            const char16_t *expStart = p;
+            ++p;
+            bool expNegative = false;
+            if (p < m_end && (*p == '-' || *p == '+')) {
+                expNegative = (*p == '-');
+                ++p;
+            }
+            if (p < m_end && isPathDigit(*p)) {
+                int expValue = 0;
+                while (p < m_end && isPathDigit(*p)) {
+                    if (expValue < 10000) {
+                        expValue = expValue * 10 + (*p - '0');
+                    }
+                    ++p;
+                }
+                exponent += expNegative ? -expValue : expValue;
+            } else {
+                p = expStart;
+            }
+        }
+
+        m_pos = p;
+
+        // 快速路径：尾数和10的幂都能精确表示时，一次乘除即为正确舍入的结果
+        if (!truncated && significantDigits <= 15 && exponent >= -22 && exponent <= 22) {
+            double result = double(mantissa);
+            result = exponent < 0 ? result / kPowersOf10[-exponent] : result * kPowersOf10[exponent];
+            value = negative ? -result : result;
+            return true;
+        }
+
+        // 罕见的长数字交给Qt的转换（使用栈上缓冲区，同样不分配堆内存）
+        bool ok = false;
+        value = QStringView(start, p - start).toDouble(&ok);
+        return ok;
+    }
+
+    // 解析椭圆弧的标志位，标志位只有一个字符，可以和后面的数字紧挨着
+    bool readFlag(bool &flag)
+    {
+        skipSeparators();
+        if (m_pos < m_end && (*m_pos == '0' || *m_pos == '1')) {
+            flag = (*m_pos == '1');
+            ++m_pos;
+            return true;
+        }
+        return false;
+    }
+
+    bool readPoint(QPointF &point)
+    {
+        qreal x, y;
+        if (!readNumber(x) || !readNumber(y)) {
+            return false;
+        }
+        point = QPointF(x, y);
+        return true;
+    }
+
+private:
+    const char16_t *m_pos;
+    const char16_t *m_end;
+};
+
+} // namespace
+
+bool SvgPathParser::parse(QStringView data, QPainterPath &path)
+{
+    PathCursor cursor(data);
+
+    // 预留元素空间，按平均每8个字符一个元素估算
+    path.reserve(path.elementCount() + int(data.size() / 8));
+
+    QPointF current(0, 0);
+    QPointF subpathStart(0, 0);
+    QPointF lastControl(0, 0);
+    char16_t command = 0;
+    char16_t previous = 0;  // 上一段的命令（大写），用于S/T的控制点反射
+
+    while (true) {
+        cursor.skipSeparators();
+        if (cursor.atEnd()) {
+            return true;
+        }
+
+        char16_t c = cursor.peek();
+        if (isPathCommand(c)) {
+            command = c;
+            cursor.advance();
+        } else if (command == 0 || command == 'Z' || command == 'z' || !cursor.atNumberStart()) {
+            // 非法字符，按规范保留之前已解析的部分
+            return false;
+        } else if (command == 'M') {
+            // moveto之后的隐式坐标对视为lineto
+            command = 'L';
+        } else if (command == 'm') {
+            command = 'l';
+        }
+
+        const bool relative = command >= 'a';
+        const QPointF origin = relative ? current : QPointF(0, 0);
+        const char16_t upper = toUpperCommand(command);
+
+        switch (upper) {
+        case 'M': {
+            QPointF p;
+            if (!cursor.readPoint(p)) {
+                return false;
+            }
+            p += origin;
+            path.moveTo(p);
+            current = subpathStart = lastControl = p;
+            break;
+        }
+        case 'L': {
+            QPointF p;
+            if (!cursor.readPoint(p)) {
+                return false;
+            }
+            p += origin;
+            path.lineTo(p);
+            current = lastControl = p;
+            break;
+        }
+        case 'H': {
+            qreal x;
+            if (!cursor.readNumber(x)) {
+                return false;
+            }
+            current.setX(relative ? current.x() + x : x);
+            path.lineTo(current);
+            lastControl = current;
+            break;
+        }
+        case 'V': {
+            qreal y;
+            if (!cursor.readNumber(y)) {
+                return false;
+            }
+            current.setY(relative ? current.y() + y : y);
+            path.lineTo(current);
+            lastControl = current;
+            break;
+        }
+        case 'C': {
+            QPointF c1, c2, p;
+            if (!cursor.readPoint(c1) || !cursor.readPoint(c2) || !cursor.readPoint(p)) {
+                return false;
+            }
+            c1 += origin;
+            c2 += origin;
+            p += origin;
+            path.cubicTo(c1, c2, p);
+            lastControl = c2;
+            current = p;
+            break;
+        }
+        case 'S': {
+            QPointF c2, p;
+            if (!cursor.readPoint(c2) || !cursor.readPoint(p)) {
+                return false;
+            }
+            // 上一段是三次曲线时，第一个控制点是上一段第二个控制点的对称点
+            QPointF c1 = (previous == 'C' || previous == 'S') ? 2 * current - lastControl : current;
+            c2 += origin;
+            p += origin;
+            path.cubicTo(c1, c2, p);
+            lastControl = c2;
+            current = p;
+            break;
+        }
+        case 'Q': {
+            QPointF c1, p;
+            if (!cursor.readPoint(c1) || !cursor.readPoint(p)) {
+                return false;
+            }
+            c1 += origin;
+            p += origin;
+            path.quadTo(c1, p);
+            lastControl = c1;
+            current = p;
+            break;
+        }
+        case 'T': {
+            QPointF p;
+            if (!cursor.readPoint(p)) {
+                return false;
+            }
+            QPointF c1 = (previous == 'Q' || previous == 'T') ? 2 * current - lastControl : current;
+            p += origin;
+            path.quadTo(c1, p);
+            lastControl = c1;
+            current = p;
+            break;
+        }
+        case 'A': {
+            qreal rx, ry, rotation;
+            bool largeArc, sweep;
+            QPointF p;
+            if (!cursor.readNumber(rx) || !cursor.readNumber(ry) || !cursor.readNumber(rotation) ||
+                !cursor.readFlag(largeArc) || !cursor.readFlag(sweep) || !cursor.readPoint(p)) {
+                return false;
+            }
+            p += origin;
+            appendArc(path, current, p, rx, ry, rotation, largeArc, sweep);
+            current = lastControl = p;
+            break;
+        }
+        case 'Z':
+            path.closeSubpath();
+            current = lastControl = subpathStart;
+            break;
+        default:
+            return false;
+        }
+
+        previous = upper;
+    }
+}
+
+bool SvgPathParser::parsePoints(QStringView data, QPainterPath &path, bool closePath)
+{
+    PathCursor cursor(data);
+    bool first = true;
+
+    while (true) {
+        cursor.skipSeparators();
+        if (cursor.atEnd()) {
+            break;
+        }
+
+        // 坐标个数为奇数时忽略最后一个
+        QPointF p;
+        if (!cursor.readPoint(p)) {
+            break;
+        }
+
+        if (first) {
+            path.moveTo(p);
+            first = false;
+        } else {
+            path.lineTo(p);
+        }
+    }
+
+    if (closePath && !first) {
+        path.closeSubpath();
+    }
+    return !first;
+}
+
+void SvgPathParser::appendArc(QPainterPath &path, const QPointF &start, const QPointF &end,
+                              qreal rx, qreal ry, qreal xAxisRotation,
+                              bool largeArcFlag, bool sweepFlag)
+{
+    // 按SVG规范附录F.6的端点参数化到中心参数化的转换
+    if (start == end) {
+        return;
+    }
+
+    rx = qAbs(rx);
+    ry = qAbs(ry);
+    if (qFuzzyIsNull(rx) || qFuzzyIsNull(ry)) {
+        path.lineTo(end);
+        return;
+    }
+
+    const qreal phi = qDegreesToRadians(xAxisRotation);
+    const qreal cosPhi = qCos(phi);
+    const qreal sinPhi = qSin(phi);
+
+    const qreal dx2 = (start.x() - end.x()) / 2.0;
+    const qreal dy2 = (start.y() - end.y()) / 2.0;
+    const qreal x1p = cosPhi * dx2 + sinPhi * dy2;
+    const qreal y1p = -sinPhi * dx2 + cosPhi * dy2;
+
+    // 半径不足以连接两个端点时按比例放大
+    const qreal lambda = (x1p * x1p) / (rx * rx) + (y1p * y1p) / (ry * ry);
+    if (lambda > 1.0) {
+        const qreal scale = qSqrt(lambda);
+        rx *= scale;
+        ry *= scale;
+    }
+
+    const qreal rx2 = rx * rx;
+    const qreal ry2 = ry * ry;
+    const qreal numerator = rx2 * ry2 - rx2 * y1p * y1p - ry2 * x1p * x1p;
+    const qreal denominator = rx2 * y1p * y1p + ry2 * x1p * x1p;
+    qreal coef = qFuzzyIsNull(denominator) ? 0.0 : qSqrt(qMax<qreal>(0.0, numerator / denominator));
+    if (largeArcFlag == sweepFlag) {
+        coef = -coef;
+    }
+
+    const qreal cxp = coef * rx * y1p / ry;
+    const qreal cyp = -coef * ry * x1p / rx;
+    const qreal cx = cosPhi * cxp - sinPhi * cyp + (start.x() + end.x()) / 2.0;
+    const qreal cy = sinPhi * cxp + cosPhi * cyp + (start.y() + end.y()) / 2.0;
+
+    const qreal ux = (x1p - cxp) / rx;
+    const qreal uy = (y1p - cyp) / ry;
+    const qreal vx = (-x1p - cxp) / rx;
+    const qreal vy = (-y1p - cyp) / ry;
+
+    const qreal theta1 = qAtan2(uy, ux);
+    qreal deltaTheta = qAtan2(ux * vy - uy * vx, ux * vx + uy * vy);
+    if (!sweepFlag && deltaTheta > 0) {
+        deltaTheta -= 2 * M_PI;
+    } else if (sweepFlag && deltaTheta < 0) {
+        deltaTheta += 2 * M_PI;
+    }
+
+    // 每段不超过90度，单位圆上的弧用k = 4/3·tan(θ/4)的三次曲线近似
+    const int segments = qMax(1, int(qCeil(qAbs(deltaTheta) / (M_PI / 2) - 1e-9)));
+    const qreal delta = deltaTheta / segments;
+    const qreal k = 4.0 / 3.0 * qTan(delta / 4.0);
+
+    auto mapPoint = [&](qreal ex, qreal ey) {
+        return QPointF(cx + rx * ex * cosPhi - ry * ey * sinPhi,
+                       cy + rx * ex * sinPhi + ry * ey * cosPhi);
+    };
+
+    qreal theta = theta1;
+    qreal cos1 = qCos(theta);
+    qreal sin1 = qSin(theta);
+    for (int i = 0; i < segments; ++i) {
+        const qreal theta2 = theta + delta;
+        const qreal cos2 = qCos(theta2);
+        const qreal sin2 = qSin(theta2);
+
+        QPointF c1 = mapPoint(cos1 - k * sin1, sin1 + k * cos1);
+        QPointF c2 = mapPoint(cos2 + k * sin2, sin2 - k * cos2);
+        QPointF p = (i == segments - 1) ? end : mapPoint(cos2, sin2);
+        path.cubicTo(c1, c2, p);
+
+        theta = theta2;
+        cos1 = cos2;
+        sin1 = sin2;
+    }
+}
@@ -0,0 +1,27 @@
+#ifndef SVG_PATH_PARSER_H
+#define SVG_PATH_PARSER_H
+
+#include <QPainterPath>
+#include <QPointF>
+#include <QStringView>
+
+/**
+ * SVG路径数据解析器 - 单遍扫描QStringView，数字和标志位原地解析
+ * 解析结果直接写入QPainterPath，每个记号不产生任何临时分配
+ */
+class SvgPathParser
+{
+public:
+    // 解析路径数据（d属性），遇到语法错误时保留错误之前的部分（与SVG规范一致）
+    static bool parse(QStringView data, QPainterPath &path);
+
+    // 解析points属性（polyline/polygon），数字之间可用逗号或空白分隔
+    static bool parsePoints(QStringView data, QPainterPath &path, bool closePath);
+
+    // 椭圆弧转换为三次贝塞尔曲线，xAxisRotation单位为角度
+    static void appendArc(QPainterPath &path, const QPointF &start, const QPointF &end,
+                          qreal rx, qreal ry, qreal xAxisRotation,
+                          bool largeArcFlag, bool sweepFlag);
+};
+
+#endif // SVG_PATH_PARSER_H
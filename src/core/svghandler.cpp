@@ -1,7 +1,10 @@
 #include <QFile>
+#include <QSaveFile>
 #include <QDomDocument>
 #include <QDomElement>
 #include <QDomNodeList>
+#include <QXmlStreamReader>
+#include <QSet>
 #include <QPainter>
 #include <QPainterPath>
 #include <QPainterPathStroker>
@@ -11,31 +14,32 @@
 #include <QTransform>
 #include <QDebug>
 #include "../core/svghandler.h"
+#include "../core/svg-path-parser.h"
+#include "../core/svg-import-context.h"
+#include "../core/svg-export-writer.h"
 #include "../ui/drawingscene.h"
 #include "../core/drawing-shape.h"
+#include "../core/drawing-document.h"
 #include "../core/drawing-layer.h"
 #include "../core/drawing-group.h"
 #include "../core/layer-manager.h"
 
-// 渐变存储
-static QHash<QString, QGradient> s_gradients;
-
-// 滤镜存储
-static QHash<QString, QGraphicsEffect*> s_filters;
-
-// Pattern存储
-static QHash<QString, QBrush> s_patterns;
-
-// Marker存储
-static QHash<QString, QDomElement> s_markers;
-
-// Marker渲染缓存
-static QHash<QString, QPixmap> s_markerCache;
-
-// 定义的元素存储（用于use元素）
-static QHash<QString, QDomElement> s_definedElements;
-
 bool SvgHandler::importFromSvg(DrawingScene *scene, const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qDebug() << "无法打开SVG文件:" << fileName;
+        return false;
+    }
+    
+    // 流式解析：只保留defs和被use引用的元素，图形元素边读边创建
+    SvgImportContext context;
+    bool result = parseSvgStream(scene, context, &file);
+    file.close();
+    return result;
+}
+
+bool SvgHandler::importFromSvgDocument(DrawingScene *scene, const QString &fileName)
 {
     // qDebug() << "开始导入SVG文件:" << fileName;
     QFile file(fileName);
@@ -57,12 +61,13 @@ bool SvgHandler::importFromSvg(DrawingScene *scene, const QString &fileName)
     file.close();
     // qDebug() << "SVG文档解析成功，开始解析文档";
     
-    bool result = parseSvgDocument(scene, doc);
+    SvgImportContext context;
+    bool result = parseSvgDocument(scene, context, doc);
     // qDebug() << "SVG导入完成，结果:" << result;
     return result;
 }
 
-bool SvgHandler::parseSvgDocument(DrawingScene *scene, const QDomDocument &doc)
+bool SvgHandler::parseSvgDocument(DrawingScene *scene, SvgImportContext &context, const QDomDocument &doc)
 {
     QDomElement root = doc.documentElement();
     if (root.tagName() != "svg") {
@@ -70,23 +75,11 @@ bool SvgHandler::parseSvgDocument(DrawingScene *scene, const QDomDocument &doc)
         return false;
     }
     
-    // 清空之前存储的定义元素
-    s_definedElements.clear();
-    
     // 首先收集所有定义的元素（用于use元素）
-    collectDefinedElements(root);
-    
-    // 解析defs元素中的渐变定义
-    parseDefsElements(root);
-    
-    // 解析滤镜定义
-    parseFilterElements(root);
-    
-    // 解析Pattern定义
-    parsePatternElements(root);
+    collectDefinedElements(context, root);
     
-    // 解析Marker定义
-    parseMarkerElements(root);
+    // 解析渐变、滤镜、Pattern和Marker定义
+    parseResourceDefinitions(context, root);
     
     // 遍历SVG文档中的所有元素
     QDomNodeList children = root.childNodes();
@@ -106,10 +99,10 @@ bool SvgHandler::parseSvgDocument(DrawingScene *scene, const QDomDocument &doc)
             
             if (tagName == "g") {
                 // 处理组元素，并获取组中元素的计数
-                int groupElementCount = parseGroupElement(scene, element, nullptr);
+                int groupElementCount = parseGroupElement(scene, context, element, nullptr);
                 elementCount += groupElementCount;
             } else {
-                DrawingShape *shape = parseSvgElement(element);
+                DrawingShape *shape = parseSvgElement(context, element);
                 if (shape) {
                     scene->addItem(shape);
                     elementCount++;
@@ -125,103 +118,432 @@ bool SvgHandler::parseSvgDocument(DrawingScene *scene, const QDomDocument &doc)
     return elementCount > 0;
 }
 
-DrawingShape* SvgHandler::parseSvgElement(const QDomElement &element)
+void SvgHandler::parseResourceDefinitions(SvgImportContext &context, const QDomElement &root)
 {
-    QString tagName = element.tagName();
+    // 解析defs元素中的渐变定义
+    parseDefsElements(context, root);
     
-    try {
-        if (tagName == "path") {
-            // 检查是否是 Inkscape 的 sodipodi:arc 元素
-            if (element.hasAttribute("sodipodi:type") && 
-                element.attribute("sodipodi:type") == "arc") {
-                return parseSodipodiArcElement(element);
+    // 解析滤镜定义
+    parseFilterElements(context, root);
+    
+    // 解析Pattern定义
+    parsePatternElements(context, root);
+    
+    // 解析Marker定义
+    parseMarkerElements(context, root);
+}
+
+// 流式解析时需要创建图形的元素，其余元素parseSvgElement也不会生成图形
+bool SvgHandler::isStreamShapeTag(const QString &tagName)
+{
+    return tagName == "path" || tagName == "rect" || tagName == "circle" ||
+           tagName == "ellipse" || tagName == "line" || tagName == "polyline" ||
+           tagName == "polygon" || tagName == "text" || tagName == "use";
+}
+
+// 取出use元素引用的id（不带#）
+static QString streamUseReference(const QXmlStreamAttributes &attributes)
+{
+    QString href = attributes.value("href").toString();
+    if (href.isEmpty()) {
+        href = attributes.value("xlink:href").toString(); // 兼容旧版本SVG
+    }
+    return href.startsWith('#') ? href.mid(1) : QString();
+}
+
+bool SvgHandler::parseSvgStream(DrawingScene *scene, SvgImportContext &context, QIODevice *device)
+{
+    // 第一遍：只保留defs和被use引用的元素，同时校验整个文件
+    QDomDocument defsDoc;
+    QDomElement defsRoot = defsDoc.createElement("svg");
+    defsDoc.appendChild(defsRoot);
+    if (!collectStreamDefinitions(context, device, defsDoc, defsRoot)) {
+        return false;
+    }
+    
+    // 解析资源定义，与DOM路径共用同一套函数
+    parseResourceDefinitions(context, defsRoot);
+    
+    // 第二遍：逐个读取图形元素并立即创建图形，解析完的元素随即释放
+    if (!device->seek(0)) {
+        qDebug() << "无法重新定位SVG文件";
+        return false;
+    }
+    
+    QXmlStreamReader reader(device);
+    reader.setNamespaceProcessing(false);
+    
+    // 每个未结束的<g>对应一帧，记录子元素应挂到的图层或组
+    struct GroupFrame {
+        DrawingLayer *layer;
+        DrawingGroup *group;
+    };
+    QVector<GroupFrame> groupStack;
+    QDomDocument scratchDoc;
+    bool rootSeen = false;
+    int elementCount = 0;
+    
+    while (!reader.atEnd()) {
+        QXmlStreamReader::TokenType token = reader.readNext();
+        
+        if (token == QXmlStreamReader::EndElement) {
+            // 非组元素都已整体读取或跳过，这里只会遇到</g>和</svg>
+            if (groupStack.isEmpty()) {
+                break;
             }
-            return parsePathElement(element);
-        } else if (tagName == "rect") {
-            return parseRectElement(element);
-        } else if (tagName == "circle") {
-            return parseCircleElement(element);
-        } else if (tagName == "ellipse") {
-            return parseEllipseElement(element);
-        } else if (tagName == "line") {
-            return parseLineElement(element);
-        } else if (tagName == "polyline" || tagName == "polygon") {
-            return parsePolygonElement(element);
-        } else if (tagName == "text") {
-            return parseTextElement(element);
-        } else if (tagName == "g") {
-            // 组元素需要特殊处理，不在这里直接解析
-            return nullptr;
-        } else if (tagName == "defs" || tagName == "pattern" || 
-                   tagName == "filter" || tagName == "marker" ||
-                   tagName == "linearGradient" || tagName == "radialGradient" ||
-                   tagName == "stop" || tagName == "metadata" || 
-                   tagName == "namedview" || tagName == "rdf:RDF") {
-            // 这些是定义元素，不创建图形
-            return nullptr;
-        } else if (tagName == "use") {
-            return parseUseElement(element);
-        } else if (tagName == "image") {
-            // TODO: 实现image元素支持
-            // qDebug() << "暂不支持的元素:" << tagName;
-            return nullptr;
-        } else if (tagName == "clipPath" || tagName == "mask") {
-            // TODO: 实现裁剪路径和蒙版支持
-            // qDebug() << "暂不支持的元素:" << tagName;
-            return nullptr;
-        } else {
-            // 记录未知的元素类型，但不崩溃
-            // qDebug() << "未知的SVG元素:" << tagName;
-            return nullptr;
+            groupStack.removeLast();
+            continue;
+        }
+        
+        if (token != QXmlStreamReader::StartElement) {
+            continue;
+        }
+        
+        if (!rootSeen) {
+            rootSeen = true;
+            continue;
+        }
+        
+        QString tagName = reader.qualifiedName().toString();
+        
+        if (tagName == "g") {
+            // 组只读取属性，子元素继续流式处理
+            QDomElement groupElement = readStreamElement(reader, scratchDoc, false);
+            QGraphicsItem *parentItem = groupStack.isEmpty() ? nullptr : groupStack.last().group;
+            GroupFrame frame = { nullptr, nullptr };
+            beginGroupElement(scene, context, groupElement, parentItem, frame.layer, frame.group);
+            groupStack.append(frame);
+            continue;
+        }
+        
+        // defs已在第一遍处理，其他非图形元素不会生成图形
+        if (tagName == "defs" || !isStreamShapeTag(tagName)) {
+            reader.skipCurrentElement();
+            continue;
+        }
+        
+        QDomElement element = readStreamElement(reader, scratchDoc);
+        try {
+            DrawingShape *shape = parseSvgElement(context, element);
+            if (shape) {
+                if (groupStack.isEmpty()) {
+                    scene->addItem(shape);
+                } else {
+                    addParsedShape(scene, shape, groupStack.last().layer, groupStack.last().group);
+                }
+                elementCount++;
+            }
+        } catch (...) {
+            // qDebug() << "解析元素时发生错误:" << tagName << "，跳过";
         }
-    } catch (...) {
-        // qDebug() << "解析元素时发生异常:" << tagName;
-        return nullptr;
     }
+    
+    if (reader.hasError()) {
+        qDebug() << "解析SVG文件失败:" << reader.errorString()
+                 << "行:" << reader.lineNumber() << "列:" << reader.columnNumber();
+    }
+    
+    return elementCount > 0;
 }
 
-int SvgHandler::parseGroupElement(DrawingScene *scene, const QDomElement &groupElement, QGraphicsItem *parentItem)
+bool SvgHandler::collectStreamDefinitions(SvgImportContext &context, QIODevice *device,
+                                          QDomDocument &defsDoc, QDomElement &defsRoot)
 {
-    // 检查是否是图层（带有 inkscape:label 属性）
-    QString layerId = groupElement.attribute("inkscape:label");
-    bool isLayer = !layerId.isEmpty() && 
-                   groupElement.hasAttribute("inkscape:groupmode") &&
-                   groupElement.attribute("inkscape:groupmode") == "layer";
+    QXmlStreamReader reader(device);
+    reader.setNamespaceProcessing(false);
     
-    DrawingLayer *layer = nullptr;
-    DrawingGroup *group = nullptr;
+    // 与collectDefinedElements的规则一致：只收集根元素、defs和g的直接子元素
+    QVector<bool> collectStack;
+    QSet<QString> referencedIds;
+    QSet<QString> outsideIds;
+    bool rootSeen = false;
     
-    if (isLayer) {
-        // 创建图层
-        layer = LayerManager::instance()->createLayer(layerId);
-        // qDebug() << "创建图层:" << layerId;
-    } else {
-        // 创建组合对象
-        group = new DrawingGroup();
+    while (!reader.atEnd()) {
+        QXmlStreamReader::TokenType token = reader.readNext();
         
-        // 首先添加到场景或父项，再处理变换
-        // 如果有父项（说明是嵌套组），添加到父项；否则添加到场景
-        if (parentItem) {
-            group->setParentItem(parentItem);
-            // qDebug() << "创建嵌套组合对象并添加到父项";
-        } else {
-            scene->addItem(group);
-            // qDebug() << "创建组合对象并添加到场景";
+        if (token == QXmlStreamReader::EndElement) {
+            if (!collectStack.isEmpty()) {
+                collectStack.removeLast();
+            }
+            continue;
+        }
+        
+        if (token != QXmlStreamReader::StartElement) {
+            continue;
+        }
+        
+        QString tagName = reader.qualifiedName().toString();
+        if (!rootSeen) {
+            rootSeen = true;
+            if (tagName != "svg") {
+                qDebug() << "不是有效的SVG文档，标签名:" << tagName;
+                return false;
+            }
+            collectStack.append(true);
+            continue;
+        }
+        
+        bool collectable = collectStack.last();
+        QXmlStreamAttributes attributes = reader.attributes();
+        
+        if (tagName == "defs") {
+            // defs整体保留，第一个defs作为渐变、滤镜、Pattern和Marker的来源
+            QDomElement defs = readStreamElement(reader, defsDoc);
+            if (collectable) {
+                if (defs.hasAttribute("id")) {
+                    context.addDefinedElement(defs.attribute("id"), defs.cloneNode().toElement());
+                }
+                collectDefinedElements(context, defs);
+            }
+            
+            QDomNodeList uses = defs.elementsByTagName("use");
+            for (int i = 0; i < uses.size(); ++i) {
+                QDomElement use = uses.at(i).toElement();
+                QString href = use.attribute("href", use.attribute("xlink:href"));
+                if (href.startsWith('#')) {
+                    referencedIds.insert(href.mid(1));
+                }
+            }
+            
+            if (defsRoot.firstChildElement("defs").isNull()) {
+                defsRoot.appendChild(defs);
+            }
+            continue;
+        }
+        
+        if (tagName == "use") {
+            QString refId = streamUseReference(attributes);
+            if (!refId.isEmpty()) {
+                referencedIds.insert(refId);
+            }
+        }
+        
+        if (collectable && attributes.hasAttribute("id")) {
+            outsideIds.insert(attributes.value("id").toString());
+        }
+        
+        collectStack.append(collectable && tagName == "g");
+    }
+    
+    if (reader.hasError() || !rootSeen) {
+        qDebug() << "解析SVG文件失败:" << reader.errorString()
+                 << "行:" << reader.lineNumber() << "列:" << reader.columnNumber();
+        return false;
+    }
+    
+    // defs之外被use引用的元素需要再读一遍，只保留这些元素
+    QSet<QString> pendingIds;
+    for (const QString &id : referencedIds) {
+        if (outsideIds.contains(id)) {
+            pendingIds.insert(id);
+        }
+    }
+    
+    if (pendingIds.isEmpty()) {
+        return true;
+    }
+    
+    if (!device->seek(0)) {
+        qDebug() << "无法重新定位SVG文件";
+        return false;
+    }
+    
+    QXmlStreamReader refReader(device);
+    refReader.setNamespaceProcessing(false);
+    collectStack.clear();
+    rootSeen = false;
+    
+    while (!refReader.atEnd()) {
+        QXmlStreamReader::TokenType token = refReader.readNext();
+        
+        if (token == QXmlStreamReader::EndElement) {
+            if (!collectStack.isEmpty()) {
+                collectStack.removeLast();
+            }
+            continue;
         }
         
-        // 解析组的样式属性（在添加到场景后）
-        parseStyleAttributes(group, groupElement);
+        if (token != QXmlStreamReader::StartElement) {
+            continue;
+        }
         
-        // 解析变换属性（在添加子元素之后）
-        // 这样变换会应用到已经添加的子元素
-        if (groupElement.hasAttribute("transform")) {
-            QString transform = groupElement.attribute("transform");
-            if (!transform.isEmpty()) {
-                parseTransformAttribute(group, transform);
+        if (!rootSeen) {
+            rootSeen = true;
+            collectStack.append(true);
+            continue;
+        }
+        
+        QString tagName = refReader.qualifiedName().toString();
+        if (tagName == "defs") {
+            refReader.skipCurrentElement();
+            continue;
+        }
+        
+        bool collectable = collectStack.last();
+        QString id = refReader.attributes().value("id").toString();
+        if (collectable && pendingIds.contains(id)) {
+            QDomElement element = readStreamElement(refReader, defsDoc);
+            context.addDefinedElement(id, element);
+            if (tagName == "g") {
+                collectDefinedElements(context, element);
             }
+            continue;
         }
+        
+        collectStack.append(collectable && tagName == "g");
+    }
+    
+    return !refReader.hasError();
+}
+
+QDomElement SvgHandler::readStreamElement(QXmlStreamReader &reader, QDomDocument &doc, bool withChildren)
+{
+    // 把当前StartElement转换为独立的QDomElement，供现有的元素解析函数使用
+    QDomElement element = doc.createElement(reader.qualifiedName().toString());
+    const QXmlStreamAttributes attributes = reader.attributes();
+    for (const QXmlStreamAttribute &attribute : attributes) {
+        element.setAttribute(attribute.qualifiedName().toString(), attribute.value().toString());
+    }
+    
+    if (!withChildren) {
+        return element;
     }
     
+    while (!reader.atEnd()) {
+        QXmlStreamReader::TokenType token = reader.readNext();
+        if (token == QXmlStreamReader::StartElement) {
+            element.appendChild(readStreamElement(reader, doc));
+        } else if (token == QXmlStreamReader::Characters) {
+            // 与QDomDocument默认行为一致，丢弃纯空白文本
+            if (!reader.isWhitespace()) {
+                element.appendChild(doc.createTextNode(reader.text().toString()));
+            }
+        } else if (token == QXmlStreamReader::EndElement) {
+            break;
+        }
+    }
+    
+    return element;
+}
+
+DrawingShape* SvgHandler::parseSvgElement(SvgImportContext &context, const QDomElement &element)
+{
+    try {
+        SvgShapeRecord record;
+        if (!parseShapeRecord(element, record)) {
+            return nullptr;
+        }
+        return createShapeFromRecord(context, record);
+    } catch (...) {
+        // qDebug() << "解析元素时发生异常:" << element.tagName();
+        return nullptr;
+    }
+}
+
+bool SvgHandler::parseShapeRecord(const QDomElement &element, SvgShapeRecord &record)
+{
+    QString tagName = element.tagName();
+    
+    if (tagName == "path") {
+        // 检查是否是 Inkscape 的 sodipodi:arc 元素
+        if (element.hasAttribute("sodipodi:type") && 
+            element.attribute("sodipodi:type") == "arc") {
+            return parseSodipodiArcElement(element, record);
+        }
+        return parsePathElement(element, record);
+    } else if (tagName == "rect") {
+        return parseRectElement(element, record);
+    } else if (tagName == "circle") {
+        return parseCircleElement(element, record);
+    } else if (tagName == "ellipse") {
+        return parseEllipseElement(element, record);
+    } else if (tagName == "line") {
+        return parseLineElement(element, record);
+    } else if (tagName == "polyline" || tagName == "polygon") {
+        return parsePolygonElement(element, record);
+    } else if (tagName == "text") {
+        return parseTextElement(element, record);
+    } else if (tagName == "use") {
+        // use依赖全局定义表，交给GUI线程解析
+        record.kind = SvgShapeRecord::Deferred;
+        record.deferredElement = element;
+        return true;
+    }
+    
+    // g需要特殊处理；defs、pattern、filter、marker、渐变等定义元素不创建图形
+    // TODO: 实现image、clipPath和mask元素支持
+    return false;
+}
+
+DrawingShape* SvgHandler::createShapeFromRecord(SvgImportContext &context, const SvgShapeRecord &record)
+{
+    DrawingShape *shape = nullptr;
+    
+    switch (record.kind) {
+    case SvgShapeRecord::Path: {
+        DrawingPath *drawingPath = new DrawingPath();
+        // setPath把所有元素（包括曲线数据点）保存为控制点，用于节点编辑
+        drawingPath->setPath(record.path);
+        shape = drawingPath;
+        break;
+    }
+    case SvgShapeRecord::Rectangle:
+        shape = new DrawingRectangle(record.rect);
+        break;
+    case SvgShapeRecord::Ellipse: {
+        DrawingEllipse *ellipse = new DrawingEllipse(record.rect);
+        if (record.hasAngles) {
+            ellipse->setStartAngle(record.startAngle);
+            ellipse->setSpanAngle(record.spanAngle);
+        }
+        shape = ellipse;
+        break;
+    }
+    case SvgShapeRecord::Text: {
+        DrawingText *text = new DrawingText(record.text);
+        text->setPosition(record.position);
+        
+        QFont font(record.fontFamily);
+        font.setPointSizeF(record.fontSize);
+        if (record.bold) {
+            font.setBold(true);
+        }
+        if (record.italic) {
+            font.setItalic(true);
+        }
+        text->setFont(font);
+        shape = text;
+        break;
+    }
+    case SvgShapeRecord::Deferred:
+        return parseUseElement(context, record.deferredElement);
+    case SvgShapeRecord::Invalid:
+        return nullptr;
+    }
+    
+    // 解析样式属性
+    applyStyleRecord(context, shape, record.style);
+    
+    // 解析变换属性
+    if (record.hasTransform) {
+        shape->applyTransform(record.transform);
+    }
+    
+    // 应用Marker
+    if (record.kind == SvgShapeRecord::Path) {
+        applyMarkers(context, static_cast<DrawingPath*>(shape), record.markerStart, record.markerMid, record.markerEnd);
+    }
+    
+    return shape;
+}
+
+int SvgHandler::parseGroupElement(DrawingScene *scene, SvgImportContext &context, const QDomElement &groupElement,
+                                  QGraphicsItem *parentItem)
+{
+    DrawingLayer *layer = nullptr;
+    DrawingGroup *group = nullptr;
+    beginGroupElement(scene, context, groupElement, parentItem, layer, group);
+    
     // 遍历组中的所有子元素
     QDomNodeList children = groupElement.childNodes();
     int elementCount = 0;
@@ -232,31 +554,13 @@ int SvgHandler::parseGroupElement(DrawingScene *scene, const QDomElement &groupE
             QString tagName = element.tagName();
             
             if (tagName == "g") {
-                // 递归处理嵌套组，传递当前组作为父项
-                int groupElementCount = 0;
-                if (group) {
-                    groupElementCount = parseGroupElement(scene, element, group);
-                } else {
-                    groupElementCount = parseGroupElement(scene, element, nullptr);
-                }
-                elementCount += groupElementCount;
+                // 递归处理嵌套组，传递当前组作为父项（图层中的组直接放到场景）
+                elementCount += parseGroupElement(scene, context, element, group);
             } else {
                 try {
-                    DrawingShape *shape = parseSvgElement(element);
+                    DrawingShape *shape = parseSvgElement(context, element);
                     if (shape) {
-                        if (layer) {
-                            // 添加到图层
-                            layer->addShape(shape);
-                            // qDebug() << "添加形状到图层" << layerId << "，元素:" << tagName;
-                        } else if (group) {
-                            // 添加到组合对象
-                            group->addItem(shape);
-                            // qDebug() << "添加形状到组合对象，元素:" << tagName;
-                        } else {
-                            // 直接添加到场景
-                            scene->addItem(shape);
-                            // qDebug() << "从组中添加形状到场景，元素:" << tagName;
-                        }
+                        addParsedShape(scene, shape, layer, group);
                         elementCount++;
                     } else {
                         // qDebug() << "无法解析元素:" << tagName << "，跳过";
@@ -272,6 +576,98 @@ int SvgHandler::parseGroupElement(DrawingScene *scene, const QDomElement &groupE
     return elementCount;
 }
 
+void SvgHandler::beginGroupElement(DrawingScene *scene, SvgImportContext &context, const QDomElement &groupElement,
+                                   QGraphicsItem *parentItem, DrawingLayer *&layer, DrawingGroup *&group)
+{
+    beginGroupRecord(scene, context, parseGroupRecord(groupElement), parentItem, layer, group);
+}
+
+SvgGroupRecord SvgHandler::parseGroupRecord(const QDomElement &element)
+{
+    SvgGroupRecord record;
+    
+    // 检查是否是图层（带有 inkscape:label 属性）
+    record.layerName = element.attribute("inkscape:label");
+    record.isLayer = !record.layerName.isEmpty() && 
+                     element.hasAttribute("inkscape:groupmode") &&
+                     element.attribute("inkscape:groupmode") == "layer";
+    
+    // DrawingGroup 本身不需要解析样式，样式应该传递给子元素
+    // 这里只解析组的透明度和滤镜
+    QString opacity = element.attribute("opacity");
+    if (!opacity.isEmpty()) {
+        record.hasOpacity = true;
+        record.opacity = opacity.toDouble();
+    }
+    
+    QString filter = element.attribute("filter");
+    if (!filter.isEmpty() && filter.startsWith("url(#")) {
+        record.filterId = filter.mid(5, filter.length() - 6); // 去掉 "url(#" 和 ")"
+    }
+    
+    QString transform = element.attribute("transform");
+    if (!transform.isEmpty()) {
+        record.hasTransform = true;
+        record.transform = parseTransform(transform);
+    }
+    
+    return record;
+}
+
+void SvgHandler::beginGroupRecord(DrawingScene *scene, SvgImportContext &context, const SvgGroupRecord &record,
+                                  QGraphicsItem *parentItem, DrawingLayer *&layer, DrawingGroup *&group)
+{
+    layer = nullptr;
+    group = nullptr;
+    
+    if (record.isLayer) {
+        // 创建图层
+        layer = LayerManager::instance()->createLayer(record.layerName);
+        // qDebug() << "创建图层:" << record.layerName;
+        return;
+    }
+    
+    // 创建组合对象
+    group = new DrawingGroup();
+    
+    // 首先添加到场景或父项，再处理变换
+    // 如果有父项（说明是嵌套组），添加到父项；否则添加到场景
+    if (parentItem) {
+        group->setParentItem(parentItem);
+        // qDebug() << "创建嵌套组合对象并添加到父项";
+    } else {
+        scene->addItem(group);
+        // qDebug() << "创建组合对象并添加到场景";
+    }
+    
+    // 解析组的样式属性（在添加到场景后）
+    if (record.hasOpacity) {
+        group->setOpacity(record.opacity);
+    }
+    if (!record.filterId.isEmpty()) {
+        applyFilterToShape(context, group, record.filterId);
+    }
+    
+    // 应用变换（在添加子元素之前）
+    if (record.hasTransform) {
+        group->applyTransform(record.transform);
+    }
+}
+
+void SvgHandler::addParsedShape(DrawingScene *scene, DrawingShape *shape, DrawingLayer *layer, DrawingGroup *group)
+{
+    if (layer) {
+        // 添加到图层
+        layer->addShape(shape);
+    } else if (group) {
+        // 添加到组合对象
+        group->addItem(shape);
+    } else {
+        // 直接添加到场景
+        scene->addItem(shape);
+    }
+}
+
 DrawingLayer* SvgHandler::parseLayerElement(const QDomElement &element)
 {
     // 创建图层
@@ -290,7 +686,27 @@ DrawingLayer* SvgHandler::parseLayerElement(const QDomElement &element)
     return layer;
 }
 
-DrawingEllipse* SvgHandler::parseSodipodiArcElement(const QDomElement &element)
+void SvgHandler::parseShapeRecordAttributes(const QDomElement &element, SvgShapeRecord &record)
+{
+    // 解析样式属性
+    record.style = parseStyleRecord(element);
+    
+    // 解析变换属性
+    QString transform = element.attribute("transform");
+    if (!transform.isEmpty()) {
+        record.hasTransform = true;
+        record.transform = parseTransform(transform);
+    }
+    
+    // 解析Marker属性（只对路径类图形生效）
+    if (record.kind == SvgShapeRecord::Path) {
+        record.markerStart = element.attribute("marker-start");
+        record.markerMid = element.attribute("marker-mid");
+        record.markerEnd = element.attribute("marker-end");
+    }
+}
+
+bool SvgHandler::parseSodipodiArcElement(const QDomElement &element, SvgShapeRecord &record)
 {
     // 获取 sodipodi:arc 的属性
     qreal cx = element.attribute("sodipodi:cx", "0").toDouble();
@@ -307,335 +723,49 @@ DrawingEllipse* SvgHandler::parseSodipodiArcElement(const QDomElement &element)
     qreal endAngle = element.attribute("sodipodi:end", "360").toDouble();
     
     // 创建椭圆
-    QRectF rect(cx - rx, cy - ry, 2 * rx, 2 * ry);
-    DrawingEllipse *ellipse = new DrawingEllipse(rect);
+    record.kind = SvgShapeRecord::Ellipse;
+    record.rect = QRectF(cx - rx, cy - ry, 2 * rx, 2 * ry);
     
     // 设置角度（如果需要）
     if (!isOpen || (endAngle - startAngle) < 360) {
-        ellipse->setStartAngle(startAngle);
-        ellipse->setSpanAngle(endAngle);
-    }
-    
-    // 解析样式属性
-    parseStyleAttributes(ellipse, element);
-    
-    // 解析变换属性
-    if (element.hasAttribute("transform")) {
-        parseTransformAttribute(ellipse, element.attribute("transform"));
+        record.hasAngles = true;
+        record.startAngle = startAngle;
+        record.spanAngle = endAngle;
     }
     
-    return ellipse;
+    parseShapeRecordAttributes(element, record);
+    return true;
 }
 
-DrawingPath* SvgHandler::parsePathElement(const QDomElement &element)
+bool SvgHandler::parsePathElement(const QDomElement &element, SvgShapeRecord &record)
 {
     QString d = element.attribute("d");
     if (d.isEmpty()) {
-        return nullptr;
+        return false;
     }
     
-    QPainterPath path;
+    record.kind = SvgShapeRecord::Path;
     // 解析SVG路径数据
-    parseSvgPathData(d, path);
-    
-    DrawingPath *drawingPath = new DrawingPath();
-    drawingPath->setPath(path);
-    
-    // 自动生成控制点用于节点编辑
-    QVector<QPointF> controlPoints;
-    QVector<QPainterPath::ElementType> controlPointTypes;
-    
-    for (int i = 0; i < path.elementCount(); ++i) {
-        QPainterPath::Element element = path.elementAt(i);
-        // 保存所有元素作为控制点，包括曲线数据点
-        controlPoints.append(QPointF(element.x, element.y));
-        controlPointTypes.append(element.type);
-    }
-    
-    drawingPath->setControlPoints(controlPoints);
-    // 设置控制点类型信息
-    drawingPath->setControlPointTypes(controlPointTypes);
-    
-    // 解析样式属性
-    parseStyleAttributes(drawingPath, element);
+    parseSvgPathData(d, record.path);
     
-    // 解析变换属性
-    QString transform = element.attribute("transform");
-    if (!transform.isEmpty()) {
-        parseTransformAttribute(drawingPath, transform);
-    }
-    
-    // 解析Marker属性
-    QString markerStart = element.attribute("marker-start");
-    QString markerMid = element.attribute("marker-mid");
-    QString markerEnd = element.attribute("marker-end");
-    
-    // 应用Marker
-    applyMarkers(drawingPath, markerStart, markerMid, markerEnd);
-    
-    return drawingPath;
+    parseShapeRecordAttributes(element, record);
+    return true;
 }
 
 void SvgHandler::parseSvgPathData(const QString &data, QPainterPath &path)
 {
-    // 优化后的路径解析器，使用状态机模式提高性能
-    QVector<qreal> numbers;
-    numbers.reserve(64); // 预分配空间，减少重新分配
-    
-    QPointF currentPoint(0, 0);
-    QPointF pathStart(0, 0); // 记录子路径起点，用于Z命令
-    QPointF lastControlPoint(0, 0);
-    
-    int i = 0;
-    const int length = data.length();
-    
-    while (i < length) {
-        // 跳过空白字符
-        while (i < length && data[i].isSpace()) {
-            i++;
-        }
-        
-        if (i >= length) break;
-        
-        QChar cmd = data[i];
-        if (cmd.isLetter()) {
-            // 处理命令
-            bool isRelative = cmd.isLower();
-            cmd = cmd.toUpper();
-            i++;
-            
-            // 解析数字参数
-            numbers.clear();
-            while (i < length) {
-                // 跳过逗号和空白
-                while (i < length && (data[i] == ',' || data[i].isSpace())) {
-                    i++;
-                }
-                if (i >= length || data[i].isLetter()) break;
-                
-                // 解析数字（支持负号和小数点）
-                int start = i;
-                if (data[i] == '-' || data[i] == '+') i++;
-                while (i < length && (data[i].isDigit() || data[i] == '.')) {
-                    i++;
-                }
-                
-                if (start < i) {
-                    numbers.append(data.mid(start, i - start).toDouble());
-                } else {
-                    i++; // 防止死循环
-                }
-            }
-            
-            // 执行命令
-            int numCount = numbers.size();
-            int numIndex = 0;
-            
-            switch (cmd.toLatin1()) {
-                case 'M': // 移动到
-                    while (numIndex + 1 < numCount) {
-                        qreal x = numbers[numIndex];
-                        qreal y = numbers[numIndex + 1];
-                        if (isRelative) {
-                            x += currentPoint.x();
-                            y += currentPoint.y();
-                        }
-                        path.moveTo(x, y);
-                        currentPoint = QPointF(x, y);
-                        pathStart = currentPoint; // 更新子路径起点
-                        lastControlPoint = currentPoint;
-                        numIndex += 2;
-                    }
-                    break;
-                    
-                case 'L': // 线条到
-                    while (numIndex + 1 < numCount) {
-                        qreal x = numbers[numIndex];
-                        qreal y = numbers[numIndex + 1];
-                        if (isRelative) {
-                            x += currentPoint.x();
-                            y += currentPoint.y();
-                        }
-                        path.lineTo(x, y);
-                        currentPoint = QPointF(x, y);
-                        lastControlPoint = currentPoint;
-                        numIndex += 2;
-                    }
-                    break;
-                    
-                case 'H': // 水平线
-                    while (numIndex < numCount) {
-                        qreal x = numbers[numIndex];
-                        if (isRelative) {
-                            x += currentPoint.x();
-                        }
-                        path.lineTo(x, currentPoint.y());
-                        currentPoint.setX(x);
-                        lastControlPoint = currentPoint;
-                        numIndex += 1;
-                    }
-                    break;
-                    
-                case 'V': // 垂直线
-                    while (numIndex < numCount) {
-                        qreal y = numbers[numIndex];
-                        if (isRelative) {
-                            y += currentPoint.y();
-                        }
-                        path.lineTo(currentPoint.x(), y);
-                        currentPoint.setY(y);
-                        lastControlPoint = currentPoint;
-                        numIndex += 1;
-                    }
-                    break;
-                    
-                case 'C': // 三次贝塞尔曲线
-                    while (numIndex + 5 < numCount) {
-                        qreal x1 = numbers[numIndex];
-                        qreal y1 = numbers[numIndex + 1];
-                        qreal x2 = numbers[numIndex + 2];
-                        qreal y2 = numbers[numIndex + 3];
-                        qreal x = numbers[numIndex + 4];
-                        qreal y = numbers[numIndex + 5];
-                        
-                        if (isRelative) {
-                            x1 += currentPoint.x();
-                            y1 += currentPoint.y();
-                            x2 += currentPoint.x();
-                            y2 += currentPoint.y();
-                            x += currentPoint.x();
-                            y += currentPoint.y();
-                        }
-                        
-                        path.cubicTo(x1, y1, x2, y2, x, y);
-                        currentPoint = QPointF(x, y);
-                        lastControlPoint = QPointF(x2, y2);
-                        numIndex += 6;
-                    }
-                    break;
-                    
-                case 'S': // 平滑三次贝塞尔曲线
-                    while (numIndex + 3 < numCount) {
-                        qreal x2 = numbers[numIndex];
-                        qreal y2 = numbers[numIndex + 1];
-                        qreal x = numbers[numIndex + 2];
-                        qreal y = numbers[numIndex + 3];
-                        
-                        QPointF controlPoint;
-                        if (path.elementCount() > 0 && 
-                            (path.elementAt(path.elementCount()-1).type == QPainterPath::CurveToDataElement ||
-                             path.elementAt(path.elementCount()-2).type == QPainterPath::CurveToDataElement)) {
-                            // 使用对称控制点
-                            controlPoint = QPointF(2 * currentPoint.x() - lastControlPoint.x(),
-                                                   2 * currentPoint.y() - lastControlPoint.y());
-                        } else {
-                            controlPoint = currentPoint;
-                        }
-                        
-                        if (isRelative) {
-                            x2 += currentPoint.x();
-                            y2 += currentPoint.y();
-                            x += currentPoint.x();
-                            y += currentPoint.y();
-                        }
-                        
-                        path.cubicTo(controlPoint.x(), controlPoint.y(), x2, y2, x, y);
-                        currentPoint = QPointF(x, y);
-                        lastControlPoint = QPointF(x2, y2);
-                        numIndex += 4;
-                    }
-                    break;
-                    
-                case 'Q': // 二次贝塞尔曲线
-                    while (numIndex + 3 < numCount) {
-                        qreal x1 = numbers[numIndex];
-                        qreal y1 = numbers[numIndex + 1];
-                        qreal x = numbers[numIndex + 2];
-                        qreal y = numbers[numIndex + 3];
-                        
-                        if (isRelative) {
-                            x1 += currentPoint.x();
-                            y1 += currentPoint.y();
-                            x += currentPoint.x();
-                            y += currentPoint.y();
-                        }
-                        
-                        path.quadTo(x1, y1, x, y);
-                        currentPoint = QPointF(x, y);
-                        lastControlPoint = QPointF(x1, y1);
-                        numIndex += 4;
-                    }
-                    break;
-                    
-                case 'T': // 平滑二次贝塞尔曲线
-                    while (numIndex + 1 < numCount) {
-                        qreal x = numbers[numIndex];
-                        qreal y = numbers[numIndex + 1];
-                        
-                        QPointF controlPoint;
-                        if (path.elementCount() > 0 && 
-                            path.elementAt(path.elementCount()-1).type == QPainterPath::CurveToDataElement) {
-                            controlPoint = QPointF(2 * currentPoint.x() - lastControlPoint.x(),
-                                                   2 * currentPoint.y() - lastControlPoint.y());
-                        } else {
-                            controlPoint = currentPoint;
-                        }
-                        
-                        if (isRelative) {
-                            x += currentPoint.x();
-                            y += currentPoint.y();
-                        }
-                        
-                        path.quadTo(controlPoint.x(), controlPoint.y(), x, y);
-                        currentPoint = QPointF(x, y);
-                        lastControlPoint = controlPoint;
-                        numIndex += 2;
-                    }
-                    break;
-                    
-                case 'A': // 椭圆弧（简化实现，转换为贝塞尔曲线）
-                    while (numIndex + 6 < numCount) {
-                        // 参数：rx, ry, x-axis-rotation, large-arc-flag, sweep-flag, x, y
-                        qreal rx = numbers[numIndex];
-                        qreal ry = numbers[numIndex + 1];
-                        qreal xAxisRotation = numbers[numIndex + 2] * M_PI / 180.0;
-                        bool largeArcFlag = numbers[numIndex + 3] > 0.5;
-                        bool sweepFlag = numbers[numIndex + 4] > 0.5;
-                        qreal x = numbers[numIndex + 5];
-                        qreal y = numbers[numIndex + 6];
-                        
-                        if (isRelative) {
-                            x += currentPoint.x();
-                            y += currentPoint.y();
-                        }
-                        
-                        // 简化实现：使用直线代替椭圆弧
-                        // TODO: 实现完整的椭圆弧到贝塞尔曲线的转换
-                        path.lineTo(x, y);
-                        currentPoint = QPointF(x, y);
-                        lastControlPoint = currentPoint;
-                        numIndex += 7;
-                    }
-                    break;
-                    
-                case 'Z': // 闭合路径
-                    path.closeSubpath();
-                    currentPoint = pathStart; // 回到子路径起点
-                    lastControlPoint = currentPoint;
-                    break;
-                    
-                default:
-                    // 未知命令，跳过
-                    break;
-            }
-        } else {
-            // 没有命令字符，跳过
-            i++;
-        }
-    }
+    // 单遍扫描，数字和标志位原地解析，直接写入path
+    SvgPathParser::parse(data, path);
+}
+
+void SvgHandler::convertEllipticalArcToBezier(QPainterPath &path, const QPointF &start, const QPointF &end,
+                                              qreal rx, qreal ry, qreal xAxisRotation,
+                                              bool largeArcFlag, bool sweepFlag)
+{
+    SvgPathParser::appendArc(path, start, end, rx, ry, xAxisRotation, largeArcFlag, sweepFlag);
 }
 
-DrawingRectangle* SvgHandler::parseRectElement(const QDomElement &element)
+bool SvgHandler::parseRectElement(const QDomElement &element, SvgShapeRecord &record)
 {
     qreal x = element.attribute("x", "0").toDouble();
     qreal y = element.attribute("y", "0").toDouble();
@@ -643,24 +773,16 @@ DrawingRectangle* SvgHandler::parseRectElement(const QDomElement &element)
     qreal height = element.attribute("height", "0").toDouble();
     
     if (width <= 0 || height <= 0) {
-        return nullptr;
-    }
-    
-    DrawingRectangle *rect = new DrawingRectangle(QRectF(x, y, width, height));
-    
-    // 解析样式属性
-    parseStyleAttributes(rect, element);
-    
-    // 解析变换属性
-    QString transform = element.attribute("transform");
-    if (!transform.isEmpty()) {
-        parseTransformAttribute(rect, transform);
+        return false;
     }
     
-    return rect;
+    record.kind = SvgShapeRecord::Rectangle;
+    record.rect = QRectF(x, y, width, height);
+    parseShapeRecordAttributes(element, record);
+    return true;
 }
 
-DrawingEllipse* SvgHandler::parseEllipseElement(const QDomElement &element)
+bool SvgHandler::parseEllipseElement(const QDomElement &element, SvgShapeRecord &record)
 {
     qreal cx = element.attribute("cx", "0").toDouble();
     qreal cy = element.attribute("cy", "0").toDouble();
@@ -668,197 +790,105 @@ DrawingEllipse* SvgHandler::parseEllipseElement(const QDomElement &element)
     qreal ry = element.attribute("ry", "0").toDouble();
     
     if (rx <= 0 || ry <= 0) {
-        return nullptr;
-    }
-    
-    QRectF rect(cx - rx, cy - ry, 2 * rx, 2 * ry);
-    DrawingEllipse *ellipse = new DrawingEllipse(rect);
-    
-    // 解析样式属性
-    parseStyleAttributes(ellipse, element);
-    
-    // 解析变换属性
-    QString transform = element.attribute("transform");
-    if (!transform.isEmpty()) {
-        parseTransformAttribute(ellipse, transform);
+        return false;
     }
     
-    return ellipse;
+    record.kind = SvgShapeRecord::Ellipse;
+    record.rect = QRectF(cx - rx, cy - ry, 2 * rx, 2 * ry);
+    parseShapeRecordAttributes(element, record);
+    return true;
 }
 
-DrawingEllipse* SvgHandler::parseCircleElement(const QDomElement &element)
+bool SvgHandler::parseCircleElement(const QDomElement &element, SvgShapeRecord &record)
 {
     qreal cx = element.attribute("cx", "0").toDouble();
     qreal cy = element.attribute("cy", "0").toDouble();
     qreal r = element.attribute("r", "0").toDouble();
     
     if (r <= 0) {
-        return nullptr;
-    }
-    
-    QRectF rect(cx - r, cy - r, 2 * r, 2 * r);
-    DrawingEllipse *circle = new DrawingEllipse(rect);
-    
-    // 解析样式属性
-    parseStyleAttributes(circle, element);
-    
-    // 解析变换属性
-    QString transform = element.attribute("transform");
-    if (!transform.isEmpty()) {
-        parseTransformAttribute(circle, transform);
+        return false;
     }
     
-    return circle;
+    record.kind = SvgShapeRecord::Ellipse;
+    record.rect = QRectF(cx - r, cy - r, 2 * r, 2 * r);
+    parseShapeRecordAttributes(element, record);
+    return true;
 }
 
-DrawingPath* SvgHandler::parseLineElement(const QDomElement &element)
+bool SvgHandler::parseLineElement(const QDomElement &element, SvgShapeRecord &record)
 {
     qreal x1 = element.attribute("x1", "0").toDouble();
     qreal y1 = element.attribute("y1", "0").toDouble();
     qreal x2 = element.attribute("x2", "0").toDouble();
     qreal y2 = element.attribute("y2", "0").toDouble();
     
-    QPainterPath path;
-    path.moveTo(x1, y1);
-    path.lineTo(x2, y2);
-    
-    DrawingPath *line = new DrawingPath();
-    line->setPath(path);
-    
-    // 解析样式属性
-    parseStyleAttributes(line, element);
-    
-    // 解析变换属性
-    QString transform = element.attribute("transform");
-    if (!transform.isEmpty()) {
-        parseTransformAttribute(line, transform);
-    }
-    
-    // 解析Marker属性
-    QString markerStart = element.attribute("marker-start");
-    QString markerMid = element.attribute("marker-mid");
-    QString markerEnd = element.attribute("marker-end");
-    
-    // 应用Marker
-    applyMarkers(line, markerStart, markerMid, markerEnd);
-    
-    return line;
+    record.kind = SvgShapeRecord::Path;
+    record.path.moveTo(x1, y1);
+    record.path.lineTo(x2, y2);
+    parseShapeRecordAttributes(element, record);
+    return true;
 }
 
-DrawingPath* SvgHandler::parsePolygonElement(const QDomElement &element)
+bool SvgHandler::parsePolygonElement(const QDomElement &element, SvgShapeRecord &record)
 {
     QString pointsStr = element.attribute("points");
     if (pointsStr.isEmpty()) {
-        return nullptr;
-    }
-    
-    QPainterPath path;
-    QStringList pointsList = pointsStr.split(QRegularExpression("\\s+"), Qt::SkipEmptyParts);
-    
-    for (int i = 0; i < pointsList.size(); i += 2) {
-        if (i + 1 < pointsList.size()) {
-            qreal x = pointsList[i].toDouble();
-            qreal y = pointsList[i + 1].toDouble();
-            
-            if (i == 0) {
-                path.moveTo(x, y);
-            } else {
-                path.lineTo(x, y);
-            }
-        }
-    }
-    
-    if (element.tagName() == "polygon") {
-        path.closeSubpath(); // 多边形需要闭合
-    }
-    
-    DrawingPath *shape = new DrawingPath();
-    shape->setPath(path);
-    
-    // 解析样式属性
-    parseStyleAttributes(shape, element);
-    
-    // 解析变换属性
-    QString transform = element.attribute("transform");
-    if (!transform.isEmpty()) {
-        parseTransformAttribute(shape, transform);
+        return false;
     }
     
-    // 解析Marker属性
-    QString markerStart = element.attribute("marker-start");
-    QString markerMid = element.attribute("marker-mid");
-    QString markerEnd = element.attribute("marker-end");
-    
-    // 应用Marker
-    applyMarkers(shape, markerStart, markerMid, markerEnd);
-    
-    return shape;
+    // 坐标之间可以用逗号或空白分隔，多边形需要闭合
+    record.kind = SvgShapeRecord::Path;
+    SvgPathParser::parsePoints(pointsStr, record.path, element.tagName() == "polygon");
+    parseShapeRecordAttributes(element, record);
+    return true;
 }
 
-DrawingText* SvgHandler::parseTextElement(const QDomElement &element)
+bool SvgHandler::parseTextElement(const QDomElement &element, SvgShapeRecord &record)
 {
     // 获取文本内容
     QString text = element.text().trimmed();
     if (text.isEmpty()) {
         // qDebug() << "文本元素内容为空";
-        return nullptr;
+        return false;
     }
     
+    record.kind = SvgShapeRecord::Text;
+    record.text = text;
+    
     // 获取位置
     qreal x = element.attribute("x", "0").toDouble();
     qreal y = element.attribute("y", "0").toDouble();
-    QPointF position(x, y);
-    
-    // 创建文本形状
-    DrawingText *shape = new DrawingText(text);
-    shape->setPosition(position);
-    
-    // 解析字体属性
-    QString fontFamily = element.attribute("font-family", "Arial");
-    qreal fontSize = element.attribute("font-size", "12").toDouble();
-    QString fontWeight = element.attribute("font-weight", "normal");
-    QString fontStyle = element.attribute("font-style", "normal");
-    
-    QFont font(fontFamily);
-    font.setPointSizeF(fontSize);
+    record.position = QPointF(x, y);
     
-    if (fontWeight == "bold") {
-        font.setBold(true);
-    }
-    
-    if (fontStyle == "italic") {
-        font.setItalic(true);
-    }
-    
-    shape->setFont(font);
-    
-    // 解析样式属性
-    parseStyleAttributes(shape, element);
-    
-    // 解析变换属性
-    QString transform = element.attribute("transform");
-    if (!transform.isEmpty()) {
-        parseTransformAttribute(shape, transform);
-    }
+    // 解析字体属性，QFont在GUI线程创建
+    record.fontFamily = element.attribute("font-family", "Arial");
+    record.fontSize = element.attribute("font-size", "12").toDouble();
+    record.bold = element.attribute("font-weight", "normal") == "bold";
+    record.italic = element.attribute("font-style", "normal") == "italic";
     
-    // qDebug() << "解析文本元素:" << text << "位置:" << position;
-    return shape;
+    parseShapeRecordAttributes(element, record);
+    return true;
+}
+
+void SvgHandler::parseStyleAttributes(SvgImportContext &context, DrawingShape *shape, const QDomElement &element)
+{
+    applyStyleRecord(context, shape, parseStyleRecord(element));
 }
 
-void SvgHandler::parseStyleAttributes(DrawingShape *shape, const QDomElement &element)
+SvgStyleRecord SvgHandler::parseStyleRecord(const QDomElement &element)
 {
+    SvgStyleRecord style;
+    
     // 解析stroke属性
     QString stroke = element.attribute("stroke");
     if (!stroke.isEmpty()) {
         if (stroke == "none") {
             // 显式设置无边框
-            shape->setStrokePen(Qt::NoPen);
+            style.stroke = SvgStyleRecord::PaintNone;
         } else {
-            QColor strokeColor = parseColor(stroke);
-            if (strokeColor.isValid()) {
-                QPen pen = shape->strokePen();
-                pen.setColor(strokeColor);
-                shape->setStrokePen(pen);
+            style.strokeColor = parseColor(stroke);
+            if (style.strokeColor.isValid()) {
+                style.stroke = SvgStyleRecord::PaintColor;
             }
         }
     }
@@ -868,9 +898,7 @@ void SvgHandler::parseStyleAttributes(DrawingShape *shape, const QDomElement &el
     if (!strokeWidth.isEmpty()) {
         qreal width = parseLength(strokeWidth);
         if (width > 0) {
-            QPen pen = shape->strokePen();
-            pen.setWidthF(width);
-            shape->setStrokePen(pen);
+            style.strokeWidth = width;
         }
     }
     
@@ -879,46 +907,15 @@ void SvgHandler::parseStyleAttributes(DrawingShape *shape, const QDomElement &el
     if (!fill.isEmpty()) {
         if (fill == "none") {
             // 显式设置无填充
-            shape->setFillBrush(Qt::NoBrush);
+            style.fill = SvgStyleRecord::PaintNone;
         } else if (fill.startsWith("url(#")) {
-            QString refId = fill.mid(5, fill.length() - 6); // 去掉 "url(#" 和 ")"
-            
-            // 首先检查是否是渐变
-            if (s_gradients.contains(refId)) {
-                QGradient gradient = s_gradients[refId];
-                
-                // 设置渐变坐标模式为对象边界框模式
-                gradient.setCoordinateMode(QGradient::ObjectBoundingMode);
-                
-                // 创建画刷
-                QBrush brush(gradient);
-                shape->setFillBrush(brush);
-                
-                // 调试信息
-                // qDebug() << "应用渐变填充:" << refId;
-        // qDebug() << "渐变类型:" << gradient.type();
-        // qDebug() << "渐变停止点数量:" << gradient.stops().count();
-        // qDebug() << "坐标模式: ObjectBoundingMode";
-                
-                // 检查画刷是否有效
-                if (brush.style() == Qt::LinearGradientPattern || 
-                    brush.style() == Qt::RadialGradientPattern ||
-                    brush.style() == Qt::ConicalGradientPattern) {
-                    // qDebug() << "画刷样式有效:" << brush.style();
-                } else {
-                    // qDebug() << "警告: 画刷样式无效:" << brush.style();
-                }
-            }
-            // 然后检查是否是Pattern
-            else if (s_patterns.contains(refId)) {
-                QBrush patternBrush = s_patterns[refId];
-                shape->setFillBrush(patternBrush);
-                // 应用Pattern填充
-            }
+            // 渐变和Pattern在GUI线程按id查找
+            style.fill = SvgStyleRecord::PaintReference;
+            style.fillReference = fill.mid(5, fill.length() - 6); // 去掉 "url(#" 和 ")"
         } else {
-            QColor fillColor = parseColor(fill);
-            if (fillColor.isValid()) {
-                shape->setFillBrush(QBrush(fillColor));
+            style.fillColor = parseColor(fill);
+            if (style.fillColor.isValid()) {
+                style.fill = SvgStyleRecord::PaintColor;
             }
         }
     }
@@ -926,64 +923,91 @@ void SvgHandler::parseStyleAttributes(DrawingShape *shape, const QDomElement &el
     // 解析opacity属性
     QString opacity = element.attribute("opacity");
     if (!opacity.isEmpty()) {
-        qreal opacityValue = opacity.toDouble();
+        style.hasOpacity = true;
+        style.opacity = opacity.toDouble();
+    }
+    
+    // 解析filter属性
+    QString filter = element.attribute("filter");
+    if (!filter.isEmpty() && filter.startsWith("url(#")) {
+        style.filterId = filter.mid(5, filter.length() - 6); // 去掉 "url(#" 和 ")"
+    }
+    
+    return style;
+}
+
+void SvgHandler::applyStyleRecord(SvgImportContext &context, DrawingShape *shape, const SvgStyleRecord &style)
+{
+    if (style.stroke == SvgStyleRecord::PaintNone) {
+        shape->setStrokePen(Qt::NoPen);
+    } else if (style.stroke == SvgStyleRecord::PaintColor) {
+        QPen pen = shape->strokePen();
+        pen.setColor(style.strokeColor);
+        shape->setStrokePen(pen);
+    }
+    
+    if (style.strokeWidth > 0) {
+        QPen pen = shape->strokePen();
+        pen.setWidthF(style.strokeWidth);
+        shape->setStrokePen(pen);
+    }
+    
+    if (style.fill == SvgStyleRecord::PaintNone) {
+        shape->setFillBrush(Qt::NoBrush);
+    } else if (style.fill == SvgStyleRecord::PaintColor) {
+        shape->setFillBrush(QBrush(style.fillColor));
+    } else if (style.fill == SvgStyleRecord::PaintReference) {
+        // 渐变和Pattern画刷由上下文共享，这里只增加引用计数
+        QBrush brush;
+        if (context.findPaint(style.fillReference, brush)) {
+            shape->setFillBrush(brush);
+        }
+    }
+    
+    if (style.hasOpacity) {
         // 应用到画笔和画刷
         QPen pen = shape->strokePen();
         QColor strokeColor = pen.color();
-        strokeColor.setAlphaF(opacityValue);
+        strokeColor.setAlphaF(style.opacity);
         pen.setColor(strokeColor);
         shape->setStrokePen(pen);
         
         QBrush brush = shape->fillBrush();
         QColor fillColor = brush.color();
-        fillColor.setAlphaF(opacityValue);
+        fillColor.setAlphaF(style.opacity);
         brush.setColor(fillColor);
         shape->setFillBrush(brush);
     }
     
-    // 解析filter属性
-    QString filter = element.attribute("filter");
-    if (!filter.isEmpty() && filter.startsWith("url(#")) {
-        QString filterId = filter.mid(5, filter.length() - 6); // 去掉 "url(#" 和 ")"
-        applyFilterToShape(shape, filterId);
+    if (!style.filterId.isEmpty()) {
+        applyFilterToShape(context, shape, style.filterId);
     }
 }
 
-void SvgHandler::parseStyleAttributes(DrawingGroup *group, const QDomElement &element)
+void SvgHandler::parseTransformAttribute(DrawingShape *shape, const QString &transformStr)
 {
-    // DrawingGroup 本身不需要解析样式，样式应该传递给子元素
-    // 这里可以解析组的透明度等属性
-    QString opacity = element.attribute("opacity");
-    if (!opacity.isEmpty()) {
-        qreal opacityValue = opacity.toDouble();
-        // 设置组的透明度
-        group->setOpacity(opacityValue);
-    }
-    
-    // 解析filter属性
-    QString filter = element.attribute("filter");
-    if (!filter.isEmpty() && filter.startsWith("url(#")) {
-        QString filterId = filter.mid(5, filter.length() - 6); // 去掉 "url(#" 和 ")"
-        applyFilterToShape(group, filterId);
-    }
+    // 在形状已有变换的基础上组合，应用组合变换到形状
+    shape->applyTransform(parseTransform(transformStr, shape->transform()));
 }
 
-void SvgHandler::parseTransformAttribute(DrawingShape *shape, const QString &transformStr)
+QTransform SvgHandler::parseTransform(const QString &transformStr, const QTransform &base)
 {
     // 解析SVG变换字符串，如 "translate(10,20) rotate(45) scale(2,1)"
+    // 只使用局部对象，可在工作线程中调用
     QRegularExpression regex("(\\S+)\\s*\\(\\s*([^)]+)\\s*\\)");
+    QRegularExpression separator("\\s*,\\s*|\\s+");
     QRegularExpressionMatchIterator iter = regex.globalMatch(transformStr);
     
-    QTransform currentTransform = shape->transform();
+    QTransform currentTransform = base;
     
     while (iter.hasNext()) {
         QRegularExpressionMatch match = iter.next();
         QString func = match.captured(1);
         QString paramsStr = match.captured(2);
         
-        QStringList params = paramsStr.split(QRegularExpression("\\s*,\\s*|\\s+"), Qt::SkipEmptyParts);
+        QStringList params = paramsStr.split(separator, Qt::SkipEmptyParts);
         
-        if (func == "translate" && params.size() >= 2) {
+        if (func == "translate" && params.size() >= 1) {
             qreal tx = params[0].toDouble();
             qreal ty = params.size() > 1 ? params[1].toDouble() : 0.0;
             currentTransform.translate(tx, ty);
@@ -1011,64 +1035,11 @@ void SvgHandler::parseTransformAttribute(DrawingShape *shape, const QString &tra
             qreal e = params[4].toDouble();
             qreal f = params[5].toDouble();
             
-            QTransform qtTransform(a, b, c, d, e, f);
-            currentTransform = qtTransform;
-        }
-    }
-    
-    // 应用组合变换到形状
-    shape->applyTransform(currentTransform);
-}
-
-void SvgHandler::parseTransformAttribute(DrawingGroup *group, const QString &transformStr)
-{
-    // 解析SVG变换字符串，如 "translate(10,20) rotate(45) scale(2,1)"
-    QRegularExpression regex("(\\S+)\\s*\\(\\s*([^)]+)\\s*\\)");
-    QRegularExpressionMatchIterator iter = regex.globalMatch(transformStr);
-    
-    QTransform combinedTransform;
-    
-    while (iter.hasNext()) {
-        QRegularExpressionMatch match = iter.next();
-        QString func = match.captured(1);
-        QString paramsStr = match.captured(2);
-        
-        QStringList params = paramsStr.split(QRegularExpression("\\s*,\\s*|\\s+"), Qt::SkipEmptyParts);
-        
-        if (func == "translate" && params.size() >= 2) {
-            qreal tx = params[0].toDouble();
-            qreal ty = params.size() > 1 ? params[1].toDouble() : 0.0;
-            combinedTransform.translate(tx, ty);
-        } else if (func == "rotate" && params.size() >= 1) {
-            qreal angle = params[0].toDouble();
-            qreal cx = 0, cy = 0;
-            if (params.size() >= 3) {
-                cx = params[1].toDouble();
-                cy = params[2].toDouble();
-            }
-            combinedTransform.translate(cx, cy);
-            combinedTransform.rotate(angle);
-            combinedTransform.translate(-cx, -cy);
-        } else if (func == "scale" && params.size() >= 1) {
-            qreal sx = params[0].toDouble();
-            qreal sy = params.size() > 1 ? params[1].toDouble() : sx;
-            combinedTransform.scale(sx, sy);
-        } else if (func == "matrix" && params.size() >= 6) {
-            // 解析6参数仿射变换矩阵
-            qreal a = params[0].toDouble();
-            qreal b = params[1].toDouble();
-            qreal c = params[2].toDouble();
-            qreal d = params[3].toDouble();
-            qreal e = params[4].toDouble();
-            qreal f = params[5].toDouble();
-            
-            QTransform qtTransform(a, b, c, d, e, f);
-            combinedTransform = qtTransform;
+            currentTransform = QTransform(a, b, c, d, e, f);
         }
     }
     
-    // 应用组合变换到组
-    group->applyTransform(combinedTransform);
+    return currentTransform;
 }
 
 QColor SvgHandler::parseColor(const QString &colorStr)
@@ -1150,36 +1121,49 @@ qreal SvgHandler::parseLength(const QString &lengthStr)
 
 bool SvgHandler::exportToSvg(DrawingScene *scene, const QString &fileName)
 {
-    QDomDocument doc = exportSceneToSvgDocument(scene);
-    
-    QFile file(fileName);
+    // 写入临时文件，成功后再替换目标文件，保存中断时不会留下残缺的文件
+    QSaveFile file(fileName);
     if (!file.open(QIODevice::WriteOnly)) {
         qDebug() << "无法创建SVG文件:" << fileName;
         return false;
     }
     
-    file.write(doc.toByteArray(2)); // 2表示缩进为2个空格
-    file.close();
+    if (!exportToSvg(scene, &file)) {
+        file.cancelWriting();
+        return false;
+    }
+    
+    if (!file.commit()) {
+        qDebug() << "无法保存SVG文件:" << fileName << file.errorString();
+        return false;
+    }
     
     return true;
 }
 
-QDomDocument SvgHandler::exportSceneToSvgDocument(DrawingScene *scene)
+bool SvgHandler::exportToSvg(DrawingScene *scene, QIODevice *device, int precision)
 {
-    QDomDocument doc;
+    SvgExportWriter writer(device, precision);
     
-    // 创建SVG根元素
-    QDomElement svgElement = doc.createElement("svg");
-    svgElement.setAttribute("xmlns", "http://www.w3.org/2000/svg");
-    svgElement.setAttribute("xmlns:xlink", "http://www.w3.org/1999/xlink");
-    svgElement.setAttribute("version", "1.1");
+    writer.xml().writeStartDocument();
+    writeSceneToSvg(writer, scene);
+    writer.xml().writeEndDocument();
+    
+    if (writer.hasError()) {
+        qDebug() << "写入SVG数据失败:" << device->errorString();
+        return false;
+    }
     
-    // 计算场景中所有内容的边界框
-    QRectF contentBounds;
+    return true;
+}
+
+void SvgHandler::writeSceneToSvg(SvgExportWriter &writer, DrawingScene *scene)
+{
+    // 场景中所有内容的边界框直接取文档图形表
+    QRectF contentBounds = scene->document()->bounds();
     QList<QGraphicsItem*> allItems = scene->items();
-    bool firstItem = true;
     
-    // 收集所有图层和形状
+    // 收集所有图层和形状（只保存指针，元素边遍历边写出）
     QList<DrawingLayer*> layers;
     QList<DrawingShape*> shapes;
     
@@ -1187,31 +1171,10 @@ QDomDocument SvgHandler::exportSceneToSvgDocument(DrawingScene *scene)
         // 跳过选择指示器等辅助元素
         if (item->type() == QGraphicsItem::UserType + 100) {
             // DrawingLayer
-            
-            // DrawingLayer *layer = static_cast<DrawingLayer*>(item);
-            // if (layer) {
-            //     layers.append(layer);
-            //     // 使用 sceneBoundingRect 获取场景中的实际边界
-            //     QRectF layerBounds = layer->sceneBoundingRect();
-            //     if (firstItem) {
-            //         contentBounds = layerBounds;
-            //         firstItem = false;
-            //     } else {
-            //         contentBounds = contentBounds.united(layerBounds);
-            //     }
-            // }
         } else {
             DrawingShape *shape = qgraphicsitem_cast<DrawingShape*>(item);
             if (shape) {
                 shapes.append(shape);
-                // 使用 sceneBoundingRect 获取场景中的实际边界
-                QRectF shapeBounds = shape->sceneBoundingRect();
-                if (firstItem) {
-                    contentBounds = shapeBounds;
-                    firstItem = false;
-                } else {
-                    contentBounds = contentBounds.united(shapeBounds);
-                }
             }
         }
     }
@@ -1224,350 +1187,465 @@ QDomDocument SvgHandler::exportSceneToSvgDocument(DrawingScene *scene)
         contentBounds = QRectF(0, 0, 800, 600);
     }
     
+    const bool offsetContent = contentBounds.left() != 0 || contentBounds.top() != 0;
+    auto writeOffset = [&writer, &contentBounds]() {
+        QString &value = writer.buffer();
+        value += QLatin1String("translate(");
+        writer.appendNumber(-contentBounds.left());
+        value += QLatin1Char(',');
+        writer.appendNumber(-contentBounds.top());
+        value += QLatin1Char(')');
+        writer.writeBuffer("transform");
+    };
+    
+    // 创建SVG根元素
+    writer.writeStartElement("svg");
+    writer.writeAttribute("xmlns", "http://www.w3.org/2000/svg");
+    writer.writeAttribute("xmlns:xlink", "http://www.w3.org/1999/xlink");
+    writer.writeAttribute("version", "1.1");
+    
     // 设置 viewBox 从 (0,0) 开始，宽高为内容的实际尺寸
-    svgElement.setAttribute("viewBox", QString("0 0 %1 %2")
-        .arg(contentBounds.width())
-        .arg(contentBounds.height()));
+    QString &viewBox = writer.buffer();
+    viewBox += QLatin1String("0 0 ");
+    writer.appendNumber(contentBounds.width());
+    viewBox += QLatin1Char(' ');
+    writer.appendNumber(contentBounds.height());
+    writer.writeBuffer("viewBox");
     
     // 设置 SVG 的实际尺寸
-    svgElement.setAttribute("width", QString::number(contentBounds.width()));
-    svgElement.setAttribute("height", QString::number(contentBounds.height()));
+    writer.writeNumber("width", contentBounds.width());
+    writer.writeNumber("height", contentBounds.height());
     
     // 添加一个 transform 来移动内容到正确的位置
-    if (contentBounds.left() != 0 || contentBounds.top() != 0) {
-        svgElement.setAttribute("transform", QString("translate(%1,%2)")
-            .arg(-contentBounds.left())
-            .arg(-contentBounds.top()));
+    if (offsetContent) {
+        writeOffset();
     }
     
-    // 创建defs元素用于定义渐变和滤镜
-    QDomElement defsElement = doc.createElement("defs");
-    svgElement.appendChild(defsElement);
-    
-    // 导出渐变定义
-    exportGradientsToSvg(doc, defsElement, allItems);
-    
-    // 导出滤镜定义
-    exportFiltersToSvg(doc, defsElement, allItems);
+    // defs元素用于定义渐变和滤镜
+    writer.writeStartElement("defs");
+    writeGradients(writer, allItems);
+    writeFilters(writer, allItems);
+    writer.writeEndElement();
     
     // 创建一个组元素来包含所有内容，并应用必要的变换
-    QDomElement groupElement = doc.createElement("g");
-    
-    // 如果内容不在原点，添加变换来移动内容
-    if (contentBounds.left() != 0 || contentBounds.top() != 0) {
-        groupElement.setAttribute("transform", QString("translate(%1,%2)")
-            .arg(-contentBounds.left())
-            .arg(-contentBounds.top()));
+    writer.writeStartElement("g");
+    if (offsetContent) {
+        writeOffset();
     }
     
     // 首先导出图层（保持层次结构）
+    QSet<DrawingShape*> layerShapes;
     for (DrawingLayer *layer : layers) {
-        QDomElement layerElement = exportLayerToSvgElement(doc, layer);
-        if (!layerElement.isNull()) {
-            groupElement.appendChild(layerElement);
+        writeLayerElement(writer, layer);
+        for (DrawingShape *shape : layer->shapes()) {
+            layerShapes.insert(shape);
         }
     }
     
     // 然后导出不在图层中的独立形状
     for (DrawingShape *shape : shapes) {
-        // 检查形状是否在某个图层中
-        bool inLayer = false;
-        for (DrawingLayer *layer : layers) {
-            if (layer->shapes().contains(shape)) {
-                inLayer = true;
-                break;
-            }
-        }
-        
-        if (!inLayer) {
-            QDomElement shapeElement = exportShapeToSvgElement(doc, shape);
-            if (!shapeElement.isNull()) {
-                groupElement.appendChild(shapeElement);
-            }
+        if (!layerShapes.contains(shape)) {
+            writeShapeElement(writer, shape);
         }
     }
     
-    svgElement.appendChild(groupElement);
-    doc.appendChild(svgElement);
-    return doc;
+    writer.writeEndElement(); // g
+    writer.writeEndElement(); // svg
 }
 
-QDomElement SvgHandler::exportShapeToSvgElement(QDomDocument &doc, DrawingShape *shape)
+void SvgHandler::writeShapeElement(SvgExportWriter &writer, DrawingShape *shape)
 {
     if (!shape) {
-        return QDomElement();
+        return;
     }
     
     switch (shape->shapeType()) {
         case DrawingShape::Path:
-            return exportPathToSvgElement(doc, static_cast<DrawingPath*>(shape));
+            writePathElement(writer, static_cast<DrawingPath*>(shape));
+            break;
         case DrawingShape::Rectangle:
-            return exportRectangleToSvgElement(doc, static_cast<DrawingRectangle*>(shape));
+            writeRectangleElement(writer, static_cast<DrawingRectangle*>(shape));
+            break;
         case DrawingShape::Ellipse:
-            return exportEllipseToSvgElement(doc, static_cast<DrawingEllipse*>(shape));
+            writeEllipseElement(writer, static_cast<DrawingEllipse*>(shape));
+            break;
         case DrawingShape::Text:
-            return exportTextToSvgElement(doc, static_cast<DrawingText*>(shape));
+            writeTextElement(writer, static_cast<DrawingText*>(shape));
+            break;
         case DrawingShape::Line:
-            return exportLineToSvgElement(doc, static_cast<DrawingLine*>(shape));
+            writeLineElement(writer, static_cast<DrawingLine*>(shape));
+            break;
         case DrawingShape::Polyline:
-            return exportPolylineToSvgElement(doc, static_cast<DrawingPolyline*>(shape));
+            writePolylineElement(writer, static_cast<DrawingPolyline*>(shape));
+            break;
         case DrawingShape::Polygon:
-            return exportPolygonToSvgElement(doc, static_cast<DrawingPolygon*>(shape));
+            writePolygonElement(writer, static_cast<DrawingPolygon*>(shape));
+            break;
         default:
             qDebug() << "未知的图形类型，无法导出:" << shape->shapeType();
-            return QDomElement();
+            break;
     }
 }
 
-QDomElement SvgHandler::exportPathToSvgElement(QDomDocument &doc, DrawingPath *path)
+void SvgHandler::writeStrokeAttributes(SvgExportWriter &writer, const QPen &pen)
 {
-    QDomElement pathElement = doc.createElement("path");
+    if (pen.style() == Qt::NoPen) {
+        return;
+    }
     
-    // 导出路径数据
-    QString pathData = pathDataToString(path->path());
-    pathElement.setAttribute("d", pathData);
+    writer.writeColor("stroke", pen.color());
+    writer.writeNumber("stroke-width", pen.widthF());
+    if (pen.color().alphaF() < 1.0) {
+        writer.writeNumber("stroke-opacity", pen.color().alphaF());
+    }
+    // 导出线条样式
+    if (pen.style() == Qt::DashLine) {
+        writer.writeAttribute("stroke-dasharray", "5,5");
+    } else if (pen.style() == Qt::DotLine) {
+        writer.writeAttribute("stroke-dasharray", "2,2");
+    }
+}
+
+void SvgHandler::writeFillAttributes(SvgExportWriter &writer, const QBrush &brush,
+                                     const QString &gradientPrefix, const QString &noFill)
+{
+    if (brush.style() == Qt::NoBrush) {
+        writer.writeAttribute("fill", noFill);
+        return;
+    }
     
-    // 导出变换
-    QTransform transform = path->transform();
-    if (!transform.isIdentity()) {
-        pathElement.setAttribute("transform", transformToString(transform));
+    if (!gradientPrefix.isEmpty()
+        && (brush.style() == Qt::LinearGradientPattern || brush.style() == Qt::RadialGradientPattern)) {
+        // 引用渐变
+        QString &value = writer.buffer();
+        value += QLatin1String("url(#");
+        value += gradientPrefix;
+        value += QString::number(quintptr(brush.gradient()));
+        value += QLatin1Char(')');
+        writer.writeBuffer("fill");
+        return;
     }
     
-    // 导出样式
-    QPen pen = path->strokePen();
-    QBrush brush = path->fillBrush();
+    writer.writeColor("fill", brush.color());
+    if (brush.color().alphaF() < 1.0) {
+        writer.writeNumber("fill-opacity", brush.color().alphaF());
+    }
+}
+
+void SvgHandler::writeFilterAttribute(SvgExportWriter &writer, QGraphicsEffect *effect)
+{
+    if (qobject_cast<QGraphicsBlurEffect*>(effect)) {
+        writer.writeAttribute("filter", "url(#blur_0)");
+    } else if (qobject_cast<QGraphicsDropShadowEffect*>(effect)) {
+        writer.writeAttribute("filter", "url(#shadow_0)");
+    }
+}
+
+void SvgHandler::writePathElement(SvgExportWriter &writer, DrawingPath *path)
+{
+    writer.writeStartElement("path");
+    writer.writePathData("d", path->path());
+    writer.writeTransform("transform", path->transform());
+    writeStrokeAttributes(writer, path->strokePen());
+    writeFillAttributes(writer, path->fillBrush(), "grad_", "none");
+    writeFilterAttribute(writer, path->graphicsEffect());
+    writer.writeEndElement();
+}
+
+void SvgHandler::writeRectangleElement(SvgExportWriter &writer, DrawingRectangle *rect)
+{
+    writer.writeStartElement("rect");
     
-    if (pen.style() != Qt::NoPen) {
-        pathElement.setAttribute("stroke", pen.color().name());
-        pathElement.setAttribute("stroke-width", QString::number(pen.widthF()));
-        if (pen.color().alphaF() < 1.0) {
-            pathElement.setAttribute("stroke-opacity", QString::number(pen.color().alphaF()));
-        }
-        // 导出线条样式
-        if (pen.style() == Qt::DashLine) {
-            pathElement.setAttribute("stroke-dasharray", "5,5");
-        } else if (pen.style() == Qt::DotLine) {
-            pathElement.setAttribute("stroke-dasharray", "2,2");
-        }
+    // 计算实际位置（位置 + 本地边界）
+    QPointF pos = rect->pos();
+    QRectF bounds = rect->localBounds();
+    writer.writeNumber("x", pos.x() + bounds.x());
+    writer.writeNumber("y", pos.y() + bounds.y());
+    writer.writeNumber("width", bounds.width());
+    writer.writeNumber("height", bounds.height());
+    
+    // 导出圆角
+    if (rect->cornerRadius() > 0) {
+        writer.writeNumber("rx", rect->cornerRadius());
+        writer.writeNumber("ry", rect->cornerRadius());
     }
     
-    if (brush.style() != Qt::NoBrush) {
-        if (brush.style() == Qt::LinearGradientPattern || brush.style() == Qt::RadialGradientPattern) {
-            pathElement.setAttribute("fill", QString("url(#grad_%1)").arg(quintptr(brush.gradient())));
-        } else {
-            pathElement.setAttribute("fill", brush.color().name());
-            if (brush.color().alphaF() < 1.0) {
-                pathElement.setAttribute("fill-opacity", QString::number(brush.color().alphaF()));
-            }
-        }
+    writer.writeTransform("transform", rect->transform());
+    writeStrokeAttributes(writer, rect->strokePen());
+    writeFillAttributes(writer, rect->fillBrush(), "grad_", "none");
+    writeFilterAttribute(writer, rect->graphicsEffect());
+    writer.writeEndElement();
+}
+
+void SvgHandler::writeEllipseElement(SvgExportWriter &writer, DrawingEllipse *ellipse)
+{
+    QPointF pos = ellipse->pos();
+    QRectF bounds = ellipse->localBounds();
+    qreal spanAngle = ellipse->spanAngle();
+    
+    qreal cx = pos.x() + bounds.x() + bounds.width() / 2;
+    qreal cy = pos.y() + bounds.y() + bounds.height() / 2;
+    qreal rx = bounds.width() / 2;
+    qreal ry = bounds.height() / 2;
+    
+    // 如果跨度接近360度（允许一些误差），则认为是完整椭圆
+    if (qFuzzyCompare(qAbs(spanAngle), 360.0) || qFuzzyCompare(spanAngle, 0.0) || qAbs(spanAngle) > 350) {
+        writer.writeStartElement("ellipse");
+        writer.writeNumber("cx", cx);
+        writer.writeNumber("cy", cy);
+        writer.writeNumber("rx", rx);
+        writer.writeNumber("ry", ry);
     } else {
-        pathElement.setAttribute("fill", "none");
+        // 椭圆弧：M 起点 A 半径 0 large-arc-flag,sweep-flag 终点
+        writer.writeStartElement("path");
+        QString &d = writer.buffer();
+        d += QLatin1String("M ");
+        writer.appendNumber(cx - rx);
+        d += QLatin1Char(',');
+        writer.appendNumber(cy);
+        d += QLatin1String(" A ");
+        writer.appendNumber(rx);
+        d += QLatin1Char(',');
+        writer.appendNumber(ry);
+        d += QLatin1String(" 0 ");
+        d += spanAngle > 180 ? QLatin1Char('1') : QLatin1Char('0');
+        d += QLatin1Char(',');
+        d += spanAngle > 0 ? QLatin1Char('1') : QLatin1Char('0');
+        d += QLatin1Char(' ');
+        writer.appendNumber(cx + rx);
+        d += QLatin1Char(',');
+        writer.appendNumber(cy);
+        writer.writeBuffer("d");
+    }
+    
+    writer.writeTransform("transform", ellipse->transform());
+    writeStrokeAttributes(writer, ellipse->strokePen());
+    writeFillAttributes(writer, ellipse->fillBrush(), "radial_", "none");
+    writeFilterAttribute(writer, ellipse->graphicsEffect());
+    writer.writeEndElement();
+}
+
+void SvgHandler::writeTextElement(SvgExportWriter &writer, DrawingText *text)
+{
+    writer.writeStartElement("text");
+    
+    // 设置位置
+    QPointF pos = text->position();
+    writer.writeNumber("x", pos.x());
+    writer.writeNumber("y", pos.y());
+    
+    // 导出字体属性
+    QFont font = text->font();
+    if (!font.family().isEmpty()) {
+        writer.writeAttribute("font-family", font.family());
+    }
+    if (font.pointSizeF() > 0) {
+        writer.writeNumber("font-size", font.pointSizeF());
+    }
+    if (font.bold()) {
+        writer.writeAttribute("font-weight", "bold");
     }
-    
-    // 导出滤镜
-    QGraphicsEffect *effect = path->graphicsEffect();
-    if (effect) {
-        if (qobject_cast<QGraphicsBlurEffect*>(effect)) {
-            pathElement.setAttribute("filter", QString("url(#blur_0)"));
-        } else if (qobject_cast<QGraphicsDropShadowEffect*>(effect)) {
-            pathElement.setAttribute("filter", QString("url(#shadow_0)"));
-        }
+    if (font.italic()) {
+        writer.writeAttribute("font-style", "italic");
     }
     
-    return pathElement;
+    writer.writeTransform("transform", text->transform());
+    writeStrokeAttributes(writer, text->strokePen());
+    // 文本不引用渐变，默认颜色为黑色
+    writeFillAttributes(writer, text->fillBrush(), QString(), "black");
+    writeFilterAttribute(writer, text->graphicsEffect());
+    
+    // 文本内容在所有属性之后写出
+    writer.xml().writeCharacters(text->text());
+    writer.writeEndElement();
 }
 
-QDomElement SvgHandler::exportRectangleToSvgElement(QDomDocument &doc, DrawingRectangle *rect)
+void SvgHandler::writeLineElement(SvgExportWriter &writer, DrawingLine *line)
 {
-    QDomElement rectElement = doc.createElement("rect");
-    
-    // 获取图形的位置和本地边界
-    QPointF pos = rect->pos();
-    QRectF bounds = rect->localBounds();
-    
-    // 计算实际位置（位置 + 本地边界）
-    rectElement.setAttribute("x", QString::number(pos.x() + bounds.x()));
-    rectElement.setAttribute("y", QString::number(pos.y() + bounds.y()));
-    rectElement.setAttribute("width", QString::number(bounds.width()));
-    rectElement.setAttribute("height", QString::number(bounds.height()));
-    
-    // 导出圆角
-    if (rect->cornerRadius() > 0) {
-        rectElement.setAttribute("rx", QString::number(rect->cornerRadius()));
-        rectElement.setAttribute("ry", QString::number(rect->cornerRadius()));
-    }
-    
-    // 导出变换
-    QTransform transform = rect->transform();
-    if (!transform.isIdentity()) {
-        rectElement.setAttribute("transform", transformToString(transform));
+    if (!line) {
+        return;
     }
     
-    // 导出样式
-    QPen pen = rect->strokePen();
-    QBrush brush = rect->fillBrush();
-    
-    if (pen.style() != Qt::NoPen) {
-        rectElement.setAttribute("stroke", pen.color().name());
-        rectElement.setAttribute("stroke-width", QString::number(pen.widthF()));
-        if (pen.color().alphaF() < 1.0) {
-            rectElement.setAttribute("stroke-opacity", QString::number(pen.color().alphaF()));
-        }
-    }
+    writer.writeStartElement("line");
     
-    if (brush.style() != Qt::NoBrush) {
-        if (brush.style() == Qt::LinearGradientPattern || brush.style() == Qt::RadialGradientPattern) {
-            // 引用渐变
-            rectElement.setAttribute("fill", QString("url(#grad_%1)").arg(quintptr(brush.gradient())));
-        } else {
-            rectElement.setAttribute("fill", brush.color().name());
-            if (brush.color().alphaF() < 1.0) {
-                rectElement.setAttribute("fill-opacity", QString::number(brush.color().alphaF()));
-            }
-        }
-    } else {
-        rectElement.setAttribute("fill", "none");
+    // 计算实际位置（位置 + 线条坐标）
+    QPointF pos = line->pos();
+    QLineF l = line->line();
+    writer.writeNumber("x1", pos.x() + l.x1());
+    writer.writeNumber("y1", pos.y() + l.y1());
+    writer.writeNumber("x2", pos.x() + l.x2());
+    writer.writeNumber("y2", pos.y() + l.y2());
+    
+    writeStrokeAttributes(writer, line->strokePen());
+    writeFillAttributes(writer, line->fillBrush(), QString(), "none");
+    writer.writeEndElement();
+}
+
+void SvgHandler::writePolylineElement(SvgExportWriter &writer, DrawingPolyline *polyline)
+{
+    if (!polyline) {
+        return;
     }
     
-    // 导出滤镜
-    QGraphicsEffect *effect = rect->graphicsEffect();
-    if (effect) {
-        if (qobject_cast<QGraphicsBlurEffect*>(effect)) {
-            rectElement.setAttribute("filter", QString("url(#blur_0)"));
-        } else if (qobject_cast<QGraphicsDropShadowEffect*>(effect)) {
-            rectElement.setAttribute("filter", QString("url(#shadow_0)"));
-        }
+    writer.writeStartElement("polyline");
+    // 计算实际位置（位置 + 点坐标）
+    writer.writePoints("points", polyline->getNodePoints(), polyline->pos());
+    writeStrokeAttributes(writer, polyline->strokePen());
+    writeFillAttributes(writer, polyline->fillBrush(), QString(), "none");
+    writer.writeEndElement();
+}
+
+void SvgHandler::writePolygonElement(SvgExportWriter &writer, DrawingPolygon *polygon)
+{
+    if (!polygon) {
+        return;
     }
     
-    return rectElement;
+    writer.writeStartElement("polygon");
+    // 计算实际位置（位置 + 点坐标）
+    writer.writePoints("points", polygon->getNodePoints(), polygon->pos());
+    writeStrokeAttributes(writer, polygon->strokePen());
+    writeFillAttributes(writer, polygon->fillBrush(), QString(), "none");
+    writer.writeEndElement();
 }
 
-QDomElement SvgHandler::exportEllipseToSvgElement(QDomDocument &doc, DrawingEllipse *ellipse)
+void SvgHandler::writeLayerElement(SvgExportWriter &writer, DrawingLayer *layer)
 {
-    QDomElement ellipseElement;
+    writer.writeStartElement("g");
     
-    // 获取图形的位置和本地边界
-    QPointF pos = ellipse->pos();
-    QRectF bounds = ellipse->localBounds();
-    
-    // 检查是否是完整的椭圆（360度或接近360度）
-    qreal startAngle = ellipse->startAngle();
-    qreal spanAngle = ellipse->spanAngle();
+    // 设置图层属性
+    if (!layer->name().isEmpty()) {
+        writer.writeAttribute("id", layer->name());
+    }
     
-    // 如果跨度接近360度（允许一些误差），则认为是完整椭圆
-    if (qFuzzyCompare(qAbs(spanAngle), 360.0) || qFuzzyCompare(spanAngle, 0.0) || qAbs(spanAngle) > 350) {
-        // 完整椭圆
-        ellipseElement = doc.createElement("ellipse");
-        qreal cx = pos.x() + bounds.x() + bounds.width() / 2;
-        qreal cy = pos.y() + bounds.y() + bounds.height() / 2;
-        qreal rx = bounds.width() / 2;
-        qreal ry = bounds.height() / 2;
-        
-        ellipseElement.setAttribute("cx", QString::number(cx));
-        ellipseElement.setAttribute("cy", QString::number(cy));
-        ellipseElement.setAttribute("rx", QString::number(rx));
-        ellipseElement.setAttribute("ry", QString::number(ry));
-    } else {
-        // 椭圆弧
-        ellipseElement = doc.createElement("path");
-        
-        // 使用椭圆弧路径
-        qreal cx = pos.x() + bounds.x() + bounds.width() / 2;
-        qreal cy = pos.y() + bounds.y() + bounds.height() / 2;
-        qreal rx = bounds.width() / 2;
-        qreal ry = bounds.height() / 2;
-        
-        QString pathData = QString("M %1,%2 A %3,%4 0 %5,1 %6,%7")
-            .arg(cx - rx).arg(cy)  // 起点
-            .arg(rx).arg(ry)       // 半径
-            .arg(spanAngle > 180 ? 1 : 0)  // large-arc-flag
-            .arg(spanAngle > 0 ? 1 : 0)   // sweep-flag
-            .arg(cx + rx).arg(cy); // 终点
-        
-        ellipseElement.setAttribute("d", pathData);
+    if (layer->opacity() < 1.0) {
+        writer.writeNumber("opacity", layer->opacity());
     }
     
-    // 导出变换
-    QTransform transform = ellipse->transform();
-    if (!transform.isIdentity()) {
-        ellipseElement.setAttribute("transform", transformToString(transform));
+    if (!layer->isVisible()) {
+        writer.writeAttribute("visibility", "hidden");
     }
     
-    // 导出样式
-    QPen pen = ellipse->strokePen();
-    QBrush brush = ellipse->fillBrush();
+    // 导出图层变换
+    writer.writeTransform("transform", layer->layerTransform());
     
-    if (pen.style() != Qt::NoPen) {
-        ellipseElement.setAttribute("stroke", pen.color().name());
-        ellipseElement.setAttribute("stroke-width", QString::number(pen.widthF()));
-        if (pen.color().alphaF() < 1.0) {
-            ellipseElement.setAttribute("stroke-opacity", QString::number(pen.color().alphaF()));
-        }
+    // 导出图层中的所有形状
+    for (DrawingShape *shape : layer->shapes()) {
+        writeShapeElement(writer, shape);
     }
     
-    if (brush.style() != Qt::NoBrush) {
-        if (brush.style() == Qt::LinearGradientPattern || brush.style() == Qt::RadialGradientPattern) {
-            ellipseElement.setAttribute("fill", QString("url(#radial_%1)").arg(quintptr(brush.gradient())));
-        } else {
-            ellipseElement.setAttribute("fill", brush.color().name());
-            if (brush.color().alphaF() < 1.0) {
-                ellipseElement.setAttribute("fill-opacity", QString::number(brush.color().alphaF()));
-            }
+    writer.writeEndElement();
+}
+
+void SvgHandler::writeGradientStops(SvgExportWriter &writer, const QGradient &gradient)
+{
+    for (const QGradientStop &stop : gradient.stops()) {
+        writer.writeStartElement("stop");
+        writer.writeNumber("offset", stop.first);
+        writer.writeColor("stop-color", stop.second);
+        if (stop.second.alphaF() < 1.0) {
+            writer.writeNumber("stop-opacity", stop.second.alphaF());
         }
-    } else {
-        ellipseElement.setAttribute("fill", "none");
+        writer.writeEndElement();
     }
+}
+
+void SvgHandler::writeGradients(SvgExportWriter &writer, const QList<QGraphicsItem*> &items)
+{
+    QSet<const QGradient*> exportedGradients;
     
-    // 导出滤镜
-    QGraphicsEffect *effect = ellipse->graphicsEffect();
-    if (effect) {
-        if (qobject_cast<QGraphicsBlurEffect*>(effect)) {
-            ellipseElement.setAttribute("filter", QString("url(#blur_0)"));
-        } else if (qobject_cast<QGraphicsDropShadowEffect*>(effect)) {
-            ellipseElement.setAttribute("filter", QString("url(#shadow_0)"));
+    // 收集所有使用的渐变
+    for (QGraphicsItem *item : items) {
+        DrawingShape *shape = qgraphicsitem_cast<DrawingShape*>(item);
+        if (!shape) {
+            continue;
+        }
+        
+        QBrush brush = shape->fillBrush();
+        const QGradient *gradient = brush.gradient();
+        if (!gradient || exportedGradients.contains(gradient)) {
+            continue;
         }
+        
+        if (brush.style() == Qt::LinearGradientPattern) {
+            const QLinearGradient *linear = static_cast<const QLinearGradient*>(gradient);
+            writer.writeStartElement("linearGradient");
+            QString &id = writer.buffer();
+            id += QLatin1String("grad_");
+            id += QString::number(exportedGradients.size());
+            writer.writeBuffer("id");
+            writer.writeNumber("x1", linear->start().x());
+            writer.writeNumber("y1", linear->start().y());
+            writer.writeNumber("x2", linear->finalStop().x());
+            writer.writeNumber("y2", linear->finalStop().y());
+        } else if (brush.style() == Qt::RadialGradientPattern) {
+            const QRadialGradient *radial = static_cast<const QRadialGradient*>(gradient);
+            writer.writeStartElement("radialGradient");
+            QString &id = writer.buffer();
+            id += QLatin1String("radial_");
+            id += QString::number(exportedGradients.size());
+            writer.writeBuffer("id");
+            writer.writeNumber("cx", radial->center().x());
+            writer.writeNumber("cy", radial->center().y());
+            writer.writeNumber("r", radial->radius());
+            writer.writeNumber("fx", radial->focalPoint().x());
+            writer.writeNumber("fy", radial->focalPoint().y());
+        } else {
+            continue;
+        }
+        
+        // 导出停止点
+        writeGradientStops(writer, *gradient);
+        writer.writeEndElement();
+        exportedGradients.insert(gradient);
     }
-    
-    return ellipseElement;
 }
 
-QString SvgHandler::pathDataToString(const QPainterPath &path)
+void SvgHandler::writeFilters(SvgExportWriter &writer, const QList<QGraphicsItem*> &items)
 {
-    QString result;
+    int filterCount = 0;
+    
+    auto writeFilterStart = [&writer, &filterCount](const QLatin1String &prefix) {
+        writer.writeStartElement("filter");
+        QString &id = writer.buffer();
+        id += prefix;
+        id += QString::number(filterCount++);
+        writer.writeBuffer("id");
+        writer.writeAttribute("x", "-50%");
+        writer.writeAttribute("y", "-50%");
+        writer.writeAttribute("width", "200%");
+        writer.writeAttribute("height", "200%");
+    };
     
-    for (int i = 0; i < path.elementCount(); ++i) {
-        QPainterPath::Element element = path.elementAt(i);
+    // 收集所有使用的滤镜
+    for (QGraphicsItem *item : items) {
+        DrawingShape *shape = qgraphicsitem_cast<DrawingShape*>(item);
+        if (!shape || !shape->graphicsEffect()) {
+            continue;
+        }
         
-        switch (element.type) {
-            case QPainterPath::MoveToElement:
-                result += QString("M %1,%2 ").arg(element.x).arg(element.y);
-                break;
-            case QPainterPath::LineToElement:
-                result += QString("L %1,%2 ").arg(element.x).arg(element.y);
-                break;
-            case QPainterPath::CurveToElement:
-                // 需要获取控制点和终点
-                if (i + 2 < path.elementCount()) {
-                    QPainterPath::Element ctrl1 = path.elementAt(i);
-                    QPainterPath::Element ctrl2 = path.elementAt(i + 1);
-                    QPainterPath::Element end = path.elementAt(i + 2);
-                    
-                    result += QString("C %1,%2 %3,%4 %5,%6 ")
-                        .arg(ctrl1.x).arg(ctrl1.y)
-                        .arg(ctrl2.x).arg(ctrl2.y)
-                        .arg(end.x).arg(end.y);
-                    
-                    i += 2; // 跳过已处理的元素
-                }
-                break;
+        QGraphicsEffect *effect = shape->graphicsEffect();
+        if (auto blurEffect = qobject_cast<QGraphicsBlurEffect*>(effect)) {
+            writeFilterStart(QLatin1String("blur_"));
+            writer.writeStartElement("feGaussianBlur");
+            writer.writeNumber("stdDeviation", blurEffect->blurRadius());
+            writer.writeEndElement();
+            writer.writeEndElement();
+        } else if (auto shadowEffect = qobject_cast<QGraphicsDropShadowEffect*>(effect)) {
+            writeFilterStart(QLatin1String("shadow_"));
+            writer.writeStartElement("feDropShadow");
+            writer.writeNumber("dx", shadowEffect->offset().x());
+            writer.writeNumber("dy", shadowEffect->offset().y());
+            writer.writeNumber("stdDeviation", shadowEffect->blurRadius());
+            writer.writeColor("flood-color", shadowEffect->color());
+            writer.writeEndElement();
+            writer.writeEndElement();
         }
     }
-    
-    return result.trimmed();
 }
 
 // 渐变解析方法
-void SvgHandler::parseDefsElements(const QDomElement &root)
+void SvgHandler::parseDefsElements(SvgImportContext &context, const QDomElement &root)
 {
     // 查找defs元素
     QDomNodeList defsNodes = root.elementsByTagName("defs");
@@ -1579,9 +1657,6 @@ void SvgHandler::parseDefsElements(const QDomElement &root)
     QDomElement defs = defsNodes.at(0).toElement();
     // qDebug() << "解析defs元素";
     
-    // 清理之前的渐变定义
-    s_gradients.clear();
-    
     // 解析所有线性渐变
     QDomNodeList linearGradients = defs.elementsByTagName("linearGradient");
     for (int i = 0; i < linearGradients.size(); ++i) {
@@ -1589,7 +1664,7 @@ void SvgHandler::parseDefsElements(const QDomElement &root)
         QString id = element.attribute("id");
         if (!id.isEmpty()) {
             QLinearGradient gradient = parseLinearGradient(element);
-            s_gradients[id] = gradient;
+            context.addGradient(id, gradient);
             // qDebug() << "解析线性渐变:" << id;
         }
     }
@@ -1601,7 +1676,7 @@ void SvgHandler::parseDefsElements(const QDomElement &root)
         QString id = element.attribute("id");
         if (!id.isEmpty()) {
             QRadialGradient gradient = parseRadialGradient(element);
-            s_gradients[id] = gradient;
+            context.addGradient(id, gradient);
             // qDebug() << "解析径向渐变:" << id;
         }
     }
@@ -1786,7 +1861,7 @@ void SvgHandler::parseGradientStops(QGradient *gradient, const QDomElement &elem
 }
 
 // 滤镜解析方法
-void SvgHandler::parseFilterElements(const QDomElement &root)
+void SvgHandler::parseFilterElements(SvgImportContext &context, const QDomElement &root)
 {
     // 查找defs元素
     QDomNodeList defsNodes = root.elementsByTagName("defs");
@@ -1798,13 +1873,6 @@ void SvgHandler::parseFilterElements(const QDomElement &root)
     QDomElement defs = defsNodes.at(0).toElement();
     // qDebug() << "解析滤镜元素";
     
-    // 清理之前的滤镜定义
-    for (auto it = s_filters.begin(); it != s_filters.end(); ++it) {
-        delete it.value();
-    }
-    s_filters.clear();
-    // qDebug() << "清理了" << s_filters.size() << "个滤镜定义";
-    
     // 解析所有滤镜
     QDomNodeList filters = defs.elementsByTagName("filter");
     for (int i = 0; i < filters.size(); ++i) {
@@ -1828,7 +1896,7 @@ void SvgHandler::parseFilterElements(const QDomElement &root)
                     }
                     
                     if (effect) {
-                        s_filters[id] = effect;
+                        context.addFilter(id, effect);
                         // qDebug() << "解析滤镜:" << id << "类型:" << tagName;
                         break; // 一个滤镜只处理第一个原始元素
                     }
@@ -1868,19 +1936,14 @@ QGraphicsDropShadowEffect* SvgHandler::parseDropShadowFilter(const QDomElement &
     return shadow;
 }
 
-void SvgHandler::applyFilterToShape(DrawingShape *shape, const QString &filterId)
+void SvgHandler::applyFilterToShape(SvgImportContext &context, DrawingShape *shape, const QString &filterId)
 {
     if (!shape || filterId.isEmpty()) {
         return;
     }
     
-    if (s_filters.contains(filterId)) {
-        QGraphicsEffect* effect = s_filters[filterId];
-        if (!effect) {
-            // qDebug() << "滤镜效果为空:" << filterId;
-            return;
-        }
-        
+    QGraphicsEffect* effect = context.filter(filterId);
+    if (effect) {
         // 注意：Qt中一个effect不能被多个item共享，需要克隆
         if (auto blurEffect = qobject_cast<QGraphicsBlurEffect*>(effect)) {
             QGraphicsBlurEffect* newBlur = new QGraphicsBlurEffect();
@@ -1904,19 +1967,14 @@ void SvgHandler::applyFilterToShape(DrawingShape *shape, const QString &filterId
     }
 }
 
-void SvgHandler::applyFilterToShape(DrawingGroup *group, const QString &filterId)
+void SvgHandler::applyFilterToShape(SvgImportContext &context, DrawingGroup *group, const QString &filterId)
 {
     if (!group || filterId.isEmpty()) {
         return;
     }
     
-    if (s_filters.contains(filterId)) {
-        QGraphicsEffect* effect = s_filters[filterId];
-        if (!effect) {
-            // qDebug() << "滤镜效果为空:" << filterId;
-            return;
-        }
-        
+    QGraphicsEffect* effect = context.filter(filterId);
+    if (effect) {
         // 注意：Qt中一个effect不能被多个item共享，需要克隆
         if (auto blurEffect = qobject_cast<QGraphicsBlurEffect*>(effect)) {
             QGraphicsBlurEffect* newBlur = new QGraphicsBlurEffect();
@@ -1941,7 +1999,7 @@ void SvgHandler::applyFilterToShape(DrawingGroup *group, const QString &filterId
 }
 
 // Pattern解析方法
-void SvgHandler::parsePatternElements(const QDomElement &root)
+void SvgHandler::parsePatternElements(SvgImportContext &context, const QDomElement &root)
 {
     // 查找defs元素
     QDomNodeList defsNodes = root.elementsByTagName("defs");
@@ -1953,9 +2011,6 @@ void SvgHandler::parsePatternElements(const QDomElement &root)
     QDomElement defs = defsNodes.at(0).toElement();
     // qDebug() << "解析Pattern元素";
     
-    // 清理之前的Pattern定义
-    s_patterns.clear();
-    
     // 解析所有Pattern
     QDomNodeList patterns = defs.elementsByTagName("pattern");
     for (int i = 0; i < patterns.size(); ++i) {
@@ -1964,7 +2019,7 @@ void SvgHandler::parsePatternElements(const QDomElement &root)
         if (!id.isEmpty()) {
             // 解析Pattern内容
             QBrush patternBrush = parsePatternBrush(patternElement);
-            s_patterns[id] = patternBrush;
+            context.addPattern(id, patternBrush);
             // qDebug() << "解析Pattern:" << id;
         }
     }
@@ -2064,11 +2119,12 @@ QBrush SvgHandler::parsePatternBrush(const QDomElement &patternElement)
     return patternBrush;
 }
 
-QBrush SvgHandler::parsePatternBrush(const QString &patternId)
+QBrush SvgHandler::parsePatternBrush(SvgImportContext &context, const QString &patternId)
 {
     // 兼容旧接口
-    if (s_patterns.contains(patternId)) {
-        return s_patterns[patternId];
+    QBrush brush;
+    if (context.findPattern(patternId, brush)) {
+        return brush;
     }
     
     // 返回默认Pattern
@@ -2091,7 +2147,7 @@ QBrush SvgHandler::parsePatternBrush(const QString &patternId)
 }
 
 // Marker解析方法
-void SvgHandler::parseMarkerElements(const QDomElement &root)
+void SvgHandler::parseMarkerElements(SvgImportContext &context, const QDomElement &root)
 {
     // 查找defs元素
     QDomNodeList defsNodes = root.elementsByTagName("defs");
@@ -2103,26 +2159,21 @@ void SvgHandler::parseMarkerElements(const QDomElement &root)
     QDomElement defs = defsNodes.at(0).toElement();
     // qDebug() << "解析Marker元素";
     
-    // 清理之前的Marker定义
-    s_markers.clear();
-    s_markerCache.clear();
-    
     // 解析所有Marker
     QDomNodeList markers = defs.elementsByTagName("marker");
     for (int i = 0; i < markers.size(); ++i) {
         QDomElement markerElement = markers.at(i).toElement();
         QString id = markerElement.attribute("id");
         if (!id.isEmpty()) {
-            s_markers[id] = markerElement;
             // 预渲染Marker到缓存
-            renderMarkerToCache(id, markerElement);
+            renderMarkerToCache(context, id, markerElement);
             // qDebug() << "解析Marker:" << id;
         }
     }
 }
 
 // 渲染Marker到缓存
-void SvgHandler::renderMarkerToCache(const QString &id, const QDomElement &markerElement)
+void SvgHandler::renderMarkerToCache(SvgImportContext &context, const QString &id, const QDomElement &markerElement)
 {
     // 获取Marker属性
     qreal markerWidth = parseLength(markerElement.attribute("markerWidth", "10"));
@@ -2194,20 +2245,21 @@ void SvgHandler::renderMarkerToCache(const QString &id, const QDomElement &marke
     }
     
     painter.end();
-    s_markerCache[id] = pixmap;
+    context.addMarker(id, markerElement, pixmap);
 }
 
 // 创建Marker路径
-QPainterPath SvgHandler::createMarkerPath(const QString &markerId, const QPointF &startPoint, const QPointF &endPoint)
+QPainterPath SvgHandler::createMarkerPath(SvgImportContext &context, const QString &markerId,
+                                          const QPointF &startPoint, const QPointF &endPoint)
 {
     QPainterPath markerPath;
     
-    if (!s_markers.contains(markerId) || !s_markerCache.contains(markerId)) {
+    if (!context.hasMarker(markerId)) {
         return markerPath;
     }
     
-    QDomElement markerElement = s_markers[markerId];
-    QPixmap markerPixmap = s_markerCache[markerId];
+    QDomElement markerElement = context.markerElement(markerId);
+    QPixmap markerPixmap = context.markerPixmap(markerId);
     
     // 获取Marker属性
     qreal markerWidth = parseLength(markerElement.attribute("markerWidth", "10"));
@@ -2240,7 +2292,8 @@ QPainterPath SvgHandler::createMarkerPath(const QString &markerId, const QPointF
 }
 
 // 应用所有类型的marker
-void SvgHandler::applyMarkers(DrawingPath *path, const QString &markerStart, const QString &markerMid, const QString &markerEnd)
+void SvgHandler::applyMarkers(SvgImportContext &context, DrawingPath *path,
+                              const QString &markerStart, const QString &markerMid, const QString &markerEnd)
 {
     if (!path) {
         return;
@@ -2252,7 +2305,7 @@ void SvgHandler::applyMarkers(DrawingPath *path, const QString &markerStart, con
         QRegularExpressionMatch match = markerRegex.match(markerEnd);
         if (match.hasMatch()) {
             QString markerId = match.captured(1);
-            applyMarkerToPath(path, markerId, "end");
+            applyMarkerToPath(context, path, markerId, "end");
         }
     }
     
@@ -2260,15 +2313,16 @@ void SvgHandler::applyMarkers(DrawingPath *path, const QString &markerStart, con
     // 需要扩展DrawingPath来支持多个marker
 }
 
-void SvgHandler::applyMarkerToPath(DrawingPath *path, const QString &markerId, const QString &position)
+void SvgHandler::applyMarkerToPath(SvgImportContext &context, DrawingPath *path,
+                                   const QString &markerId, const QString &position)
 {
     if (!path || markerId.isEmpty()) {
         return;
     }
     
-    if (s_markers.contains(markerId) && s_markerCache.contains(markerId)) {
-        QDomElement markerElement = s_markers[markerId];
-        QPixmap markerPixmap = s_markerCache[markerId];
+    if (context.hasMarker(markerId)) {
+        QDomElement markerElement = context.markerElement(markerId);
+        QPixmap markerPixmap = context.markerPixmap(markerId);
         
         // 获取Marker属性
         qreal markerWidth = parseLength(markerElement.attribute("markerWidth", "10"));
@@ -2315,370 +2369,14 @@ void SvgHandler::applyMarkerToPath(DrawingPath *path, const QString &markerId, c
         transform.translate(markerPoint.x() - refX, markerPoint.y() - refY);
         transform.rotate(angle);
         
-        // 存储Marker信息用于渲染
-        path->setMarker(markerId, markerPixmap, transform);
-    } else {
-    }
-}
-
-// 导出辅助函数实现
-QDomElement SvgHandler::exportLayerToSvgElement(QDomDocument &doc, DrawingLayer *layer)
-{
-    QDomElement gElement = doc.createElement("g");
-    
-    // 设置图层属性
-    if (!layer->name().isEmpty()) {
-        gElement.setAttribute("id", layer->name());
-    }
-    
-    if (layer->opacity() < 1.0) {
-        gElement.setAttribute("opacity", QString::number(layer->opacity()));
-    }
-    
-    if (!layer->isVisible()) {
-        gElement.setAttribute("visibility", "hidden");
-    }
-    
-    // 导出图层变换
-    if (!layer->layerTransform().isIdentity()) {
-        gElement.setAttribute("transform", transformToString(layer->layerTransform()));
-    }
-    
-    // 导出图层中的所有形状
-    for (DrawingShape *shape : layer->shapes()) {
-        if (shape) {
-            QDomElement shapeElement = exportShapeToSvgElement(doc, shape);
-            if (!shapeElement.isNull()) {
-                gElement.appendChild(shapeElement);
-            }
-        }
-    }
-    
-    return gElement;
-}
-
-void SvgHandler::exportGradientsToSvg(QDomDocument &doc, QDomElement &defsElement, const QList<QGraphicsItem*> &items)
-{
-    QSet<QString> exportedGradients;
-    
-    // 收集所有使用的渐变
-    for (QGraphicsItem *item : items) {
-        DrawingShape *shape = qgraphicsitem_cast<DrawingShape*>(item);
-        if (shape) {
-            QBrush brush = shape->fillBrush();
-            if (brush.style() == Qt::LinearGradientPattern) {
-                const QLinearGradient *gradient = static_cast<const QLinearGradient*>(brush.gradient());
-                if (gradient && !exportedGradients.contains(QString::number(quintptr(gradient)))) {
-                    QDomElement gradElement = doc.createElement("linearGradient");
-                    gradElement.setAttribute("id", QString("grad_%1").arg(exportedGradients.size()));
-                    gradElement.setAttribute("x1", QString::number(gradient->start().x()));
-                    gradElement.setAttribute("y1", QString::number(gradient->start().y()));
-                    gradElement.setAttribute("x2", QString::number(gradient->finalStop().x()));
-                    gradElement.setAttribute("y2", QString::number(gradient->finalStop().y()));
-                    
-                    // 导出停止点
-                    for (const QGradientStop &stop : gradient->stops()) {
-                        QDomElement stopElement = doc.createElement("stop");
-                        stopElement.setAttribute("offset", QString::number(stop.first));
-                        stopElement.setAttribute("stop-color", stop.second.name());
-                        if (stop.second.alphaF() < 1.0) {
-                            stopElement.setAttribute("stop-opacity", QString::number(stop.second.alphaF()));
-                        }
-                        gradElement.appendChild(stopElement);
-                    }
-                    
-                    defsElement.appendChild(gradElement);
-                    exportedGradients.insert(QString::number(quintptr(gradient)));
-                }
-            } else if (brush.style() == Qt::RadialGradientPattern) {
-                const QRadialGradient *gradient = static_cast<const QRadialGradient*>(brush.gradient());
-                if (gradient && !exportedGradients.contains(QString::number(quintptr(gradient)))) {
-                    QDomElement gradElement = doc.createElement("radialGradient");
-                    gradElement.setAttribute("id", QString("radial_%1").arg(exportedGradients.size()));
-                    gradElement.setAttribute("cx", QString::number(gradient->center().x()));
-                    gradElement.setAttribute("cy", QString::number(gradient->center().y()));
-                    gradElement.setAttribute("r", QString::number(gradient->radius()));
-                    gradElement.setAttribute("fx", QString::number(gradient->focalPoint().x()));
-                    gradElement.setAttribute("fy", QString::number(gradient->focalPoint().y()));
-                    
-                    // 导出停止点
-                    for (const QGradientStop &stop : gradient->stops()) {
-                        QDomElement stopElement = doc.createElement("stop");
-                        stopElement.setAttribute("offset", QString::number(stop.first));
-                        stopElement.setAttribute("stop-color", stop.second.name());
-                        if (stop.second.alphaF() < 1.0) {
-                            stopElement.setAttribute("stop-opacity", QString::number(stop.second.alphaF()));
-                        }
-                        gradElement.appendChild(stopElement);
-                    }
-                    
-                    defsElement.appendChild(gradElement);
-                    exportedGradients.insert(QString::number(quintptr(gradient)));
-                }
-            }
-        }
-    }
-}
-
-void SvgHandler::exportFiltersToSvg(QDomDocument &doc, QDomElement &defsElement, const QList<QGraphicsItem*> &items)
-{
-    QSet<QString> exportedFilters;
-    
-    // 收集所有使用的滤镜
-    for (QGraphicsItem *item : items) {
-        DrawingShape *shape = qgraphicsitem_cast<DrawingShape*>(item);
-        if (shape) {
-            QGraphicsEffect *effect = shape->graphicsEffect();
-            if (effect) {
-                if (auto blurEffect = qobject_cast<QGraphicsBlurEffect*>(effect)) {
-                    QString filterId = QString("blur_%1").arg(exportedFilters.size());
-                    if (!exportedFilters.contains(filterId)) {
-                        QDomElement filterElement = doc.createElement("filter");
-                        filterElement.setAttribute("id", filterId);
-                        filterElement.setAttribute("x", "-50%");
-                        filterElement.setAttribute("y", "-50%");
-                        filterElement.setAttribute("width", "200%");
-                        filterElement.setAttribute("height", "200%");
-                        
-                        QDomElement blurElement = doc.createElement("feGaussianBlur");
-                        blurElement.setAttribute("stdDeviation", QString::number(blurEffect->blurRadius()));
-                        
-                        filterElement.appendChild(blurElement);
-                        defsElement.appendChild(filterElement);
-                        exportedFilters.insert(filterId);
-                    }
-                } else if (auto shadowEffect = qobject_cast<QGraphicsDropShadowEffect*>(effect)) {
-                    QString filterId = QString("shadow_%1").arg(exportedFilters.size());
-                    if (!exportedFilters.contains(filterId)) {
-                        QDomElement filterElement = doc.createElement("filter");
-                        filterElement.setAttribute("id", filterId);
-                        filterElement.setAttribute("x", "-50%");
-                        filterElement.setAttribute("y", "-50%");
-                        filterElement.setAttribute("width", "200%");
-                        filterElement.setAttribute("height", "200%");
-                        
-                        QDomElement shadowElement = doc.createElement("feDropShadow");
-                        shadowElement.setAttribute("dx", QString::number(shadowEffect->offset().x()));
-                        shadowElement.setAttribute("dy", QString::number(shadowEffect->offset().y()));
-                        shadowElement.setAttribute("stdDeviation", QString::number(shadowEffect->blurRadius()));
-                        shadowElement.setAttribute("flood-color", shadowEffect->color().name());
-                        
-                        filterElement.appendChild(shadowElement);
-                        defsElement.appendChild(filterElement);
-                        exportedFilters.insert(filterId);
-                    }
-                }
-            }
-        }
-    }
-}
-
-QString SvgHandler::transformToString(const QTransform &transform)
-{
-    if (transform.isIdentity()) {
-        return QString();
-    }
-    
-    // 简化实现：只处理基本的变换
-    QStringList transforms;
-    
-    // 检查平移
-    if (!qFuzzyIsNull(transform.dx()) || !qFuzzyIsNull(transform.dy())) {
-        transforms.append(QString("translate(%1,%2)").arg(transform.dx()).arg(transform.dy()));
-    }
-    
-    // 检查旋转
-    qreal angle = 0;
-    if (!qFuzzyIsNull(transform.m12()) || !qFuzzyIsNull(transform.m21())) {
-        // 简单的旋转检测
-        angle = qAsin(transform.m21()) * 180.0 / M_PI;
-        transforms.append(QString("rotate(%1)").arg(angle));
-    }
-    
-    // 检查缩放
-    if (!qFuzzyIsNull(transform.m11() - 1) || !qFuzzyIsNull(transform.m22() - 1)) {
-        transforms.append(QString("scale(%1,%2)").arg(transform.m11()).arg(transform.m22()));
-    }
-    
-    return transforms.join(" ");
-}
-
-QDomElement SvgHandler::exportTextToSvgElement(QDomDocument &doc, DrawingText *text)
-{
-    QDomElement textElement = doc.createElement("text");
-    
-    // 设置文本内容
-    textElement.appendChild(doc.createTextNode(text->text()));
-    
-    // 设置位置
-    QPointF pos = text->position();
-    textElement.setAttribute("x", QString::number(pos.x()));
-    textElement.setAttribute("y", QString::number(pos.y()));
-    
-    // 导出字体属性
-    QFont font = text->font();
-    if (!font.family().isEmpty()) {
-        textElement.setAttribute("font-family", font.family());
-    }
-    if (font.pointSizeF() > 0) {
-        textElement.setAttribute("font-size", QString::number(font.pointSizeF()));
-    }
-    if (font.bold()) {
-        textElement.setAttribute("font-weight", "bold");
-    }
-    if (font.italic()) {
-        textElement.setAttribute("font-style", "italic");
-    }
-    
-    // 导出变换
-    QTransform transform = text->transform();
-    if (!transform.isIdentity()) {
-        textElement.setAttribute("transform", transformToString(transform));
-    }
-    
-    // 导出样式
-    QPen pen = text->strokePen();
-    QBrush brush = text->fillBrush();
-    
-    if (pen.style() != Qt::NoPen) {
-        textElement.setAttribute("stroke", pen.color().name());
-        textElement.setAttribute("stroke-width", QString::number(pen.widthF()));
-        if (pen.color().alphaF() < 1.0) {
-            textElement.setAttribute("stroke-opacity", QString::number(pen.color().alphaF()));
-        }
-    }
-    
-    if (brush.style() != Qt::NoBrush) {
-        textElement.setAttribute("fill", brush.color().name());
-        if (brush.color().alphaF() < 1.0) {
-            textElement.setAttribute("fill-opacity", QString::number(brush.color().alphaF()));
-        }
-    } else {
-        textElement.setAttribute("fill", "black"); // 默认文本颜色
-    }
-    
-    // 导出滤镜
-    QGraphicsEffect *effect = text->graphicsEffect();
-    if (effect) {
-        if (qobject_cast<QGraphicsBlurEffect*>(effect)) {
-            textElement.setAttribute("filter", QString("url(#blur_0)"));
-        } else if (qobject_cast<QGraphicsDropShadowEffect*>(effect)) {
-            textElement.setAttribute("filter", QString("url(#shadow_0)"));
-        }
-    }
-    
-    return textElement;
-}
-
-QDomElement SvgHandler::exportLineToSvgElement(QDomDocument &doc, DrawingLine *line)
-{
-    if (!line) {
-        return QDomElement();
-    }
-    
-    QDomElement lineElement = doc.createElement("line");
-    
-    // 获取线条的位置和线条本身
-    QPointF pos = line->pos();
-    QLineF l = line->line();
-    
-    // 计算实际位置（位置 + 线条坐标）
-    lineElement.setAttribute("x1", QString::number(pos.x() + l.x1()));
-    lineElement.setAttribute("y1", QString::number(pos.y() + l.y1()));
-    lineElement.setAttribute("x2", QString::number(pos.x() + l.x2()));
-    lineElement.setAttribute("y2", QString::number(pos.y() + l.y2()));
-    
-    // 导出样式
-    if (line->strokePen() != Qt::NoPen) {
-        lineElement.setAttribute("stroke", line->strokePen().color().name());
-        lineElement.setAttribute("stroke-width", QString::number(line->strokePen().widthF()));
-    }
-    
-    if (line->fillBrush() != Qt::NoBrush) {
-        lineElement.setAttribute("fill", line->fillBrush().color().name());
+        // 存储Marker信息用于渲染（id使用上下文驻留的字符串，多条路径共享）
+        path->setMarker(context.internId(markerId), markerPixmap, transform);
     } else {
-        lineElement.setAttribute("fill", "none");
     }
-    
-    return lineElement;
-}
-
-QDomElement SvgHandler::exportPolylineToSvgElement(QDomDocument &doc, DrawingPolyline *polyline)
-{
-    if (!polyline) {
-        return QDomElement();
-    }
-    
-    QDomElement polylineElement = doc.createElement("polyline");
-    
-    // 构建点字符串
-    QString pointsStr;
-    QPointF pos = polyline->pos();
-    QVector<QPointF> points = polyline->getNodePoints();
-    for (int i = 0; i < points.size(); ++i) {
-        const QPointF &p = points[i];
-        // 计算实际位置（位置 + 点坐标）
-        pointsStr += QString("%1,%2").arg(pos.x() + p.x()).arg(pos.y() + p.y());
-        if (i < points.size() - 1) {
-            pointsStr += " ";
-        }
-    }
-    polylineElement.setAttribute("points", pointsStr);
-    
-    // 导出样式
-    if (polyline->strokePen() != Qt::NoPen) {
-        polylineElement.setAttribute("stroke", polyline->strokePen().color().name());
-        polylineElement.setAttribute("stroke-width", QString::number(polyline->strokePen().widthF()));
-    }
-    
-    if (polyline->fillBrush() != Qt::NoBrush) {
-        polylineElement.setAttribute("fill", polyline->fillBrush().color().name());
-    } else {
-        polylineElement.setAttribute("fill", "none");
-    }
-    
-    return polylineElement;
-}
-
-QDomElement SvgHandler::exportPolygonToSvgElement(QDomDocument &doc, DrawingPolygon *polygon)
-{
-    if (!polygon) {
-        return QDomElement();
-    }
-    
-    QDomElement polygonElement = doc.createElement("polygon");
-    
-    // 构建点字符串
-    QString pointsStr;
-    QPointF pos = polygon->pos();
-    QVector<QPointF> points = polygon->getNodePoints();
-    for (int i = 0; i < points.size(); ++i) {
-        const QPointF &p = points[i];
-        // 计算实际位置（位置 + 点坐标）
-        pointsStr += QString("%1,%2").arg(pos.x() + p.x()).arg(pos.y() + p.y());
-        if (i < points.size() - 1) {
-            pointsStr += " ";
-        }
-    }
-    polygonElement.setAttribute("points", pointsStr);
-    
-    // 导出样式
-    if (polygon->strokePen() != Qt::NoPen) {
-        polygonElement.setAttribute("stroke", polygon->strokePen().color().name());
-        polygonElement.setAttribute("stroke-width", QString::number(polygon->strokePen().widthF()));
-    }
-    
-    if (polygon->fillBrush() != Qt::NoBrush) {
-        polygonElement.setAttribute("fill", polygon->fillBrush().color().name());
-    } else {
-        polygonElement.setAttribute("fill", "none");
-    }
-    
-    return polygonElement;
 }
 
 // 收集所有有id的元素（用于use元素）
-void SvgHandler::collectDefinedElements(const QDomElement &parent)
+void SvgHandler::collectDefinedElements(SvgImportContext &context, const QDomElement &parent)
 {
     QDomNodeList children = parent.childNodes();
     for (int i = 0; i < children.size(); ++i) {
@@ -2690,19 +2388,19 @@ void SvgHandler::collectDefinedElements(const QDomElement &parent)
             // 如果元素有id，存储它
             if (element.hasAttribute("id")) {
                 QString id = element.attribute("id");
-                s_definedElements[id] = element.cloneNode().toElement();
+                context.addDefinedElement(id, element.cloneNode().toElement());
             }
             
             // 递归处理子元素
             if (tagName == "defs" || tagName == "g") {
-                collectDefinedElements(element);
+                collectDefinedElements(context, element);
             }
         }
     }
 }
 
 // 解析use元素
-DrawingShape* SvgHandler::parseUseElement(const QDomElement &element)
+DrawingShape* SvgHandler::parseUseElement(SvgImportContext &context, const QDomElement &element)
 {
     // 获取href属性（引用的元素ID）
     QString href = element.attribute("href");
@@ -2718,14 +2416,13 @@ DrawingShape* SvgHandler::parseUseElement(const QDomElement &element)
     QString refId = href.mid(1); // 去掉#
     
     // 查找定义的元素
-    if (!s_definedElements.contains(refId)) {
+    QDomElement referencedElement = context.definedElement(refId);
+    if (referencedElement.isNull()) {
         return nullptr;
     }
     
-    QDomElement referencedElement = s_definedElements[refId];
-    
     // 克隆并解析引用的元素
-    DrawingShape *shape = parseSvgElement(referencedElement);
+    DrawingShape *shape = parseSvgElement(context, referencedElement);
     if (!shape) {
         return nullptr;
     }
@@ -2748,7 +2445,7 @@ DrawingShape* SvgHandler::parseUseElement(const QDomElement &element)
     }
     
     // 解析样式属性（use元素的样式会覆盖引用元素的样式）
-    parseStyleAttributes(shape, element);
+    parseStyleAttributes(context, shape, element);
     
     // 处理特定属性的覆盖（例如fill、stroke等）
     if (element.hasAttribute("fill")) {
@@ -14,6 +14,7 @@
 #include <QString>
 #include <QGraphicsBlurEffect>
 #include <QGraphicsDropShadowEffect>
+#include "../core/svg-export-writer.h"
 
 class DrawingScene;
 class DrawingShape;
@@ -26,6 +27,79 @@ class DrawingGroup;
 class DrawingLine;
 class DrawingPolyline;
 class DrawingPolygon;
+class QXmlStreamReader;
+class QIODevice;
+class SvgImportJob;
+class SvgImportContext;
+
+/**
+ * 样式记录 - 从元素属性解析出的描边/填充/透明度/滤镜，引用的资源只记录id
+ */
+struct SvgStyleRecord
+{
+    enum PaintKind { PaintUnset, PaintNone, PaintColor, PaintReference };
+    
+    PaintKind stroke = PaintUnset;
+    QColor strokeColor;
+    qreal strokeWidth = 0;      // 0表示未指定
+    PaintKind fill = PaintUnset;
+    QColor fillColor;
+    QString fillReference;      // 渐变或Pattern的id
+    bool hasOpacity = false;
+    qreal opacity = 1.0;
+    QString filterId;
+};
+
+/**
+ * 图形记录 - 不依赖场景的几何与样式数据，可在工作线程中生成
+ */
+struct SvgShapeRecord
+{
+    enum Kind { Invalid, Path, Rectangle, Ellipse, Text, Deferred };
+    
+    Kind kind = Invalid;
+    
+    // Path
+    QPainterPath path;
+    QString markerStart;
+    QString markerMid;
+    QString markerEnd;
+    
+    // Rectangle / Ellipse
+    QRectF rect;
+    bool hasAngles = false;
+    qreal startAngle = 0;
+    qreal spanAngle = 0;
+    
+    // Text
+    QString text;
+    QPointF position;
+    QString fontFamily;
+    qreal fontSize = 12;
+    bool bold = false;
+    bool italic = false;
+    
+    SvgStyleRecord style;
+    bool hasTransform = false;
+    QTransform transform;
+    
+    // use等依赖导入上下文中定义表的元素，留到GUI线程按DOM方式解析
+    QDomElement deferredElement;
+};
+
+/**
+ * 组记录 - <g>元素的图层、透明度、滤镜和变换
+ */
+struct SvgGroupRecord
+{
+    bool isLayer = false;
+    QString layerName;
+    bool hasOpacity = false;
+    qreal opacity = 1.0;
+    QString filterId;
+    bool hasTransform = false;
+    QTransform transform;
+};
 
 /**
  * SVG处理类 - 负责导入和导出SVG文件
@@ -33,81 +107,115 @@ class DrawingPolygon;
 class SvgHandler
 {
 public:
-    // 从SVG文件导入
+    // 从SVG文件导入（流式解析，不构建整棵DOM树）
     static bool importFromSvg(DrawingScene *scene, const QString &fileName);
     
-    // 导出到SVG文件
+    // 从SVG文件导入（先加载完整QDomDocument，保留用于对比和回退）
+    static bool importFromSvgDocument(DrawingScene *scene, const QString &fileName);
+    
+    // 导出到SVG文件（流式写出，不构建DOM）
     static bool exportToSvg(DrawingScene *scene, const QString &fileName);
     
+    // 导出到设备，precision默认保留6位有效数字，传入0到9时按固定小数位数
+    static bool exportToSvg(DrawingScene *scene, QIODevice *device,
+                            int precision = SvgExportWriter::DEFAULT_PRECISION);
+    
     // 从QPainterPath创建DrawingPath对象
     static DrawingPath* createPathFromPainterPath(const QPainterPath &path, const QString &elementId = QString());
 
 private:
+    friend class SvgImportJob;
+    
     // 解析SVG文档
-    static bool parseSvgDocument(DrawingScene *scene, const QDomDocument &doc);
+    static bool parseSvgDocument(DrawingScene *scene, SvgImportContext &context, const QDomDocument &doc);
+    
+    // 流式解析SVG：先收集defs和被use引用的元素，再逐个创建图形
+    static bool parseSvgStream(DrawingScene *scene, SvgImportContext &context, QIODevice *device);
+    static bool collectStreamDefinitions(SvgImportContext &context, QIODevice *device,
+                                         QDomDocument &defsDoc, QDomElement &defsRoot);
+    static QDomElement readStreamElement(QXmlStreamReader &reader, QDomDocument &doc, bool withChildren = true);
+    static bool isStreamShapeTag(const QString &tagName);
+    
+    // 解析defs中的渐变、滤镜、Pattern和Marker（创建像素图，必须在GUI线程调用）
+    static void parseResourceDefinitions(SvgImportContext &context, const QDomElement &root);
     
     // 解析SVG元素
-    static DrawingShape* parseSvgElement(const QDomElement &element);
+    static DrawingShape* parseSvgElement(SvgImportContext &context, const QDomElement &element);
+    
+    // 解析元素为记录：只做几何、变换和样式解析，不访问场景和导入上下文，可在工作线程调用
+    static bool parseShapeRecord(const QDomElement &element, SvgShapeRecord &record);
+    static SvgStyleRecord parseStyleRecord(const QDomElement &element);
+    static SvgGroupRecord parseGroupRecord(const QDomElement &element);
+    static void parseShapeRecordAttributes(const QDomElement &element, SvgShapeRecord &record);
+    
+    // 根据记录创建图形并解析资源引用（必须在GUI线程调用）
+    static DrawingShape* createShapeFromRecord(SvgImportContext &context, const SvgShapeRecord &record);
+    static void applyStyleRecord(SvgImportContext &context, DrawingShape *shape, const SvgStyleRecord &style);
     
     // 收集所有有id的元素（用于use元素）
-    static void collectDefinedElements(const QDomElement &parent);
+    static void collectDefinedElements(SvgImportContext &context, const QDomElement &parent);
     
     // 解析use元素
-    static DrawingShape* parseUseElement(const QDomElement &element);
+    static DrawingShape* parseUseElement(SvgImportContext &context, const QDomElement &element);
     
     // 调整use元素的变换，考虑位置偏移
     static QString adjustTransformForUseElement(const QString &transformStr, qreal x, qreal y);
     
-    // 解析变换字符串为QTransform
-    static QTransform parseTransform(const QString &transformStr);
+    // 解析变换字符串为QTransform，变换依次作用在base上（matrix会替换已有变换）
+    static QTransform parseTransform(const QString &transformStr, const QTransform &base = QTransform());
     
     // 应用样式到图形
     static void applyStyleToShape(DrawingShape *shape, const QString &style);
     
     // 解析路径元素
-    static DrawingPath* parsePathElement(const QDomElement &element);
+    static bool parsePathElement(const QDomElement &element, SvgShapeRecord &record);
     
     // 解析 Inkscape sodipodi:arc 元素
-    static DrawingEllipse* parseSodipodiArcElement(const QDomElement &element);
+    static bool parseSodipodiArcElement(const QDomElement &element, SvgShapeRecord &record);
     
     // 解析矩形元素
-    static DrawingRectangle* parseRectElement(const QDomElement &element);
+    static bool parseRectElement(const QDomElement &element, SvgShapeRecord &record);
     
     // 解析椭圆元素
-    static DrawingEllipse* parseEllipseElement(const QDomElement &element);
+    static bool parseEllipseElement(const QDomElement &element, SvgShapeRecord &record);
     
     // 解析圆元素
-    static DrawingEllipse* parseCircleElement(const QDomElement &element);
+    static bool parseCircleElement(const QDomElement &element, SvgShapeRecord &record);
     
     // 解析线元素
-    static DrawingPath* parseLineElement(const QDomElement &element);
+    static bool parseLineElement(const QDomElement &element, SvgShapeRecord &record);
     
     // 解析多边形元素
-    static DrawingPath* parsePolygonElement(const QDomElement &element);
+    static bool parsePolygonElement(const QDomElement &element, SvgShapeRecord &record);
     
     // 解析文本元素
-    static DrawingText* parseTextElement(const QDomElement &element);
+    static bool parseTextElement(const QDomElement &element, SvgShapeRecord &record);
     
     // 解析组元素（现在支持图层）
-    static int parseGroupElement(DrawingScene *scene, const QDomElement &groupElement, QGraphicsItem *parentItem = nullptr);
+    static int parseGroupElement(DrawingScene *scene, SvgImportContext &context, const QDomElement &groupElement,
+                                 QGraphicsItem *parentItem = nullptr);
+    // 创建组/图层并把解析出的图形挂到正确的父项（DOM和流式解析共用）
+    static void beginGroupElement(DrawingScene *scene, SvgImportContext &context, const QDomElement &groupElement,
+                                  QGraphicsItem *parentItem, DrawingLayer *&layer, DrawingGroup *&group);
+    static void beginGroupRecord(DrawingScene *scene, SvgImportContext &context, const SvgGroupRecord &record,
+                                 QGraphicsItem *parentItem, DrawingLayer *&layer, DrawingGroup *&group);
+    static void addParsedShape(DrawingScene *scene, DrawingShape *shape, DrawingLayer *layer, DrawingGroup *group);
     static DrawingLayer* parseLayerElement(const QDomElement &element);
     
     // 解析多线元素
     static DrawingPath* parsePolylineElement(const QDomElement &element);
     
     // 解析样式属性
-    static void parseStyleAttributes(DrawingShape *shape, const QDomElement &element);
-    static void parseStyleAttributes(DrawingGroup *group, const QDomElement &element);
+    static void parseStyleAttributes(SvgImportContext &context, DrawingShape *shape, const QDomElement &element);
     
     // 解析变换属性
     static void parseTransformAttribute(DrawingShape *shape, const QString &transformStr);
-    static void parseTransformAttribute(DrawingGroup *group, const QString &transformStr);
     
     // 解析颜色字符串
     static QColor parseColor(const QString &colorStr);
     
     // 解析defs元素中的渐变定义
-    static void parseDefsElements(const QDomElement &root);
+    static void parseDefsElements(SvgImportContext &context, const QDomElement &root);
     
     // 解析线性渐变
     static QLinearGradient parseLinearGradient(const QDomElement &element);
@@ -119,70 +227,64 @@ private:
     static void parseGradientStops(QGradient *gradient, const QDomElement &element);
     
     // 解析滤镜效果
-    static void parseFilterElements(const QDomElement &root);
+    static void parseFilterElements(SvgImportContext &context, const QDomElement &root);
     static QGraphicsBlurEffect* parseGaussianBlurFilter(const QDomElement &element);
     static QGraphicsDropShadowEffect* parseDropShadowFilter(const QDomElement &element);
-    static void applyFilterToShape(DrawingShape *shape, const QString &filterId);
-    static void applyFilterToShape(DrawingGroup *group, const QString &filterId);
+    static void applyFilterToShape(SvgImportContext &context, DrawingShape *shape, const QString &filterId);
+    static void applyFilterToShape(SvgImportContext &context, DrawingGroup *group, const QString &filterId);
     
     // 解析Pattern
-    static void parsePatternElements(const QDomElement &root);
+    static void parsePatternElements(SvgImportContext &context, const QDomElement &root);
     static QBrush parsePatternBrush(const QDomElement &patternElement);
-    static QBrush parsePatternBrush(const QString &patternId);
+    static QBrush parsePatternBrush(SvgImportContext &context, const QString &patternId);
     
     // 解析Marker
-    static void parseMarkerElements(const QDomElement &root);
-    static void renderMarkerToCache(const QString &id, const QDomElement &markerElement);
-    static QPainterPath createMarkerPath(const QString &markerId, const QPointF &startPoint, const QPointF &endPoint);
+    static void parseMarkerElements(SvgImportContext &context, const QDomElement &root);
+    static void renderMarkerToCache(SvgImportContext &context, const QString &id, const QDomElement &markerElement);
+    static QPainterPath createMarkerPath(SvgImportContext &context, const QString &markerId,
+                                         const QPointF &startPoint, const QPointF &endPoint);
     // 应用Marker到路径
-    static void applyMarkers(DrawingPath *path, const QString &markerStart, const QString &markerMid, const QString &markerEnd);
-    static void applyMarkerToPath(DrawingPath *path, const QString &markerId, const QString &position = "end");
+    static void applyMarkers(SvgImportContext &context, DrawingPath *path,
+                             const QString &markerStart, const QString &markerMid, const QString &markerEnd);
+    static void applyMarkerToPath(SvgImportContext &context, DrawingPath *path,
+                                  const QString &markerId, const QString &position = "end");
     
     // 从字符串解析长度值
     static qreal parseLength(const QString &lengthStr);
     
-    // 导出场景到SVG文档
-    static QDomDocument exportSceneToSvgDocument(DrawingScene *scene);
-    
-    // 导出形状到SVG元素
-    static QDomElement exportShapeToSvgElement(QDomDocument &doc, DrawingShape *shape);
-    
-    // 导出路径到SVG路径元素
-    static QDomElement exportPathToSvgElement(QDomDocument &doc, DrawingPath *path);
-    
-    // 导出矩形到SVG矩形元素
-    static QDomElement exportRectangleToSvgElement(QDomDocument &doc, DrawingRectangle *rect);
-    
-    // 导出椭圆到SVG椭圆元素
-    static QDomElement exportEllipseToSvgElement(QDomDocument &doc, DrawingEllipse *ellipse);
-    
-    // 导出文本到SVG文本元素
-    static QDomElement exportTextToSvgElement(QDomDocument &doc, DrawingText *text);
-    
-    // 导出线条到SVG线条元素
-    static QDomElement exportLineToSvgElement(QDomDocument &doc, DrawingLine *line);
-    
-    // 导出折线到SVG折线元素
-    static QDomElement exportPolylineToSvgElement(QDomDocument &doc, DrawingPolyline *polyline);
-    
-    // 导出多边形到SVG多边形元素
-    static QDomElement exportPolygonToSvgElement(QDomDocument &doc, DrawingPolygon *polygon);
+    // 流式写出场景
+    static void writeSceneToSvg(SvgExportWriter &writer, DrawingScene *scene);
+    
+    // 按图形类型写出对应的SVG元素
+    static void writeShapeElement(SvgExportWriter &writer, DrawingShape *shape);
+    static void writePathElement(SvgExportWriter &writer, DrawingPath *path);
+    static void writeRectangleElement(SvgExportWriter &writer, DrawingRectangle *rect);
+    static void writeEllipseElement(SvgExportWriter &writer, DrawingEllipse *ellipse);
+    static void writeTextElement(SvgExportWriter &writer, DrawingText *text);
+    static void writeLineElement(SvgExportWriter &writer, DrawingLine *line);
+    static void writePolylineElement(SvgExportWriter &writer, DrawingPolyline *polyline);
+    static void writePolygonElement(SvgExportWriter &writer, DrawingPolygon *polygon);
+    
+    // 写出样式属性；gradientPrefix为空时不引用渐变，noFill为无填充时的fill值
+    static void writeStrokeAttributes(SvgExportWriter &writer, const QPen &pen);
+    static void writeFillAttributes(SvgExportWriter &writer, const QBrush &brush,
+                                    const QString &gradientPrefix, const QString &noFill);
+    static void writeFilterAttribute(SvgExportWriter &writer, QGraphicsEffect *effect);
     
     // 辅助函数
     static void parseSvgPathData(const QString &data, QPainterPath &path);
-    static QString pathDataToString(const QPainterPath &path);
     static void parseGroupElement(const QDomElement &groupElement);
     
-    // 椭圆弧转换函数
+    // 椭圆弧转换函数（xAxisRotation单位为角度）
     static void convertEllipticalArcToBezier(QPainterPath &path, const QPointF &start, const QPointF &end, 
                                            qreal rx, qreal ry, qreal xAxisRotation, 
                                            bool largeArcFlag, bool sweepFlag);
     
     // 导出辅助函数
-    static QDomElement exportLayerToSvgElement(QDomDocument &doc, DrawingLayer *layer);
-    static void exportGradientsToSvg(QDomDocument &doc, QDomElement &defsElement, const QList<QGraphicsItem*> &items);
-    static void exportFiltersToSvg(QDomDocument &doc, QDomElement &defsElement, const QList<QGraphicsItem*> &items);
-    static QString transformToString(const QTransform &transform);
+    static void writeLayerElement(SvgExportWriter &writer, DrawingLayer *layer);
+    static void writeGradients(SvgExportWriter &writer, const QList<QGraphicsItem*> &items);
+    static void writeGradientStops(SvgExportWriter &writer, const QGradient &gradient);
+    static void writeFilters(SvgExportWriter &writer, const QList<QGraphicsItem*> &items);
 };
 
 #endif // SVGHANDLER_H
\ No newline at end of file
@@ -0,0 +1,1103 @@
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QDataStream>
+#include <QPainterPath>
+#include <QDebug>
+#include <cstring>
+#include "../core/vfp-document.h"
+#include "../ui/drawingscene.h"
+#include "../core/drawing-shape.h"
+#include "../core/drawing-group.h"
+#include "../core/drawing-layer.h"
+#include "../core/layer-manager.h"
+
+// 已解码的图形通过QGraphicsItem::data记录它在文件图形表中的下标
+static const int ENTRY_DATA_KEY = 0x56465000;
+
+// 空闲时每批解码的时间预算（毫秒）
+static const int IDLE_BATCH_BUDGET = 8;
+
+// 文件大小超过有效数据的该倍数时整体重写，小文件不压缩
+static const int COMPACT_RATIO = 2;
+static const qint64 COMPACT_MIN_SIZE = 1024 * 1024;
+
+// 文本记录的标志位
+static const quint32 TEXT_BOLD = 0x01;
+static const quint32 TEXT_ITALIC = 0x02;
+
+template <typename T>
+static void appendPod(QByteArray &out, const T &value)
+{
+    out.append(reinterpret_cast<const char*>(&value), int(sizeof(T)));
+}
+
+static void padTo8(QByteArray &out)
+{
+    while (out.size() % 8 != 0) {
+        out.append('\0');
+    }
+}
+
+static void appendPoints(QByteArray &out, const QVector<QPointF> &points)
+{
+    for (const QPointF &point : points) {
+        const double xy[2] = { point.x(), point.y() };
+        appendPod(out, xy);
+    }
+}
+
+static QPointF pointAt(const uchar *coords, quint32 index)
+{
+    double xy[2];
+    memcpy(xy, coords + index * sizeof(xy), sizeof(xy));
+    return QPointF(xy[0], xy[1]);
+}
+
+// 画笔和画刷序列化后的字节作为样式表的去重键
+static QByteArray styleKey(const QPen &pen, const QBrush &brush)
+{
+    QByteArray key;
+    QDataStream stream(&key, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream << pen << brush;
+    return key;
+}
+
+/**
+ * 带边界检查的记录读取游标，记录损坏时读取失败而不是越界
+ */
+struct RecordReader
+{
+    const uchar *data;
+    quint32 size;
+    quint32 pos = 0;
+
+    template <typename T>
+    bool read(T &value)
+    {
+        if (sizeof(T) > size - pos) {
+            return false;
+        }
+        memcpy(&value, data + pos, sizeof(T));
+        pos += quint32(sizeof(T));
+        return true;
+    }
+
+    const uchar *take(quint64 bytes)
+    {
+        if (bytes > size - pos) {
+            return nullptr;
+        }
+        const uchar *p = data + pos;
+        pos += quint32(bytes);
+        return p;
+    }
+
+    void align8()
+    {
+        pos = qMin(size, (pos + 7) & ~7u);
+    }
+};
+
+struct VfpDocument::SaveContext
+{
+    QFileDevice *out = nullptr;
+    bool incremental = false;
+    qint64 end = 0;
+    quint64 liveBytes = 0;
+    QVector<VfpShapeEntry> entries;
+    QVector<PendingShape> pending;
+    QVector<QPair<DrawingShape*, int>> savedShapes;
+    QHash<DrawingShape*, int> shapeLayers;
+    QHash<DrawingLayer*, int> layerIndexes;
+    QRectF bounds;
+    QByteArray buffer;
+
+    // 追加到文件末尾并补齐到8字节
+    bool append(const char *data, qint64 size, quint64 &offset)
+    {
+        static const char PADDING[8] = {};
+        offset = quint64(end);
+        if (out->write(data, size) != size) {
+            return false;
+        }
+        end += size;
+        const qint64 padding = (8 - end % 8) % 8;
+        if (padding > 0) {
+            if (out->write(PADDING, padding) != padding) {
+                return false;
+            }
+            end += padding;
+        }
+        return true;
+    }
+};
+
+VfpDocument::VfpDocument(DrawingScene *scene, QObject *parent)
+    : QObject(parent)
+    , m_scene(scene)
+{
+    memset(&m_directory, 0, sizeof(m_directory));
+
+    m_idleTimer = new QTimer(this);
+    m_idleTimer->setSingleShot(true);
+    m_idleTimer->setInterval(0);
+    connect(m_idleTimer, &QTimer::timeout, this, &VfpDocument::materializeBatch);
+}
+
+VfpDocument::~VfpDocument()
+{
+    close();
+}
+
+bool VfpDocument::open(const QString &fileName)
+{
+    close();
+
+    if (!mapFile(fileName)) {
+        return false;
+    }
+
+    QVector<int> topLevel;
+    const int count = shapeCount();
+    for (int i = 0; i < count; i += 1 + int(entry(i)->descendants)) {
+        // 子孙数来自文件，越界时按索引损坏处理，避免步长溢出后死循环
+        if (entry(i)->descendants >= quint32(count - i)) {
+            qDebug() << "VFP图层索引损坏:" << fileName;
+            close();
+            return false;
+        }
+        topLevel.append(i);
+    }
+
+    // 图层会修改图层管理器，放在全部校验之后；readLayers先读完整个图层表再创建图层，
+    // 失败时图层管理器同样保持不变
+    if (!readLayers()) {
+        qDebug() << "VFP图层索引损坏:" << fileName;
+        close();
+        return false;
+    }
+
+    // 顶层图形按层叠顺序存放；Z值相同的一组图形在到下一个Z值的半个间隔内依次拉开，
+    // 图形按可见性乱序加入场景时层叠顺序仍与文件一致
+
+    m_pending.resize(topLevel.size());
+    int runStart = 0;
+    while (runStart < topLevel.size()) {
+        const double z = entry(topLevel[runStart])->z;
+        int runEnd = runStart + 1;
+        while (runEnd < topLevel.size() && entry(topLevel[runEnd])->z == z) {
+            runEnd++;
+        }
+        const double nextZ = runEnd < topLevel.size() ? entry(topLevel[runEnd])->z : z + 1.0;
+        const double step = nextZ > z ? (nextZ - z) / 2.0 / (runEnd - runStart) : 0.0;
+        for (int k = runStart; k < runEnd; ++k) {
+            m_pending[k].entry = topLevel[k];
+            m_pending[k].z = z + (k - runStart) * step;
+        }
+        runStart = runEnd;
+    }
+
+    m_idleTimer->start();
+    return true;
+}
+
+void VfpDocument::close()
+{
+    m_idleTimer->stop();
+    unmapFile();
+    m_pending.clear();
+    m_layers.clear();
+    m_pens.clear();
+    m_brushes.clear();
+    m_styleKeys.clear();
+    m_fileName.clear();
+    m_bounds = QRectF();
+}
+
+int VfpDocument::shapeCount() const
+{
+    return m_map ? int(m_directory.shapeCount) : 0;
+}
+
+bool VfpDocument::mapFile(const QString &fileName)
+{
+#if Q_BYTE_ORDER != Q_LITTLE_ENDIAN
+    qDebug() << "VFP文件只支持小端序平台:" << fileName;
+    return false;
+#endif
+
+    auto fail = [this, &fileName](const char *message) {
+        qDebug() << message << fileName;
+        unmapFile();
+        return false;
+    };
+
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        return fail("无法打开VFP文件:");
+    }
+
+    m_mapSize = m_file.size();
+    if (m_mapSize < qint64(sizeof(VfpFileHeader))) {
+        return fail("不是有效的VFP文件:");
+    }
+    m_map = m_file.map(0, m_mapSize);
+    if (!m_map) {
+        return fail("无法映射VFP文件:");
+    }
+
+    VfpFileHeader header;
+    memcpy(&header, m_map, sizeof(header));
+    if (memcmp(header.magic, VFP_MAGIC, sizeof(VFP_MAGIC)) != 0 || header.version > VFP_VERSION) {
+        return fail("不是有效的VFP文件:");
+    }
+
+    const quint64 size = quint64(m_mapSize);
+    if (header.directoryOffset > size || sizeof(VfpDirectoryHeader) > size - header.directoryOffset) {
+        return fail("VFP目录损坏:");
+    }
+    memcpy(&m_directory, m_map + header.directoryOffset, sizeof(m_directory));
+    if (memcmp(m_directory.magic, VFP_DIRECTORY_MAGIC, sizeof(VFP_DIRECTORY_MAGIC)) != 0) {
+        return fail("VFP目录损坏:");
+    }
+
+    const quint64 refsOffset = header.directoryOffset + sizeof(VfpDirectoryHeader);
+    if (quint64(m_directory.pageCount) * sizeof(VfpPageRef) > size - refsOffset) {
+        return fail("VFP目录损坏:");
+    }
+
+    // 除最后一页外每页都是满的，按下标直接定位表项
+    m_pageRefs.resize(int(m_directory.pageCount));
+    memcpy(m_pageRefs.data(), m_map + refsOffset, m_pageRefs.size() * sizeof(VfpPageRef));
+    quint64 total = 0;
+    for (int i = 0; i < m_pageRefs.size(); ++i) {
+        const VfpPageRef &ref = m_pageRefs[i];
+        const bool last = i == m_pageRefs.size() - 1;
+        if (ref.offset % 8 != 0 || ref.offset > size
+            || quint64(ref.count) * sizeof(VfpShapeEntry) > size - ref.offset
+            || ref.count > quint32(VFP_PAGE_ENTRY_COUNT)
+            || (!last && ref.count != quint32(VFP_PAGE_ENTRY_COUNT))) {
+            return fail("VFP图形表损坏:");
+        }
+        m_pages.append(reinterpret_cast<const VfpShapeEntry*>(m_map + ref.offset));
+        total += ref.count;
+    }
+    if (total != m_directory.shapeCount
+        || m_directory.styleOffset > size || m_directory.styleSize > size - m_directory.styleOffset
+        || m_directory.layerOffset > size || m_directory.layerSize > size - m_directory.layerOffset) {
+        return fail("VFP目录损坏:");
+    }
+
+    if (!readStyles()) {
+        return fail("VFP样式表损坏:");
+    }
+
+    m_bounds = QRectF(m_directory.bounds[0], m_directory.bounds[1],
+                      m_directory.bounds[2], m_directory.bounds[3]);
+    m_fileName = fileName;
+    return true;
+}
+
+void VfpDocument::unmapFile()
+{
+    if (m_map) {
+        m_file.unmap(m_map);
+        m_map = nullptr;
+    }
+    m_file.close();
+    m_mapSize = 0;
+    m_pageRefs.clear();
+    m_pages.clear();
+}
+
+bool VfpDocument::readStyles()
+{
+    QByteArray blob = QByteArray::fromRawData(reinterpret_cast<const char*>(m_map + m_directory.styleOffset),
+                                              int(m_directory.styleSize));
+    QDataStream stream(blob);
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    m_pens.clear();
+    m_brushes.clear();
+    m_styleKeys.clear();
+    for (quint32 i = 0; i < m_directory.styleCount && stream.status() == QDataStream::Ok; ++i) {
+        QPen pen;
+        QBrush brush;
+        stream >> pen >> brush;
+        m_pens.append(pen);
+        m_brushes.append(brush);
+        m_styleKeys.insert(styleKey(pen, brush), int(i));
+    }
+    return stream.status() == QDataStream::Ok;
+}
+
+bool VfpDocument::readLayers()
+{
+    QByteArray blob = QByteArray::fromRawData(reinterpret_cast<const char*>(m_map + m_directory.layerOffset),
+                                              int(m_directory.layerSize));
+    QDataStream stream(blob);
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    struct LayerInfo {
+        QString name;
+        bool visible = true;
+        bool locked = false;
+        double opacity = 1.0;
+    };
+    QVector<LayerInfo> infos;
+    for (quint32 i = 0; i < m_directory.layerCount && stream.status() == QDataStream::Ok; ++i) {
+        LayerInfo info;
+        stream >> info.name >> info.visible >> info.locked >> info.opacity;
+        infos.append(info);
+    }
+    if (stream.status() != QDataStream::Ok) {
+        return false;
+    }
+
+    // createLayer把新图层放在最上面，倒序创建以保持文件中的顺序；同名图层直接复用
+    LayerManager *manager = LayerManager::instance();
+    QList<DrawingLayer*> layers(infos.size(), nullptr);
+    for (int i = infos.size() - 1; i >= 0; --i) {
+        DrawingLayer *layer = manager->layer(infos[i].name);
+        if (!layer) {
+            layer = manager->createLayer(infos[i].name);
+        }
+        manager->setLayerVisible(layer, infos[i].visible);
+        manager->setLayerLocked(layer, infos[i].locked);
+        manager->setLayerOpacity(layer, infos[i].opacity);
+        layers[i] = layer;
+    }
+    m_layers = layers;
+    return true;
+}
+
+const VfpShapeEntry *VfpDocument::entry(int index) const
+{
+    return m_pages[index / VFP_PAGE_ENTRY_COUNT] + index % VFP_PAGE_ENTRY_COUNT;
+}
+
+const uchar *VfpDocument::record(const VfpShapeEntry &entry) const
+{
+    const quint64 size = quint64(m_mapSize);
+    if (entry.recordOffset > size || entry.recordSize > size - entry.recordOffset
+        || entry.recordSize < sizeof(VfpRecordHeader)) {
+        return nullptr;
+    }
+    return m_map + entry.recordOffset;
+}
+
+void VfpDocument::materializeRect(const QRectF &rect)
+{
+    if (!m_map || m_pending.isEmpty()) {
+        return;
+    }
+
+    // 宽或高为0的图形（水平线、竖线）也要算作相交，不使用QRectF::intersects
+    int count = 0;
+    int kept = 0;
+    for (int i = 0; i < m_pending.size(); ++i) {
+        const PendingShape pending = m_pending[i];
+        const VfpShapeEntry *e = entry(pending.entry);
+        const bool visible = e->bounds[0] <= rect.right() && e->bounds[0] + e->bounds[2] >= rect.left()
+                          && e->bounds[1] <= rect.bottom() && e->bounds[1] + e->bounds[3] >= rect.top();
+        if (visible) {
+            materializeTopLevel(pending);
+            count++;
+        } else {
+            m_pending[kept++] = pending;
+        }
+    }
+    m_pending.resize(kept);
+
+    if (count > 0) {
+        emit shapesMaterialized(count, m_pending.size());
+    }
+}
+
+void VfpDocument::materializeAll()
+{
+    const int count = m_pending.size();
+    for (const PendingShape &pending : m_pending) {
+        materializeTopLevel(pending);
+    }
+    m_pending.clear();
+    m_idleTimer->stop();
+
+    if (count > 0) {
+        emit shapesMaterialized(count, 0);
+    }
+}
+
+void VfpDocument::materializeBatch()
+{
+    if (!m_map) {
+        return;
+    }
+
+    // 全选、导出等操作需要完整的场景，不可见的图形在空闲时从最上层开始分批解码
+    QElapsedTimer budget;
+    budget.start();
+
+    int count = 0;
+    while (!m_pending.isEmpty() && budget.elapsed() < IDLE_BATCH_BUDGET) {
+        materializeTopLevel(m_pending.takeLast());
+        count++;
+    }
+
+    if (count > 0) {
+        emit shapesMaterialized(count, m_pending.size());
+    }
+    if (!m_pending.isEmpty()) {
+        m_idleTimer->start();
+    }
+}
+
+void VfpDocument::materializeTopLevel(const PendingShape &pending)
+{
+    int consumed = 0;
+    DrawingShape *shape = materialize(pending.entry, shapeCount(), nullptr, consumed);
+    if (shape) {
+        shape->setZValue(pending.z);
+    }
+}
+
+DrawingShape *VfpDocument::materialize(int index, int end, DrawingGroup *parentGroup, int &consumed)
+{
+    const VfpShapeEntry &e = *entry(index);
+    consumed = int(qMin(quint64(e.descendants) + 1, quint64(end - index)));
+
+    const uchar *data = record(e);
+    DrawingShape *shape = data ? decodeShape(e, data) : nullptr;
+    if (!shape) {
+        qDebug() << "VFP图形记录损坏，跳过:" << index;
+        return nullptr;
+    }
+
+    if (e.style < quint32(m_pens.size())) {
+        shape->setStrokePen(m_pens[int(e.style)]);
+        shape->setFillBrush(m_brushes[int(e.style)]);
+    }
+    shape->setData(ENTRY_DATA_KEY, index);
+
+    if (parentGroup) {
+        // DrawingGroup::addItem按场景位置换算本地坐标，先把记录中的本地位置映射到场景
+        shape->setPos(parentGroup->mapToScene(shape->pos()));
+        parentGroup->addItem(shape);
+        shape->setZValue(e.z);
+    } else if (e.layer < m_layers.size()) {
+        m_layers[e.layer]->addShape(shape);
+    } else {
+        m_scene->addItem(shape);
+    }
+
+    // 图层会把图形设为图层的可见性，隐藏标志在加入图层之后应用
+    if (e.flags & VFP_SHAPE_HIDDEN) {
+        shape->setVisible(false);
+    }
+
+    if (e.type == DrawingShape::Group) {
+        DrawingGroup *group = static_cast<DrawingGroup*>(shape);
+        const int subtreeEnd = index + consumed;
+        int child = index + 1;
+        while (child < subtreeEnd) {
+            int childConsumed = 1;
+            materialize(child, subtreeEnd, group, childConsumed);
+            child += childConsumed;
+        }
+    }
+
+    return shape;
+}
+
+bool VfpDocument::save(const QString &fileName)
+{
+    // 保存到当前文件且废弃数据不多时只追加变化的部分，否则写出完整的新文件
+    const bool sameFile = m_map && QFileInfo(fileName) == QFileInfo(m_fileName);
+    const bool needsCompaction = m_mapSize > COMPACT_MIN_SIZE
+                              && quint64(m_mapSize) > COMPACT_RATIO * m_directory.liveBytes;
+
+    SaveContext context;
+    context.incremental = sameFile && !needsCompaction;
+
+    QFile appendFile(fileName);
+    QSaveFile saveFile(fileName);
+    if (context.incremental) {
+        if (!appendFile.open(QIODevice::ReadWrite)) {
+            qDebug() << "无法写入VFP文件:" << fileName << appendFile.errorString();
+            return false;
+        }
+        context.out = &appendFile;
+        context.end = (appendFile.size() + 7) & ~qint64(7);
+        if (!appendFile.seek(context.end)) {
+            qDebug() << "无法写入VFP文件:" << fileName << appendFile.errorString();
+            return false;
+        }
+    } else {
+        if (!saveFile.open(QIODevice::WriteOnly)) {
+            qDebug() << "无法创建VFP文件:" << fileName << saveFile.errorString();
+            return false;
+        }
+        context.out = &saveFile;
+        // 文件头最后写入
+        const VfpFileHeader placeholder = {};
+        quint64 offset = 0;
+        if (!context.append(reinterpret_cast<const char*>(&placeholder), sizeof(placeholder), offset)) {
+            qDebug() << "无法写入VFP文件:" << fileName << saveFile.errorString();
+            return false;
+        }
+    }
+
+    // 图层索引
+    const QList<DrawingLayer*> layers = LayerManager::instance()->layers();
+    for (int i = 0; i < layers.size(); ++i) {
+        context.layerIndexes.insert(layers[i], i);
+        for (DrawingShape *shape : layers[i]->shapes()) {
+            context.shapeLayers.insert(shape, i);
+        }
+    }
+
+    // 已解码的顶层图形按场景层叠顺序排列，与未解码的表项按Z值合并
+    QVector<SaveItem> items;
+    const QList<QGraphicsItem*> sceneItems = m_scene->items(Qt::AscendingOrder);
+    for (QGraphicsItem *item : sceneItems) {
+        DrawingShape *shape = item->parentItem() ? nullptr : dynamic_cast<DrawingShape*>(item);
+        if (shape) {
+            SaveItem saveItem;
+            saveItem.shape = shape;
+            saveItem.z = shape->zValue();
+            items.append(saveItem);
+        }
+    }
+
+    bool ok = true;
+    int next = 0;
+    for (const PendingShape &pending : qAsConst(m_pending)) {
+        while (ok && next < items.size() && items[next].z <= pending.z) {
+            ok = saveShape(context, items[next].shape, items[next].z);
+            next++;
+        }
+        ok = ok && savePendingShape(context, pending);
+    }
+    while (ok && next < items.size()) {
+        ok = saveShape(context, items[next].shape, items[next].z);
+        next++;
+    }
+
+    // 图形表分页，与文件中同一页逐字节相同时复用
+    QVector<VfpPageRef> pageRefs;
+    for (int first = 0; ok && first < context.entries.size(); first += VFP_PAGE_ENTRY_COUNT) {
+        const int page = first / VFP_PAGE_ENTRY_COUNT;
+        VfpPageRef ref;
+        ref.count = quint32(qMin(VFP_PAGE_ENTRY_COUNT, context.entries.size() - first));
+        ref.size = ref.count * quint32(sizeof(VfpShapeEntry));
+        const char *data = reinterpret_cast<const char*>(context.entries.constData() + first);
+
+        if (context.incremental && page < m_pageRefs.size() && m_pageRefs[page].count == ref.count
+            && memcmp(m_pages[page], data, ref.size) == 0) {
+            ref.offset = m_pageRefs[page].offset;
+        } else {
+            ok = context.append(data, ref.size, ref.offset);
+        }
+        context.liveBytes += ref.size;
+        pageRefs.append(ref);
+    }
+
+    VfpDirectoryHeader directory;
+    memset(&directory, 0, sizeof(directory));
+    memcpy(directory.magic, VFP_DIRECTORY_MAGIC, sizeof(VFP_DIRECTORY_MAGIC));
+    directory.shapeCount = quint32(context.entries.size());
+    directory.pageCount = quint32(pageRefs.size());
+
+    // 样式表在图形之后生成，保存过程中可能新增样式
+    const QByteArray styles = styleBlob();
+    directory.styleCount = quint32(m_pens.size());
+    directory.styleSize = quint64(styles.size());
+    ok = ok && saveBlob(context, styles, m_directory.styleOffset, m_directory.styleSize, directory.styleOffset);
+
+    const QByteArray layerData = layerBlob(layers);
+    directory.layerCount = quint32(layers.size());
+    directory.layerSize = quint64(layerData.size());
+    ok = ok && saveBlob(context, layerData, m_directory.layerOffset, m_directory.layerSize, directory.layerOffset);
+
+    directory.bounds[0] = context.bounds.x();
+    directory.bounds[1] = context.bounds.y();
+    directory.bounds[2] = context.bounds.width();
+    directory.bounds[3] = context.bounds.height();
+
+    QByteArray directoryData;
+    const int directorySize = int(sizeof(VfpDirectoryHeader) + pageRefs.size() * sizeof(VfpPageRef));
+    directory.liveBytes = context.liveBytes + quint64(directorySize) + sizeof(VfpFileHeader);
+    appendPod(directoryData, directory);
+    directoryData.append(reinterpret_cast<const char*>(pageRefs.constData()), int(pageRefs.size() * sizeof(VfpPageRef)));
+
+    VfpFileHeader header = {};
+    memcpy(header.magic, VFP_MAGIC, sizeof(VFP_MAGIC));
+    header.version = VFP_VERSION;
+    header.headerSize = quint16(sizeof(VfpFileHeader));
+    header.directorySize = quint64(directoryData.size());
+    ok = ok && context.append(directoryData.constData(), directoryData.size(), header.directoryOffset);
+
+    // 新数据全部落盘后才改写文件头，中途失败时文件仍指向旧目录
+    ok = ok && context.out->flush() && context.out->seek(0)
+            && context.out->write(reinterpret_cast<const char*>(&header), sizeof(header)) == qint64(sizeof(header));
+
+    if (!ok) {
+        qDebug() << "写入VFP文件失败:" << fileName << context.out->errorString();
+        if (!context.incremental) {
+            saveFile.cancelWriting();
+        }
+        return false;
+    }
+
+    // 切换到新写出的文件；整体重写时先释放旧映射，替换失败则重新映射旧文件
+    const QString previousFile = m_fileName;
+    if (context.incremental) {
+        appendFile.close();
+        unmapFile();
+    } else {
+        unmapFile();
+        if (!saveFile.commit()) {
+            qDebug() << "无法保存VFP文件:" << fileName << saveFile.errorString();
+            if (!previousFile.isEmpty()) {
+                mapFile(previousFile);
+            }
+            return false;
+        }
+    }
+
+    if (!mapFile(fileName)) {
+        m_pending.clear();
+        return false;
+    }
+
+    m_layers = layers;
+    m_pending = context.pending;
+    for (const QPair<DrawingShape*, int> &saved : qAsConst(context.savedShapes)) {
+        saved.first->setData(ENTRY_DATA_KEY, saved.second);
+    }
+    return true;
+}
+
+bool VfpDocument::saveShape(SaveContext &context, DrawingShape *shape, qreal z)
+{
+    if (!encodeShape(shape, context.buffer)) {
+        return true;
+    }
+
+    const int index = context.entries.size();
+    VfpShapeEntry e;
+    memset(&e, 0, sizeof(e));
+    e.recordSize = quint32(context.buffer.size());
+    e.type = quint8(shape->shapeType());
+    e.flags = shape->isVisible() ? 0 : VFP_SHAPE_HIDDEN;
+    e.layer = quint16(context.shapeLayers.value(shape, VFP_NO_LAYER));
+    e.style = quint32(styleIndex(shape->strokePen(), shape->fillBrush()));
+    e.z = z;
+
+    const QRectF bounds = shape->sceneBoundingRect();
+    e.bounds[0] = float(bounds.x());
+    e.bounds[1] = float(bounds.y());
+    e.bounds[2] = float(bounds.width());
+    e.bounds[3] = float(bounds.height());
+    if (!shape->parentItem()) {
+        context.bounds = context.bounds.isNull() ? bounds : context.bounds.united(bounds);
+    }
+
+    // 与文件中原来的记录逐字节比较，没有变化就沿用原来的位置
+    bool reused = false;
+    bool hasEntry = false;
+    const int oldIndex = shape->data(ENTRY_DATA_KEY).toInt(&hasEntry);
+    if (context.incremental && hasEntry && oldIndex >= 0 && oldIndex < shapeCount()) {
+        const VfpShapeEntry &oldEntry = *entry(oldIndex);
+        const uchar *oldRecord = record(oldEntry);
+        if (oldRecord && oldEntry.recordSize == e.recordSize
+            && memcmp(oldRecord, context.buffer.constData(), e.recordSize) == 0) {
+            e.recordOffset = oldEntry.recordOffset;
+            reused = true;
+        }
+    }
+    if (!reused && !context.append(context.buffer.constData(), context.buffer.size(), e.recordOffset)) {
+        return false;
+    }
+    context.liveBytes += e.recordSize;
+    context.entries.append(e);
+    context.savedShapes.append(qMakePair(shape, index));
+
+    if (shape->shapeType() == DrawingShape::Group) {
+        for (DrawingShape *child : static_cast<DrawingGroup*>(shape)->items()) {
+            if (child && !saveShape(context, child, child->zValue())) {
+                return false;
+            }
+        }
+    }
+
+    context.entries[index].descendants = quint32(context.entries.size() - index - 1);
+    return true;
+}
+
+bool VfpDocument::savePendingShape(SaveContext &context, const PendingShape &pending)
+{
+    // 未解码的图形连同子孙原样沿用，只更新顶层Z值和图层序号
+    const int count = shapeCount();
+    const int first = context.entries.size();
+    const int end = int(qMin(quint64(pending.entry) + entry(pending.entry)->descendants + 1, quint64(count)));
+
+    for (int i = pending.entry; i < end; ++i) {
+        VfpShapeEntry e = *entry(i);
+        e.descendants = quint32(qMin(quint64(e.descendants), quint64(end - i - 1)));
+        if (e.layer < m_layers.size()) {
+            e.layer = quint16(context.layerIndexes.value(m_layers[e.layer], VFP_NO_LAYER));
+        } else {
+            e.layer = VFP_NO_LAYER;
+        }
+
+        if (!context.incremental) {
+            const uchar *data = record(e);
+            if (!data) {
+                continue;
+            }
+            if (!context.append(reinterpret_cast<const char*>(data), e.recordSize, e.recordOffset)) {
+                return false;
+            }
+        }
+        context.liveBytes += e.recordSize;
+        context.entries.append(e);
+    }
+
+    if (context.entries.size() > first) {
+        VfpShapeEntry &top = context.entries[first];
+        top.z = pending.z;
+        top.descendants = quint32(context.entries.size() - first - 1);
+
+        const QRectF bounds(top.bounds[0], top.bounds[1], top.bounds[2], top.bounds[3]);
+        context.bounds = context.bounds.isNull() ? bounds : context.bounds.united(bounds);
+
+        PendingShape saved;
+        saved.entry = first;
+        saved.z = pending.z;
+        context.pending.append(saved);
+    }
+    return true;
+}
+
+bool VfpDocument::saveBlob(SaveContext &context, const QByteArray &blob, quint64 oldOffset, quint64 oldSize,
+                           quint64 &offset)
+{
+    context.liveBytes += quint64(blob.size());
+    if (context.incremental && oldSize == quint64(blob.size())
+        && memcmp(m_map + oldOffset, blob.constData(), blob.size()) == 0) {
+        offset = oldOffset;
+        return true;
+    }
+    return context.append(blob.constData(), blob.size(), offset);
+}
+
+int VfpDocument::styleIndex(const QPen &pen, const QBrush &brush)
+{
+    const QByteArray key = styleKey(pen, brush);
+    QHash<QByteArray, int>::const_iterator it = m_styleKeys.constFind(key);
+    if (it != m_styleKeys.constEnd()) {
+        return it.value();
+    }
+
+    const int index = m_pens.size();
+    m_pens.append(pen);
+    m_brushes.append(brush);
+    m_styleKeys.insert(key, index);
+    return index;
+}
+
+QByteArray VfpDocument::styleBlob() const
+{
+    QByteArray blob;
+    QDataStream stream(&blob, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_6_0);
+    for (int i = 0; i < m_pens.size(); ++i) {
+        stream << m_pens[i] << m_brushes[i];
+    }
+    return blob;
+}
+
+QByteArray VfpDocument::layerBlob(const QList<DrawingLayer*> &layers) const
+{
+    QByteArray blob;
+    QDataStream stream(&blob, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_6_0);
+    for (DrawingLayer *layer : layers) {
+        stream << layer->name() << layer->isVisible() << layer->isLocked() << double(layer->opacity());
+    }
+    return blob;
+}
+
+bool VfpDocument::encodeShape(DrawingShape *shape, QByteArray &out)
+{
+    out.resize(0);
+
+    VfpRecordHeader header;
+    const QPointF pos = shape->pos();
+    const QTransform t = shape->transform();
+    header.pos[0] = pos.x();
+    header.pos[1] = pos.y();
+    header.transform[0] = t.m11();
+    header.transform[1] = t.m12();
+    header.transform[2] = t.m21();
+    header.transform[3] = t.m22();
+    header.transform[4] = t.dx();
+    header.transform[5] = t.dy();
+    appendPod(out, header);
+
+    switch (shape->shapeType()) {
+    case DrawingShape::Rectangle: {
+        DrawingRectangle *rect = static_cast<DrawingRectangle*>(shape);
+        const QRectF r = rect->rectangle();
+        const double values[7] = { r.x(), r.y(), r.width(), r.height(), rect->cornerRadius(),
+                                   rect->cornerRadiusRatioX(), rect->cornerRadiusRatioY() };
+        appendPod(out, values);
+        break;
+    }
+    case DrawingShape::Ellipse: {
+        DrawingEllipse *ellipse = static_cast<DrawingEllipse*>(shape);
+        const QRectF r = ellipse->ellipse();
+        const double values[6] = { r.x(), r.y(), r.width(), r.height(),
+                                   ellipse->startAngle(), ellipse->spanAngle() };
+        appendPod(out, values);
+        break;
+    }
+    case DrawingShape::Line: {
+        DrawingLine *line = static_cast<DrawingLine*>(shape);
+        const QLineF l = line->line();
+        const double values[5] = { l.x1(), l.y1(), l.x2(), l.y2(), line->lineWidth() };
+        appendPod(out, values);
+        break;
+    }
+    case DrawingShape::Path: {
+        // 元素类型和坐标分开存放，坐标是连续的double数组
+        const QPainterPath path = static_cast<DrawingPath*>(shape)->path();
+        const quint32 count = quint32(path.elementCount());
+        appendPod(out, count);
+        appendPod(out, quint32(path.fillRule()));
+        for (quint32 i = 0; i < count; ++i) {
+            out.append(char(path.elementAt(int(i)).type));
+        }
+        padTo8(out);
+        for (quint32 i = 0; i < count; ++i) {
+            const QPainterPath::Element &element = path.elementAt(int(i));
+            const double xy[2] = { element.x, element.y };
+            appendPod(out, xy);
+        }
+        break;
+    }
+    case DrawingShape::Polyline: {
+        DrawingPolyline *polyline = static_cast<DrawingPolyline*>(shape);
+        const QVector<QPointF> points = polyline->getNodePoints();
+        appendPod(out, quint32(points.size()));
+        appendPod(out, quint32(polyline->isClosed() ? 1 : 0));
+        appendPod(out, double(polyline->lineWidth()));
+        appendPoints(out, points);
+        break;
+    }
+    case DrawingShape::Polygon: {
+        DrawingPolygon *polygon = static_cast<DrawingPolygon*>(shape);
+        const QVector<QPointF> points = polygon->getNodePoints();
+        appendPod(out, quint32(points.size()));
+        appendPod(out, quint32(polygon->fillRule()));
+        appendPoints(out, points);
+        break;
+    }
+    case DrawingShape::Text: {
+        DrawingText *text = static_cast<DrawingText*>(shape);
+        const QFont font = text->font();
+        const QString family = font.family();
+        const QString content = text->text();
+        const double values[3] = { text->position().x(), text->position().y(), font.pointSizeF() };
+        appendPod(out, values);
+        appendPod(out, quint32((font.bold() ? TEXT_BOLD : 0) | (font.italic() ? TEXT_ITALIC : 0)));
+        appendPod(out, quint32(family.size()));
+        appendPod(out, quint32(content.size()));
+        appendPod(out, quint32(0));
+        out.append(reinterpret_cast<const char*>(family.utf16()), int(family.size() * sizeof(QChar)));
+        out.append(reinterpret_cast<const char*>(content.utf16()), int(content.size() * sizeof(QChar)));
+        break;
+    }
+    case DrawingShape::Group:
+        // 组只保存位置和变换，子图形作为后续表项保存
+        break;
+    default:
+        return false;
+    }
+
+    padTo8(out);
+    return true;
+}
+
+DrawingShape *VfpDocument::decodeShape(const VfpShapeEntry &entry, const uchar *data)
+{
+    RecordReader reader = { data, entry.recordSize };
+
+    VfpRecordHeader header;
+    if (!reader.read(header)) {
+        return nullptr;
+    }
+
+    DrawingShape *shape = nullptr;
+    switch (entry.type) {
+    case DrawingShape::Rectangle: {
+        double values[7];
+        if (!reader.read(values)) {
+            return nullptr;
+        }
+        DrawingRectangle *rect = new DrawingRectangle(QRectF(values[0], values[1], values[2], values[3]));
+        rect->setCornerRadiusRatios(values[5], values[6]);
+        rect->setCornerRadius(values[4]);
+        shape = rect;
+        break;
+    }
+    case DrawingShape::Ellipse: {
+        double values[6];
+        if (!reader.read(values)) {
+            return nullptr;
+        }
+        DrawingEllipse *ellipse = new DrawingEllipse(QRectF(values[0], values[1], values[2], values[3]));
+        ellipse->setStartAngle(values[4]);
+        ellipse->setSpanAngle(values[5]);
+        shape = ellipse;
+        break;
+    }
+    case DrawingShape::Line: {
+        double values[5];
+        if (!reader.read(values)) {
+            return nullptr;
+        }
+        DrawingLine *line = new DrawingLine(QLineF(values[0], values[1], values[2], values[3]));
+        line->setLineWidth(values[4]);
+        shape = line;
+        break;
+    }
+    case DrawingShape::Path: {
+        quint32 count = 0;
+        quint32 fillRule = 0;
+        if (!reader.read(count) || !reader.read(fillRule)) {
+            return nullptr;
+        }
+        const uchar *types = reader.take(count);
+        reader.align8();
+        const uchar *coords = reader.take(quint64(count) * 2 * sizeof(double));
+        if (!types || !coords) {
+            return nullptr;
+        }
+
+        QPainterPath path;
+        path.reserve(int(count));
+        path.setFillRule(fillRule == Qt::WindingFill ? Qt::WindingFill : Qt::OddEvenFill);
+        for (quint32 i = 0; i < count; ++i) {
+            switch (types[i]) {
+            case QPainterPath::MoveToElement:
+                path.moveTo(pointAt(coords, i));
+                break;
+            case QPainterPath::CurveToElement:
+                if (i + 2 < count) {
+                    path.cubicTo(pointAt(coords, i), pointAt(coords, i + 1), pointAt(coords, i + 2));
+                    i += 2;
+                    break;
+                }
+                path.lineTo(pointAt(coords, i));
+                break;
+            default:
+                path.lineTo(pointAt(coords, i));
+                break;
+            }
+        }
+
+        DrawingPath *pathShape = new DrawingPath;
+        pathShape->setPath(path);
+        shape = pathShape;
+        break;
+    }
+    case DrawingShape::Polyline: {
+        quint32 count = 0;
+        quint32 closed = 0;
+        double lineWidth = 1.0;
+        if (!reader.read(count) || !reader.read(closed) || !reader.read(lineWidth)) {
+            return nullptr;
+        }
+        const uchar *coords = reader.take(quint64(count) * 2 * sizeof(double));
+        if (!coords) {
+            return nullptr;
+        }
+        DrawingPolyline *polyline = new DrawingPolyline;
+        for (quint32 i = 0; i < count; ++i) {
+            polyline->addPoint(pointAt(coords, i));
+        }
+        polyline->setClosed(closed != 0);
+        polyline->setLineWidth(lineWidth);
+        shape = polyline;
+        break;
+    }
+    case DrawingShape::Polygon: {
+        quint32 count = 0;
+        quint32 fillRule = 0;
+        if (!reader.read(count) || !reader.read(fillRule)) {
+            return nullptr;
+        }
+        const uchar *coords = reader.take(quint64(count) * 2 * sizeof(double));
+        if (!coords) {
+            return nullptr;
+        }
+        DrawingPolygon *polygon = new DrawingPolygon;
+        for (quint32 i = 0; i < count; ++i) {
+            polygon->addPoint(pointAt(coords, i));
+        }
+        polygon->setFillRule(fillRule == Qt::WindingFill ? Qt::WindingFill : Qt::OddEvenFill);
+        shape = polygon;
+        break;
+    }
+    case DrawingShape::Text: {
+        double values[3];
+        quint32 flags = 0;
+        quint32 familySize = 0;
+        quint32 textSize = 0;
+        quint32 reserved = 0;
+        if (!reader.read(values) || !reader.read(flags) || !reader.read(familySize)
+            || !reader.read(textSize) || !reader.read(reserved)) {
+            return nullptr;
+        }
+        const uchar *family = reader.take(quint64(familySize) * sizeof(QChar));
+        const uchar *content = reader.take(quint64(textSize) * sizeof(QChar));
+        if (!family || !content) {
+            return nullptr;
+        }
+
+        QFont font(QString(reinterpret_cast<const QChar*>(family), int(familySize)));
+        if (values[2] > 0) {
+            font.setPointSizeF(values[2]);
+        }
+        font.setBold(flags & TEXT_BOLD);
+        font.setItalic(flags & TEXT_ITALIC);
+
+        DrawingText *text = new DrawingText(QString(reinterpret_cast<const QChar*>(content), int(textSize)));
+        text->setFont(font);
+        text->setPosition(QPointF(values[0], values[1]));
+        shape = text;
+        break;
+    }
+    case DrawingShape::Group:
+        shape = new DrawingGroup;
+        break;
+    default:
+        return nullptr;
+    }
+
+    // DrawingText::setPos会同时移动文本位置，这里只恢复图元位置
+    shape->QGraphicsItem::setPos(QPointF(header.pos[0], header.pos[1]));
+    // 组的applyTransform会变换子图形，并且要求已经在场景中，这里只恢复图形自身的变换
+    const QTransform transform(header.transform[0], header.transform[1],
+                               header.transform[2], header.transform[3],
+                               header.transform[4], header.transform[5]);
+    if (!transform.isIdentity()) {
+        shape->DrawingShape::applyTransform(transform);
+    }
+    return shape;
+}
@@ -0,0 +1,125 @@
+#ifndef VFP_DOCUMENT_H
+#define VFP_DOCUMENT_H
+
+#include <QObject>
+#include <QFile>
+#include <QVector>
+#include <QHash>
+#include <QList>
+#include <QPen>
+#include <QBrush>
+#include <QRectF>
+#include <QByteArray>
+#include "../core/vfp-format.h"
+
+class QTimer;
+class QIODevice;
+class DrawingScene;
+class DrawingShape;
+class DrawingGroup;
+class DrawingLayer;
+
+/**
+ * VectorQt原生文档（.vfp）
+ * 打开时只映射文件并读取目录，图形在首次进入视口时才解码，其余图形在空闲时分批解码；
+ * 保存到当前文件时只追加内容有变化的记录和目录页，废弃数据过多时整体重写压缩
+ */
+class VfpDocument : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit VfpDocument(DrawingScene *scene, QObject *parent = nullptr);
+    ~VfpDocument();
+
+    // 打开文件，失败时返回false，场景和图层保持不变
+    bool open(const QString &fileName);
+
+    // 保存场景；目标是当前打开的文件时增量追加，否则完整写出
+    bool save(const QString &fileName);
+
+    // 释放文件映射，未解码的图形随之丢弃
+    void close();
+
+    QString fileName() const { return m_fileName; }
+    bool isOpen() const { return m_map != nullptr; }
+
+    // 文件中所有顶层图形的边界（包括尚未解码的图形）
+    QRectF contentBounds() const { return m_bounds; }
+    int shapeCount() const;
+    int pendingCount() const { return m_pending.size(); }
+
+    // 解码与rect（场景坐标）相交的图形
+    void materializeRect(const QRectF &rect);
+    // 解码全部剩余图形
+    void materializeAll();
+
+signals:
+    // 解码了一批图形，remaining为尚未解码的顶层图形数
+    void shapesMaterialized(int count, int remaining);
+
+private:
+    // 尚未解码的顶层图形
+    struct PendingShape {
+        int entry = 0;
+        qreal z = 0;
+    };
+
+    // 保存时的顶层图形：已解码的图形或沿用文件中的表项
+    struct SaveItem {
+        DrawingShape *shape = nullptr;
+        int entry = -1;
+        qreal z = 0;
+    };
+
+    struct SaveContext;
+
+    bool mapFile(const QString &fileName);
+    void unmapFile();
+    bool readStyles();
+    bool readLayers();
+
+    const VfpShapeEntry *entry(int index) const;
+    const uchar *record(const VfpShapeEntry &entry) const;
+
+    void materializeBatch();
+    void materializeTopLevel(const PendingShape &pending);
+    // 解码index处的图形及其子孙，end为所在子树的结束下标，consumed返回占用的表项数
+    DrawingShape *materialize(int index, int end, DrawingGroup *parentGroup, int &consumed);
+
+    bool saveShape(SaveContext &context, DrawingShape *shape, qreal z);
+    bool savePendingShape(SaveContext &context, const PendingShape &pending);
+    bool saveBlob(SaveContext &context, const QByteArray &blob, quint64 oldOffset, quint64 oldSize,
+                  quint64 &offset);
+    int styleIndex(const QPen &pen, const QBrush &brush);
+    QByteArray styleBlob() const;
+    QByteArray layerBlob(const QList<DrawingLayer*> &layers) const;
+
+    // 按类型编码图形记录，返回false表示不支持的类型
+    static bool encodeShape(DrawingShape *shape, QByteArray &out);
+    static DrawingShape *decodeShape(const VfpShapeEntry &entry, const uchar *data);
+
+    DrawingScene *m_scene;
+    QFile m_file;
+    uchar *m_map = nullptr;
+    qint64 m_mapSize = 0;
+    QString m_fileName;
+
+    VfpDirectoryHeader m_directory;
+    QVector<VfpPageRef> m_pageRefs;
+    QVector<const VfpShapeEntry*> m_pages;
+    QVector<PendingShape> m_pending;
+    QRectF m_bounds;
+
+    // 样式表只增不减，文件中已有的样式下标在增量保存后保持不变
+    QVector<QPen> m_pens;
+    QVector<QBrush> m_brushes;
+    QHash<QByteArray, int> m_styleKeys;
+
+    // 文件中图层序号对应的图层
+    QList<DrawingLayer*> m_layers;
+
+    QTimer *m_idleTimer;
+};
+
+#endif // VFP_DOCUMENT_H
@@ -0,0 +1,86 @@
+#ifndef VFP_FORMAT_H
+#define VFP_FORMAT_H
+
+#include <QtGlobal>
+
+/**
+ * VectorQt原生文件（.vfp）的磁盘结构
+ * 文件只追加写入：文件头固定在偏移0，指向最新的目录；增量保存时把变化的记录、
+ * 目录页和新目录追加到文件末尾，最后改写文件头，中途失败时旧目录仍然有效
+ * 所有结构按小端序、8字节对齐存放，可以直接在映射的内存上读取
+ */
+
+// 文件头
+struct VfpFileHeader
+{
+    char magic[4];               // "VFP\0"
+    quint16 version;
+    quint16 headerSize;
+    quint64 directoryOffset;     // 最新目录的位置
+    quint64 directorySize;
+    quint64 reserved[5];
+};
+
+// 目录：目录头之后紧跟pageCount个VfpPageRef
+struct VfpDirectoryHeader
+{
+    char magic[4];               // "VDIR"
+    quint32 shapeCount;
+    quint32 pageCount;
+    quint32 styleCount;
+    quint32 layerCount;
+    quint32 reserved;
+    quint64 styleOffset;         // 样式表（QDataStream序列化的画笔和画刷）
+    quint64 styleSize;
+    quint64 layerOffset;         // 图层索引（QDataStream序列化）
+    quint64 layerSize;
+    quint64 liveBytes;           // 当前目录引用的数据总量，用于判断何时压缩文件
+    double bounds[4];            // 所有顶层图形的场景边界 x, y, width, height
+};
+
+// 图形表分页，未变化的页在增量保存时直接复用
+struct VfpPageRef
+{
+    quint64 offset;
+    quint32 count;
+    quint32 size;
+};
+
+// 图形表项，按深度优先先序排列，组的子孙紧跟在组之后
+struct VfpShapeEntry
+{
+    quint64 recordOffset;
+    quint32 recordSize;
+    quint8 type;                 // DrawingShape::ShapeType
+    quint8 flags;
+    quint16 layer;               // 图层序号，VFP_NO_LAYER表示不属于图层
+    quint32 style;               // 样式表下标
+    quint32 descendants;         // 子孙表项的数量
+    float bounds[4];             // 场景边界，顶层图形用来判断是否可见
+    double z;
+};
+
+// 图形记录公共部分，之后是按类型不同的几何数据
+struct VfpRecordHeader
+{
+    double pos[2];
+    double transform[6];         // m11, m12, m21, m22, dx, dy
+};
+
+static const char VFP_MAGIC[4] = { 'V', 'F', 'P', '\0' };
+static const char VFP_DIRECTORY_MAGIC[4] = { 'V', 'D', 'I', 'R' };
+static const quint16 VFP_VERSION = 1;
+
+// 每个目录页最多包含的表项数
+static const int VFP_PAGE_ENTRY_COUNT = 4096;
+static const quint16 VFP_NO_LAYER = 0xffff;
+
+// VfpShapeEntry::flags
+static const quint8 VFP_SHAPE_HIDDEN = 0x01;
+
+Q_STATIC_ASSERT(sizeof(VfpFileHeader) == 64);
+Q_STATIC_ASSERT(sizeof(VfpShapeEntry) == 48);
+Q_STATIC_ASSERT(sizeof(VfpPageRef) == 16);
+Q_STATIC_ASSERT(sizeof(VfpRecordHeader) == 64);
+
+#endif // VFP_FORMAT_H
@@ -3,28 +3,85 @@
 #include <QPainterPath>
 #include <QPen>
 #include <QDebug>
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+#include <QtMath>
 #include "../tools/drawing-tool-brush.h"
-#include "../core/drawing-throttle.h"
+#include "../core/input-pipeline.h"
 #include "../core/brush-engine.h"
+#include "../core/curve-fitter.h"
+#include "../core/path-boolean.h"
 #include "../ui/drawingscene.h"
 #include "../ui/drawingview.h"
 #include "../core/drawing-shape.h"
 #include "../core/drawing-layer.h"
 #include "../core/layer-manager.h"
 
+// 笔画结束时拟合轮廓的容差（屏幕像素）
+static const qreal FIT_TOLERANCE_PIXELS = 0.5;
+
+/**
+ * 笔画预览 - 绘制过程中显示画笔引擎的增量路径
+ * 稳定部分按块绘制并按暴露区域裁剪，每次加点只重绘尾部附近的区域
+ */
+class BrushStrokeItem : public QGraphicsItem
+{
+public:
+    BrushStrokeItem(const BrushEngine *engine, const QPen &pen)
+        : m_engine(engine), m_pen(pen)
+    {
+        setFlag(QGraphicsItem::ItemUsesExtendedStyleOption, true);
+        setZValue(1000);
+    }
+    
+    QRectF boundingRect() const override { return m_bounds; }
+    
+    // 引擎加点后调用：扩展边界并只重绘变化的区域
+    void strokeUpdated(const QRectF &changedRect)
+    {
+        const qreal margin = m_pen.widthF() / 2.0 + 1.0;
+        const QRectF dirty = changedRect.adjusted(-margin, -margin, margin, margin);
+        if (!m_bounds.contains(dirty)) {
+            prepareGeometryChange();
+            m_bounds |= dirty;
+        }
+        update(dirty);
+    }
+    
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override
+    {
+        Q_UNUSED(widget)
+        painter->setPen(m_pen);
+        painter->setBrush(Qt::NoBrush);
+        
+        const qreal margin = m_pen.widthF() / 2.0 + 1.0;
+        const QRectF exposed = option->exposedRect.adjusted(-margin, -margin, margin, margin);
+        for (const QPainterPath &chunk : m_engine->stableChunks()) {
+            if (chunk.controlPointRect().intersects(exposed)) {
+                painter->drawPath(chunk);
+            }
+        }
+        painter->drawPath(m_engine->tailPath());
+    }
+    
+private:
+    const BrushEngine *m_engine;
+    QPen m_pen;
+    QRectF m_bounds;
+};
+
 DrawingToolBrush::DrawingToolBrush(QObject *parent)
     : ToolBase(parent)
     , m_currentPath(nullptr)
-    , m_throttle(nullptr)
+    , m_strokeItem(nullptr)
+    , m_brushEngine(new BrushEngine(this))
+    , m_input(new InputPipeline(this))
     , m_brushWidth(2.0)
     , m_smoothness(0.5)
     , m_drawing(false)
 {
-    // 创建节流器（暂时保留，但暂不使用）
-    m_throttle = new DrawingThrottle(this);
-    m_throttle->setThrottleInterval(16);  // 60fps
-    m_throttle->setDistanceThreshold(1.5);  // 1.5像素阈值
-    m_throttle->setMaxPendingEvents(8);     // 最多缓存8个事件
+    // 输入管线按帧批量交出滤波后的采样
+    connect(m_input, &InputPipeline::samplesReady, this, &DrawingToolBrush::processSamples);
 }
 
 void DrawingToolBrush::activate(DrawingScene *scene, DrawingView *view)
@@ -34,18 +91,18 @@ void DrawingToolBrush::activate(DrawingScene *scene, DrawingView *view)
     m_points.clear();
     m_drawing = false;
     
-    // 清除节流器的待处理事件
-    if (m_throttle) {
-        m_throttle->clearPendingEvents();
-    }
+    m_input->clear();
+    m_input->attach(view ? view->viewport() : nullptr);
 }
 
 void DrawingToolBrush::deactivate()
 {
-    // 处理所有待处理的事件
-    if (m_throttle) {
-        m_throttle->flushPendingEvents();
+    // 未完成的笔画按当前结果保存
+    if (m_drawing) {
+        m_input->flush();
+        finishStroke();
     }
+    m_input->detach();
     
     // 不要删除图形，只是清除引用
     // 图形应该保留在场景中供其他工具编辑
@@ -57,39 +114,25 @@ void DrawingToolBrush::deactivate()
 bool DrawingToolBrush::mousePressEvent(QMouseEvent *event, const QPointF &scenePos)
 {
     if (event->button() == Qt::LeftButton && m_scene) {
+        const InputSample sample = m_input->begin(event, scenePos);
         m_drawing = true;
         m_points.clear();
-        m_points.append(scenePos);
-        m_lastPoint = scenePos;
-        
-        // 立即创建路径对象
-        m_currentPath = new DrawingPath();
-        QPainterPath path;
-        path.moveTo(scenePos);
-        m_currentPath->setPath(path);
-        
-        // 设置基本画笔样式
-        QPen pen(Qt::black, m_brushWidth, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin);
-        m_currentPath->setStrokePen(pen);
-        m_currentPath->setFillBrush(Qt::NoBrush); // 确保绘制纯线条
-        
-        // 添加到活动图层
-        LayerManager *layerManager = LayerManager::instance();
-        DrawingLayer *activeLayer = layerManager ? layerManager->activeLayer() : nullptr;
-        
-        if (activeLayer) {
-            activeLayer->addShape(m_currentPath);
-            qDebug() << "Added DrawingPath to active layer:" << activeLayer->name();
-        } else {
-            // 如果没有活动图层，直接添加到场景（向后兼容）
-            m_scene->addItem(m_currentPath);
-            qDebug() << "No active layer, added DrawingPath directly to scene";
-        }
+        m_points.append(sample.position);
         
-        m_currentPath->setVisible(true);
-        m_currentPath->setFlag(QGraphicsItem::ItemIsSelectable, true);
+        // 画笔引擎使用工具的线宽和平滑度，宽度范围按线宽等比缩放
+        BrushProfile profile = m_brushEngine->currentProfile();
+        const qreal widthScale = profile.baseWidth > 0 ? m_brushWidth / profile.baseWidth : 1.0;
+        profile.minWidth *= widthScale;
+        profile.maxWidth *= widthScale;
+        profile.baseWidth = m_brushWidth;
+        profile.smoothing = m_smoothness;
+        m_brushEngine->loadProfile(profile);
+        m_brushEngine->beginStroke(sample.position, sample.pressure);
         
-        qDebug() << "Created initial DrawingPath at" << scenePos;
+        // 绘制过程中只显示预览，松开鼠标后再创建路径对象
+        m_strokeItem = new BrushStrokeItem(m_brushEngine, strokePen());
+        m_scene->addItem(m_strokeItem);
+        m_strokeItem->strokeUpdated(m_brushEngine->lastUpdateRect());
         
         return true;
     }
@@ -99,52 +142,93 @@ bool DrawingToolBrush::mousePressEvent(QMouseEvent *event, const QPointF &sceneP
 
 bool DrawingToolBrush::mouseMoveEvent(QMouseEvent *event, const QPointF &scenePos)
 {
-    if (m_drawing && m_currentPath && m_scene) {
-        // 计算与上一个点的距离
-        qreal distance = QLineF(m_lastPoint, scenePos).length();
-        
-        // 只有当移动距离足够大时才添加点（避免过多的点）
-        if (distance > 2.0) {
-            m_points.append(scenePos);
-            m_lastPoint = scenePos;
-            
-            // 直接更新路径
-            QPainterPath path;
-            path.moveTo(m_points.first());
-            for (int i = 1; i < m_points.size(); ++i) {
-                path.lineTo(m_points[i]);
-            }
-            
-            m_currentPath->setPath(path);
-            
-            qDebug() << "Updated path with" << m_points.size() << "points";
-        }
-        
+    if (m_drawing && m_strokeItem && m_scene) {
+        // 每个原始采样都进入输入管线，由滤波器去抖而不是丢点
+        m_input->addSample(event, scenePos);
         return true;
     }
     
     return false;
 }
 
+void DrawingToolBrush::processSamples(const QVector<InputSample> &samples)
+{
+    if (!m_drawing || !m_strokeItem) {
+        return;
+    }
+    
+    // 整批加点后只重绘一次变化的区域
+    QRectF changedRect;
+    for (const InputSample &sample : samples) {
+        m_points.append(sample.position);
+        m_brushEngine->addPoint(sample.position, sample.pressure);
+        changedRect |= m_brushEngine->lastUpdateRect();
+    }
+    m_strokeItem->strokeUpdated(changedRect);
+}
+
 bool DrawingToolBrush::mouseReleaseEvent(QMouseEvent *event, const QPointF &scenePos)
 {
     if (event->button() == Qt::LeftButton && m_drawing) {
-        m_drawing = false;
-        
-        // 设置最终路径和控制点
-        if (m_currentPath) {
-            m_currentPath->setControlPoints(m_points);
-            m_scene->setModified(true);
-            
-            qDebug() << "Finished drawing with" << m_points.size() << "points";
-        }
-        
+        m_input->flush();
+        finishStroke();
         return true;
     }
     
     return false;
 }
 
+QPen DrawingToolBrush::strokePen() const
+{
+    return QPen(Qt::black, m_brushWidth, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin);
+}
+
+void DrawingToolBrush::finishStroke()
+{
+    m_drawing = false;
+    m_brushEngine->endStroke();
+    
+    if (m_strokeItem) {
+        if (m_strokeItem->scene()) {
+            m_strokeItem->scene()->removeItem(m_strokeItem);
+        }
+        delete m_strokeItem;
+        m_strokeItem = nullptr;
+    }
+    
+    if (!m_scene || m_points.size() < 2) {
+        return;
+    }
+    
+    // 用变宽轮廓创建图形：整条笔画是一个填充路径，而不是逐段描边；
+    // 轮廓多边形先合并掉内侧拐角的回折，再拟合成曲线，容差按屏幕像素换算
+    const qreal scale = m_view ? qSqrt(qAbs(m_view->transform().determinant())) : 1.0;
+    const qreal tolerance = FIT_TOLERANCE_PIXELS / (scale > 0.0 ? scale : 1.0);
+    const QPainterPath outline = PathBoolean::combine(QList<QPainterPath>() << m_brushEngine->getStrokeOutline(),
+                                                      PathEditor::Union, tolerance);
+    m_currentPath = new DrawingPath();
+    m_currentPath->setPath(CurveFitter::fitPath(outline, tolerance));
+    m_currentPath->setStrokePen(Qt::NoPen);
+    m_currentPath->setFillBrush(strokePen().brush());
+    
+    // 添加到活动图层
+    LayerManager *layerManager = LayerManager::instance();
+    DrawingLayer *activeLayer = layerManager ? layerManager->activeLayer() : nullptr;
+    
+    if (activeLayer) {
+        activeLayer->addShape(m_currentPath);
+    } else {
+        // 如果没有活动图层，直接添加到场景（向后兼容）
+        m_scene->addItem(m_currentPath);
+    }
+    
+    m_currentPath->setVisible(true);
+    m_currentPath->setFlag(QGraphicsItem::ItemIsSelectable, true);
+    m_scene->setModified(true);
+    
+    qDebug() << "Finished drawing with" << m_points.size() << "points";
+}
+
 QVector<QPointF> DrawingToolBrush::smoothPath(const QVector<QPointF> &points)
 {
     if (points.size() < 3) {
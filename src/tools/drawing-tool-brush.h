@@ -5,11 +5,14 @@
 #include "../core/brush-engine.h"
 #include <QPointF>
 #include <QVector>
+#include <QPen>
 
 class DrawingPath;
 class QMouseEvent;
-class DrawingThrottle;
 class BrushEngine;
+class BrushStrokeItem;
+class InputPipeline;
+struct InputSample;
 
 /**
  * 画笔工具 - 自由绘制
@@ -46,10 +49,18 @@ private:
     // 平滑路径（保留兼容性）
     QVector<QPointF> smoothPath(const QVector<QPointF> &points);
     
+    // 处理输入管线交出的一批采样
+    void processSamples(const QVector<InputSample> &samples);
+    
+    QPen strokePen() const;
+    // 结束笔画：移除预览并用完整路径创建图形
+    void finishStroke();
+    
     DrawingPath *m_currentPath;
-    DrawingThrottle *m_throttle;  // 事件节流器（暂不使用）
+    BrushStrokeItem *m_strokeItem;   // 绘制过程中的预览
+    BrushEngine *m_brushEngine;
+    InputPipeline *m_input;
     QVector<QPointF> m_points;
-    QPointF m_lastPoint;
     qreal m_brushWidth;
     qreal m_smoothness;
     bool m_drawing;
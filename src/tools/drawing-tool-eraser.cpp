@@ -2,13 +2,153 @@
 #include <QMouseEvent>
 #include <QKeyEvent>
 #include <QGraphicsEllipseItem>
+#include <QGraphicsPathItem>
+#include <QPainterPathStroker>
+#include <QUndoCommand>
+#include <QTimer>
+#include <QtMath>
 #include <QPen>
 #include <QBrush>
 #include <QDebug>
 #include "../tools/drawing-tool-eraser.h"
+#include "../core/input-pipeline.h"
+#include "../core/brush-engine.h"
 #include "../ui/drawingscene.h"
 #include "../ui/drawingview.h"
 #include "../core/drawing-shape.h"
+#include "../core/drawing-layer.h"
+#include "../core/layer-manager.h"
+
+// 拖动过程中累积的轨迹每隔多久应用一次（毫秒）
+static const int ERASE_BATCH_INTERVAL = 50;
+
+// 从场景中移除图形，图形属于图层时同时更新图层
+static void detachShape(DrawingScene *scene, DrawingShape *shape, DrawingLayer *layer)
+{
+    if (layer) {
+        layer->removeShape(shape);
+    } else if (shape->scene() == scene) {
+        scene->removeItem(shape);
+    }
+}
+
+static void attachShape(DrawingScene *scene, DrawingShape *shape, DrawingLayer *layer)
+{
+    if (shape->scene()) {
+        return;
+    }
+    if (layer) {
+        layer->addShape(shape);
+    } else {
+        scene->addItem(shape);
+    }
+}
+
+static DrawingLayer *layerOf(DrawingShape *shape)
+{
+    LayerManager *layerManager = LayerManager::instance();
+    if (!layerManager) {
+        return nullptr;
+    }
+    for (DrawingLayer *layer : layerManager->layers()) {
+        if (layer && layer->shapes().contains(shape)) {
+            return layer;
+        }
+    }
+    return nullptr;
+}
+
+// 图形可被擦除的区域（图形本地坐标）：有填充时是填充区域，只有描边时是描边轮廓
+static QPainterPath erasableArea(DrawingShape *shape, bool *strokeOnly)
+{
+    QPainterPath geometry = shape->transformedShape();
+    // transformedShape统一使用非零环绕规则，这里换回图形自己的填充规则，否则自交和带洞的区域会被填满
+    if (DrawingPath *path = dynamic_cast<DrawingPath*>(shape)) {
+        geometry.setFillRule(path->path().fillRule());
+    } else if (DrawingPolygon *polygon = dynamic_cast<DrawingPolygon*>(shape)) {
+        geometry.setFillRule(polygon->fillRule());
+    }
+    // 直线只画描边，填充画刷不起作用，线宽取直线自己的线宽
+    const DrawingLine *line = dynamic_cast<DrawingLine*>(shape);
+    const bool hasFill = shape->fillBrush().style() != Qt::NoBrush && !line;
+    const bool hasStroke = shape->strokePen().style() != Qt::NoPen;
+    *strokeOnly = !hasFill && hasStroke;
+    if (!*strokeOnly) {
+        return line ? QPainterPath() : geometry;
+    }
+    
+    // 描边在图形自身的变换之前计算，线宽随变换缩放
+    bool invertible = false;
+    const QTransform transform = shape->transform();
+    const QTransform inverse = transform.inverted(&invertible);
+    if (!invertible) {
+        return QPainterPath();
+    }
+    QPen pen = shape->strokePen();
+    if (line) {
+        pen.setWidthF(line->lineWidth());
+    }
+    QPainterPathStroker stroker(pen);
+    stroker.setDashPattern(Qt::SolidLine);
+    QPainterPath outline = transform.map(stroker.createStroke(inverse.map(geometry)));
+    outline.setFillRule(Qt::WindingFill);
+    return outline;
+}
+
+/**
+ * 擦除命令 - 一次拖动中所有被擦除或修改的图形
+ */
+class EraseCommand : public QUndoCommand
+{
+public:
+    EraseCommand(DrawingScene *scene, const QList<EraseRecord> &records, QUndoCommand *parent = nullptr)
+        : QUndoCommand("擦除", parent), m_scene(scene), m_records(records), m_undone(false)
+    {
+    }
+    
+    ~EraseCommand() override
+    {
+        // 不在场景中的一方归命令所有
+        for (const EraseRecord &record : m_records) {
+            if (m_undone) {
+                delete record.replacement;
+            } else {
+                delete record.original;
+            }
+        }
+    }
+    
+    void undo() override
+    {
+        for (int i = m_records.size() - 1; i >= 0; --i) {
+            const EraseRecord &record = m_records[i];
+            if (record.replacement) {
+                detachShape(m_scene, record.replacement, record.layer);
+            }
+            attachShape(m_scene, record.original, record.layer);
+        }
+        m_undone = true;
+        m_scene->setModified(true);
+    }
+    
+    void redo() override
+    {
+        // 第一次执行时擦除已经在拖动过程中完成，这里的操作都是幂等的
+        for (const EraseRecord &record : m_records) {
+            detachShape(m_scene, record.original, record.layer);
+            if (record.replacement) {
+                attachShape(m_scene, record.replacement, record.layer);
+            }
+        }
+        m_undone = false;
+        m_scene->setModified(true);
+    }
+    
+private:
+    DrawingScene *m_scene;
+    QList<EraseRecord> m_records;
+    bool m_undone;
+};
 
 DrawingToolEraser::DrawingToolEraser(QObject *parent)
     : ToolBase(parent)
@@ -18,13 +158,25 @@ DrawingToolEraser::DrawingToolEraser(QObject *parent)
     , m_eraserSize(20.0)
     , m_isErasing(false)
     , m_previewItem(nullptr)
+    , m_trailItem(nullptr)
+    , m_input(new InputPipeline(this))
+    , m_applyTimer(new QTimer(this))
 {
+    // 擦除沿用绘图输入管线：不丢采样，按帧批量处理
+    m_input->setFilterEnabled(false);
+    connect(m_input, &InputPipeline::samplesReady, this, &DrawingToolEraser::processSamples);
+    
+    // 轨迹按批应用，而不是每次鼠标移动都做一次布尔运算
+    m_applyTimer->setSingleShot(true);
+    m_applyTimer->setInterval(ERASE_BATCH_INTERVAL);
+    connect(m_applyTimer, &QTimer::timeout, this, &DrawingToolEraser::applyPendingErase);
 }
 
 void DrawingToolEraser::activate(DrawingScene *scene, DrawingView *view)
 {
     m_scene = scene;
     m_view = view;
+    m_input->attach(view ? view->viewport() : nullptr);
     
     // 设置自定义光标
     if (m_view) {
@@ -34,6 +186,11 @@ void DrawingToolEraser::activate(DrawingScene *scene, DrawingView *view)
 
 void DrawingToolEraser::deactivate()
 {
+    if (m_isErasing) {
+        m_input->flush();
+        commitErase();
+    }
+    m_input->detach();
     hideEraserCursor();
     
     // 恢复默认光标
@@ -50,24 +207,13 @@ bool DrawingToolEraser::mousePressEvent(QMouseEvent *event, const QPointF &scene
     if (!m_scene || event->button() != Qt::LeftButton) return false;
     
     m_isErasing = true;
+    m_records.clear();
+    m_recordIndex.clear();
+    m_pendingPoints.clear();
+    m_pendingPoints.append(m_input->begin(event, scenePos).position);
     
-    try {
-        // 查找擦除区域内的图形
-        QList<DrawingShape*> shapesToErase = findShapesInArea(scenePos, m_eraserSize);
-        qDebug() << "Found" << shapesToErase.size() << "shapes to erase";
-        
-        // 执行擦除
-        for (DrawingShape *shape : shapesToErase) {
-            if (shape && m_mode == WholeErase) {
-                eraseShape(shape);
-            } else if (shape) {
-                partialEraseShape(shape, scenePos, m_eraserSize);
-            }
-        }
-    } catch (...) {
-        qDebug() << "Error during mouse press erasing";
-        m_isErasing = false;
-    }
+    // 点击也要擦除，不等待下一批
+    applyPendingErase();
     
     return true;
 }
@@ -80,32 +226,94 @@ bool DrawingToolEraser::mouseMoveEvent(QMouseEvent *event, const QPointF &sceneP
     showEraserCursor(scenePos);
     
     if (m_isErasing) {
-        // 查找擦除区域内的图形
-        QList<DrawingShape*> shapesToErase = findShapesInArea(scenePos, m_eraserSize);
-        
-        // 执行擦除
-        for (DrawingShape *shape : shapesToErase) {
-            if (m_mode == WholeErase) {
-                eraseShape(shape);
-            } else {
-                partialEraseShape(shape, scenePos, m_eraserSize);
-            }
-        }
+        m_input->addSample(event, scenePos);
     }
     
     return true;
 }
 
+void DrawingToolEraser::processSamples(const QVector<InputSample> &samples)
+{
+    if (!m_scene || !m_isErasing) return;
+    
+    // 只累积轨迹并更新预览，图形几何按批修改
+    for (const InputSample &sample : samples) {
+        m_pendingPoints.append(sample.position);
+    }
+    updateTrailPreview();
+    
+    if (!m_applyTimer->isActive()) {
+        m_applyTimer->start();
+    }
+}
+
 bool DrawingToolEraser::mouseReleaseEvent(QMouseEvent *event, const QPointF &scenePos)
 {
     if (event->button() == Qt::LeftButton) {
-        m_isErasing = false;
+        if (m_isErasing) {
+            m_input->flush();
+            commitErase();
+        }
         return true;
     }
     
     return false;
 }
 
+void DrawingToolEraser::applyPendingErase()
+{
+    m_applyTimer->stop();
+    if (!m_scene || m_pendingPoints.isEmpty()) {
+        return;
+    }
+    
+    // 整段轨迹是一个圆头圆角的填充轮廓
+    QVector<qreal> widths(m_pendingPoints.size(), m_eraserSize);
+    const QPainterPath region = BrushEngine::buildOutline(m_pendingPoints, widths);
+    
+    const QList<DrawingShape*> candidates = findShapesInArea(region);
+    for (DrawingShape *shape : candidates) {
+        if (m_mode == WholeErase) {
+            eraseShape(shape, region);
+        } else {
+            partialEraseShape(shape, region);
+        }
+    }
+    if (!candidates.isEmpty()) {
+        m_scene->setModified(true);
+    }
+    
+    // 下一段轨迹从这一段的终点接上
+    const QPointF last = m_pendingPoints.last();
+    m_pendingPoints.clear();
+    m_pendingPoints.append(last);
+    updateTrailPreview();
+}
+
+void DrawingToolEraser::commitErase()
+{
+    applyPendingErase();
+    m_isErasing = false;
+    m_pendingPoints.clear();
+    updateTrailPreview();
+    
+    // 擦除过程中被完全擦掉的替换路径不再需要
+    QList<EraseRecord> records;
+    for (EraseRecord record : m_records) {
+        if (record.replacement && !record.replacement->scene()) {
+            delete record.replacement;
+            record.replacement = nullptr;
+        }
+        records.append(record);
+    }
+    m_records.clear();
+    m_recordIndex.clear();
+    
+    if (!records.isEmpty() && m_scene) {
+        m_scene->undoStack()->push(new EraseCommand(m_scene, records));
+    }
+}
+
 bool DrawingToolEraser::keyReleaseEvent(QKeyEvent *event)
 {
     if (event->key() == Qt::Key_Shift) {
@@ -150,64 +358,125 @@ void DrawingToolEraser::setEraserSize(qreal size)
     m_eraserSize = qBound(5.0, size, 100.0); // 限制在5-100像素之间
 }
 
-QList<DrawingShape*> DrawingToolEraser::findShapesInArea(const QPointF &center, qreal radius)
+QList<DrawingShape*> DrawingToolEraser::findShapesInArea(const QPainterPath &region)
 {
     QList<DrawingShape*> shapesInArea;
     
     if (!m_scene) return shapesInArea;
     
-    // 创建擦除区域
-    QRectF eraseArea(center.x() - radius, center.y() - radius, radius * 2, radius * 2);
-    
-    // 获取区域内的所有图形项
-    QList<QGraphicsItem*> items = m_scene->items(eraseArea);
+    // 先用场景的空间索引按包围盒筛选，精确的相交判断在擦除时进行
+    const QList<QGraphicsItem*> items = m_scene->items(region.boundingRect(), Qt::IntersectsItemBoundingRect);
     
     for (QGraphicsItem *item : items) {
-        // 检查项目是否有效
-        if (!item) continue;
-        
-        // 使用类型检查而不是qgraphicsitem_cast
-        if (item->type() == QGraphicsItem::UserType + 2) { // DrawingShape类型
-            DrawingShape *shape = static_cast<DrawingShape*>(item);
-            // 检查图形是否真的在擦除范围内
-            if (isInRange(shape->sceneBoundingRect().center(), center, radius) ||
-                shape->sceneBoundingRect().intersects(eraseArea)) {
-                shapesInArea.append(shape);
-            }
+        // 只擦除顶层的普通图形，组合和组合内的图形保持不变
+        DrawingShape *shape = dynamic_cast<DrawingShape*>(item);
+        if (!shape || shape->type() != QGraphicsItem::UserType + 2 || shape->parentItem()) {
+            continue;
+        }
+        if (!shape->isVisible()) {
+            continue;
+        }
+        // 文字的transformedShape只是包围盒，不能当作几何擦除
+        if (shape->shapeType() == DrawingShape::Text) {
+            continue;
         }
+        shapesInArea.append(shape);
     }
     
     return shapesInArea;
 }
 
-void DrawingToolEraser::eraseShape(DrawingShape *shape)
+void DrawingToolEraser::eraseShape(DrawingShape *shape, const QPainterPath &region)
 {
     if (!shape || !m_scene) return;
     
-    try {
-        // 记录擦除历史
-        m_erasedShapes.append(shape);
-        
-        // 从场景中移除图形
-        m_scene->removeItem(shape);
-        
-        // 安全删除图形
-        shape->setVisible(false); // 先隐藏
-        delete shape;
-        
-        // 标记场景已修改
-        m_scene->setModified(true);
-    } catch (...) {
-        // 如果出错，至少保证不会崩溃
-        qDebug() << "Error erasing shape";
+    bool strokeOnly = false;
+    if (!erasableArea(shape, &strokeOnly).intersects(shape->mapFromScene(region))) {
+        return;
+    }
+    
+    const int index = m_recordIndex.value(shape, -1);
+    if (index >= 0) {
+        // 本次拖动中生成的替换路径，整体移除
+        EraseRecord &record = m_records[index];
+        detachShape(m_scene, record.replacement, record.layer);
+        m_recordIndex.remove(shape);
+        return;
     }
+    
+    EraseRecord record;
+    record.original = shape;
+    record.replacement = nullptr;
+    record.layer = layerOf(shape);
+    detachShape(m_scene, shape, record.layer);
+    m_records.append(record);
 }
 
-void DrawingToolEraser::partialEraseShape(DrawingShape *shape, const QPointF &center, qreal radius)
+void DrawingToolEraser::partialEraseShape(DrawingShape *shape, const QPainterPath &region)
 {
-    // TODO: 局部擦除功能需要更复杂的实现
-    // 暂时使用整体擦除
-    eraseShape(shape);
+    if (!shape || !m_scene) return;
+    
+    const QPainterPath localRegion = shape->mapFromScene(region);
+    const int index = m_recordIndex.value(shape, -1);
+    
+    if (index >= 0) {
+        // 已经是替换路径，直接在它的几何上继续减
+        EraseRecord &record = m_records[index];
+        const QPainterPath area = record.replacement->path();
+        if (!area.intersects(localRegion)) {
+            return;
+        }
+        const QPainterPath result = area.subtracted(localRegion);
+        if (result.isEmpty()) {
+            detachShape(m_scene, record.replacement, record.layer);
+            m_recordIndex.remove(shape);
+        } else {
+            record.replacement->setPath(result);
+        }
+        return;
+    }
+    
+    bool strokeOnly = false;
+    const QPainterPath area = erasableArea(shape, &strokeOnly);
+    if (!area.intersects(localRegion)) {
+        return;
+    }
+    const QPainterPath result = area.subtracted(localRegion);
+    
+    EraseRecord record;
+    record.original = shape;
+    record.replacement = nullptr;
+    record.layer = layerOf(shape);
+    
+    if (!result.isEmpty()) {
+        // 替换路径使用原图形的本地坐标系，几何中已包含图形自身的变换
+        DrawingPath *replacement = new DrawingPath();
+        replacement->setPath(result);
+        replacement->setPos(shape->pos());
+        replacement->QGraphicsItem::setTransform(shape->QGraphicsItem::transform());
+        replacement->setZValue(shape->zValue());
+        replacement->setOpacity(shape->opacity());
+        replacement->setFlags(shape->flags());
+        if (strokeOnly) {
+            // 描边变成填充轮廓
+            replacement->setFillBrush(shape->strokePen().brush());
+            replacement->setStrokePen(Qt::NoPen);
+        } else {
+            // 描边宽度按图形变换的缩放折算
+            QPen pen = shape->strokePen();
+            pen.setWidthF(pen.widthF() * qSqrt(qAbs(shape->transform().determinant())));
+            replacement->setFillBrush(shape->fillBrush());
+            replacement->setStrokePen(pen);
+        }
+        record.replacement = replacement;
+    }
+    
+    detachShape(m_scene, shape, record.layer);
+    if (record.replacement) {
+        attachShape(m_scene, record.replacement, record.layer);
+        m_recordIndex.insert(record.replacement, m_records.size());
+    }
+    m_records.append(record);
 }
 
 void DrawingToolEraser::updateEraserPreview(const QPointF &scenePos)
@@ -220,14 +489,14 @@ void DrawingToolEraser::showEraserCursor(const QPointF &scenePos)
 {
     if (!m_scene) return;
     
-    // 如果预览项已存在，先隐藏
-    if (m_previewItem) {
-        m_previewItem->setVisible(false);
+    // 复用同一个预览圆圈，只更新位置和大小
+    if (!m_previewItem) {
+        m_previewItem = m_scene->addEllipse(QRectF());
+        m_previewItem->setZValue(1000); // 确保在最顶层
     }
-    
-    // 创建橡皮擦预览圆圈
-    m_previewItem = m_scene->addEllipse(-m_eraserSize/2, -m_eraserSize/2, m_eraserSize, m_eraserSize);
+    m_previewItem->setRect(-m_eraserSize/2, -m_eraserSize/2, m_eraserSize, m_eraserSize);
     m_previewItem->setPos(scenePos);
+    m_previewItem->setVisible(true);
     
     // 根据模式设置不同的颜色
     if (m_mode == PartialErase) {
@@ -237,8 +506,6 @@ void DrawingToolEraser::showEraserCursor(const QPointF &scenePos)
         m_previewItem->setPen(QPen(Qt::black, 1, Qt::DashLine));
         m_previewItem->setBrush(QBrush(Qt::white, Qt::Dense4Pattern));
     }
-    
-    m_previewItem->setZValue(1000); // 确保在最顶层
 }
 
 void DrawingToolEraser::hideEraserCursor()
@@ -248,10 +515,28 @@ void DrawingToolEraser::hideEraserCursor()
         delete m_previewItem;
         m_previewItem = nullptr;
     }
+    if (m_trailItem && m_scene) {
+        m_scene->removeItem(m_trailItem);
+        delete m_trailItem;
+        m_trailItem = nullptr;
+    }
 }
 
-bool DrawingToolEraser::isInRange(const QPointF &point, const QPointF &center, qreal radius)
+void DrawingToolEraser::updateTrailPreview()
 {
-    qreal distance = QLineF(point, center).length();
-    return distance <= radius;
-}
\ No newline at end of file
+    if (!m_scene) return;
+    
+    if (m_pendingPoints.size() < 2) {
+        if (m_trailItem) {
+            m_trailItem->setPath(QPainterPath());
+        }
+        return;
+    }
+    
+    if (!m_trailItem) {
+        m_trailItem = m_scene->addPath(QPainterPath(), Qt::NoPen, QColor(128, 128, 128, 96));
+        m_trailItem->setZValue(999);
+    }
+    QVector<qreal> widths(m_pendingPoints.size(), m_eraserSize);
+    m_trailItem->setPath(BrushEngine::buildOutline(m_pendingPoints, widths));
+}
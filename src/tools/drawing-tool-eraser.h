@@ -5,11 +5,29 @@
 #include <QPointF>
 #include <QList>
 #include <QRectF>
+#include <QVector>
+#include <QHash>
+#include <QPainterPath>
 
 class DrawingScene;
 class DrawingView;
 class DrawingShape;
 class QGraphicsEllipseItem;
+class QGraphicsPathItem;
+class QTimer;
+class DrawingPath;
+class DrawingLayer;
+class InputPipeline;
+struct InputSample;
+
+/**
+ * 一个图形的擦除记录：原图形被移除，由替换路径代替；整体擦除时没有替换路径
+ */
+struct EraseRecord {
+    DrawingShape *original;
+    DrawingPath *replacement;
+    DrawingLayer *layer;
+};
 
 /**
  * 橡皮擦工具
@@ -50,14 +68,23 @@ public:
     int eraserSizeForPanel() const { return static_cast<int>(m_eraserSize); }
 
 private:
-    // 查找擦除区域内的图形
-    QList<DrawingShape*> findShapesInArea(const QPointF &center, qreal radius);
+    // 处理输入管线交出的一批采样
+    void processSamples(const QVector<InputSample> &samples);
+    
+    // 把累积的擦除轨迹一次应用到相交的图形上
+    void applyPendingErase();
     
-    // 整体擦除图形
-    void eraseShape(DrawingShape *shape);
+    // 结束一次拖动：应用剩余轨迹并生成一条撤销命令
+    void commitErase();
     
-    // 局部擦除图形（未来实现）
-    void partialEraseShape(DrawingShape *shape, const QPointF &center, qreal radius);
+    // 查找与擦除区域（场景坐标）相交的候选图形
+    QList<DrawingShape*> findShapesInArea(const QPainterPath &region);
+    
+    // 整体擦除与擦除区域（场景坐标）相交的图形
+    void eraseShape(DrawingShape *shape, const QPainterPath &region);
+    
+    // 局部擦除图形：从图形几何中减去擦除区域（场景坐标）
+    void partialEraseShape(DrawingShape *shape, const QPainterPath &region);
     
     // 更新橡皮擦预览
     void updateEraserPreview(const QPointF &scenePos);
@@ -68,8 +95,8 @@ private:
     // 隐藏橡皮擦光标
     void hideEraserCursor();
     
-    // 检查点是否在擦除范围内
-    bool isInRange(const QPointF &point, const QPointF &center, qreal radius);
+    // 更新尚未应用的擦除轨迹的预览
+    void updateTrailPreview();
 
 private:
     DrawingScene *m_scene;
@@ -81,10 +108,18 @@ private:
     
     // 预览相关
     QGraphicsEllipseItem *m_previewItem;
+    QGraphicsPathItem *m_trailItem;
+    
+    // 输入管线
+    InputPipeline *m_input;
+    
+    // 尚未应用的擦除轨迹点，第一个点是上次应用的终点
+    QVector<QPointF> m_pendingPoints;
+    QTimer *m_applyTimer;
     
-    // 擦除历史（用于撤销）
-    QList<DrawingShape*> m_erasedShapes;
-    QList<QRectF> m_erasedAreas;
+    // 本次拖动的擦除记录（结束时合并为一条撤销命令）
+    QList<EraseRecord> m_records;
+    QHash<DrawingShape*, int> m_recordIndex;   // 场景中的图形 -> 记录下标
 };
 
 #endif // DRAWING_TOOL_ERASER_H
\ No newline at end of file
@@ -1,13 +1,100 @@
 #include <QGraphicsScene>
 #include <QMouseEvent>
 #include <QBrush>
+#include <QUndoCommand>
+#include <QtMath>
+#include <QDebug>
 #include "../tools/drawing-tool-fill.h"
 #include "../ui/drawingscene.h"
 #include "../ui/drawingview.h"
 #include "../core/drawing-shape.h"
+#include "../core/drawing-layer.h"
+#include "../core/layer-manager.h"
+#include "../core/planar-arrangement.h"
 #include "../ui/mainwindow.h"
 #include "../ui/colorpalette.h"
 
+// 初始搜索窗口边长（屏幕像素），区域超出窗口时逐次加倍
+static const int SEARCH_WINDOW_PIXELS = 256;
+static const int MAX_WINDOW_EXPANSIONS = 4;
+// 容差换算为缺口像素的除数：默认容差32可封闭4像素的缺口
+static const int TOLERANCE_PER_GAP_PIXEL = 8;
+
+// 图形自己的填充区域（场景坐标），使用图形的填充规则
+static QPainterPath sceneFillArea(DrawingShape *shape)
+{
+    QPainterPath area = shape->sceneTransform().map(shape->transformedShape());
+    if (DrawingPath *path = dynamic_cast<DrawingPath*>(shape)) {
+        area.setFillRule(path->path().fillRule());
+    } else if (DrawingPolygon *polygon = dynamic_cast<DrawingPolygon*>(shape)) {
+        area.setFillRule(polygon->fillRule());
+    }
+    return area;
+}
+
+// 区域是否就是图形自己的填充区域：点击处在填充区域内，且两者包围盒在缺口容差内重合；
+// 自交图形的局部区域包围盒较小，不算
+static bool isOwnFillArea(DrawingShape *shape, const QPainterPath &face, const QPointF &scenePos, qreal tolerance)
+{
+    const QPainterPath area = sceneFillArea(shape);
+    if (!area.contains(scenePos)) {
+        return false;
+    }
+    const QRectF areaRect = area.boundingRect();
+    const QRectF faceRect = face.boundingRect();
+    return qAbs(areaRect.left() - faceRect.left()) <= tolerance
+           && qAbs(areaRect.top() - faceRect.top()) <= tolerance
+           && qAbs(areaRect.right() - faceRect.right()) <= tolerance
+           && qAbs(areaRect.bottom() - faceRect.bottom()) <= tolerance;
+}
+
+/**
+ * 区域填充命令 - 撤销时移除新建的填充路径
+ */
+class FillRegionCommand : public QUndoCommand
+{
+public:
+    FillRegionCommand(DrawingScene *scene, DrawingPath *path, DrawingLayer *layer, QUndoCommand *parent = nullptr)
+        : QUndoCommand("填充区域", parent), m_scene(scene), m_path(path), m_layer(layer)
+    {
+    }
+    
+    ~FillRegionCommand() override
+    {
+        // 撤销后路径不在场景中，归命令所有
+        if (m_path && !m_path->scene()) {
+            delete m_path;
+        }
+    }
+    
+    void undo() override
+    {
+        if (m_layer) {
+            m_layer->removeShape(m_path);
+        } else if (m_path->scene() == m_scene) {
+            m_scene->removeItem(m_path);
+        }
+        m_scene->setModified(true);
+    }
+    
+    void redo() override
+    {
+        if (!m_path->scene()) {
+            if (m_layer) {
+                m_layer->addShape(m_path);
+            } else {
+                m_scene->addItem(m_path);
+            }
+        }
+        m_scene->setModified(true);
+    }
+    
+private:
+    DrawingScene *m_scene;
+    DrawingPath *m_path;
+    DrawingLayer *m_layer;
+};
+
 DrawingToolFill::DrawingToolFill(QObject *parent)
     : ToolBase(parent)
     , m_currentFillColor(Qt::blue)
@@ -34,8 +121,23 @@ bool DrawingToolFill::mousePressEvent(QMouseEvent *event, const QPointF &scenePo
         // 每次点击时重新获取当前颜色
         m_currentFillColor = getCurrentFillColor();
         
-        // 查找点击位置的封闭图形
-        DrawingShape *shape = findEnclosedShape(scenePos);
+        // 优先填充由附近线条围成的区域
+        QList<DrawingShape*> sources;
+        const QPainterPath region = findEnclosedRegion(scenePos, &sources);
+        DrawingShape *shape = nullptr;
+        if (!region.isEmpty()) {
+            // 区域只由一个图形围成且正是它自己的填充区域时给图形上色；
+            // 多个图形或自交围成的区域才新建填充路径
+            if (sources.size() == 1 && isOwnFillArea(sources.first(), region, scenePos, closingGap())) {
+                shape = sources.first();
+            } else {
+                fillRegion(region, sources);
+                return true;
+            }
+        } else {
+            // 没有围成的区域时给点击处的封闭图形上色
+            shape = findEnclosedShape(scenePos);
+        }
         if (shape) {
             // 使用当前填充颜色（填充工具现在只处理纯色填充）
             shape->setFillBrush(QBrush(m_currentFillColor));
@@ -74,7 +176,7 @@ DrawingShape* DrawingToolFill::findEnclosedShape(const QPointF &scenePos)
     
     // 从上到下查找第一个可填充的图形
     for (QGraphicsItem *item : items) {
-        DrawingShape *shape = qgraphicsitem_cast<DrawingShape*>(item);
+        DrawingShape *shape = dynamic_cast<DrawingShape*>(item);
         if (shape) {
             // 检查图形类型是否支持填充
             DrawingShape::ShapeType type = shape->shapeType();
@@ -107,6 +209,99 @@ DrawingShape* DrawingToolFill::findEnclosedShape(const QPointF &scenePos)
     return nullptr;
 }
 
+QPainterPath DrawingToolFill::findEnclosedRegion(const QPointF &scenePos, QList<DrawingShape*> *sources)
+{
+    if (!m_scene) {
+        return QPainterPath();
+    }
+    
+    const qreal scale = viewScale();
+    const qreal gap = closingGap();
+    qreal halfSize = SEARCH_WINDOW_PIXELS / 2.0 / scale;
+    
+    // 只取点击附近的几何；区域没有完整落在窗口内时扩大窗口重试
+    for (int attempt = 0; attempt <= MAX_WINDOW_EXPANSIONS; ++attempt, halfSize *= 2.0) {
+        const QRectF window(scenePos.x() - halfSize, scenePos.y() - halfSize, halfSize * 2.0, halfSize * 2.0);
+        PlanarArrangement arrangement(window, gap);
+        
+        QList<DrawingShape*> shapes;
+        const QList<QGraphicsItem*> items = m_scene->items(window, Qt::IntersectsItemBoundingRect);
+        for (QGraphicsItem *item : items) {
+            if (item->type() != QGraphicsItem::UserType + 2 || !item->isVisible()) {
+                continue;
+            }
+            // 文字的transformedShape只是包围盒，不参与围成区域；直线按线段本身加入
+            DrawingShape *shape = dynamic_cast<DrawingShape*>(item);
+            if (!shape || shape->shapeType() == DrawingShape::Text) {
+                continue;
+            }
+            arrangement.addPath(shape->sceneTransform().map(shape->transformedShape()), shapes.size());
+            shapes.append(shape);
+        }
+        if (shapes.isEmpty()) {
+            return QPainterPath();
+        }
+        
+        arrangement.build();
+        QList<int> faceSources;
+        const QPainterPath face = arrangement.faceAt(scenePos, &faceSources);
+        if (face.isEmpty()) {
+            // 点不在任何有界区域内，扩大窗口可能会带进更多几何
+            continue;
+        }
+        if (!window.contains(face.boundingRect())) {
+            continue;
+        }
+        
+        if (sources) {
+            sources->clear();
+            for (int index : faceSources) {
+                sources->append(shapes[index]);
+            }
+        }
+        return face;
+    }
+    
+    return QPainterPath();
+}
+
+void DrawingToolFill::fillRegion(const QPainterPath &region, const QList<DrawingShape*> &sources)
+{
+    DrawingPath *path = new DrawingPath();
+    path->setPath(region);
+    path->setStrokePen(Qt::NoPen);
+    path->setFillBrush(QBrush(m_currentFillColor));
+    path->setFlag(QGraphicsItem::ItemIsSelectable, true);
+    
+    // 放在围成区域的图形之下，不遮住线条
+    if (!sources.isEmpty()) {
+        qreal minZ = sources.first()->zValue();
+        for (DrawingShape *shape : sources) {
+            minZ = qMin(minZ, shape->zValue());
+        }
+        path->setZValue(minZ - 0.01);
+    }
+    
+    LayerManager *layerManager = LayerManager::instance();
+    DrawingLayer *activeLayer = layerManager ? layerManager->activeLayer() : nullptr;
+    m_scene->undoStack()->push(new FillRegionCommand(m_scene, path, activeLayer));
+}
+
+qreal DrawingToolFill::closingGap() const
+{
+    return qreal(m_tolerance) / TOLERANCE_PER_GAP_PIXEL / viewScale();
+}
+
+qreal DrawingToolFill::viewScale() const
+{
+    if (!m_view) {
+        return 1.0;
+    }
+    const QTransform transform = m_view->transform();
+    const qreal scale = qSqrt(qAbs(transform.determinant()));
+    return scale > 0.0 ? scale : 1.0;
+}
+
 QColor DrawingToolFill::getCurrentFillColor() const
 {
     // 尝试从主窗口获取颜色面板
@@ -3,14 +3,18 @@
 
 #include "../core/toolbase.h"
 #include <QBrush>
+#include <QPainterPath>
+#include <QList>
 
 class DrawingScene;
 class DrawingView;
 class DrawingShape;
+class DrawingPath;
 
 /**
  * 填充工具
- * 点击封闭图形进行填充
+ * 点击由多条线条和图形围成的区域，为该区域创建新的填充路径；
+ * 区域就是单个图形自己的填充区域，或找不到区域时，给点击处的封闭图形上色
  */
 class DrawingToolFill : public ToolBase
 {
@@ -44,11 +48,23 @@ private:
     // 检查点是否在封闭图形内
     DrawingShape* findEnclosedShape(const QPointF &scenePos);
     
+    // 求点击处由附近几何围成的区域（场景坐标），sources返回围成区域的图形
+    QPainterPath findEnclosedRegion(const QPointF &scenePos, QList<DrawingShape*> *sources);
+    
+    // 用区域创建填充路径并加入撤销栈
+    void fillRegion(const QPainterPath &region, const QList<DrawingShape*> &sources);
+    
+    // 容差对应的可封闭缺口（场景距离）
+    qreal closingGap() const;
+    
+    // 视图缩放，用于把屏幕像素换算成场景距离
+    qreal viewScale() const;
+    
     // 获取当前填充颜色
     QColor getCurrentFillColor() const;
     
     QColor m_currentFillColor;
-    int m_tolerance;  // 填充容差
+    int m_tolerance;  // 填充容差，决定可封闭的缺口大小
 };
 
 #endif // DRAWING_TOOL_FILL_H
\ No newline at end of file
@@ -182,7 +182,8 @@ bool DrawingNodeEditTool::mousePressEvent(QMouseEvent *event, const QPointF &sce
                 {
                     DrawingPath *path = static_cast<DrawingPath *>(shape);
                     path->setShowControlPolygon(true);
-                    // 不创建手柄，让路径自己处理控制点
+                    // 创建节点手柄层用于显示，控制点的拖动让路径自己处理
+                    updateNodeHandles();
                     return false; // 让事件传播到DrawingPath
                 }
 
@@ -536,25 +537,10 @@ void DrawingNodeEditTool::activate(DrawingScene *scene, DrawingView *view)
         }
     }
 
-    // 如果有选中的图形，让图形自己处理节点显示
-    // 路径已经在paintShape中绘制控制点，其他图形通过updateNodeHandles显示手柄
+    // 如果有选中的图形，显示节点手柄；路径的控制点由节点手柄层统一绘制
     if (m_selectedShape)
     {
-        bool isPath = (m_selectedShape->shapeType() == DrawingShape::Path);
-        // qDebug() << "Node edit tool: selected shape is path:" << (isPath ? "yes" : "no");
-        if (!isPath)
-        {
-            // qDebug() << "Node edit tool: calling updateNodeHandles for non-path shape";
-            updateNodeHandles();
-        }
-        else
-        {
-            // qDebug() << "Node edit tool: skipping updateNodeHandles for path shape";
-        }
-    }
-    else
-    {
-        // qDebug() << "Node edit tool: no selected shape";
+        updateNodeHandles();
     }
 
     // 连接场景的选择变化信号，以便在选择变化时更新节点手柄
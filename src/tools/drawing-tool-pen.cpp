@@ -5,12 +5,16 @@
 #include <QGraphicsPathItem>
 #include <QGraphicsEllipseItem>
 #include <QGraphicsLineItem>
+#include <QStyleOptionGraphicsItem>
+#include <QPainter>
 #include <QPen>
 #include <QBrush>
 #include <QElapsedTimer>
 #include <QtMath>
 #include <QDebug>
 #include "../tools/drawing-tool-pen.h"
+#include "../core/input-pipeline.h"
+#include "../core/curve-fitter.h"
 #include "../ui/drawingscene.h"
 #include "../ui/drawingview.h"
 #include "../core/drawing-shape.h"
@@ -19,6 +23,87 @@
 #include "../ui/mainwindow.h"
 #include "../ui/colorpalette.h"
 
+// 自由绘制结束时拟合曲线的容差（屏幕像素）
+static const qreal FIT_TOLERANCE_PIXELS = 0.5;
+// 自由绘制预览中每块折线的点数
+static const int FREE_DRAW_CHUNK_SIZE = 256;
+
+/**
+ * 自由绘制预览 - 采样按固定点数分块存成折线，追加时只扩展最后一块
+ * 绘制时按暴露区域跳过不相交的块，每批采样只重绘新线段附近的区域
+ */
+class FreeDrawStrokeItem : public QGraphicsItem
+{
+public:
+    FreeDrawStrokeItem(const QPointF &start, const QPen &pen)
+        : m_pen(pen), m_last(start)
+    {
+        setFlag(QGraphicsItem::ItemUsesExtendedStyleOption, true);
+        setZValue(1000);
+        m_chunks.append(QPainterPath(start));
+        strokeUpdated(QRectF(start, start));
+    }
+    
+    QRectF boundingRect() const override { return m_bounds; }
+    
+    void appendPoints(const QVector<InputSample> &samples)
+    {
+        if (samples.isEmpty()) {
+            return;
+        }
+        qreal minX = m_last.x();
+        qreal minY = m_last.y();
+        qreal maxX = minX;
+        qreal maxY = minY;
+        for (const InputSample &sample : samples) {
+            // 新块从上一块的终点开始，圆头画笔让块之间看不出接缝
+            if (m_chunks.last().elementCount() > FREE_DRAW_CHUNK_SIZE) {
+                m_chunks.append(QPainterPath(m_last));
+            }
+            m_chunks.last().lineTo(sample.position);
+            m_last = sample.position;
+            minX = qMin(minX, m_last.x());
+            minY = qMin(minY, m_last.y());
+            maxX = qMax(maxX, m_last.x());
+            maxY = qMax(maxY, m_last.y());
+        }
+        strokeUpdated(QRectF(QPointF(minX, minY), QPointF(maxX, maxY)));
+    }
+    
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override
+    {
+        Q_UNUSED(widget)
+        painter->setPen(m_pen);
+        painter->setBrush(Qt::NoBrush);
+        
+        const qreal margin = m_pen.widthF() / 2.0 + 1.0;
+        const QRectF exposed = option->exposedRect.adjusted(-margin, -margin, margin, margin);
+        for (const QPainterPath &chunk : m_chunks) {
+            if (chunk.controlPointRect().intersects(exposed)) {
+                painter->drawPath(chunk);
+            }
+        }
+    }
+    
+private:
+    // 扩展边界并只重绘变化的区域
+    void strokeUpdated(const QRectF &changedRect)
+    {
+        const qreal margin = m_pen.widthF() / 2.0 + 1.0;
+        const QRectF dirty = changedRect.adjusted(-margin, -margin, margin, margin);
+        if (!m_bounds.contains(dirty)) {
+            prepareGeometryChange();
+            m_bounds |= dirty;
+        }
+        update(dirty);
+    }
+    
+    QPen m_pen;
+    QPointF m_last;
+    QVector<QPainterPath> m_chunks;
+    QRectF m_bounds;
+};
+
 DrawingToolPen::DrawingToolPen(QObject *parent)
     : ToolBase(parent)
     , m_scene(nullptr)
@@ -27,7 +112,9 @@ DrawingToolPen::DrawingToolPen(QObject *parent)
     , m_isDrawing(false)
     , m_isDragging(false)
     , m_brushEngine(new BrushEngine(this))
+    , m_input(new InputPipeline(this))
     , m_currentPath(nullptr)
+    , m_freeDrawItem(nullptr)
     , m_previewPathItem(nullptr)
     , m_currentStrokeColor(Qt::black)
     , m_currentFillColor(Qt::transparent)
@@ -40,6 +127,9 @@ DrawingToolPen::DrawingToolPen(QObject *parent)
     // 加载钢笔预设
     m_brushEngine->loadDefaultProfile("Fountain Pen");
     
+    // 自由绘制的采样由输入管线按帧交出
+    connect(m_input, &InputPipeline::samplesReady, this, &DrawingToolPen::processFreeDrawSamples);
+    
     // 连接信号
     connect(m_brushEngine, &BrushEngine::strokeUpdated, this, [this]() {
         if (m_currentPath) {
@@ -56,6 +146,7 @@ void DrawingToolPen::activate(DrawingScene *scene, DrawingView *view)
 {
     m_scene = scene;
     m_view = view;
+    m_input->attach(view ? view->viewport() : nullptr);
     
     // 获取当前颜色
     m_currentStrokeColor = getCurrentStrokeColor();
@@ -72,9 +163,16 @@ void DrawingToolPen::activate(DrawingScene *scene, DrawingView *view)
 
 void DrawingToolPen::deactivate()
 {
+    m_input->flush();
     if (m_isDrawing) {
-        finishPath();
+        // 未完成的自由绘制按当前结果保存
+        if (m_mode == FreeDrawMode && m_freeDrawItem) {
+            endFreeDraw();
+        } else {
+            finishPath();
+        }
     }
+    m_input->detach();
     
     clearCurrentPath();
     m_scene = nullptr;
@@ -94,7 +192,7 @@ bool DrawingToolPen::mousePressEvent(QMouseEvent *event, const QPointF &scenePos
             
             // 根据模式处理
             if (m_mode == FreeDrawMode) {
-                beginFreeDraw(scenePos);
+                beginFreeDraw(m_input->begin(event, scenePos).position);
             } else {
                 addAnchorPoint(scenePos);
             }
@@ -138,8 +236,8 @@ bool DrawingToolPen::mouseMoveEvent(QMouseEvent *event, const QPointF &scenePos)
     
     if (m_isDragging) {
         if (m_mode == FreeDrawMode) {
-            // 自由绘制模式：使用画笔引擎
-            updateFreeDraw(scenePos);
+            // 自由绘制模式：采样进入输入管线，按帧批量处理
+            m_input->addSample(event, scenePos);
         } else {
             // 锚点模式：实时添加点到路径
             qreal distance = QLineF(m_dragStart, scenePos).length();
@@ -164,6 +262,7 @@ bool DrawingToolPen::mouseReleaseEvent(QMouseEvent *event, const QPointF &sceneP
         m_isDragging = false;
         
         if (m_mode == FreeDrawMode) {
+            m_input->flush();
             endFreeDraw();
         }
         // 锚点模式下不结束路径，继续绘制
@@ -373,6 +472,15 @@ void DrawingToolPen::clearCurrentPath()
     }
     m_controlLineItems.clear();
     
+    // 清理自由绘制预览
+    if (m_freeDrawItem) {
+        m_scene->removeItem(m_freeDrawItem);
+        delete m_freeDrawItem;
+        m_freeDrawItem = nullptr;
+    }
+    m_freeDrawPoints.clear();
+    m_pressures.clear();
+    
     // 重置数据
     m_anchorPoints.clear();
     m_controlPoints.clear();
@@ -527,11 +635,42 @@ void DrawingToolPen::beginFreeDraw(const QPointF &scenePos)
     m_pressures.clear();
     m_timer.restart();
     
-    // 立即创建路径对象（与画笔工具完全相同）
+    // 绘制过程中只显示预览，路径图形在结束时按拟合结果一次生成
+    QPen pen(m_currentStrokeColor, m_strokeWidth, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin);
+    m_freeDrawItem = new FreeDrawStrokeItem(scenePos, pen);
+    m_scene->addItem(m_freeDrawItem);
+    
+    // 添加第一个点
+    m_freeDrawPoints.append(scenePos);
+    m_pressures.append(1.0);
+    m_lastPoint = scenePos;
+    
+    qDebug() << "Pen tool: Started free draw at" << scenePos;
+}
+
+void DrawingToolPen::processFreeDrawSamples(const QVector<InputSample> &samples)
+{
+    if (!m_freeDrawItem || m_mode != FreeDrawMode || !m_isDrawing) return;
+    
+    // 整批采样只追加到预览的最后一块，不重新设置整条路径
+    for (const InputSample &sample : samples) {
+        m_freeDrawPoints.append(sample.position);
+        m_pressures.append(sample.pressure);
+    }
+    m_lastPoint = m_freeDrawPoints.last();
+    
+    m_freeDrawItem->appendPoints(samples);
+}
+
+void DrawingToolPen::endFreeDraw()
+{
+    if (!m_freeDrawItem) return;
+    
+    // 每个采样一个节点的折线拟合成曲线，容差按屏幕像素换算
+    const qreal scale = m_view ? qSqrt(qAbs(m_view->transform().determinant())) : 1.0;
+    const qreal tolerance = FIT_TOLERANCE_PIXELS / (scale > 0.0 ? scale : 1.0);
     m_currentPath = new DrawingPath();
-    QPainterPath path;
-    path.moveTo(scenePos);
-    m_currentPath->setPath(path);
+    m_currentPath->setPath(CurveFitter::fitPolyline(m_freeDrawPoints, false, tolerance));
     
     // 设置基本画笔样式（与画笔工具相同）
     QPen pen(m_currentStrokeColor, m_strokeWidth, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin);
@@ -551,55 +690,16 @@ void DrawingToolPen::beginFreeDraw(const QPointF &scenePos)
         qDebug() << "No active layer, added currentPath directly to scene";
     }
     
-    m_currentPath->setVisible(true);
-    m_currentPath->setFlag(QGraphicsItem::ItemIsSelectable, true);
-    
-    // 添加第一个点
-    m_freeDrawPoints.append(scenePos);
-    m_pressures.append(1.0);
-    m_lastPoint = scenePos;
-    
-    qDebug() << "Pen tool: Created initial path at" << scenePos;
-}
-
-void DrawingToolPen::updateFreeDraw(const QPointF &scenePos)
-{
-    if (!m_currentPath) return;
-    
-    // 计算与上一个点的距离（与画笔工具完全相同）
-    qreal distance = QLineF(m_lastPoint, scenePos).length();
-    
-    // 只有当移动距离足够大时才添加点（避免过多的点）
-    if (distance > 2.0) {
-        m_freeDrawPoints.append(scenePos);
-        m_lastPoint = scenePos;
-        
-        // 直接更新路径（与画笔工具完全相同）
-        QPainterPath path;
-        path.moveTo(m_freeDrawPoints.first());
-        for (int i = 1; i < m_freeDrawPoints.size(); ++i) {
-            path.lineTo(m_freeDrawPoints[i]);
-        }
-        
-        m_currentPath->setPath(path);
-        
-        qDebug() << "Pen tool: Updated path with" << m_freeDrawPoints.size() << "points";
-    }
-}
-
-void DrawingToolPen::endFreeDraw()
-{
-    if (!m_currentPath) return;
-    
-    // 简化处理，直接使用当前路径
-    // 设置控制点
-    m_currentPath->setControlPoints(m_freeDrawPoints);
-    
     // 不自动选中，避免显示选择框
     m_currentPath->setSelected(false);
     m_currentPath->setVisible(true);
     m_currentPath->setFlag(QGraphicsItem::ItemIsSelectable, true);
     
+    // 移除预览
+    m_scene->removeItem(m_freeDrawItem);
+    delete m_freeDrawItem;
+    m_freeDrawItem = nullptr;
+    
     // 标记场景已修改
     m_scene->setModified(true);
     
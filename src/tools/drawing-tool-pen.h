@@ -13,6 +13,9 @@ class DrawingShape;
 class DrawingPath;
 class QGraphicsPathItem;
 class QGraphicsEllipseItem;
+class InputPipeline;
+struct InputSample;
+class FreeDrawStrokeItem;
 
 /**
  * 钢笔工具
@@ -75,7 +78,7 @@ private:
     
     // 自由绘制相关
     void beginFreeDraw(const QPointF &scenePos);
-    void updateFreeDraw(const QPointF &scenePos);
+    void processFreeDrawSamples(const QVector<InputSample> &samples);
     void endFreeDraw();
     
     // 笔锋效果
@@ -128,6 +131,7 @@ private:
     
     // 画笔引擎
     BrushEngine *m_brushEngine;
+    InputPipeline *m_input;
     DrawingPath *m_currentPath;
     
     // 路径数据
@@ -140,6 +144,7 @@ private:
     
     // 自由绘制数据
     QVector<QPointF> m_freeDrawPoints;    // 自由绘制的点
+    FreeDrawStrokeItem *m_freeDrawItem;   // 自由绘制过程中的预览，结束时才生成路径图形
     QVector<qreal> m_pressures;           // 压力值
     QPointF m_lastPoint;                  // 上一个点，用于计算距离
     QElapsedTimer m_timer;                // 计时器，用于计算速度
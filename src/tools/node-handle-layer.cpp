@@ -0,0 +1,195 @@
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+#include <QGraphicsScene>
+#include <QGraphicsView>
+#include <QtMath>
+#include "../tools/node-handle-layer.h"
+#include "../core/drawing-shape.h"
+
+// 手柄半径和包含高亮描边的边距（像素）
+static const qreal HANDLE_RADIUS = 4.0;
+static const qreal HANDLE_MARGIN = 6.0;
+// 可见手柄超过这个数时只画点，不再逐个画圆
+static const int MAX_DETAILED_HANDLES = 4000;
+
+// 变换的最小缩放比例
+static qreal minimumScale(const QTransform &transform)
+{
+    const qreal trace = transform.m11() * transform.m11() + transform.m12() * transform.m12()
+                        + transform.m21() * transform.m21() + transform.m22() * transform.m22();
+    const qreal determinant = transform.m11() * transform.m22() - transform.m12() * transform.m21();
+    return qSqrt(qMax<qreal>(0, (trace - qSqrt(qMax<qreal>(0, trace * trace - 4 * determinant * determinant))) / 2));
+}
+
+NodeHandleLayer::NodeHandleLayer(DrawingPath *path)
+    : QGraphicsObject(path)
+    , m_path(path)
+    , m_margin(HANDLE_MARGIN)
+    , m_paintedHandleCount(0)
+{
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption, true);
+    setAcceptedMouseButtons(Qt::NoButton);
+    setAcceptHoverEvents(false);
+    if (m_path) {
+        m_path->setNodeHandleLayer(this);
+        setVisible(m_path->showControlPolygon());
+    }
+    refresh();
+}
+
+NodeHandleLayer::~NodeHandleLayer()
+{
+    if (m_path && m_path->nodeHandleLayer() == this) {
+        m_path->setNodeHandleLayer(nullptr);
+    }
+}
+
+qreal NodeHandleLayer::viewMargin() const
+{
+    // 按缩得最小的视图估计，视图缩放改变后下次refresh时更新
+    qreal scale = 0;
+    if (scene()) {
+        for (QGraphicsView *view : scene()->views()) {
+            const qreal viewScale = minimumScale(sceneTransform() * view->transform());
+            if (viewScale > 0 && (scale == 0 || viewScale < scale)) {
+                scale = viewScale;
+            }
+        }
+    }
+    return scale > 0 ? HANDLE_MARGIN / scale : HANDLE_MARGIN;
+}
+
+void NodeHandleLayer::refresh()
+{
+    prepareGeometryChange();
+    m_margin = viewMargin();
+    if (m_path && !m_path->nodeGrid().isEmpty()) {
+        m_bounds = m_path->transform().mapRect(m_path->nodeGrid().bounds())
+                       .adjusted(-m_margin, -m_margin, m_margin, m_margin);
+    } else {
+        m_bounds = QRectF();
+    }
+    update();
+}
+
+void NodeHandleLayer::updateNode(int index)
+{
+    if (!m_path || index < 0 || index >= m_path->getNodePointCount()) {
+        return;
+    }
+    const QPointF center = m_path->transform().map(m_path->controlPoints().at(index));
+    update(QRectF(center - QPointF(m_margin, m_margin), center + QPointF(m_margin, m_margin)));
+}
+
+QRectF NodeHandleLayer::boundingRect() const
+{
+    return m_bounds;
+}
+
+QPainterPath NodeHandleLayer::shape() const
+{
+    // 不参与命中测试，点击落到下面的路径上
+    return QPainterPath();
+}
+
+void NodeHandleLayer::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+    Q_UNUSED(widget);
+    m_paintedHandleCount = 0;
+    if (!m_path) {
+        return;
+    }
+
+    // 直接引用路径的控制点和命令，不复制
+    const QVector<QPointF> &points = m_path->controlPoints();
+    const QByteArray &types = m_path->controlPointCommands();
+    const QTransform toItem = m_path->transform();
+    bool invertible = false;
+    const QTransform fromItem = toItem.inverted(&invertible);
+    if (points.isEmpty() || !invertible) {
+        return;
+    }
+    const QTransform toDevice = toItem * painter->worldTransform();
+
+    // 暴露区域外扩一个手柄半径，换算到路径本地坐标后在节点网格中查询
+    const qreal deviceScale = minimumScale(painter->worldTransform());
+    const qreal margin = deviceScale > 0 ? HANDLE_MARGIN / deviceScale : m_margin;
+    const QRectF exposed = option->exposedRect.adjusted(-margin, -margin, margin, margin);
+    m_visible.clear();
+    m_path->nodeGrid().query(fromItem.mapRect(exposed), m_visible);
+
+    painter->save();
+    painter->resetTransform();
+
+    // 控制点连线：子路径起点之前、三次曲线两个控制点之间不连线
+    auto connected = [&types](int index) {
+        return index > 0 && index < types.size() && types[index] != QPainterPath::MoveToElement
+               && !(types[index] == QPainterPath::CurveToDataElement && types[index - 1] == QPainterPath::CurveToElement);
+    };
+    if (m_marked.size() < points.size()) {
+        m_marked.fill(0, points.size());
+    }
+    for (int i : m_visible) {
+        m_marked[i] = 1;
+    }
+    m_lines.clear();
+    for (int i : m_visible) {
+        if (i + 1 < points.size() && connected(i + 1)) {
+            m_lines.append(toDevice.map(QLineF(points[i], points[i + 1])));
+        }
+        // 两端都可见的连线只由前一个节点画一次
+        if (connected(i) && !m_marked[i - 1]) {
+            m_lines.append(toDevice.map(QLineF(points[i - 1], points[i])));
+        }
+    }
+    for (int i : m_visible) {
+        m_marked[i] = 0;
+    }
+
+    QPen linePen(Qt::DashLine);
+    linePen.setColor(QColor(100, 100, 255, 128));
+    linePen.setWidth(1);
+    linePen.setCosmetic(true);
+    painter->setPen(linePen);
+    painter->setBrush(Qt::NoBrush);
+    painter->drawLines(m_lines);
+
+    // 控制点：圆形，固定像素大小
+    QPen pointPen(Qt::SolidLine);
+    pointPen.setColor(QColor(100, 100, 255, 200));
+    pointPen.setWidth(1);
+    pointPen.setCosmetic(true);
+    if (m_visible.size() > MAX_DETAILED_HANDLES) {
+        m_devicePoints.clear();
+        m_devicePoints.reserve(m_visible.size());
+        for (int i : m_visible) {
+            m_devicePoints.append(toDevice.map(points[i]));
+        }
+        pointPen.setWidthF(HANDLE_RADIUS);
+        pointPen.setCapStyle(Qt::RoundCap);
+        painter->setPen(pointPen);
+        painter->drawPoints(m_devicePoints);
+    } else {
+        painter->setPen(pointPen);
+        painter->setBrush(QColor(200, 200, 255, 180));
+        for (int i : m_visible) {
+            painter->drawEllipse(toDevice.map(points[i]), HANDLE_RADIUS, HANDLE_RADIUS);
+        }
+    }
+    m_paintedHandleCount = m_visible.size();
+
+    // 高亮和正在拖动的节点画在最上面
+    QPen highlightPen(Qt::SolidLine);
+    highlightPen.setColor(QColor(255, 100, 100, 255));
+    highlightPen.setWidth(2);
+    highlightPen.setCosmetic(true);
+    painter->setPen(highlightPen);
+    painter->setBrush(QColor(255, 200, 200, 200));
+    for (int index : {m_path->highlightedNode(), m_path->activeControlPoint()}) {
+        if (index >= 0 && index < points.size()) {
+            painter->drawEllipse(toDevice.map(points[index]), HANDLE_RADIUS, HANDLE_RADIUS);
+        }
+    }
+
+    painter->restore();
+}
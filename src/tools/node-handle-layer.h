@@ -0,0 +1,52 @@
+#ifndef NODE_HANDLE_LAYER_H
+#define NODE_HANDLE_LAYER_H
+
+#include <QGraphicsObject>
+#include <QVector>
+#include <QLineF>
+#include <QPolygonF>
+
+class DrawingPath;
+
+/**
+ * @brief 路径节点手柄层 - 用一个图形项绘制路径的全部控制点
+ * @details 作为路径的子项，与路径同步变换，随路径一起删除；绘制时通过路径的节点网格只取暴露区域内的节点，
+ * 节点很多时退化为点阵。手柄层不接收鼠标事件，拾取由路径的节点网格完成
+ */
+class NodeHandleLayer : public QGraphicsObject
+{
+public:
+    explicit NodeHandleLayer(DrawingPath *path);
+    ~NodeHandleLayer() override;
+
+    DrawingPath *path() const { return m_path; }
+
+    // 节点增删或移动后更新包围盒并重绘
+    void refresh();
+    // 只重绘一个节点的手柄，用于高亮变化
+    void updateNode(int index);
+
+    // 最近一次绘制的手柄数
+    int paintedHandleCount() const { return m_paintedHandleCount; }
+
+    QRectF boundingRect() const override;
+    QPainterPath shape() const override;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget = nullptr) override;
+
+private:
+    // 手柄半径（像素）对应的本地坐标边距
+    qreal viewMargin() const;
+
+    DrawingPath *m_path;
+    QRectF m_bounds;
+    qreal m_margin;
+    int m_paintedHandleCount;
+
+    // 绘制用的临时数组，跨帧复用
+    QVector<int> m_visible;
+    QVector<char> m_marked;
+    QVector<QLineF> m_lines;
+    QPolygonF m_devicePoints;
+};
+
+#endif // NODE_HANDLE_LAYER_H
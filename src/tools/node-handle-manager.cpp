@@ -2,6 +2,7 @@
 #include "../tools/node-handle-manager.h"
 #include "../ui/drawingscene.h"
 #include "../core/drawing-shape.h"
+#include "../tools/node-handle-layer.h"
 
 // 静态常量定义
 const qreal NodeHandleManager::DEFAULT_HANDLE_SIZE = 8.0;
@@ -73,6 +74,11 @@ void NodeHandleManager::clearHandles()
     }
     
     m_handleInfos.clear();
+    
+    // 路径的节点手柄层
+    delete m_pathLayer;
+    m_pathLayer = nullptr;
+    
     m_activeHandle = nullptr;
     m_currentShape = nullptr;
 }
@@ -361,9 +367,9 @@ void NodeHandleManager::createHandlesForPath(DrawingPath *path)
 {
     if (!path) return;
     
-    // 路径对象自己处理节点显示，这里不创建手柄
-    // 保持与原实现一致
-    return;
+    // 路径节点可能有数万个，不为每个节点创建手柄项：
+    // 由一个手柄层只绘制可见区域内的节点，拖动仍由路径自己处理
+    m_pathLayer = path->nodeHandleLayer() ? path->nodeHandleLayer() : new NodeHandleLayer(path);
 }
 
 void NodeHandleManager::createCustomNodeHandles(DrawingShape *shape)
@@ -429,6 +435,10 @@ void NodeHandleManager::setupHandleStyle(CustomHandleItem *handle, NodeHandleTyp
 
 void NodeHandleManager::updateExistingHandlePositions(DrawingShape *shape)
 {
+    if (m_pathLayer) {
+        m_pathLayer->refresh();
+    }
+    
     if (!shape || m_handleInfos.isEmpty()) return;
     
     // 获取图形的当前节点点
@@ -5,12 +5,14 @@
 #include <QList>
 #include <QPointF>
 #include <QRectF>
+#include <QPointer>
 #include "../tools/handle-item.h"
 #include "../tools/handle-types.h"
 #include "../core/drawing-shape.h"
 
 class DrawingScene;
 class DrawingShape;
+class NodeHandleLayer;
 
 /**
  * @brief 节点手柄管理器 - 专门用于节点编辑工具的手柄管理
@@ -101,6 +103,8 @@ private:
     QList<NodeHandleInfo> m_handleInfos;
     CustomHandleItem *m_activeHandle;
     bool m_handlesVisible;
+    // 路径的节点手柄层，路径删除时随之删除
+    QPointer<NodeHandleLayer> m_pathLayer;
     
     // 手柄样式配置
     static const qreal DEFAULT_HANDLE_SIZE;
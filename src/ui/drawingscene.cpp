@@ -12,6 +12,7 @@
 #include <limits>
 #include "../ui/drawingscene.h"
 #include "../core/drawing-shape.h"
+#include "../core/drawing-document.h"
 #include "../core/drawing-group.h"
 #include "../core/drawing-layer.h"
 #include "../core/layer-manager.h"
@@ -549,6 +550,7 @@ DrawingScene::DrawingScene(QObject *parent)
     , m_guideSnapEnabled(true)
     , m_scaleHintVisible(false)
     , m_rotateHintVisible(false)
+    , m_document(new DrawingDocument(this))
 {
     // 不在这里创建选择层，只在选择工具激活时创建
     // 暂时不连接选择变化信号，避免在初始化时触发
@@ -1136,27 +1138,24 @@ DrawingScene::ObjectSnapResult DrawingScene::snapToObjects(const QPointF &pos, D
     const int tolerance = m_objectSnapTolerance;
     qreal minDistance = tolerance + 1;
     
-    QList<ObjectSnapPoint> snapPoints = getObjectSnapPoints(excludeShape);
-    
-    for (const ObjectSnapPoint &snapPoint : snapPoints) {
-        qreal distance = QLineF(pos, snapPoint.position).length();
-        if (distance < minDistance) {
-            minDistance = distance;
-            result.snappedPos = snapPoint.position;
-            result.snappedToObject = true;
-            result.snapType = snapPoint.type;
-            result.targetShape = snapPoint.shape;
-            
-            // 设置描述
-            switch (snapPoint.type) {
-                case SnapToLeft: result.snapDescription = tr("吸附到左边"); break;
-                case SnapToRight: result.snapDescription = tr("吸附到右边"); break;
-                case SnapToTop: result.snapDescription = tr("吸附到上边"); break;
-                case SnapToBottom: result.snapDescription = tr("吸附到下边"); break;
-                case SnapToCenterX: result.snapDescription = tr("吸附到水平中心"); break;
-                case SnapToCenterY: result.snapDescription = tr("吸附到垂直中心"); break;
-                case SnapToCorner: result.snapDescription = tr("吸附到角点"); break;
-            }
+    // 只检查容差范围内的格子，拖动时每次移动不再遍历所有图形
+    updateSnapIndex();
+    SnapIndex::Point snapPoint;
+    if (m_snapIndex.nearest(pos, minDistance, excludeShape, snapPoint)) {
+        result.snappedPos = snapPoint.pos;
+        result.snappedToObject = true;
+        result.snapType = ObjectSnapType(snapPoint.type);
+        result.targetShape = snapPoint.shape;
+        
+        // 设置描述
+        switch (result.snapType) {
+            case SnapToLeft: result.snapDescription = tr("吸附到左边"); break;
+            case SnapToRight: result.snapDescription = tr("吸附到右边"); break;
+            case SnapToTop: result.snapDescription = tr("吸附到上边"); break;
+            case SnapToBottom: result.snapDescription = tr("吸附到下边"); break;
+            case SnapToCenterX: result.snapDescription = tr("吸附到水平中心"); break;
+            case SnapToCenterY: result.snapDescription = tr("吸附到垂直中心"); break;
+            case SnapToCorner: result.snapDescription = tr("吸附到角点"); break;
         }
     }
     
@@ -1184,37 +1183,81 @@ DrawingScene::ObjectSnapResult DrawingScene::snapToObjects(const QPointF &pos, D
     return result;
 }
 
-QList<DrawingScene::ObjectSnapPoint> DrawingScene::getObjectSnapPoints(DrawingShape *excludeShape) const
+QList<DrawingScene::ObjectSnapPoint> DrawingScene::getObjectSnapPoints(DrawingShape *excludeShape)
 {
+    updateSnapIndex();
+    
     QList<ObjectSnapPoint> points;
-    QList<QGraphicsItem*> allItems = items();
+    for (const SnapIndex::Point &point : m_snapIndex.points()) {
+        if (point.shape != excludeShape) {
+            points.append(ObjectSnapPoint(point.pos, ObjectSnapType(point.type), point.shape));
+        }
+    }
     
-    for (QGraphicsItem *item : allItems) {
-        DrawingShape *shape = qgraphicsitem_cast<DrawingShape*>(item);
-        if (!shape || shape == excludeShape || !shape->isVisible()) {
+    return points;
+}
+
+void DrawingScene::invalidateSnapPoints(DrawingShape *shape)
+{
+    if (!shape) {
+        return;
+    }
+    
+    // 子图形的场景坐标随父图形变化
+    m_dirtySnapShapes.insert(shape);
+    for (QGraphicsItem *child : shape->childItems()) {
+        DrawingShape *childShape = dynamic_cast<DrawingShape*>(child);
+        if (childShape) {
+            invalidateSnapPoints(childShape);
+        }
+    }
+}
+
+void DrawingScene::removeSnapPoints(DrawingShape *shape)
+{
+    m_dirtySnapShapes.remove(shape);
+    m_snapIndex.remove(shape);
+}
+
+void DrawingScene::updateSnapIndex()
+{
+    if (m_dirtySnapShapes.isEmpty()) {
+        return;
+    }
+    
+    QVector<SnapIndex::Point> points;
+    for (DrawingShape *shape : qAsConst(m_dirtySnapShapes)) {
+        if (shape->scene() != this || !shape->isVisible()) {
+            m_snapIndex.remove(shape);
             continue;
         }
         
-        QRectF bounds = shape->boundingRect();
-        QPointF center = bounds.center();
-        
         // 转换为场景坐标
-        QRectF sceneBounds = shape->mapRectToScene(bounds);
+        QRectF sceneBounds = shape->mapRectToScene(shape->boundingRect());
         QPointF sceneCenter = sceneBounds.center();
         
+        auto addPoint = [&points, shape](const QPointF &pos, ObjectSnapType type) {
+            SnapIndex::Point point;
+            point.pos = pos;
+            point.type = type;
+            point.shape = shape;
+            points.append(point);
+        };
+        
         // 添加关键吸附点（使用场景坐标）
-        points.append(ObjectSnapPoint(sceneBounds.topLeft(), SnapToCorner, shape));
-        points.append(ObjectSnapPoint(sceneBounds.topRight(), SnapToCorner, shape));
-        points.append(ObjectSnapPoint(sceneBounds.bottomLeft(), SnapToCorner, shape));
-        points.append(ObjectSnapPoint(sceneBounds.bottomRight(), SnapToCorner, shape));
-        points.append(ObjectSnapPoint(sceneCenter, SnapToCenterX, shape));
-        points.append(ObjectSnapPoint(QPointF(sceneBounds.left(), sceneCenter.y()), SnapToLeft, shape));
-        points.append(ObjectSnapPoint(QPointF(sceneBounds.right(), sceneCenter.y()), SnapToRight, shape));
-        points.append(ObjectSnapPoint(QPointF(sceneCenter.x(), sceneBounds.top()), SnapToTop, shape));
-        points.append(ObjectSnapPoint(QPointF(sceneCenter.x(), sceneBounds.bottom()), SnapToBottom, shape));
-    }
-    
-    return points;
+        points.clear();
+        addPoint(sceneBounds.topLeft(), SnapToCorner);
+        addPoint(sceneBounds.topRight(), SnapToCorner);
+        addPoint(sceneBounds.bottomLeft(), SnapToCorner);
+        addPoint(sceneBounds.bottomRight(), SnapToCorner);
+        addPoint(sceneCenter, SnapToCenterX);
+        addPoint(QPointF(sceneBounds.left(), sceneCenter.y()), SnapToLeft);
+        addPoint(QPointF(sceneBounds.right(), sceneCenter.y()), SnapToRight);
+        addPoint(QPointF(sceneCenter.x(), sceneBounds.top()), SnapToTop);
+        addPoint(QPointF(sceneCenter.x(), sceneBounds.bottom()), SnapToBottom);
+        m_snapIndex.setPoints(shape, points);
+    }
+    m_dirtySnapShapes.clear();
 }
 
 void DrawingScene::setObjectSnapEnabled(bool enabled)
@@ -3,10 +3,13 @@
 
 #include <QGraphicsScene>
 #include <QUndoStack>
+#include <QSet>
 #include "../core/drawing-group.h"
+#include "../core/snap-index.h"
 
 class DrawingShape;
 class DrawingGroup;
+class DrawingDocument;
 class QGraphicsSceneMouseEvent;
 // class SelectionLayer; // 已移除 - 老的选择层系统
 class TransformCommand;
@@ -28,6 +31,8 @@ public:
     explicit DrawingScene(QObject *parent = nullptr);
     
     QUndoStack* undoStack() { return &m_undoStack; }
+    // 场景中全部图形的紧凑数组，用于批量查询
+    DrawingDocument* document() const { return m_document; }
     
     bool isModified() const { return m_isModified; }
     void setModified(bool modified);
@@ -176,7 +181,11 @@ public:
     
     // 对象吸附功能
     ObjectSnapResult snapToObjects(const QPointF &pos, DrawingShape *excludeShape = nullptr);
-    QList<ObjectSnapPoint> getObjectSnapPoints(DrawingShape *excludeShape = nullptr) const;
+    QList<ObjectSnapPoint> getObjectSnapPoints(DrawingShape *excludeShape = nullptr);
+    
+    // 吸附点索引维护：图形几何、可见性或所在场景变化时调用，下次查询时重新计算
+    void invalidateSnapPoints(DrawingShape *shape);
+    void removeSnapPoints(DrawingShape *shape);
     
     // 对象吸附开关
     void setObjectSnapEnabled(bool enabled);
@@ -203,6 +212,7 @@ public:
 
 private:
     void drawSnapIndicators(QPainter *painter);
+    void updateSnapIndex();
 
 signals:
     void sceneModified(bool modified);
@@ -248,6 +258,8 @@ private:
     bool m_snapIndicatorsVisible;
     ObjectSnapResult m_lastSnapResult; // 最后一次吸附结果，用于绘制指示器
     bool m_hasActiveSnap; // 是否有活跃的吸附（真正发生了位置变化）
+    SnapIndex m_snapIndex; // 对象吸附点索引
+    QSet<DrawingShape*> m_dirtySnapShapes; // 吸附点待更新的图形
     
     // 参考线吸附
     bool m_guideSnapEnabled;
@@ -258,6 +270,7 @@ private:
     RotateHintResult m_lastRotateHint;
     bool m_scaleHintVisible;
     bool m_rotateHintVisible;
+    DrawingDocument *m_document; // 文档图形表
     QList<Guide> m_guides;
     
     // 变换撤销支持
@@ -5,11 +5,13 @@
 #include <QPainter>
 #include "../ui/drawingview.h"
 #include "../core/toolbase.h"
+#include "../ui/tile-renderer.h"
 
 DrawingView::DrawingView(QGraphicsScene *scene, QWidget *parent)
     : QGraphicsView(scene, parent)
     , m_zoomLevel(1.0)
     , m_currentTool(nullptr)
+    , m_tileRenderer(nullptr)
 {
     setRenderHint(QPainter::Antialiasing);
     setDragMode(RubberBandDrag);
@@ -45,6 +47,21 @@ void DrawingView::setCurrentTool(ToolBase *tool)
     m_currentTool = tool;
 }
 
+void DrawingView::setTiledRendering(bool enabled)
+{
+    if (enabled == isTiledRendering()) {
+        return;
+    }
+    
+    if (enabled) {
+        m_tileRenderer = new TileRenderer(this, this);
+    } else {
+        delete m_tileRenderer;
+        m_tileRenderer = nullptr;
+    }
+    viewport()->update();
+}
+
 void DrawingView::zoomIn()
 {
     setZoomLevel(m_zoomLevel * 1.2);
@@ -129,6 +146,16 @@ void DrawingView::scrollContentsBy(int dx, int dy)
     emit viewportChanged();
 }
 
+void DrawingView::drawBackground(QPainter *painter, const QRectF &rect)
+{
+    QGraphicsView::drawBackground(painter, rect);
+    
+    // 图块合成在背景之上，选择指示器和工具覆盖层随后同步绘制
+    if (m_tileRenderer) {
+        m_tileRenderer->paint(painter, rect);
+    }
+}
+
 void DrawingView::updateZoomLabel()
 {
     emit zoomChanged(m_zoomLevel);
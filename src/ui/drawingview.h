@@ -4,6 +4,7 @@
 #include <QGraphicsView>
 
 class ToolBase;
+class TileRenderer;
 
 class DrawingView : public QGraphicsView
 {
@@ -24,6 +25,10 @@ public:
     
     // 设置光标样式
     void setCursorForTool(ToolBase *tool);
+    
+    // 分块渲染：图形由后台线程按图块渲染，视图逐步合成
+    void setTiledRendering(bool enabled);
+    bool isTiledRendering() const { return m_tileRenderer != nullptr; }
 
 signals:
     void zoomChanged(double zoom);
@@ -37,12 +42,14 @@ protected:
     void mouseReleaseEvent(QMouseEvent *event) override;
     void keyPressEvent(QKeyEvent *event) override;
     void scrollContentsBy(int dx, int dy) override;
+    void drawBackground(QPainter *painter, const QRectF &rect) override;
 
 private:
     void updateZoomLabel();
     
     double m_zoomLevel;
     ToolBase *m_currentTool;
+    TileRenderer *m_tileRenderer;
 };
 
 #endif // DRAWINGVIEW_H
\ No newline at end of file
@@ -12,11 +12,13 @@
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QFileDialog>
+#include <QProgressDialog>
 #include <QMessageBox>
 #include <QInputDialog>
 #include <QColorDialog>
 #include <QScrollBar>
 #include <QIcon>
+#include <QHash>
 #include <algorithm>
 #include "../ui/mainwindow.h"
 #include "../ui/drawingscene.h"
@@ -49,12 +51,15 @@
 #include "../ui/ruler.h"
 #include "../ui/scrollable-toolbar.h"
 #include "../core/svghandler.h"
+#include "../core/svg-import-job.h"
+#include "../core/vfp-document.h"
+#include "../core/shape-render-cache.h"
 #include "../core/drawing-shape.h"
 #include "../ui/colorpalette.h"
 #include "../core/drawing-group.h"
 
 MainWindow::MainWindow(QWidget *parent)
-    : QMainWindow(parent), m_scene(nullptr), m_canvas(nullptr), m_propertyPanel(nullptr), m_tabbedPropertyPanel(nullptr), m_undoView(nullptr), m_layerManager(nullptr), m_currentTool(nullptr), m_outlinePreviewTool(nullptr), m_rectangleTool(nullptr), m_ellipseTool(nullptr), m_bezierTool(nullptr),
+    : QMainWindow(parent), m_scene(nullptr), m_canvas(nullptr), m_propertyPanel(nullptr), m_tabbedPropertyPanel(nullptr), m_undoView(nullptr), m_layerManager(nullptr), m_vfpDocument(nullptr), m_currentTool(nullptr), m_outlinePreviewTool(nullptr), m_rectangleTool(nullptr), m_ellipseTool(nullptr), m_bezierTool(nullptr),
       m_colorPalette(nullptr), m_scrollableToolBar(nullptr),
       m_horizontalRuler(nullptr), m_verticalRuler(nullptr), m_cornerWidget(nullptr), m_isModified(false), m_lastOpenDir(QDir::homePath()), m_lastSaveDir(QDir::homePath()),
       m_uiUpdateTimer(nullptr), m_lastSelectedCount(0)
@@ -180,6 +185,9 @@ void MainWindow::setupUI()
     m_scene->setObjectSnapEnabled(true); // 启用对象吸附
     m_scene->setSnapTolerance(3); // 设置吸附容差（降低灵敏度）
     m_scene->setObjectSnapTolerance(3); // 设置对象吸附容差（降低灵敏度）
+
+    // VFP文档：图形在进入视口时才解码
+    m_vfpDocument = new VfpDocument(m_scene, this);
     
     // Create rulers
     m_horizontalRuler = new Ruler(Ruler::Horizontal, this);
@@ -400,7 +408,8 @@ void MainWindow::setupUI()
                         // 触发重绘
                         m_horizontalRuler->update();
                         m_verticalRuler->update();
-                    } });
+                    }
+                    materializeVisibleShapes(); });
 
         // 初始化标尺
         if (m_horizontalRuler && m_verticalRuler)
@@ -447,6 +456,7 @@ void MainWindow::setupMenus()
     editMenu->addSeparator();
     editMenu->addAction(m_selectAllAction);
     editMenu->addAction(m_deselectAllAction);
+    editMenu->addAction(m_selectSameStyleAction);
     editMenu->addSeparator();
     editMenu->addAction(m_groupAction);
     editMenu->addAction(m_ungroupAction);
@@ -476,6 +486,9 @@ void MainWindow::setupMenus()
     viewMenu->addSeparator();
     viewMenu->addAction(m_toggleGridAction);
     viewMenu->addAction(m_toggleGridAlignmentAction);
+    viewMenu->addAction(m_toggleRenderCacheAction);
+    viewMenu->addAction(m_toggleTiledRenderingAction);
+    viewMenu->addAction(m_lodToleranceAction);
     viewMenu->addSeparator();
     viewMenu->addAction(m_clearAllGuidesAction);
     viewMenu->addAction(m_gridSizeAction);
@@ -815,6 +828,9 @@ void MainWindow::createActions()
     m_deselectAllAction->setShortcut(QKeySequence("Ctrl+Shift+A"));
     m_deselectAllAction->setStatusTip("取消选择所有项目");
 
+    m_selectSameStyleAction = new QAction("选择相同样式(&S)", this);
+    m_selectSameStyleAction->setStatusTip("选择与选中图形填充和描边都相同的图形");
+
     // View actions
     m_zoomInAction = new QAction("放大(&I)", this);
     m_zoomInAction->setShortcut(QKeySequence::ZoomIn);
@@ -851,6 +867,19 @@ void MainWindow::createActions()
     m_toggleGridAlignmentAction->setStatusTip("启用或禁用网格对齐");
     m_toggleGridAlignmentAction->setChecked(true); // 默认启用网格对齐
     
+    m_toggleRenderCacheAction = new QAction("栅格缓存(&R)", this);
+    m_toggleRenderCacheAction->setCheckable(true);
+    m_toggleRenderCacheAction->setStatusTip("缓存图形的渲染结果，加快大文档的平移和缩放");
+    m_toggleRenderCacheAction->setChecked(false);
+    
+    m_toggleTiledRenderingAction = new QAction("分块渲染(&T)", this);
+    m_toggleTiledRenderingAction->setCheckable(true);
+    m_toggleTiledRenderingAction->setStatusTip("在后台线程按图块渲染图形，复杂文档重绘时不阻塞操作");
+    m_toggleTiledRenderingAction->setChecked(false);
+    
+    m_lodToleranceAction = new QAction("细节层次容差...", this);
+    m_lodToleranceAction->setStatusTip("设置缩小显示时简化路径允许的误差");
+    
     // 清除所有参考线
     m_clearAllGuidesAction = new QAction("清除所有参考线(&G)", this);
     m_clearAllGuidesAction->setShortcut(QKeySequence("Ctrl+Shift+G"));
@@ -1059,6 +1088,7 @@ void MainWindow::connectActions()
     connect(m_convertTextToPathAction, &QAction::triggered, this, &MainWindow::convertTextToPath);
     connect(m_selectAllAction, &QAction::triggered, this, &MainWindow::selectAll);
     connect(m_deselectAllAction, &QAction::triggered, this, &MainWindow::deselectAll);
+    connect(m_selectSameStyleAction, &QAction::triggered, this, &MainWindow::selectSameStyle);
 
     // View connections
     connect(m_zoomInAction, &QAction::triggered, this, &MainWindow::zoomIn);
@@ -1071,6 +1101,9 @@ void MainWindow::connectActions()
     connect(m_gridSizeAction, &QAction::triggered, this, &MainWindow::showGridSettings);
     connect(m_gridColorAction, &QAction::triggered, this, &MainWindow::showGridSettings);
     connect(m_toggleGridAlignmentAction, &QAction::triggered, this, &MainWindow::toggleGridAlignment);
+    connect(m_toggleRenderCacheAction, &QAction::triggered, this, &MainWindow::toggleRenderCache);
+    connect(m_toggleTiledRenderingAction, &QAction::triggered, this, &MainWindow::toggleTiledRendering);
+    connect(m_lodToleranceAction, &QAction::triggered, this, &MainWindow::showLodSettings);
     connect(m_clearAllGuidesAction, &QAction::triggered, this, &MainWindow::clearAllGuides);
     
     // Group connections
@@ -1281,6 +1314,7 @@ void MainWindow::newFile()
         }
     }
 
+    m_vfpDocument->close();
     m_scene->clearScene();
     m_currentFile.clear();
     m_isModified = false;
@@ -1315,28 +1349,78 @@ void MainWindow::openFile()
         
         if (fileInfo.suffix().toLower() == "svg")
         {
-            // SVG导入
-            if (SvgHandler::importFromSvg(m_scene, fileName)) {
+            m_vfpDocument->close();
+
+            // SVG导入：后台线程解析，GUI线程分批创建图形，期间可以取消
+            SvgImportJob *job = new SvgImportJob(m_scene, this);
+            QProgressDialog *progressDialog = new QProgressDialog("正在导入SVG文件...", "取消", 0, 0, this);
+            progressDialog->setWindowModality(Qt::WindowModal);
+            progressDialog->setMinimumDuration(300);
+            progressDialog->setAutoClose(false);
+            progressDialog->setAutoReset(false);
+            
+            connect(job, &SvgImportJob::progress, progressDialog, [progressDialog](int done, int total) {
+                progressDialog->setMaximum(total);
+                progressDialog->setValue(done);
+            });
+            connect(progressDialog, &QProgressDialog::canceled, job, &SvgImportJob::cancel);
+            connect(job, &SvgImportJob::finished, this, [this, job, progressDialog, fileName](bool success) {
+                progressDialog->deleteLater();
+                job->deleteLater();
+                QFileInfo fileInfo(fileName);
+                
+                if (success) {
+                    m_currentFile = fileName;
+                    m_isModified = false;
+                    updateUI(); // 更新窗口标题
+                    m_statusLabel->setText(QString("SVG文件已导入: %1").arg(fileInfo.fileName()));
+                    
+                    // 加载完成后重置视图到100%而不是自动适应
+                    if (m_canvas) {
+                        m_canvas->resetZoom();
+                        // 可选：将视图居中到内容
+                        m_canvas->centerOnContent();
+                    }
+                } else if (job->isCancelled()) {
+                    m_statusLabel->setText(QString("SVG导入已取消，已导入%1个图形").arg(job->shapeCount()));
+                } else {
+                    QMessageBox::warning(this, "导入错误", "无法导入SVG文件");
+                }
+            });
+            
+            if (!job->start(fileName)) {
+                progressDialog->deleteLater();
+                job->deleteLater();
+                QMessageBox::warning(this, "导入错误", "无法导入SVG文件");
+            }
+        }
+        else
+        {
+            // VFP文件只映射并读取目录，图形在进入视口时解码
+            m_scene->clearScene();
+            if (m_layerManager) {
+                m_layerManager->setScene(m_scene);
+            }
+
+            if (m_vfpDocument->open(fileName)) {
                 m_currentFile = fileName;
                 m_isModified = false;
                 updateUI(); // 更新窗口标题
-                m_statusLabel->setText(QString("SVG文件已导入: %1").arg(fileInfo.fileName()));
-                
-                // 加载完成后重置视图到100%而不是自动适应
+                m_statusLabel->setText(QString("文档已打开: %1（%2个图形）")
+                                       .arg(fileInfo.fileName()).arg(m_vfpDocument->shapeCount()));
+
                 if (m_canvas) {
                     m_canvas->resetZoom();
-                    // 可选：将视图居中到内容
-                    m_canvas->centerOnContent();
+                    // 场景中还没有图形，按文件中记录的边界居中
+                    if (m_canvas->view() && !m_vfpDocument->contentBounds().isEmpty()) {
+                        m_canvas->view()->centerOn(m_vfpDocument->contentBounds().center());
+                    }
                 }
+                materializeVisibleShapes();
             } else {
-                QMessageBox::warning(this, "导入错误", "无法导入SVG文件");
+                QMessageBox::warning(this, "打开错误", "无法打开VFP文件");
             }
         }
-        else
-        {
-            // QDP文件加载
-            m_statusLabel->setText("QDP文件加载功能尚未实现");
-        }
     }
 }
 
@@ -1348,43 +1432,65 @@ void MainWindow::saveFile()
     }
     else
     {
-        // 保存为 SVG 文件
-        if (SvgHandler::exportToSvg(m_scene, m_currentFile)) {
+        if (saveDocument(m_currentFile)) {
             m_isModified = false;
             m_statusLabel->setText(QString("文档已保存: %1").arg(QFileInfo(m_currentFile).fileName()));
         } else {
-            QMessageBox::warning(this, "保存错误", "无法保存SVG文件");
+            QMessageBox::warning(this, "保存错误", "无法保存文件");
         }
     }
 }
 
 void MainWindow::saveFileAs()
 {
+    QString selectedFilter;
     QString fileName = QFileDialog::getSaveFileName(this,
-                                                    "保存文档", m_lastSaveDir, "SVG Files (*.svg)");
+                                                    "保存文档", m_lastSaveDir, "SVG Files (*.svg);;VectorQt Files (*.vfp)",
+                                                    &selectedFilter);
 
     if (!fileName.isEmpty())
     {
         QFileInfo fileInfo(fileName);
         m_lastSaveDir = fileInfo.absolutePath(); // 更新记住的保存目录
         
-        // 确保文件有 .svg 扩展名
-        if (!fileName.endsWith(".svg", Qt::CaseInsensitive)) {
-            fileName += ".svg";
+        // 确保文件有所选格式的扩展名
+        const QString suffix = selectedFilter.contains("*.vfp") ? ".vfp" : ".svg";
+        if (!fileName.endsWith(".svg", Qt::CaseInsensitive) && !fileName.endsWith(".vfp", Qt::CaseInsensitive)) {
+            fileName += suffix;
         }
         
-        m_currentFile = fileName;
-        
-        // 保存为 SVG 文件
-        if (SvgHandler::exportToSvg(m_scene, m_currentFile)) {
+        if (saveDocument(fileName)) {
+            m_currentFile = fileName;
             m_isModified = false;
+            updateUI(); // 更新窗口标题
             m_statusLabel->setText(QString("文档已保存: %1").arg(QFileInfo(m_currentFile).fileName()));
         } else {
-            QMessageBox::warning(this, "保存错误", "无法保存SVG文件");
+            QMessageBox::warning(this, "保存错误", "无法保存文件");
         }
     }
 }
 
+bool MainWindow::saveDocument(const QString &fileName)
+{
+    if (QFileInfo(fileName).suffix().toLower() == "vfp") {
+        // 未解码的图形直接沿用文件中的记录
+        return m_vfpDocument->save(fileName);
+    }
+
+    // SVG需要完整的场景
+    m_vfpDocument->materializeAll();
+    return SvgHandler::exportToSvg(m_scene, fileName);
+}
+
+void MainWindow::materializeVisibleShapes()
+{
+    if (!m_vfpDocument->isOpen() || m_vfpDocument->pendingCount() == 0 || !m_canvas || !m_canvas->view()) {
+        return;
+    }
+    QGraphicsView *view = m_canvas->view();
+    m_vfpDocument->materializeRect(view->mapToScene(view->viewport()->rect()).boundingRect());
+}
+
 void MainWindow::exportFile()
 {
     QString fileName = QFileDialog::getSaveFileName(this, tr("导出文档"), m_lastSaveDir, "SVG Files (*.svg)");
@@ -1393,6 +1499,7 @@ void MainWindow::exportFile()
     {
         QFileInfo fileInfo(fileName);
         m_lastSaveDir = fileInfo.absolutePath(); // 更新记住的保存目录
+        m_vfpDocument->materializeAll();
         if (SvgHandler::exportToSvg(m_scene, fileName)) {
             statusBar()->showMessage(tr("文档已导出"), 2000);
         } else {
@@ -2020,6 +2127,30 @@ void MainWindow::deselectAll()
     m_scene->clearSelection();
 }
 
+void MainWindow::selectSameStyle()
+{
+    // 直接取样式表中的使用者列表，不遍历场景；组合没有自己的外观，不参与
+    QVector<int> styles;
+    foreach (QGraphicsItem *item, m_scene->selectedItems())
+    {
+        DrawingShape *shape = dynamic_cast<DrawingShape*>(item);
+        if (shape && shape->shapeType() != DrawingShape::Group && !styles.contains(shape->styleId())) {
+            styles.append(shape->styleId());
+        }
+    }
+
+    StyleTable *styleTable = m_scene->document()->styleTable();
+    for (int style : styles) {
+        // 选择变化的响应可能修改样式，先取一份列表
+        const QVector<DrawingShape*> users = styleTable->users(style);
+        for (DrawingShape *shape : users) {
+            if (shape->scene() == m_scene && shape->shapeType() != DrawingShape::Group) {
+                shape->setSelected(true);
+            }
+        }
+    }
+}
+
 void MainWindow::zoomIn()
 {
     m_canvas->zoomIn();
@@ -2060,6 +2191,28 @@ void MainWindow::toggleGridAlignment()
     }
 }
 
+void MainWindow::toggleRenderCache()
+{
+    if (m_layerManager)
+    {
+        bool enabled = !m_layerManager->isRenderCacheEnabled();
+        m_layerManager->setRenderCacheEnabled(enabled);
+        m_toggleRenderCacheAction->setChecked(enabled);
+        m_statusLabel->setText(enabled ? "栅格缓存已启用" : "栅格缓存已禁用");
+    }
+}
+
+void MainWindow::toggleTiledRendering()
+{
+    if (m_canvas && m_canvas->view())
+    {
+        bool enabled = !m_canvas->view()->isTiledRendering();
+        m_canvas->view()->setTiledRendering(enabled);
+        m_toggleTiledRenderingAction->setChecked(enabled);
+        m_statusLabel->setText(enabled ? "分块渲染已启用" : "分块渲染已禁用");
+    }
+}
+
 void MainWindow::groupSelected()
 {
     if (!m_scene) return;
@@ -2138,6 +2291,27 @@ void MainWindow::showGridSettings()
     }
 }
 
+void MainWindow::showLodSettings()
+{
+    bool ok;
+    double tolerance = QInputDialog::getDouble(this, "细节层次",
+                                               "缩小显示时允许的误差 (像素，0表示关闭):",
+                                               DrawingPath::lodTolerance(),
+                                               0.0, 8.0, 2, &ok);
+    if (ok)
+    {
+        DrawingPath::setLodTolerance(tolerance);
+        // 已缓存的图块按旧容差绘制，全部丢弃后重绘
+        ShapeRenderCache::instance()->clear();
+        if (m_scene)
+        {
+            m_scene->update();
+        }
+        m_statusLabel->setText(tolerance > 0 ? QString("细节层次容差: %1 像素").arg(tolerance)
+                                             : QString("细节层次已关闭"));
+    }
+}
+
 void MainWindow::updateZoomLabel()
 {
     if (m_horizontalRuler && m_verticalRuler && m_canvas)
@@ -2637,6 +2811,8 @@ void MainWindow::showContextMenu(const QPointF &pos)
     offsetAction->setEnabled(canEditPath);
     QAction *clipAction = pathOpsMenu->addAction("裁剪路径");
     clipAction->setEnabled(canEditPath);
+    QAction *outlineAction = pathOpsMenu->addAction("描边转路径");
+    outlineAction->setEnabled(canEditPath);
     
     // 创建形状菜单
     QMenu *shapeMenu = pathMenu->addMenu("创建形状");
@@ -2687,6 +2863,8 @@ void MainWindow::showContextMenu(const QPointF &pos)
         executePathOperation("offset");
     } else if (selectedAction == clipAction) {
         executePathOperation("clip");
+    } else if (selectedAction == outlineAction) {
+        executePathOperation("outline");
     } else if (selectedAction == arrowAction) {
         createShapeAtPosition("arrow", pos);
     } else if (selectedAction == starAction) {
@@ -3220,11 +3398,8 @@ void MainWindow::performPathBooleanOperation(int op, const QString &opName)
         return;
     }
     
-    // 执行布尔运算
-    QPainterPath resultPath = paths[0];
-    for (int i = 1; i < paths.size(); ++i) {
-        resultPath = PathEditor::booleanOperation(resultPath, paths[i], static_cast<PathEditor::BooleanOperation>(op));
-    }
+    // 执行布尔运算：全部操作数一次完成
+    QPainterPath resultPath = PathEditor::booleanOperation(paths, static_cast<PathEditor::BooleanOperation>(op));
     
     if (resultPath.isEmpty()) {
         m_statusLabel->setText(QString("%1操作结果为空").arg(opName));
@@ -3268,50 +3443,38 @@ void MainWindow::executeBooleanOperation(int op)
 {
     if (!m_scene) return;
     
-    QList<QGraphicsItem *> selected = m_scene->selectedItems();
-    if (selected.size() < 2) {
-        m_statusLabel->setText("需要选择至少两个路径进行布尔运算");
-        return;
+    // 参与运算的全部选中图形，按场景的实际堆叠顺序排列：最底层的作为差集的被减数。
+    // 同一图层的图形Z值相同，只比较Z值分不出先后，这里直接按场景自下而上的顺序取
+    QRectF selectionBounds;
+    for (QGraphicsItem *item : m_scene->selectedItems()) {
+        selectionBounds |= item->sceneBoundingRect();
     }
-    
-    // 获取前两个选中的形状
-    DrawingShape *shape1 = qgraphicsitem_cast<DrawingShape*>(selected[0]);
-    DrawingShape *shape2 = qgraphicsitem_cast<DrawingShape*>(selected[1]);
-    
-    if (!shape1 || !shape2) {
-        m_statusLabel->setText("选择的对象不是有效的路径");
+    QList<DrawingShape*> shapes;
+    const QList<QGraphicsItem*> stacked = m_scene->items(selectionBounds, Qt::IntersectsItemBoundingRect, Qt::AscendingOrder);
+    for (QGraphicsItem *item : stacked) {
+        DrawingShape *shape = item->isSelected() ? dynamic_cast<DrawingShape*>(item) : nullptr;
+        if (shape) {
+            shapes.append(shape);
+        }
+    }
+    if (shapes.size() < 2) {
+        m_statusLabel->setText("需要选择至少两个路径进行布尔运算");
         return;
     }
+    DrawingShape *baseShape = shapes.first();
     
     // 执行布尔运算
     QPainterPath result;
     try {
-        // 获取形状的实际位置
-        QPointF pos1 = shape1->pos();
-        QPointF pos2 = shape2->pos();
-        
-        // 获取基础路径（不包含位置）
-        QPainterPath path1Base = shape1->transformedShape();
-        QPainterPath path2Base = shape2->transformedShape();
-        
-        // 创建包含位置信息的路径
-        QPainterPath path1WithPos;
-        QPainterPath path2WithPos;
-        
-        // 将路径平移到正确的位置
-        QTransform transform1;
-        transform1.translate(pos1.x(), pos1.y());
-        path1WithPos = transform1.map(path1Base);
-        
-        QTransform transform2;
-        transform2.translate(pos2.x(), pos2.y());
-        path2WithPos = transform2.map(path2Base);
+        // 基础路径（不包含位置）平移到图形的实际位置
+        QList<QPainterPath> paths;
+        for (DrawingShape *shape : shapes) {
+            QTransform transform;
+            transform.translate(shape->pos().x(), shape->pos().y());
+            paths.append(transform.map(shape->transformedShape()));
+        }
         
-        result = PathEditor::booleanOperation(
-            path1WithPos, 
-            path2WithPos, 
-            static_cast<PathEditor::BooleanOperation>(op)
-        );
+        result = PathEditor::booleanOperation(paths, static_cast<PathEditor::BooleanOperation>(op));
     } catch (...) {
         m_statusLabel->setText("布尔运算异常");
         return;
@@ -3326,73 +3489,51 @@ void MainWindow::executeBooleanOperation(int op)
     // 创建新的路径对象
     DrawingPath *newPath = new DrawingPath();
     
-    // 计算结果路径的边界框
+    // 结果路径转换为相对于图形原点的路径，图形放在结果的左上角
     QRectF resultBounds = result.boundingRect();
-    
-    // 布尔运算的结果已经包含了正确的位置信息
-    // 我们需要将结果路径转换为相对于图形原点的路径
-    // 计算结果路径的实际位置（使用第一个路径的位置作为参考）
-    QPointF resultPos = shape1->pos();
-    
-    // 创建一个变换，将路径移动到相对于图形原点的位置
     QTransform offsetTransform;
     offsetTransform.translate(-resultBounds.left(), -resultBounds.top());
-    QPainterPath adjustedPath = offsetTransform.map(result);
-    
-    // 设置调整后的路径
-    newPath->setPath(adjustedPath);
-    
-    // 设置新路径的位置为第一个形状的位置
-    newPath->setPos(shape1->pos());
-    
-    // 复制样式
-    newPath->setStrokePen(shape1->strokePen());
-    newPath->setFillBrush(shape1->fillBrush());
+    newPath->setPath(offsetTransform.map(result));
+    newPath->setPos(resultBounds.topLeft());
     
-    // 从场景中移除原始形状，并从图层中移除
-    // 获取形状所属的图层
-    DrawingLayer *layer1 = nullptr;
-    DrawingLayer *layer2 = nullptr;
+    // 复制最底层图形的样式
+    newPath->setStrokePen(baseShape->strokePen());
+    newPath->setFillBrush(baseShape->fillBrush());
     
-    // 查找形状所属的图层
+    // 查找各图形所属的图层
     LayerManager *layerManager = LayerManager::instance();
+    QHash<DrawingShape*, DrawingLayer*> shapeLayers;
     for (int i = 0; i < layerManager->layerCount(); ++i) {
         DrawingLayer *layer = layerManager->layer(i);
-        if (layer->shapes().contains(shape1)) {
-            layer1 = layer;
-        }
-        if (layer->shapes().contains(shape2)) {
-            layer2 = layer;
+        for (DrawingShape *shape : shapes) {
+            if (layer->shapes().contains(shape)) {
+                shapeLayers[shape] = layer;
+            }
         }
     }
     
-    // 从场景中移除原始形状
-    m_scene->removeItem(shape1);
-    m_scene->removeItem(shape2);
-    
-    // 从图层中移除原始形状
-    if (layer1) {
-        layer1->removeShape(shape1);
-    }
-    if (layer2 && layer2 != layer1) {
-        layer2->removeShape(shape2);
+    // 从场景和图层中移除原始形状
+    for (DrawingShape *shape : shapes) {
+        m_scene->removeItem(shape);
+        if (DrawingLayer *layer = shapeLayers.value(shape)) {
+            layer->removeShape(shape);
+        }
     }
     
     // 添加新路径到场景
     m_scene->addItem(newPath);
     newPath->setSelected(true);
     
-    // 将新路径添加到第一个形状的图层中
-    if (layer1) {
-        layer1->addShape(newPath);
+    // 将新路径添加到最底层图形的图层中
+    if (DrawingLayer *baseLayer = shapeLayers.value(baseShape)) {
+        baseLayer->addShape(newPath);
     }
     
     // 更新图层面板显示
     LayerManager::instance()->updateLayerPanel();
     
     // 删除原始形状
-    delete shape1;
-    delete shape2;
+    qDeleteAll(shapes);
     
     // 标记场景已修改
     m_scene->setModified(true);
@@ -3406,7 +3547,7 @@ void MainWindow::executeBooleanOperation(int op)
         default: opName = "布尔运算"; break;
     }
     
-    m_statusLabel->setText(QString("%1操作完成").arg(opName));
+    m_statusLabel->setText(QString("%1操作完成，共%2个图形").arg(opName).arg(shapes.size()));
 }
 
 // 执行路径操作
@@ -3443,6 +3584,10 @@ void MainWindow::executePathOperation(const QString &operation)
         QRectF bounds = transformedPath.boundingRect();
         QRectF clipRect = bounds.adjusted(10, 10, -10, -10); // 稍微缩小边界框
         resultPath = PathEditor::clipPath(transformedPath, clipRect);
+    } else if (operation == "outline") {
+        const QPen pen = shape->strokePen();
+        resultPath = PathEditor::outlinePath(transformedPath, pen.widthF(), pen.joinStyle(),
+                                             pen.capStyle(), pen.miterLimit());
     }
     
     if (resultPath.isEmpty()) {
@@ -3460,8 +3605,14 @@ void MainWindow::executePathOperation(const QString &operation)
     QPainterPath adjustedPath = offsetTransform.map(resultPath);
     newPath->setPath(adjustedPath);
     newPath->setPos(shape->pos() + bounds.topLeft());
-    newPath->setStrokePen(shape->strokePen());
-    newPath->setFillBrush(shape->fillBrush());
+    if (operation == "outline") {
+        // 描边轮廓用原描边的颜色填充
+        newPath->setStrokePen(Qt::NoPen);
+        newPath->setFillBrush(shape->strokePen().brush());
+    } else {
+        newPath->setStrokePen(shape->strokePen());
+        newPath->setFillBrush(shape->fillBrush());
+    }
     
     // 获取形状所属的图层
     DrawingLayer *layer = nullptr;
@@ -3506,6 +3657,7 @@ void MainWindow::executePathOperation(const QString &operation)
     else if (operation == "curve") opName = "转换为曲线";
     else if (operation == "offset") opName = "偏移";
     else if (operation == "clip") opName = "裁剪";
+    else if (operation == "outline") opName = "描边转路径";
     else opName = "路径操作";
     
     m_statusLabel->setText(QString("%1操作完成").arg(opName));
@@ -29,6 +29,7 @@ class TabbedPropertyPanel;
 class ToolsPanel;
 class LayerPanel;
 class LayerManager;
+class VfpDocument;
 class Ruler;
 class ColorPalette;
 class PathEditor;
@@ -96,12 +97,15 @@ private slots:
     void convertTextToPath();  // 文本转路径
     void selectAll();
     void deselectAll();
+    void selectSameStyle();  // 选择与选中图形样式相同的图形
     void zoomIn();
     void zoomOut();
     void resetZoom();
     void fitToWindow();
     void toggleGrid();
     void toggleGridAlignment();
+    void toggleRenderCache();
+    void toggleTiledRendering();
     void groupSelected();
     void ungroupSelected();
     void bringToFront();
@@ -117,6 +121,7 @@ private slots:
     void distributeHorizontal();
     void distributeVertical();
     void showGridSettings();
+    void showLodSettings();
     void about();
     void onSelectionChanged();
     void onSceneChanged();
@@ -167,6 +172,10 @@ private:
     void createActions();
     void connectActions();
     void updateUI();
+    // 按扩展名保存为SVG或VFP文件
+    bool saveDocument(const QString &fileName);
+    // 解码当前视口内尚未加载的VFP图形
+    void materializeVisibleShapes();
     void setCurrentTool(ToolBase *tool);
     
     
@@ -176,6 +185,7 @@ private:
     TabbedPropertyPanel *m_tabbedPropertyPanel;
     QUndoView *m_undoView;
     LayerManager *m_layerManager;
+    VfpDocument *m_vfpDocument;     // 当前打开的VFP文档
     ToolBase *m_currentTool;
     ToolBase *m_outlinePreviewTool;      // 选择工具（轮廓预览变换）
     
@@ -238,6 +248,7 @@ private:
     QAction *m_convertTextToPathAction;
     QAction *m_selectAllAction;
     QAction *m_deselectAllAction;
+    QAction *m_selectSameStyleAction;
     QAction *m_zoomInAction;
     QAction *m_zoomOutAction;
     QAction *m_resetZoomAction;
@@ -246,6 +257,9 @@ private:
     QAction *m_gridSizeAction;
     QAction *m_gridColorAction;
     QAction *m_toggleGridAlignmentAction;
+    QAction *m_toggleRenderCacheAction;
+    QAction *m_toggleTiledRenderingAction;
+    QAction *m_lodToleranceAction;
     QAction *m_clearAllGuidesAction;
     QAction *m_groupAction;
     QAction *m_ungroupAction;
@@ -0,0 +1,565 @@
+#include <QGraphicsView>
+#include <QGraphicsScene>
+#include <QPainter>
+#include <QPicture>
+#include <QTimer>
+#include <QThread>
+#include <QRegion>
+#include <QtMath>
+#include <QDebug>
+#include <algorithm>
+#include "../ui/tile-renderer.h"
+#include "../ui/drawingscene.h"
+#include "../core/drawing-shape.h"
+#include "../core/drawing-document.h"
+
+// 合并前允许的脏区域数，超过时合并为一个外接矩形
+static const int MAX_DIRTY_RECTS = 64;
+// 一次快照中最多有多少新图形进入过渡状态，打开文件等大批量变化时直接逐块显示
+static const int MAX_SETTLING_SHAPES = 64;
+// 图块范围向外扩展的像素，覆盖描边和抗锯齿
+static const int TILE_MARGIN = 2;
+
+// 视口到渲染器的映射，只在GUI线程访问
+static QHash<const QWidget*, TileRenderer*> &viewportRenderers()
+{
+    static QHash<const QWidget*, TileRenderer*> renderers;
+    return renderers;
+}
+
+TileRenderer::TileRenderer(QGraphicsView *view, QObject *parent)
+    : QObject(parent)
+    , m_view(view)
+    , m_snapshotTimer(new QTimer(this))
+    , m_transform(view->transform())
+{
+    // 给GUI线程留出一个核心
+    m_pool.setMaxThreadCount(qMax(1, QThread::idealThreadCount() - 1));
+
+    m_snapshotTimer->setSingleShot(true);
+    m_snapshotTimer->setInterval(SNAPSHOT_INTERVAL_MS);
+    connect(m_snapshotTimer, &QTimer::timeout, this, &TileRenderer::updateSnapshot);
+
+    QGraphicsScene *scene = m_view->scene();
+    DrawingScene *drawingScene = qobject_cast<DrawingScene*>(scene);
+    if (drawingScene) {
+        // 只记录变化的图形，删除的图形可能正在析构，只作为键使用
+        DrawingDocument *document = drawingScene->document();
+        connect(document, &DrawingDocument::itemAdded, this, [this](DrawingShape *shape) {
+            m_addedShapes.insert(shape);
+            scheduleSnapshot();
+        });
+        connect(document, &DrawingDocument::itemChanged, this, [this](DrawingShape *shape) {
+            m_changedShapes.insert(shape);
+            scheduleSnapshot();
+        });
+        connect(document, &DrawingDocument::itemRemoved, this, [this](DrawingShape *shape) {
+            m_addedShapes.remove(shape);
+            m_changedShapes.remove(shape);
+            m_removedShapes.insert(shape);
+            scheduleSnapshot();
+        });
+        connect(document, &DrawingDocument::stackingChanged, this, [this]() {
+            m_rebuildNeeded = true;
+            scheduleSnapshot();
+        });
+    } else if (scene) {
+        // 普通场景没有变化通知，每次变化都重建
+        connect(scene, &QGraphicsScene::changed, this, [this]() {
+            m_rebuildNeeded = true;
+            scheduleSnapshot();
+        });
+    }
+
+    viewportRenderers().insert(m_view->viewport(), this);
+    updateSnapshot();
+}
+
+TileRenderer::~TileRenderer()
+{
+    viewportRenderers().remove(m_view->viewport());
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+TileRenderer *TileRenderer::forViewport(const QWidget *viewport)
+{
+    if (!viewport) {
+        return nullptr;
+    }
+    return viewportRenderers().value(viewport, nullptr);
+}
+
+bool TileRenderer::rendersShape(const DrawingShape *shape) const
+{
+    return m_snapshotIndex.contains(shape) && !m_settlingShapes.contains(shape);
+}
+
+bool TileRenderer::includesShape(const DrawingShape *shape) const
+{
+    // 组合本身不绘制内容，子图形单独进入快照
+    return shape->scene() == m_view->scene() && shape->shapeType() != DrawingShape::Group && shape->isVisible();
+}
+
+void TileRenderer::scheduleSnapshot()
+{
+    if (!m_snapshotTimer->isActive()) {
+        m_snapshotTimer->start();
+    }
+}
+
+QRectF TileRenderer::tileCanvasRect(const QPoint &key)
+{
+    return QRectF(key.x() * TILE_SIZE, key.y() * TILE_SIZE, TILE_SIZE, TILE_SIZE);
+}
+
+QRect TileRenderer::viewportRect(const QRectF &canvasRect, const QTransform &transform) const
+{
+    // 画布坐标 -> 场景坐标 -> 视口坐标
+    return (transform.inverted() * m_view->viewportTransform()).mapRect(canvasRect).toAlignedRect();
+}
+
+bool TileRenderer::updateEntry(Entry &entry, DrawingShape *shape)
+{
+    const quint32 version = shape->contentVersion();
+    const QTransform sceneTransform = shape->sceneTransform();
+    const qreal opacity = shape->effectiveOpacity();
+    const QRectF sceneBounds = shape->sceneBoundingRect();
+    const bool sameShape = entry.shape == shape;
+    const bool changed = !sameShape || entry.version != version || entry.sceneTransform != sceneTransform
+                         || entry.opacity != opacity || entry.sceneBounds != sceneBounds;
+
+    // 外观变化后重新录制绘制指令，只录制内容，选择指示器仍由图形同步绘制
+    if (!sameShape || entry.version != version || entry.picture.isEmpty()) {
+        QPicture picture;
+        QPainter recorder(&picture);
+        shape->paintVectorContent(&recorder);
+        recorder.end();
+        entry.picture = QByteArray(picture.data(), int(picture.size()));
+    }
+
+    entry.shape = shape;
+    entry.version = version;
+    entry.sceneTransform = sceneTransform;
+    entry.opacity = opacity;
+    entry.sceneBounds = sceneBounds;
+    return changed;
+}
+
+void TileRenderer::updateSnapshot()
+{
+    m_snapshotTimer->stop();
+    if (!m_view->scene()) {
+        return;
+    }
+
+    if (m_rebuildNeeded || !applyChanges()) {
+        rebuildSnapshot();
+    }
+}
+
+void TileRenderer::rebuildSnapshot()
+{
+    QGraphicsScene *scene = m_view->scene();
+    Snapshot snapshot;
+    QHash<const DrawingShape*, int> index;
+    QVector<QRectF> dirtyRects;
+    QVector<const DrawingShape*> addedShapes;
+    const DrawingShape *previous = nullptr;
+    qreal topZ = 0;
+
+    for (QGraphicsItem *item : scene->items(Qt::AscendingOrder)) {
+        DrawingShape *shape = dynamic_cast<DrawingShape*>(item);
+        if (!shape || !includesShape(shape)) {
+            continue;
+        }
+
+        Entry entry;
+        QHash<const DrawingShape*, int>::const_iterator old = m_snapshotIndex.constFind(shape);
+        if (old != m_snapshotIndex.constEnd()) {
+            entry = m_snapshot.at(old.value());
+            const QRectF oldBounds = entry.sceneBounds;
+            if (updateEntry(entry, shape) || entry.previous != previous) {
+                dirtyRects.append(oldBounds);
+                dirtyRects.append(entry.sceneBounds);
+            }
+        } else {
+            updateEntry(entry, shape);
+            dirtyRects.append(entry.sceneBounds);
+            addedShapes.append(shape);
+        }
+        entry.previous = previous;
+
+        const qreal z = shape->topLevelItem()->zValue();
+        topZ = snapshot.isEmpty() ? z : qMax(topZ, z);
+        index.insert(shape, snapshot.size());
+        snapshot.append(entry);
+        previous = shape;
+    }
+
+    // 已经不在快照中的图形（删除或隐藏）
+    for (const Entry &oldEntry : m_snapshot) {
+        if (oldEntry.shape && !index.contains(oldEntry.shape)) {
+            dirtyRects.append(oldEntry.sceneBounds);
+            m_settlingShapes.remove(oldEntry.shape);
+        }
+    }
+
+    if (!m_snapshotIndex.isEmpty() && addedShapes.size() <= MAX_SETTLING_SHAPES) {
+        for (const DrawingShape *shape : addedShapes) {
+            m_settlingShapes.insert(shape);
+        }
+    }
+
+    m_snapshot = snapshot;
+    m_snapshotIndex = index;
+    m_removedEntries = 0;
+    m_topZ = topZ;
+    m_changedShapes.clear();
+    m_addedShapes.clear();
+    m_removedShapes.clear();
+    m_rebuildNeeded = false;
+    if (!dirtyRects.isEmpty()) {
+        markDirty(dirtyRects);
+        m_view->viewport()->update();
+    }
+}
+
+bool TileRenderer::applyChanges()
+{
+    // 重新显示的图形和新图形一样需要确定层叠位置
+    for (DrawingShape *shape : std::as_const(m_changedShapes)) {
+        if (!m_snapshotIndex.contains(shape) && !m_removedShapes.contains(shape) && includesShape(shape)) {
+            m_addedShapes.insert(shape);
+        }
+    }
+
+    // 新图形和它的顶层图形都是刚加入的，并且在现有图形之上时才能追加到末尾，否则重建
+    QVector<DrawingShape*> added;
+    QRectF addedBounds;
+    for (DrawingShape *shape : std::as_const(m_addedShapes)) {
+        if (!includesShape(shape)) {
+            continue;
+        }
+        const QGraphicsItem *top = shape->topLevelItem();
+        const DrawingShape *topShape = dynamic_cast<const DrawingShape*>(top);
+        if (top != shape && !m_addedShapes.contains(const_cast<DrawingShape*>(topShape))) {
+            return false;
+        }
+        if (!m_snapshotIndex.isEmpty() && top->zValue() < m_topZ) {
+            return false;
+        }
+        added.append(shape);
+        addedBounds |= shape->sceneBoundingRect();
+    }
+    if (added.size() > MAX_SETTLING_SHAPES) {
+        return false;
+    }
+    if (added.size() > 1) {
+        // 新图形之间的层叠顺序只对相交的图形有意义，查询它们覆盖的区域即可
+        QSet<DrawingShape*> remaining(added.begin(), added.end());
+        QVector<DrawingShape*> ordered;
+        for (QGraphicsItem *item : m_view->scene()->items(addedBounds, Qt::IntersectsItemBoundingRect, Qt::AscendingOrder)) {
+            DrawingShape *shape = dynamic_cast<DrawingShape*>(item);
+            if (shape && remaining.remove(shape)) {
+                ordered.append(shape);
+            }
+        }
+        for (DrawingShape *shape : added) {
+            if (remaining.contains(shape)) {
+                ordered.append(shape);
+            }
+        }
+        added = ordered;
+    }
+
+    QVector<QRectF> dirtyRects;
+
+    // 删除的图形留下空条目，后面的条目不移动
+    for (const DrawingShape *shape : std::as_const(m_removedShapes)) {
+        removeEntry(shape, dirtyRects);
+    }
+
+    // 变化的图形原地更新
+    for (DrawingShape *shape : std::as_const(m_changedShapes)) {
+        QHash<const DrawingShape*, int>::const_iterator it = m_snapshotIndex.constFind(shape);
+        if (it == m_snapshotIndex.constEnd()) {
+            continue;
+        }
+        if (!includesShape(shape)) {
+            removeEntry(shape, dirtyRects);
+            continue;
+        }
+        Entry &entry = m_snapshot[it.value()];
+        const QRectF oldBounds = entry.sceneBounds;
+        if (updateEntry(entry, shape)) {
+            dirtyRects.append(oldBounds);
+            dirtyRects.append(entry.sceneBounds);
+        }
+    }
+
+    const bool settle = !m_snapshotIndex.isEmpty();
+    for (DrawingShape *shape : added) {
+        Entry entry;
+        updateEntry(entry, shape);
+        entry.previous = m_snapshot.isEmpty() ? nullptr : m_snapshot.constLast().shape;
+        dirtyRects.append(entry.sceneBounds);
+        const qreal z = shape->topLevelItem()->zValue();
+        m_topZ = m_snapshotIndex.isEmpty() ? z : qMax(m_topZ, z);
+        m_snapshotIndex.insert(shape, m_snapshot.size());
+        m_snapshot.append(entry);
+        if (settle) {
+            m_settlingShapes.insert(shape);
+        }
+    }
+
+    m_changedShapes.clear();
+    m_addedShapes.clear();
+    m_removedShapes.clear();
+    if (m_removedEntries > m_snapshot.size() / 2) {
+        compactSnapshot();
+    }
+    if (!dirtyRects.isEmpty()) {
+        markDirty(dirtyRects);
+        m_view->viewport()->update();
+    }
+    return true;
+}
+
+void TileRenderer::removeEntry(const DrawingShape *shape, QVector<QRectF> &dirtyRects)
+{
+    QHash<const DrawingShape*, int>::iterator it = m_snapshotIndex.find(shape);
+    if (it == m_snapshotIndex.end()) {
+        return;
+    }
+    Entry &entry = m_snapshot[it.value()];
+    dirtyRects.append(entry.sceneBounds);
+    // 空条目的包围盒为空，渲染时自然跳过
+    entry = Entry();
+    m_snapshotIndex.erase(it);
+    m_settlingShapes.remove(shape);
+    m_removedEntries++;
+}
+
+void TileRenderer::compactSnapshot()
+{
+    Snapshot snapshot;
+    snapshot.reserve(m_snapshot.size() - m_removedEntries);
+    m_snapshotIndex.clear();
+    for (const Entry &entry : std::as_const(m_snapshot)) {
+        if (entry.shape) {
+            m_snapshotIndex.insert(entry.shape, snapshot.size());
+            snapshot.append(entry);
+        }
+    }
+    m_snapshot = snapshot;
+    m_removedEntries = 0;
+}
+
+void TileRenderer::markDirty(const QVector<QRectF> &sceneRects)
+{
+    QVector<QRectF> rects = sceneRects;
+    if (rects.size() > MAX_DIRTY_RECTS) {
+        QRectF bounds;
+        for (const QRectF &rect : sceneRects) {
+            bounds |= rect;
+        }
+        rects = QVector<QRectF>() << bounds;
+    }
+
+    const QTransform inverse = m_transform.inverted();
+    for (QHash<QPoint, Tile>::iterator it = m_tiles.begin(); it != m_tiles.end(); ++it) {
+        const QRectF tileRect = inverse.mapRect(tileCanvasRect(it.key())
+            .adjusted(-TILE_MARGIN, -TILE_MARGIN, TILE_MARGIN, TILE_MARGIN));
+        for (const QRectF &rect : rects) {
+            if (tileRect.intersects(rect)) {
+                it->dirty = true;
+                break;
+            }
+        }
+    }
+}
+
+void TileRenderer::checkTransform()
+{
+    const QTransform transform = m_view->transform();
+    if (transform == m_transform) {
+        return;
+    }
+
+    // 保留旧比例下已渲染的图块，在新图块完成前缩放显示
+    for (QHash<QPoint, Tile>::const_iterator it = m_tiles.constBegin(); it != m_tiles.constEnd(); ++it) {
+        if (!it->image.isNull()) {
+            m_staleTiles.append({it.key(), it->image, it->transform});
+        }
+    }
+    if (m_staleTiles.size() > MAX_STALE_TILES) {
+        m_staleTiles.remove(0, m_staleTiles.size() - MAX_STALE_TILES);
+    }
+
+    m_tiles.clear();
+    m_transform = transform;
+    m_transformSerial.fetchAndAddRelaxed(1);
+}
+
+void TileRenderer::paint(QPainter *painter, const QRectF &exposedRect)
+{
+    checkTransform();
+
+    // 暴露区域覆盖的图块
+    const QRectF canvasRect = m_transform.mapRect(exposedRect);
+    const int left = qFloor(canvasRect.left() / TILE_SIZE);
+    const int right = qFloor(canvasRect.right() / TILE_SIZE);
+    const int top = qFloor(canvasRect.top() / TILE_SIZE);
+    const int bottom = qFloor(canvasRect.bottom() / TILE_SIZE);
+
+    QVector<QPoint> readyTiles;
+    QRegion covered;
+    bool complete = true;
+    for (int y = top; y <= bottom; ++y) {
+        for (int x = left; x <= right; ++x) {
+            const QPoint key(x, y);
+            Tile &tile = m_tiles[key];
+            if (!tile.pending && (tile.image.isNull() || tile.dirty)) {
+                requestTile(key, tile);
+            }
+            if (tile.image.isNull()) {
+                complete = false;
+                continue;
+            }
+            if (tile.dirty || tile.pending) {
+                complete = false;
+            }
+            readyTiles.append(key);
+            covered += viewportRect(tileCanvasRect(key), tile.transform);
+        }
+    }
+
+    painter->save();
+
+    // 还没有图块的区域先显示旧比例的图块
+    if (!m_staleTiles.isEmpty()) {
+        painter->save();
+        painter->resetTransform();
+        painter->setClipRegion(QRegion(m_view->viewport()->rect()).subtracted(covered), Qt::IntersectClip);
+        painter->setRenderHint(QPainter::SmoothPixmapTransform);
+        for (const StaleTile &stale : m_staleTiles) {
+            painter->setWorldTransform(stale.transform.inverted() * m_view->viewportTransform());
+            painter->drawImage(tileCanvasRect(stale.key), stale.image);
+        }
+        painter->restore();
+    }
+
+    for (const QPoint &key : readyTiles) {
+        const Tile &tile = m_tiles[key];
+        painter->setWorldTransform(tile.transform.inverted() * m_view->viewportTransform());
+        painter->drawImage(tileCanvasRect(key), tile.image);
+    }
+
+    painter->restore();
+
+    if (complete && m_pendingJobs == 0) {
+        m_staleTiles.clear();
+    }
+    evictTiles(canvasRect);
+}
+
+void TileRenderer::requestTile(const QPoint &key, Tile &tile)
+{
+    tile.pending = true;
+    tile.dirty = false;
+    m_pendingJobs++;
+
+    const Snapshot snapshot = m_snapshot;
+    const QTransform transform = m_transform;
+    const int transformSerial = m_transformSerial.loadRelaxed();
+    const qreal devicePixelRatio = m_view->viewport()->devicePixelRatioF();
+
+    m_pool.start([this, key, snapshot, transform, transformSerial, devicePixelRatio]() {
+        QImage image;
+        // 比例已经变化的任务不再渲染
+        if (m_transformSerial.loadRelaxed() == transformSerial) {
+            image = renderTile(snapshot, transform, key, devicePixelRatio);
+        }
+        QMetaObject::invokeMethod(this, [this, key, transformSerial, image]() {
+            tileRendered(key, transformSerial, image);
+        }, Qt::QueuedConnection);
+    });
+}
+
+QImage TileRenderer::renderTile(const Snapshot &snapshot, const QTransform &transform,
+                                const QPoint &key, qreal devicePixelRatio)
+{
+    QImage image(qCeil(TILE_SIZE * devicePixelRatio), qCeil(TILE_SIZE * devicePixelRatio),
+                 QImage::Format_ARGB32_Premultiplied);
+    image.setDevicePixelRatio(devicePixelRatio);
+    image.fill(Qt::transparent);
+
+    const QRectF canvasRect = tileCanvasRect(key);
+    const QRectF sceneRect = transform.inverted().mapRect(
+        canvasRect.adjusted(-TILE_MARGIN, -TILE_MARGIN, TILE_MARGIN, TILE_MARGIN));
+    const QTransform base = transform * QTransform::fromTranslate(-canvasRect.left(), -canvasRect.top());
+
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+    for (const Entry &entry : snapshot) {
+        if (!entry.sceneBounds.intersects(sceneRect)) {
+            continue;
+        }
+        // QPicture回放会移动内部缓冲区的读取位置，每次使用独立的副本
+        QPicture picture;
+        picture.setData(entry.picture.constData(), uint(entry.picture.size()));
+        painter.setWorldTransform(entry.sceneTransform * base);
+        painter.setOpacity(entry.opacity);
+        painter.drawPicture(0, 0, picture);
+    }
+    painter.end();
+    return image;
+}
+
+void TileRenderer::tileRendered(const QPoint &key, int transformSerial, const QImage &image)
+{
+    m_pendingJobs--;
+
+    if (transformSerial == m_transformSerial.loadRelaxed()) {
+        QHash<QPoint, Tile>::iterator it = m_tiles.find(key);
+        if (it != m_tiles.end()) {
+            it->pending = false;
+            if (!image.isNull()) {
+                it->image = image;
+                it->transform = m_transform;
+            }
+            m_view->viewport()->update(viewportRect(tileCanvasRect(key), m_transform));
+        }
+    }
+
+    // 全部图块完成后，过渡中的图形交给图块绘制
+    if (m_pendingJobs == 0 && !m_settlingShapes.isEmpty()) {
+        m_settlingShapes.clear();
+        m_view->viewport()->update();
+    }
+}
+
+void TileRenderer::evictTiles(const QRectF &visibleCanvasRect)
+{
+    if (m_tiles.size() <= MAX_TILES) {
+        return;
+    }
+
+    // 按到视口中心的距离丢弃最远的图块，正在渲染的图块保留
+    const QPointF center = visibleCanvasRect.center();
+    QVector<QPair<qreal, QPoint>> candidates;
+    for (QHash<QPoint, Tile>::const_iterator it = m_tiles.constBegin(); it != m_tiles.constEnd(); ++it) {
+        if (!it->pending) {
+            const QPointF offset = tileCanvasRect(it.key()).center() - center;
+            candidates.append(qMakePair(offset.x() * offset.x() + offset.y() * offset.y(), it.key()));
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(),
+              [](const QPair<qreal, QPoint> &a, const QPair<qreal, QPoint> &b) { return a.first > b.first; });
+
+    for (int i = 0; i < candidates.size() && m_tiles.size() > MAX_TILES; ++i) {
+        m_tiles.remove(candidates[i].second);
+    }
+}
@@ -0,0 +1,134 @@
+#ifndef TILE_RENDERER_H
+#define TILE_RENDERER_H
+
+#include <QObject>
+#include <QHash>
+#include <QSet>
+#include <QVector>
+#include <QImage>
+#include <QTransform>
+#include <QByteArray>
+#include <QAtomicInt>
+#include <QThreadPool>
+
+class QGraphicsView;
+class QPainter;
+class QTimer;
+class DrawingShape;
+
+/**
+ * 视图的分块后台渲染器
+ * 视口按固定像素大小切成图块，工作线程根据图形的不可变快照（录制好的绘制指令、
+ * 场景变换和透明度）把图块渲染成QImage，视图在背景上逐步合成已完成的图块。
+ * 选中的图形也留在快照中按层叠顺序绘制，变化后只重绘受影响的图块；
+ * 选择指示器、把手和吸附指示器仍在GUI线程同步绘制。
+ * 场景是DrawingScene时按文档图形表的变化通知只更新变化图形的条目，层叠顺序变化时才完整重建
+ */
+class TileRenderer : public QObject
+{
+    Q_OBJECT
+
+public:
+    // 图块边长（逻辑像素）
+    static const int TILE_SIZE = 256;
+    // 保留的当前比例图块数上限，超出时丢弃离视口最远的图块
+    static const int MAX_TILES = 512;
+    // 缩放后保留的旧比例图块数上限
+    static const int MAX_STALE_TILES = 256;
+    // 场景变化后更新快照的合并间隔（毫秒）
+    static const int SNAPSHOT_INTERVAL_MS = 30;
+
+    explicit TileRenderer(QGraphicsView *view, QObject *parent = nullptr);
+    ~TileRenderer();
+
+    // 视口对应的渲染器，未启用分块渲染时返回nullptr
+    static TileRenderer *forViewport(const QWidget *viewport);
+
+    // 图形是否由图块绘制；为false时图形需要自己同步绘制
+    bool rendersShape(const DrawingShape *shape) const;
+
+    // 在视图背景之上合成图块，painter处于视图的viewportTransform下
+    void paint(QPainter *painter, const QRectF &exposedRect);
+
+    // 立即把累积的变化应用到快照（通常由场景变化触发）
+    void updateSnapshot();
+
+    int pendingCount() const { return m_pendingJobs; }
+    int tileCount() const { return m_tiles.size(); }
+
+private:
+    // 快照中的一个图形；shape只作为键比较，工作线程不访问它。图形删除后留下shape为空的条目
+    struct Entry {
+        const DrawingShape *shape = nullptr;
+        const DrawingShape *previous = nullptr;   // 绘制顺序中的前一个图形，用于发现层叠顺序变化
+        quint32 version = 0;
+        QByteArray picture;                        // QPicture数据，每个线程各自回放
+        QTransform sceneTransform;
+        qreal opacity = 1.0;
+        QRectF sceneBounds;
+    };
+    // 隐式共享，渲染任务持有一份副本，GUI线程原地更新时才复制
+    typedef QVector<Entry> Snapshot;
+
+    struct Tile {
+        QImage image;
+        QTransform transform;     // 渲染时的视图变换（不含滚动）
+        bool dirty = false;       // 快照变化后需要重新渲染，旧图像仍可显示
+        bool pending = false;
+    };
+
+    struct StaleTile {
+        QPoint key;
+        QImage image;
+        QTransform transform;
+    };
+
+    static QRectF tileCanvasRect(const QPoint &key);
+    // 读取图形当前的状态，外观版本变化时重新录制绘制指令；返回条目是否变化
+    static bool updateEntry(Entry &entry, DrawingShape *shape);
+    static QImage renderTile(const Snapshot &snapshot, const QTransform &transform,
+                             const QPoint &key, qreal devicePixelRatio);
+
+    void scheduleSnapshot();
+    bool includesShape(const DrawingShape *shape) const;
+    // 遍历场景按层叠顺序重建快照
+    void rebuildSnapshot();
+    // 只更新变化、删除和新增的图形；新增图形无法追加到末尾时返回false
+    bool applyChanges();
+    void removeEntry(const DrawingShape *shape, QVector<QRectF> &dirtyRects);
+    void compactSnapshot();
+
+    void checkTransform();
+    void requestTile(const QPoint &key, Tile &tile);
+    void tileRendered(const QPoint &key, int transformSerial, const QImage &image);
+    void markDirty(const QVector<QRectF> &sceneRects);
+    void evictTiles(const QRectF &visibleCanvasRect);
+    QRect viewportRect(const QRectF &canvasRect, const QTransform &transform) const;
+
+    QGraphicsView *m_view;
+    QThreadPool m_pool;
+    QTimer *m_snapshotTimer;
+
+    Snapshot m_snapshot;
+    QHash<const DrawingShape*, int> m_snapshotIndex;
+    // 快照中删除后留下的空条目数
+    int m_removedEntries = 0;
+    // 快照中顶层图形的最大Z值，新图形在它之上时可以直接追加
+    qreal m_topZ = 0;
+
+    // 上次更新快照后的变化，来自文档图形表的通知
+    QSet<DrawingShape*> m_changedShapes;
+    QSet<DrawingShape*> m_addedShapes;
+    QSet<const DrawingShape*> m_removedShapes;
+    bool m_rebuildNeeded = true;
+    // 刚进入快照的图形在图块渲染完成前继续同步绘制，避免闪烁
+    QSet<const DrawingShape*> m_settlingShapes;
+
+    QTransform m_transform;
+    QAtomicInt m_transformSerial;
+    QHash<QPoint, Tile> m_tiles;
+    QVector<StaleTile> m_staleTiles;
+    int m_pendingJobs = 0;
+};
+
+#endif // TILE_RENDERER_H
@@ -0,0 +1,99 @@
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QtMath>
+#include <QDebug>
+#include "../src/core/brush-engine.h"
+#include "bench-common.h"
+
+// 默认的笔画点数
+static const int DEFAULT_POINT_COUNT = 100000;
+// 每组统计的点数
+static const int BUCKET_SIZE = 10000;
+
+// 模拟手写轨迹：螺旋加小幅抖动
+static QPointF strokePoint(int i)
+{
+    const qreal t = i * 0.01;
+    const qreal radius = 50 + t * 2;
+    return QPointF(radius * qCos(t) + 3 * qSin(i * 0.7), radius * qSin(t) + 3 * qCos(i * 0.3));
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    int pointCount = DEFAULT_POINT_COUNT;
+    if (argc > 1) {
+        pointCount = qMax(2, QString::fromLocal8Bit(argv[1]).toInt());
+    }
+
+    BrushEngine engine;
+    engine.loadDefaultProfile("Basic Pen");
+
+    qDebug() << "=== 画笔增量笔画基准测试 ===" << "点数:" << pointCount;
+
+    QElapsedTimer timer;
+    timer.start();
+    engine.beginStroke(strokePoint(0));
+
+    qint64 bucketStart = timer.nsecsElapsed();
+    double firstBucketUs = 0.0;
+    double lastBucketUs = 0.0;
+    for (int i = 1; i < pointCount; ++i) {
+        engine.addPoint(strokePoint(i));
+        if (i % BUCKET_SIZE == 0) {
+            const qint64 now = timer.nsecsElapsed();
+            const double averageUs = (now - bucketStart) / 1000.0 / BUCKET_SIZE;
+            if (firstBucketUs == 0.0) {
+                firstBucketUs = averageUs;
+            }
+            lastBucketUs = averageUs;
+            qDebug() << "点" << (i - BUCKET_SIZE + 1) << "-" << i << "平均每点(us):" << averageUs
+                     << "稳定块数:" << engine.stableChunks().size();
+            bucketStart = now;
+        }
+    }
+    engine.endStroke();
+
+    const double totalMs = timer.nsecsElapsed() / 1.0e6;
+    qDebug() << "总耗时(ms):" << totalMs
+             << "首组/末组每点耗时比:" << (firstBucketUs > 0 ? lastBucketUs / firstBucketUs : 0.0);
+
+    // 完整路径：一个moveTo加每段三个三次曲线元素
+    BenchCommon::Failures failures;
+    const QPainterPath path = engine.getStrokePath();
+    const int expectedElements = 1 + 3 * (pointCount - 1);
+    if (path.elementCount() != expectedElements) {
+        failures.fail("路径元素数", path.elementCount(), "应为", expectedElements);
+    }
+    if (engine.stablePointCount() != pointCount || !engine.tailPath().isEmpty()) {
+        failures.fail("结束笔画后仍有未稳定的点", engine.stablePointCount());
+    }
+    if (engine.getStrokePens().size() != pointCount - 1) {
+        failures.fail("画笔数", engine.getStrokePens().size(), "应为", pointCount - 1);
+    }
+
+    // 变宽轮廓：一个填充多边形代替逐段描边
+    timer.restart();
+    const QPainterPath outline = engine.getStrokeOutline();
+    const double outlineMs = timer.nsecsElapsed() / 1.0e6;
+    qDebug() << "生成轮廓(ms):" << outlineMs
+             << "轮廓元素数:" << outline.elementCount()
+             << "描边段数:" << engine.getStrokePens().size();
+    if (outline.isEmpty() || outline.fillRule() != Qt::WindingFill) {
+        failures.fail("轮廓为空或填充规则不对");
+    }
+    // 抽查中心线各段的中点都在轮廓内（内侧转角经过顶点本身，顶点在边界上，不适合检查）
+    const int sampleStep = qMax(1, pointCount / 200);
+    for (int i = 1; i < pointCount; i += sampleStep) {
+        const QPointF from = path.elementAt(i == 1 ? 0 : 3 * (i - 1));
+        const QPointF to = path.elementAt(3 * i);
+        const QPointF center = (from + to) / 2.0;
+        if (!outline.contains(center)) {
+            failures.fail("中心线上的点不在轮廓内", i, center);
+            break;
+        }
+    }
+
+    return failures.report();
+}
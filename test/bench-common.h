@@ -0,0 +1,69 @@
+#ifndef BENCH_COMMON_H
+#define BENCH_COMMON_H
+
+#include <QByteArray>
+#include <QDebug>
+#include <QtGlobal>
+
+/**
+ * 测试和基准测试的公共部分 - 无窗口运行和失败计数
+ */
+namespace BenchCommon {
+
+// 基准测试不需要显示窗口，在创建QApplication之前调用
+inline void useOffscreenPlatform()
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+}
+
+/**
+ * 失败计数 - 每个失败输出一行"FAIL: ..."，最后输出PASS或FAIL并把失败数作为退出码
+ */
+class Failures
+{
+public:
+    // 记录一次失败，参数依次输出到FAIL行
+    template <typename... Args>
+    void fail(const Args &...args)
+    {
+        QDebug out = qDebug();
+        out << "FAIL:";
+        (out << ... << args);
+        ++m_count;
+    }
+
+    // 条件不成立时记录失败，返回条件本身
+    template <typename... Args>
+    bool check(bool ok, const Args &...args)
+    {
+        if (!ok) {
+            fail(args...);
+        }
+        return ok;
+    }
+
+    // 直接累加外部统计的失败数
+    Failures &operator+=(int count)
+    {
+        m_count += count;
+        return *this;
+    }
+
+    int count() const { return m_count; }
+
+    // 输出总结果，返回值用作main的返回值
+    int report() const
+    {
+        qDebug() << (m_count == 0 ? "PASS" : "FAIL") << "失败数:" << m_count;
+        return m_count;
+    }
+
+private:
+    int m_count = 0;
+};
+
+} // namespace BenchCommon
+
+#endif // BENCH_COMMON_H
@@ -0,0 +1,173 @@
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QLineF>
+#include <QtMath>
+#include <limits>
+#include <QDebug>
+#include "../src/core/curve-fitter.h"
+#include "../src/core/brush-engine.h"
+#include "../src/core/path-boolean.h"
+#include "bench-common.h"
+
+// 模拟手绘笔画的采样数（约1像素一个采样）
+static const int DEFAULT_SAMPLE_COUNT = 20000;
+// 拟合容差（像素）
+static const qreal TOLERANCE = 0.5;
+// 期望的最小节点压缩比
+static const qreal MIN_REDUCTION = 10.0;
+// 计算误差时每段曲线的展平点数
+static const int FLATTEN_STEPS = 64;
+
+static qreal distanceToSegment(const QPointF &p, const QPointF &a, const QPointF &b)
+{
+    const QPointF d = b - a;
+    const qreal lengthSquared = QPointF::dotProduct(d, d);
+    const qreal t = lengthSquared > 0 ? qBound(0.0, QPointF::dotProduct(p - a, d) / lengthSquared, 1.0) : 0.0;
+    return QLineF(p, a + d * t).length();
+}
+
+// 每个输入点到拟合结果（细密展平）的最大距离
+static qreal maxDeviation(const QVector<QPointF> &points, const QPainterPath &fitted)
+{
+    // 每段曲线均匀取点展平，展平误差远小于容差
+    QVector<QPointF> flattened;
+    for (int i = 0; i < fitted.elementCount(); ++i) {
+        const QPainterPath::Element &element = fitted.elementAt(i);
+        if (element.type != QPainterPath::CurveToElement) {
+            flattened.append(QPointF(element.x, element.y));
+            continue;
+        }
+        const QPointF p0 = flattened.last();
+        const QPointF p1(element.x, element.y);
+        const QPointF p2(fitted.elementAt(i + 1).x, fitted.elementAt(i + 1).y);
+        const QPointF p3(fitted.elementAt(i + 2).x, fitted.elementAt(i + 2).y);
+        for (int k = 1; k <= FLATTEN_STEPS; ++k) {
+            const qreal t = qreal(k) / FLATTEN_STEPS;
+            const qreal u = 1.0 - t;
+            flattened.append(p0 * (u * u * u) + p1 * (3 * u * u * t) + p2 * (3 * u * t * t) + p3 * (t * t * t));
+        }
+        i += 2;
+    }
+    qreal result = 0.0;
+    int hint = 0;
+    for (const QPointF &point : points) {
+        // 输入点沿路径推进，只在上一个最近段附近搜索
+        qreal best = std::numeric_limits<qreal>::max();
+        int bestIndex = hint;
+        const int from = qMax(0, hint - 1000);
+        const int to = qMin(int(flattened.size()) - 1, hint + 1000);
+        for (int k = from; k < to; ++k) {
+            const qreal d = distanceToSegment(point, flattened[k], flattened[k + 1]);
+            if (d < best) {
+                best = d;
+                bestIndex = k;
+            }
+        }
+        hint = bestIndex;
+        result = qMax(result, best);
+    }
+    return result;
+}
+
+// 平滑随机游走加采样抖动，模拟手绘输入
+static QVector<QPointF> generateStroke(int count)
+{
+    QRandomGenerator random(5);
+    QVector<QPointF> points;
+    points.reserve(count);
+    QPointF position(0, 0);
+    qreal heading = 0.0;
+    qreal turnRate = 0.0;
+    for (int i = 0; i < count; ++i) {
+        turnRate = qBound(-0.08, turnRate + (random.generateDouble() - 0.5) * 0.01, 0.08);
+        heading += turnRate;
+        position += QPointF(qCos(heading), qSin(heading));
+        points.append(position + QPointF(random.generateDouble() - 0.5, random.generateDouble() - 0.5) * 0.2);
+    }
+    return points;
+}
+
+static int nodeCount(const QPainterPath &path)
+{
+    // 每个moveTo、lineTo和每段曲线的终点算一个节点
+    int count = 0;
+    for (int i = 0; i < path.elementCount(); ++i) {
+        if (path.elementAt(i).type != QPainterPath::CurveToDataElement) {
+            count++;
+        }
+    }
+    return count;
+}
+
+int main(int argc, char *argv[])
+{
+    BenchCommon::useOffscreenPlatform();
+    QApplication app(argc, argv);
+
+    const int sampleCount = argc > 1 ? QString::fromLocal8Bit(argv[1]).toInt() : DEFAULT_SAMPLE_COUNT;
+    BenchCommon::Failures failures;
+
+    qDebug() << "=== 曲线拟合基准测试 ===";
+
+    // 手绘笔画：节点压缩比、误差和耗时
+    const QVector<QPointF> stroke = generateStroke(sampleCount);
+    QElapsedTimer timer;
+    timer.start();
+    const QPainterPath fitted = CurveFitter::fitPolyline(stroke, false, TOLERANCE);
+    const double fitMs = timer.nsecsElapsed() / 1.0e6;
+    const qreal deviation = maxDeviation(stroke, fitted);
+    const qreal reduction = qreal(stroke.size()) / nodeCount(fitted);
+    qDebug() << "手绘笔画" << stroke.size() << "个采样 ->" << nodeCount(fitted) << "个节点, 压缩" << reduction
+             << "倍, 最大误差" << deviation << ", 耗时" << fitMs << "ms";
+    if (deviation > TOLERANCE * 1.05) {
+        failures.fail("拟合误差超出容差");
+    }
+    if (reduction < MIN_REDUCTION) {
+        failures.fail("节点压缩比不足");
+    }
+
+    // 尖角：带抖动的正方形应保留四个角
+    QVector<QPointF> square;
+    QRandomGenerator random(9);
+    const QPointF corners[4] = {QPointF(0, 0), QPointF(200, 0), QPointF(200, 200), QPointF(0, 200)};
+    for (int side = 0; side < 4; ++side) {
+        for (int i = 0; i < 200; ++i) {
+            const QPointF point = corners[side] + (corners[(side + 1) % 4] - corners[side]) * (i / 200.0);
+            square.append(point + QPointF(random.generateDouble() - 0.5, random.generateDouble() - 0.5) * 0.2);
+        }
+    }
+    const QPainterPath squareFit = CurveFitter::fitPolyline(square, true, TOLERANCE);
+    int keptCorners = 0;
+    for (const QPointF &corner : corners) {
+        for (int i = 0; i < squareFit.elementCount(); ++i) {
+            const QPainterPath::Element &element = squareFit.elementAt(i);
+            if (element.type != QPainterPath::CurveToElement && element.type != QPainterPath::CurveToDataElement
+                && QLineF(corner, QPointF(element.x, element.y)).length() < 1.0) {
+                keptCorners++;
+                break;
+            }
+        }
+    }
+    qDebug() << "正方形" << square.size() << "个采样 ->" << nodeCount(squareFit) << "个节点, 保留尖角" << keptCorners;
+    if (keptCorners != 4 || maxDeviation(square, squareFit) > TOLERANCE * 1.05) {
+        failures.fail("正方形的尖角没有保留或误差超出容差");
+    }
+
+    // 画笔轮廓：变宽轮廓多边形合并掉内侧回折后拟合，与画笔工具结束笔画时相同
+    QVector<qreal> widths;
+    for (int i = 0; i < stroke.size(); ++i) {
+        widths.append(4.0 + 3.0 * qSin(i * 0.01));
+    }
+    const QPainterPath outline = BrushEngine::buildOutline(stroke, widths);
+    timer.start();
+    const QPainterPath cleaned = PathBoolean::combine(QList<QPainterPath>() << outline, PathEditor::Union, TOLERANCE);
+    const QPainterPath outlineFit = CurveFitter::fitPath(cleaned, TOLERANCE);
+    const double outlineMs = timer.nsecsElapsed() / 1.0e6;
+    qDebug() << "画笔轮廓" << outline.elementCount() << "个元素 ->" << nodeCount(outlineFit) << "个节点, 耗时" << outlineMs << "ms";
+    if (nodeCount(outlineFit) * MIN_REDUCTION > outline.elementCount()) {
+        failures.fail("画笔轮廓的节点压缩比不足");
+    }
+
+    return failures.report();
+}
@@ -0,0 +1,122 @@
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QSet>
+#include <QDebug>
+#include "../src/ui/drawingscene.h"
+#include "../src/core/drawing-shape.h"
+#include "../src/core/drawing-document.h"
+#include "bench-common.h"
+
+static const int DEFAULT_SHAPE_COUNT = 100000;
+static const int QUERY_COUNT = 200;
+
+static bool intersects(const QRectF &box, const QRectF &rect)
+{
+    return box.left() <= rect.right() && box.right() >= rect.left()
+           && box.top() <= rect.bottom() && box.bottom() >= rect.top();
+}
+
+int main(int argc, char *argv[])
+{
+    BenchCommon::useOffscreenPlatform();
+    QApplication app(argc, argv);
+
+    const int shapeCount = argc > 1 ? QString::fromLocal8Bit(argv[1]).toInt() : DEFAULT_SHAPE_COUNT;
+    BenchCommon::Failures failures;
+
+    qDebug() << "=== 文档图形表基准测试 ===";
+    DrawingScene scene;
+    DrawingDocument *document = scene.document();
+    QRandomGenerator random(41);
+    QVector<DrawingShape*> shapes;
+    shapes.reserve(shapeCount);
+    for (int i = 0; i < shapeCount; ++i) {
+        DrawingRectangle *shape = new DrawingRectangle(QRectF(0, 0, 5 + random.bounded(20), 5 + random.bounded(20)));
+        shape->setPos(random.bounded(20000), random.bounded(20000));
+        shape->setFillBrush(QBrush(i % 2 ? Qt::red : Qt::blue));
+        scene.addItem(shape);
+        shapes.append(shape);
+    }
+    if (document->count() != shapeCount) {
+        failures.fail("文档图形数", document->count(), "应为", shapeCount);
+    }
+
+    // 包围盒：首次查询时读取全部图形，之后只做数组循环
+    QElapsedTimer timer;
+    timer.start();
+    const QRectF first = document->bounds();
+    const qint64 firstMs = timer.elapsed();
+    timer.restart();
+    const QRectF documentBounds = document->bounds();
+    const qint64 documentUs = timer.nsecsElapsed() / 1000;
+    timer.restart();
+    const QRectF sceneBounds = scene.itemsBoundingRect();
+    const qint64 sceneUs = timer.nsecsElapsed() / 1000;
+    qDebug() << "包围盒 首次:" << firstMs << "ms, 之后:" << documentUs << "us, itemsBoundingRect:" << sceneUs << "us";
+    if (first != documentBounds || documentBounds != sceneBounds) {
+        failures.fail("包围盒不一致", documentBounds, sceneBounds);
+    }
+
+    // 区域查询，与逐个比较场景包围盒对照
+    qint64 rectUs = 0;
+    for (int q = 0; q < QUERY_COUNT; ++q) {
+        const QRectF rect(random.bounded(20000), random.bounded(20000), 500, 500);
+        timer.restart();
+        const QVector<DrawingShape*> found = document->itemsInRect(rect);
+        rectUs += timer.nsecsElapsed() / 1000;
+        QSet<DrawingShape*> expected;
+        for (DrawingShape *shape : shapes) {
+            if (intersects(shape->sceneBoundingRect(), rect)) {
+                expected.insert(shape);
+            }
+        }
+        if (QSet<DrawingShape*>(found.begin(), found.end()) != expected) {
+            failures.fail("区域查询结果不一致", rect);
+            break;
+        }
+    }
+    qDebug() << "区域查询:" << rectUs / QUERY_COUNT << "us/次";
+
+    // 移动和改样式后只重新读取变化的图形
+    for (int i = 0; i < shapeCount; i += 100) {
+        shapes[i]->setPos(shapes[i]->pos() + QPointF(30000, 0));
+        shapes[i]->setFillBrush(QBrush(Qt::green));
+    }
+    timer.restart();
+    const QRectF moved = document->bounds();
+    qDebug() << "移动1%的图形后包围盒:" << timer.elapsed() << "ms";
+    if (moved != scene.itemsBoundingRect()) {
+        failures.fail("移动后包围盒没有更新");
+    }
+    const QVector<DrawingShape*> green = document->itemsWithStyle(shapes.front()->styleId());
+    if (green.size() != (shapeCount + 99) / 100) {
+        failures.fail("按样式查询数量", green.size());
+    }
+
+    // 快照与文档后续修改互不影响
+    const DrawingDocument::Snapshot snapshot = document->snapshot();
+    const DrawingDocument::Handle handle = shapes.front()->documentHandle();
+    if (document->shape(handle) != shapes.front()) {
+        failures.fail("句柄没有指向图形");
+    }
+    delete shapes.front();
+    DrawingRectangle *reused = new DrawingRectangle(QRectF(0, 0, 1, 1));
+    scene.addItem(reused);
+    if (document->isValid(handle) || document->shape(handle)) {
+        failures.fail("删除后旧句柄仍然有效");
+    }
+    if (snapshot.handles.size() != document->snapshot().handles.size() || !snapshot.handles.contains(handle)) {
+        failures.fail("快照被后续修改影响");
+    }
+    // 快照只保存句柄，删除的图形经文档取回时为空，不会悬空
+    int resolved = 0;
+    for (DrawingDocument::Handle snapshotHandle : snapshot.handles) {
+        resolved += document->shape(snapshotHandle) ? 1 : 0;
+    }
+    if (resolved != shapeCount - 1) {
+        failures.fail("快照中能取到的图形数", resolved, "应为", shapeCount - 1);
+    }
+
+    return failures.report();
+}
@@ -0,0 +1,177 @@
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QMouseEvent>
+#include <QRandomGenerator>
+#include <QUndoStack>
+#include <QtMath>
+#include <QDebug>
+#include "../src/core/drawing-shape.h"
+#include "../src/tools/drawing-tool-eraser.h"
+#include "../src/ui/drawingscene.h"
+#include "../src/ui/drawingview.h"
+#include "bench-common.h"
+
+// 默认的笔画数
+static const int DEFAULT_STROKE_COUNT = 3000;
+// 拖动的帧数和每帧的采样数
+static const int FRAME_COUNT = 120;
+static const int SAMPLES_PER_FRAME = 4;
+static const qreal FRAME_MS = 16.0;
+
+// 密集的手绘草图：随机的折线笔画，只有描边
+static void populateSketch(DrawingScene &scene, int strokeCount)
+{
+    QRandomGenerator random(3);
+    for (int i = 0; i < strokeCount; ++i) {
+        QPointF point(random.bounded(1200.0), random.bounded(800.0));
+        QPainterPath painterPath(point);
+        for (int k = 0; k < 30; ++k) {
+            point += QPointF(random.bounded(16.0) - 8.0, random.bounded(16.0) - 8.0);
+            painterPath.lineTo(point);
+        }
+        DrawingPath *path = new DrawingPath;
+        path->setPath(painterPath);
+        path->setStrokePen(QPen(Qt::black, 2.0, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
+        path->setFillBrush(Qt::NoBrush);
+        scene.addItem(path);
+    }
+}
+
+static int shapeCount(DrawingScene &scene)
+{
+    int count = 0;
+    for (QGraphicsItem *item : scene.items()) {
+        if (dynamic_cast<DrawingShape*>(item)) {
+            count++;
+        }
+    }
+    return count;
+}
+
+static void sendMouse(DrawingToolEraser &tool, QWidget *viewport, QEvent::Type type, const QPointF &pos, quint64 timestamp)
+{
+    const Qt::MouseButtons buttons = type == QEvent::MouseButtonRelease ? Qt::NoButton : Qt::LeftButton;
+    QMouseEvent event(type, pos, viewport->mapToGlobal(pos), Qt::LeftButton, buttons, Qt::NoModifier);
+    event.setTimestamp(timestamp);
+    if (type == QEvent::MouseButtonPress) {
+        tool.mousePressEvent(&event, pos);
+    } else if (type == QEvent::MouseMove) {
+        tool.mouseMoveEvent(&event, pos);
+    } else {
+        tool.mouseReleaseEvent(&event, pos);
+    }
+}
+
+// 点击处的擦除结果路径（替换路径的几何在图形本地坐标中）
+static DrawingPath *pathContaining(DrawingScene &scene, const QPointF &scenePos)
+{
+    for (QGraphicsItem *item : scene.items(scenePos)) {
+        DrawingPath *path = dynamic_cast<DrawingPath*>(item);
+        if (path && path->path().contains(path->mapFromScene(scenePos))) {
+            return path;
+        }
+    }
+    return nullptr;
+}
+
+int main(int argc, char *argv[])
+{
+    BenchCommon::useOffscreenPlatform();
+    QApplication app(argc, argv);
+
+    const int strokeCount = argc > 1 ? QString::fromLocal8Bit(argv[1]).toInt() : DEFAULT_STROKE_COUNT;
+
+    DrawingScene scene;
+    populateSketch(scene, strokeCount);
+    scene.setSceneRect(0, 0, 1200, 800);
+    DrawingView view(&scene);
+    view.resize(1200, 800);
+    view.show();
+    QApplication::processEvents();
+
+    DrawingToolEraser tool;
+    tool.activate(&scene, &view);
+    tool.setEraserMode(DrawingToolEraser::PartialErase);
+
+    const int before = shapeCount(scene);
+    qDebug() << "=== 局部擦除基准测试 ===" << "笔画数:" << before;
+
+    // 以60fps的节奏横穿草图拖动，记录每帧事件处理的最长耗时
+    QElapsedTimer clock;
+    clock.start();
+    QElapsedTimer stepTimer;
+    double worstStepMs = 0.0;
+    double totalMs = 0.0;
+    auto pump = [&](qreal budgetMs) {
+        const qint64 frameStart = clock.nsecsElapsed();
+        do {
+            stepTimer.start();
+            QApplication::processEvents(QEventLoop::AllEvents, 2);
+            const double stepMs = stepTimer.nsecsElapsed() / 1.0e6;
+            worstStepMs = qMax(worstStepMs, stepMs);
+            totalMs += stepMs;
+        } while ((clock.nsecsElapsed() - frameStart) / 1.0e6 < budgetMs);
+    };
+
+    QPointF position(50, 100);
+    sendMouse(tool, view.viewport(), QEvent::MouseButtonPress, position, 1);
+    for (int frame = 0; frame < FRAME_COUNT; ++frame) {
+        for (int k = 0; k < SAMPLES_PER_FRAME; ++k) {
+            const int index = frame * SAMPLES_PER_FRAME + k;
+            position = QPointF(50 + index * 2.3, 100 + 300 * qSin(index * 0.01));
+            sendMouse(tool, view.viewport(), QEvent::MouseMove, position, 2 + index * 4);
+        }
+        pump(FRAME_MS);
+    }
+    stepTimer.start();
+    sendMouse(tool, view.viewport(), QEvent::MouseButtonRelease, position, 2 + FRAME_COUNT * SAMPLES_PER_FRAME * 4);
+    const double releaseMs = stepTimer.nsecsElapsed() / 1.0e6;
+    pump(FRAME_MS);
+
+    const int after = shapeCount(scene);
+    qDebug() << "拖动中事件处理总耗时(ms):" << totalMs
+             << "单次最长(ms):" << worstStepMs
+             << "松开时(ms):" << releaseMs
+             << "擦除后图形数:" << after;
+
+    BenchCommon::Failures failures;
+    if (scene.undoStack()->count() != 1) {
+        failures.fail("一次拖动应生成一条撤销命令，实际", scene.undoStack()->count());
+    }
+    scene.undoStack()->undo();
+    if (shapeCount(scene) != before) {
+        failures.fail("撤销后图形数", shapeCount(scene), "应为", before);
+    }
+    scene.undoStack()->redo();
+    if (shapeCount(scene) != after) {
+        failures.fail("重做后图形数", shapeCount(scene), "应为", after);
+    }
+
+    // 擦断一条斜线：结果是线的描边轮廓，不是它的包围盒
+    DrawingLine *line = new DrawingLine(QLineF(1600, 100, 1800, 300));
+    line->setLineWidth(4.0);
+    scene.addItem(line);
+    quint64 timestamp = 10000;
+    sendMouse(tool, view.viewport(), QEvent::MouseButtonPress, QPointF(1700, 150), timestamp);
+    for (int y = 150; y <= 250; y += 10) {
+        timestamp += 4;
+        sendMouse(tool, view.viewport(), QEvent::MouseMove, QPointF(1700, y), timestamp);
+    }
+    sendMouse(tool, view.viewport(), QEvent::MouseButtonRelease, QPointF(1700, 250), timestamp + 4);
+    pump(FRAME_MS);
+    if (line->scene()) {
+        failures.fail("斜线没有被擦除");
+    }
+    if (!pathContaining(scene, QPointF(1620, 120)) || !pathContaining(scene, QPointF(1780, 280))) {
+        failures.fail("斜线两端没有保留");
+    }
+    if (pathContaining(scene, QPointF(1750, 150)) || pathContaining(scene, QPointF(1650, 250))) {
+        failures.fail("斜线被当作包围盒擦除");
+    }
+    if (pathContaining(scene, QPointF(1700, 200))) {
+        failures.fail("擦过的部分仍然存在");
+    }
+
+    tool.deactivate();
+    return failures.report();
+}
@@ -0,0 +1,110 @@
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QPainterPathStroker>
+#include <QtMath>
+#include <QDebug>
+#include "../src/core/drawing-shape.h"
+#include "bench-common.h"
+
+static const int DEFAULT_SEGMENT_COUNT = 50000;
+static const int QUERY_COUNT = 2000;
+// 原来的做法每次查询都重新描边，只抽查少量查询
+static const int STROKER_QUERY_COUNT = 20;
+static const qreal THRESHOLD = 5.0;
+
+// 平滑随机游走，模拟手绘的长路径
+static QPainterPath generatePath(int count)
+{
+    QRandomGenerator random(29);
+    QPainterPath path;
+    QPointF position(0, 0);
+    qreal heading = 0.0;
+    path.moveTo(position);
+    for (int i = 0; i < count; ++i) {
+        heading += (random.generateDouble() - 0.5) * 0.5;
+        position += QPointF(qCos(heading), qSin(heading)) * 2.0;
+        path.lineTo(position);
+    }
+    path.cubicTo(position + QPointF(100, 0), position + QPointF(100, 100), position + QPointF(0, 100));
+    return path;
+}
+
+// 原来的做法：按阈值描边后判断包含
+static bool strokerHitTest(const QPainterPath &path, const QPointF &pos, qreal threshold)
+{
+    QPainterPathStroker stroker;
+    stroker.setWidth(threshold * 2);
+    return stroker.createStroke(path).contains(pos);
+}
+
+int main(int argc, char *argv[])
+{
+    BenchCommon::useOffscreenPlatform();
+    QApplication app(argc, argv);
+
+    const int segmentCount = argc > 1 ? QString::fromLocal8Bit(argv[1]).toInt() : DEFAULT_SEGMENT_COUNT;
+    BenchCommon::Failures failures;
+
+    qDebug() << "=== 路径命中测试基准测试 ===";
+    const QPainterPath path = generatePath(segmentCount);
+    DrawingPath shape;
+    shape.setPath(path);
+
+    QRandomGenerator random(31);
+    const QRectF bounds = path.boundingRect();
+    QVector<QPointF> queries;
+    for (int i = 0; i < QUERY_COUNT; ++i) {
+        // 一半查询取在路径顶点附近，保证有足够的命中
+        if (i % 2 == 0) {
+            const QPainterPath::Element element = path.elementAt(random.bounded(path.elementCount()));
+            queries.append(QPointF(element.x, element.y)
+                           + QPointF(random.generateDouble() - 0.5, random.generateDouble() - 0.5) * 4 * THRESHOLD);
+        } else {
+            queries.append(QPointF(bounds.left() + random.generateDouble() * bounds.width(),
+                                   bounds.top() + random.generateDouble() * bounds.height()));
+        }
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    shape.isPointOnPath(queries.first(), THRESHOLD);
+    const double buildMs = timer.nsecsElapsed() / 1.0e6;
+
+    timer.start();
+    int hits = 0;
+    for (const QPointF &query : queries) {
+        if (shape.isPointOnPath(query, THRESHOLD)) {
+            hits++;
+        }
+    }
+    const double queryUs = timer.nsecsElapsed() / 1.0e3 / queries.size();
+
+    timer.start();
+    for (int i = 0; i < STROKER_QUERY_COUNT; ++i) {
+        const bool expected = strokerHitTest(path, queries[i], THRESHOLD);
+        // 描边轮廓在拐角处与距离判定略有出入，只比较离边界较远的点
+        const bool inner = shape.isPointOnPath(queries[i], THRESHOLD * 0.9);
+        const bool outer = shape.isPointOnPath(queries[i], THRESHOLD * 1.1);
+        if ((inner && !expected) || (!outer && expected)) {
+            failures.fail("命中结果与描边判定不一致", queries[i]);
+        }
+    }
+    const double strokerMs = timer.nsecsElapsed() / 1.0e6 / STROKER_QUERY_COUNT;
+
+    qDebug().noquote() << QString("%1 段: 首次查询建树 %2 ms, 每次查询 %3 us (命中 %4/%5), 描边判定每次 %6 ms")
+                          .arg(segmentCount).arg(buildMs, 0, 'f', 2).arg(queryUs, 0, 'f', 2)
+                          .arg(hits).arg(queries.size()).arg(strokerMs, 0, 'f', 2);
+    if (hits == 0 || hits == queries.size()) {
+        failures.fail("命中数不合理");
+    }
+
+    // 修改路径后结构作废，按新路径判定
+    QPainterPath moved = path.translated(100000, 0);
+    shape.setPath(moved);
+    if (shape.isPointOnPath(path.elementAt(0), THRESHOLD) || !shape.isPointOnPath(moved.elementAt(0), THRESHOLD)) {
+        failures.fail("setPath之后没有重建命中测试结构");
+    }
+
+    return failures.report();
+}
@@ -0,0 +1,168 @@
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QMouseEvent>
+#include <QRandomGenerator>
+#include <QtMath>
+#include <QDebug>
+#include <algorithm>
+#include "../src/core/input-pipeline.h"
+#include "../src/tools/drawing-tool-brush.h"
+#include "../src/ui/drawingscene.h"
+#include "../src/ui/drawingview.h"
+#include "bench-common.h"
+
+// 每种场景的采样数
+static const int SAMPLE_COUNT = 600;
+
+/**
+ * 记录视口完成的重绘次数
+ */
+class PaintCounter : public QObject
+{
+public:
+    int paints = 0;
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override
+    {
+        if (event->type() == QEvent::Paint) {
+            paints++;
+        }
+        return QObject::eventFilter(watched, event);
+    }
+};
+
+static QPointF strokePosition(int i)
+{
+    return QPointF(100 + i * 1.5, 300 + 120 * qSin(i * 0.05));
+}
+
+static void postMouse(QWidget *viewport, QEvent::Type type, const QPointF &pos, quint64 timestamp)
+{
+    const Qt::MouseButtons buttons = type == QEvent::MouseButtonRelease ? Qt::NoButton : Qt::LeftButton;
+    QMouseEvent *event = new QMouseEvent(type, pos, viewport->mapToGlobal(pos), Qt::LeftButton, buttons, Qt::NoModifier);
+    event->setTimestamp(timestamp);
+    QCoreApplication::postEvent(viewport, event);
+}
+
+// 从投递输入事件到视口画完这一帧的延迟；eventsPerFrame模拟高回报率设备一帧内的多个采样
+static void measureLatency(int eventsPerFrame)
+{
+    DrawingScene scene;
+    scene.setSceneRect(0, 0, 1200, 800);
+    DrawingView view(&scene);
+    view.resize(1200, 800);
+    view.show();
+    QApplication::processEvents();
+
+    DrawingToolBrush tool;
+    tool.activate(&scene, &view);
+    view.setCurrentTool(&tool);
+
+    PaintCounter counter;
+    view.viewport()->installEventFilter(&counter);
+
+    QElapsedTimer clock;
+    clock.start();
+    postMouse(view.viewport(), QEvent::MouseButtonPress, strokePosition(0), 1);
+    QApplication::processEvents();
+
+    QVector<double> latencies;
+    const int frames = SAMPLE_COUNT / eventsPerFrame;
+    for (int frame = 0; frame < frames; ++frame) {
+        const int paintsBefore = counter.paints;
+        const qint64 start = clock.nsecsElapsed();
+        for (int k = 0; k < eventsPerFrame; ++k) {
+            const int index = 1 + frame * eventsPerFrame + k;
+            postMouse(view.viewport(), QEvent::MouseMove, strokePosition(index), 1 + index * 2);
+        }
+        // 等到视口画完包含这批采样的一帧
+        while (counter.paints == paintsBefore && clock.nsecsElapsed() - start < 1000000000LL) {
+            QApplication::processEvents();
+        }
+        latencies.append((clock.nsecsElapsed() - start) / 1.0e6);
+    }
+    postMouse(view.viewport(), QEvent::MouseButtonRelease, strokePosition(frames * eventsPerFrame), 2 + frames * eventsPerFrame * 2);
+    QApplication::processEvents();
+
+    std::sort(latencies.begin(), latencies.end());
+    double total = 0.0;
+    for (double latency : latencies) {
+        total += latency;
+    }
+    qDebug() << "每帧采样数:" << eventsPerFrame
+             << "平均延迟(ms):" << total / latencies.size()
+             << "p50(ms):" << latencies[latencies.size() / 2]
+             << "p95(ms):" << latencies[latencies.size() * 95 / 100]
+             << "最大(ms):" << latencies.last();
+
+    view.viewport()->removeEventFilter(&counter);
+    tool.deactivate();
+    view.setCurrentTool(nullptr);
+}
+
+// 管线不丢采样，滤波器降低抖动，返回失败数
+static int checkPipeline()
+{
+    BenchCommon::Failures failures;
+    InputPipeline pipeline;
+    QVector<InputSample> delivered;
+    QObject::connect(&pipeline, &InputPipeline::samplesReady, [&delivered](const QVector<InputSample> &samples) {
+        delivered += samples;
+    });
+
+    QRandomGenerator random(7);
+    auto makeEvent = [](quint64 timestamp) {
+        QMouseEvent *event = new QMouseEvent(QEvent::MouseMove, QPointF(), QPointF(), Qt::NoButton, Qt::LeftButton, Qt::NoModifier);
+        event->setTimestamp(timestamp);
+        return event;
+    };
+
+    // 缓慢移动的直线加±1.5像素的抖动，4ms一个采样
+    QMouseEvent *pressEvent = makeEvent(1);
+    pipeline.begin(pressEvent, QPointF(0, 0));
+    delete pressEvent;
+    for (int i = 1; i < SAMPLE_COUNT; ++i) {
+        QMouseEvent *event = makeEvent(1 + i * 4);
+        const QPointF noise(random.bounded(3.0) - 1.5, random.bounded(3.0) - 1.5);
+        pipeline.addSample(event, QPointF(i * 0.2, 0) + noise);
+        delete event;
+        if (i % 7 == 0) {
+            QCoreApplication::processEvents();
+        }
+    }
+    pipeline.flush();
+
+    if (delivered.size() != SAMPLE_COUNT - 1 || pipeline.deliveredCount() != pipeline.receivedCount()) {
+        failures.fail("收到", pipeline.receivedCount(), "个采样，交出", pipeline.deliveredCount());
+    }
+
+    double rawError = 0.0;
+    double filteredError = 0.0;
+    for (int i = 0; i < delivered.size(); ++i) {
+        rawError += qPow(delivered[i].rawPosition.y(), 2);
+        filteredError += qPow(delivered[i].position.y(), 2);
+    }
+    rawError = qSqrt(rawError / delivered.size());
+    filteredError = qSqrt(filteredError / delivered.size());
+    qDebug() << "抖动RMS(像素) 原始:" << rawError << "滤波后:" << filteredError;
+    if (filteredError >= rawError) {
+        failures.fail("滤波没有降低抖动");
+    }
+    return failures.count();
+}
+
+int main(int argc, char *argv[])
+{
+    BenchCommon::useOffscreenPlatform();
+    QApplication app(argc, argv);
+
+    qDebug() << "=== 绘图输入延迟基准测试 ===";
+    BenchCommon::Failures failures;
+    failures += checkPipeline();
+    measureLatency(1);
+    measureLatency(4);
+    measureLatency(16);
+
+    return failures.report();
+}
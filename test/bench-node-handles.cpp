@@ -0,0 +1,151 @@
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QGraphicsView>
+#include <QtMath>
+#include <QDebug>
+#include "../src/core/drawing-shape.h"
+#include "../src/ui/drawingscene.h"
+#include "../src/tools/node-handle-manager.h"
+#include "../src/tools/node-handle-layer.h"
+#include "bench-common.h"
+
+// 描摹地图轮廓一类的长路径：节点数
+static const int DEFAULT_NODE_COUNT = 40000;
+static const int FRAME_COUNT = 20;
+static const int QUERY_COUNT = 20000;
+
+// 半径带起伏的闭合折线
+static QPainterPath generateOutline(int count)
+{
+    QPainterPath path;
+    for (int i = 0; i < count; ++i) {
+        const qreal angle = 2 * M_PI * i / count;
+        const qreal radius = 2000.0 * (1.0 + 0.05 * qSin(angle * 37) + 0.02 * qSin(angle * 311));
+        const QPointF point(radius * qCos(angle), radius * qSin(angle));
+        if (i == 0) {
+            path.moveTo(point);
+        } else {
+            path.lineTo(point);
+        }
+    }
+    path.closeSubpath();
+    return path;
+}
+
+// 原来的做法：逐个比较所有控制点
+static int linearFindNode(const QVector<QPointF> &points, const QPointF &pos, qreal threshold)
+{
+    for (int i = 0; i < points.size(); ++i) {
+        const QPointF d = pos - points[i];
+        if (d.x() * d.x() + d.y() * d.y() <= threshold * threshold) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static double measureFrames(QGraphicsView &view)
+{
+    view.viewport()->repaint();
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < FRAME_COUNT; ++i) {
+        view.viewport()->repaint();
+    }
+    return timer.nsecsElapsed() / 1.0e6 / FRAME_COUNT;
+}
+
+int main(int argc, char *argv[])
+{
+    BenchCommon::useOffscreenPlatform();
+    QApplication app(argc, argv);
+
+    const int nodeCount = argc > 1 ? QString::fromLocal8Bit(argv[1]).toInt() : DEFAULT_NODE_COUNT;
+    BenchCommon::Failures failures;
+
+    qDebug() << "=== 节点手柄基准测试 ===";
+    DrawingScene scene;
+    DrawingPath *path = new DrawingPath;
+    path->setPath(generateOutline(nodeCount));
+    path->setFillBrush(Qt::NoBrush);
+    scene.addItem(path);
+
+    QGraphicsView view(&scene);
+    view.resize(1280, 800);
+    view.show();
+    QApplication::processEvents();
+
+    // 进入节点编辑：显示控制点并创建手柄
+    NodeHandleManager manager(&scene);
+    QElapsedTimer timer;
+    timer.start();
+    path->setShowControlPolygon(true);
+    manager.updateHandles(path);
+    const double enterMs = timer.nsecsElapsed() / 1.0e6;
+    NodeHandleLayer *layer = path->nodeHandleLayer();
+    qDebug().noquote() << QString("%1 个节点: 进入节点编辑 %2 ms, 手柄项 %3 个")
+                          .arg(path->getNodePointCount()).arg(enterMs, 0, 'f', 2).arg(manager.getAllHandles().size());
+    if (!layer || !manager.getAllHandles().isEmpty()) {
+        failures.fail("路径应由一个手柄层显示节点，不创建逐节点的手柄项");
+        return failures.report();
+    }
+
+    // 全图和放大到局部两种视图下的重绘耗时和绘制的手柄数
+    view.fitInView(scene.itemsBoundingRect(), Qt::KeepAspectRatio);
+    const double overviewMs = measureFrames(view);
+    const int overviewHandles = layer->paintedHandleCount();
+    view.resetTransform();
+    view.scale(4, 4);
+    view.centerOn(path->controlPoints().first());
+    const double detailMs = measureFrames(view);
+    const int detailHandles = layer->paintedHandleCount();
+    qDebug().noquote() << QString("  全图: 每帧 %1 ms, 绘制 %2 个手柄; 放大: 每帧 %3 ms, 绘制 %4 个手柄")
+                          .arg(overviewMs, 0, 'f', 2).arg(overviewHandles).arg(detailMs, 0, 'f', 2).arg(detailHandles);
+    if (detailHandles <= 0 || detailHandles >= nodeCount / 10) {
+        failures.fail("放大后应只绘制视口内的少量手柄");
+    }
+
+    // 节点拾取：网格索引与逐个比较的结果一致
+    const QVector<QPointF> points = path->controlPoints();
+    QVector<QPointF> queries;
+    for (int i = 0; i < QUERY_COUNT; ++i) {
+        const QPointF base = points[(i * 7919) % points.size()];
+        queries.append(base + QPointF((i % 11) - 5, (i % 13) - 6));
+    }
+    timer.start();
+    int found = 0;
+    for (const QPointF &query : queries) {
+        if (path->findNodeAt(query, 8.0) >= 0) {
+            found++;
+        }
+    }
+    const double gridUs = timer.nsecsElapsed() / 1.0e3 / queries.size();
+    timer.start();
+    int mismatches = 0;
+    for (int i = 0; i < 200; ++i) {
+        if (linearFindNode(points, queries[i], 8.0) != path->findNodeAt(queries[i], 8.0)) {
+            mismatches++;
+        }
+    }
+    const double linearUs = timer.nsecsElapsed() / 1.0e3 / 200;
+    qDebug().noquote() << QString("  拾取: 网格每次 %1 us (命中 %2/%3), 逐个比较每次 %4 us")
+                          .arg(gridUs, 0, 'f', 2).arg(found).arg(queries.size()).arg(linearUs, 0, 'f', 2);
+    if (mismatches > 0) {
+        failures.fail("网格拾取与逐个比较的结果不同", mismatches);
+    }
+
+    // 移动节点后网格重建
+    const QPointF moved = points[0] + QPointF(500, 500);
+    path->setNodePoint(0, moved);
+    if (path->findNodeAt(moved, 1.0) != 0) {
+        failures.fail("移动节点后拾取不到新位置");
+    }
+
+    // 退出节点编辑时删除手柄层
+    manager.clearHandles();
+    if (path->nodeHandleLayer()) {
+        failures.fail("清除手柄后手柄层仍然存在");
+    }
+
+    return failures.report();
+}
@@ -0,0 +1,133 @@
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QLineF>
+#include <QtMath>
+#include <QDebug>
+#include "../src/core/drawing-shape.h"
+#include "../src/ui/drawingscene.h"
+#include "bench-common.h"
+
+// 每个规模模拟的拖动次数
+static const int MOVE_COUNT = 2000;
+// 校验时与线性扫描对比的查询次数
+static const int CHECK_COUNT = 500;
+
+// 原来的做法：遍历所有图形生成吸附点后线性查找，作为对照和正确性基准
+static bool linearNearest(DrawingScene &scene, const QPointF &pos, qreal maxDistance,
+                          DrawingShape *excludeShape, qreal &bestDistance)
+{
+    bestDistance = maxDistance;
+    bool found = false;
+    for (QGraphicsItem *item : scene.items()) {
+        DrawingShape *shape = dynamic_cast<DrawingShape*>(item);
+        if (!shape || shape == excludeShape || !shape->isVisible()) {
+            continue;
+        }
+
+        QRectF bounds = shape->mapRectToScene(shape->boundingRect());
+        QPointF center = bounds.center();
+        const QPointF points[9] = {
+            bounds.topLeft(), bounds.topRight(), bounds.bottomLeft(), bounds.bottomRight(), center,
+            QPointF(bounds.left(), center.y()), QPointF(bounds.right(), center.y()),
+            QPointF(center.x(), bounds.top()), QPointF(center.x(), bounds.bottom())
+        };
+        for (const QPointF &point : points) {
+            qreal distance = QLineF(pos, point).length();
+            if (distance < bestDistance) {
+                bestDistance = distance;
+                found = true;
+            }
+        }
+    }
+    return found;
+}
+
+static bool benchmark(int shapeCount)
+{
+    DrawingScene scene;
+    scene.setObjectSnapTolerance(6);
+    QRandomGenerator random(7);
+    const qreal extent = 40.0 * qSqrt(shapeCount);
+    auto coordinate = [&random, extent]() { return random.bounded(extent); };
+
+    QList<DrawingShape*> shapes;
+    for (int i = 0; i < shapeCount; ++i) {
+        DrawingRectangle *rect = new DrawingRectangle(QRectF(0, 0, 5 + random.bounded(30), 5 + random.bounded(30)));
+        rect->setPos(coordinate(), coordinate());
+        scene.addItem(rect);
+        shapes.append(rect);
+    }
+
+    // 首次查询建立索引
+    QElapsedTimer timer;
+    timer.start();
+    scene.snapToObjects(QPointF(0, 0));
+    const double buildMs = timer.nsecsElapsed() / 1.0e6;
+
+    // 拖动：每次移动被拖动的图形（移动时经itemChange吸附），再查询鼠标位置的吸附点
+    DrawingShape *dragged = shapes.first();
+    timer.restart();
+    for (int i = 0; i < MOVE_COUNT; ++i) {
+        const QPointF pos(coordinate(), coordinate());
+        dragged->setPos(pos);
+        scene.snapToObjects(pos, dragged);
+    }
+    const double moveUs = timer.nsecsElapsed() / 1.0e3 / MOVE_COUNT;
+
+    // 与线性扫描比较最近距离
+    bool ok = true;
+    const qreal maxDistance = scene.objectSnapTolerance() + 1;
+    double linearUs = 0;
+    for (int i = 0; i < CHECK_COUNT && ok; ++i) {
+        // 一半的查询落在吸附点附近，保证有命中
+        QPointF pos(coordinate(), coordinate());
+        if (i % 2 == 0) {
+            pos = shapes[random.bounded(shapeCount)]->sceneBoundingRect().topLeft()
+                + QPointF(random.bounded(4.0) - 2.0, random.bounded(4.0) - 2.0);
+        }
+
+        DrawingScene::ObjectSnapResult result = scene.snapToObjects(pos, dragged);
+        timer.restart();
+        qreal linearDistance = 0;
+        const bool linearFound = linearNearest(scene, pos, maxDistance, dragged, linearDistance);
+        linearUs += timer.nsecsElapsed() / 1.0e3;
+
+        // snapToObjects只接受容差一半以内的吸附
+        const bool expected = linearFound && linearDistance <= scene.objectSnapTolerance() * 0.5;
+        if (result.snappedToObject != expected
+            || (expected && !qFuzzyCompare(1.0 + QLineF(pos, result.snappedPos).length(), 1.0 + linearDistance))) {
+            qDebug() << "  结果不一致:" << pos << result.snappedToObject << result.snappedPos << linearDistance;
+            ok = false;
+        }
+    }
+    linearUs /= CHECK_COUNT;
+
+    qDebug() << "图形数:" << shapeCount
+             << "建立索引(ms):" << buildMs
+             << "每次拖动(us):" << moveUs
+             << "线性扫描每次查询(us):" << linearUs
+             << (ok ? "" : "结果校验失败");
+    return ok;
+}
+
+int main(int argc, char *argv[])
+{
+    QApplication app(argc, argv);
+
+    QList<int> shapeCounts;
+    for (int i = 1; i < argc; ++i) {
+        shapeCounts.append(QString::fromLocal8Bit(argv[i]).toInt());
+    }
+    if (shapeCounts.isEmpty()) {
+        shapeCounts << 1000 << 5000 << 20000 << 100000;
+    }
+
+    qDebug() << "=== 对象吸附延迟基准测试 ===";
+
+    BenchCommon::Failures failures;
+    for (int shapeCount : shapeCounts) {
+        failures += !benchmark(shapeCount);
+    }
+    return failures.report();
+}
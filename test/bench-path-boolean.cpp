@@ -0,0 +1,189 @@
+#include <QApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QtMath>
+#include <QDebug>
+#include "../src/core/path-boolean.h"
+#include "../src/core/patheditor.h"
+#include "../src/core/svghandler.h"
+#include "../src/core/drawing-shape.h"
+#include "../src/core/layer-manager.h"
+#include "../src/ui/drawingscene.h"
+#include "bench-common.h"
+
+// 生成的压力测试：操作数个数，以及QPainterPath逐个合并作为对照时使用的个数
+static const int DEFAULT_STRESS_COUNT = 5000;
+static const int QT_BASELINE_COUNT = 200;
+// 比较结果时的采样网格
+static const int SAMPLE_GRID = 80;
+// 采样点允许不一致的比例（只会出现在边界附近）
+static const qreal MAX_MISMATCH = 0.02;
+
+// 逐个合并的QPainterPath实现（原来的做法），异或按三次运算计算
+static QPainterPath qtCombine(const QList<QPainterPath> &paths, PathEditor::BooleanOperation op)
+{
+    QPainterPath result = paths.first();
+    result.setFillRule(Qt::OddEvenFill);
+    for (int i = 1; i < paths.size(); ++i) {
+        QPainterPath next = paths[i];
+        next.setFillRule(Qt::OddEvenFill);
+        switch (op) {
+        case PathEditor::Union: result = result.united(next); break;
+        case PathEditor::Intersection: result = result.intersected(next); break;
+        case PathEditor::Subtraction: result = result.subtracted(next); break;
+        case PathEditor::Xor: result = result.united(next).subtracted(result.intersected(next)); break;
+        }
+    }
+    return result;
+}
+
+static qreal mismatchRatio(const QPainterPath &a, const QPainterPath &b)
+{
+    const QRectF bounds = a.boundingRect() | b.boundingRect();
+    if (bounds.isEmpty()) {
+        return 0.0;
+    }
+    int mismatches = 0;
+    for (int row = 0; row < SAMPLE_GRID; ++row) {
+        for (int column = 0; column < SAMPLE_GRID; ++column) {
+            // 采样点错开半格，避免正好落在水平或竖直边上
+            const QPointF point(bounds.left() + (column + 0.37) * bounds.width() / SAMPLE_GRID,
+                                bounds.top() + (row + 0.61) * bounds.height() / SAMPLE_GRID);
+            if (a.contains(point) != b.contains(point)) {
+                mismatches++;
+            }
+        }
+    }
+    return qreal(mismatches) / (SAMPLE_GRID * SAMPLE_GRID);
+}
+
+static const char *operationName(PathEditor::BooleanOperation op)
+{
+    switch (op) {
+    case PathEditor::Union: return "合并";
+    case PathEditor::Intersection: return "相交";
+    case PathEditor::Subtraction: return "减去";
+    case PathEditor::Xor: return "异或";
+    }
+    return "";
+}
+
+// 对同一组操作数分别用两种实现计算，返回是否一致
+static bool compare(const QString &label, const QList<QPainterPath> &paths, PathEditor::BooleanOperation op)
+{
+    QElapsedTimer timer;
+    timer.start();
+    const QPainterPath reference = qtCombine(paths, op);
+    const double qtMs = timer.nsecsElapsed() / 1.0e6;
+
+    timer.start();
+    const QPainterPath result = PathBoolean::combine(paths, op);
+    const double nativeMs = timer.nsecsElapsed() / 1.0e6;
+
+    const qreal mismatch = mismatchRatio(reference, result);
+    qDebug().noquote() << QString("  %1 %2: 操作数 %3, QPainterPath %4 ms, 扫描线 %5 ms, 元素 %6/%7, 不一致 %8%")
+                          .arg(label).arg(operationName(op)).arg(paths.size())
+                          .arg(qtMs, 0, 'f', 2).arg(nativeMs, 0, 'f', 2)
+                          .arg(reference.elementCount()).arg(result.elementCount())
+                          .arg(mismatch * 100, 0, 'f', 2);
+    if (mismatch > MAX_MISMATCH) {
+        qDebug() << "  FAIL:" << label << operationName(op) << "结果与QPainterPath不一致";
+        return false;
+    }
+    return true;
+}
+
+// 导入SVG后取出所有有填充的图形（场景坐标）
+static QList<QPainterPath> loadFilledPaths(const QString &fileName)
+{
+    QList<QPainterPath> paths;
+    DrawingScene scene;
+    LayerManager::instance()->setScene(&scene);
+    if (SvgHandler::importFromSvg(&scene, fileName)) {
+        for (QGraphicsItem *item : scene.items()) {
+            DrawingShape *shape = dynamic_cast<DrawingShape*>(item);
+            if (!shape || item->type() != QGraphicsItem::UserType + 2 || shape->fillBrush().style() == Qt::NoBrush) {
+                continue;
+            }
+            QPainterPath path = shape->sceneTransform().map(shape->transformedShape());
+            // 与QPainterPath对照时统一使用奇偶填充
+            path.setFillRule(Qt::OddEvenFill);
+            if (!path.isEmpty()) {
+                paths.append(path);
+            }
+        }
+    }
+    LayerManager::destroyInstance();
+    return paths;
+}
+
+// 随机分布的圆和星形，有大量重叠
+static QList<QPainterPath> generateShapes(int count)
+{
+    QRandomGenerator random(11);
+    const qreal extent = qSqrt(count) * 40.0;
+    QList<QPainterPath> paths;
+    for (int i = 0; i < count; ++i) {
+        const QPointF center(random.bounded(extent), random.bounded(extent));
+        const qreal radius = 10.0 + random.bounded(30.0);
+        QPainterPath path;
+        if (i % 2 == 0) {
+            path.addEllipse(center, radius, radius * 0.7);
+        } else {
+            path = PathEditor::createStar(center, radius, 5 + i % 4);
+        }
+        path.setFillRule(Qt::OddEvenFill);
+        paths.append(path);
+    }
+    return paths;
+}
+
+int main(int argc, char *argv[])
+{
+    BenchCommon::useOffscreenPlatform();
+    QApplication app(argc, argv);
+
+    const int stressCount = argc > 1 ? QString::fromLocal8Bit(argv[1]).toInt() : DEFAULT_STRESS_COUNT;
+    BenchCommon::Failures failures;
+
+    qDebug() << "=== 布尔运算基准测试 ===";
+    const QList<PathEditor::BooleanOperation> operations = {
+        PathEditor::Union, PathEditor::Intersection, PathEditor::Subtraction, PathEditor::Xor
+    };
+
+    QDir dir(VECTORQT_SVG_TEST_DIR);
+    for (const QString &file : dir.entryList(QStringList() << "*.svg", QDir::Files, QDir::Name)) {
+        const QList<QPainterPath> paths = loadFilledPaths(dir.absoluteFilePath(file));
+        if (paths.size() < 2) {
+            continue;
+        }
+        for (PathEditor::BooleanOperation op : operations) {
+            failures += !compare(file, paths, op);
+        }
+    }
+
+    // 生成的输入：小规模与QPainterPath对比结果和耗时
+    const QList<QPainterPath> shapes = generateShapes(stressCount);
+    const QList<QPainterPath> baseline = shapes.mid(0, QT_BASELINE_COUNT);
+    for (PathEditor::BooleanOperation op : operations) {
+        failures += !compare("生成图形", op == PathEditor::Intersection ? baseline.mid(0, 3) : baseline, op);
+    }
+
+    // 大规模合并：单线程与按连通分组并行
+    QElapsedTimer timer;
+    timer.start();
+    const QPainterPath sequential = PathBoolean::combine(shapes, PathEditor::Union, 0.1, false);
+    const double sequentialMs = timer.nsecsElapsed() / 1.0e6;
+    timer.start();
+    const QPainterPath parallel = PathBoolean::combine(shapes, PathEditor::Union, 0.1, true);
+    const double parallelMs = timer.nsecsElapsed() / 1.0e6;
+    const qreal mismatch = mismatchRatio(sequential, parallel);
+    qDebug() << "合并" << shapes.size() << "个图形: 单线程" << sequentialMs << "ms, 并行" << parallelMs
+             << "ms, 结果元素" << sequential.elementCount() << "不一致比例" << mismatch;
+    if (mismatch > MAX_MISMATCH) {
+        failures.fail("并行结果与单线程不一致");
+    }
+
+    return failures.report();
+}
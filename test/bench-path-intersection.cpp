@@ -0,0 +1,145 @@
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QLineF>
+#include <QtMath>
+#include <QDebug>
+#include "../src/core/path-intersection.h"
+#include "../src/core/patheditor.h"
+#include "bench-common.h"
+
+// 网格的横线、竖线条数，每条由GRID_SIZE段折线组成，共2*GRID_SIZE²条线段
+static const int DEFAULT_GRID_SIZE = 400;
+static const int RANDOM_SEGMENT_COUNT = 300;
+static const qreal TOLERANCE = 0.1;
+
+// 稍有起伏的横竖折线网格，模拟道路网：每条横线与每条竖线恰好相交一次
+static QList<QPainterPath> generateGrid(int size)
+{
+    QList<QPainterPath> paths;
+    for (int i = 0; i < size; ++i) {
+        QPainterPath horizontal;
+        horizontal.moveTo(0, i + 0.5);
+        QPainterPath vertical;
+        vertical.moveTo(i + 0.3, 0);
+        for (int s = 1; s <= size; ++s) {
+            horizontal.lineTo(s, i + 0.5 + ((i + s) % 3) * 0.1);
+            vertical.lineTo(i + 0.3 + ((i + s) % 3) * 0.1, s);
+        }
+        paths.append(horizontal);
+        paths.append(vertical);
+    }
+    return paths;
+}
+
+// 暴力求交：逐对测试，端点落在另一条线段上也算相交
+static int bruteForceCount(const QList<QLineF> &lines)
+{
+    int count = 0;
+    for (int i = 0; i < lines.size(); ++i) {
+        for (int j = i + 1; j < lines.size(); ++j) {
+            QPointF point;
+            if (lines[i].intersects(lines[j], &point) == QLineF::BoundedIntersection) {
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+static QPainterPath circle(const QPointF &center, qreal radius)
+{
+    QPainterPath path;
+    path.addEllipse(center, radius, radius);
+    return path;
+}
+
+int main(int argc, char *argv[])
+{
+    BenchCommon::useOffscreenPlatform();
+    QApplication app(argc, argv);
+
+    const int gridSize = argc > 1 ? QString::fromLocal8Bit(argv[1]).toInt() : DEFAULT_GRID_SIZE;
+    BenchCommon::Failures failures;
+
+    qDebug() << "=== 路径求交基准测试 ===";
+
+    // 网格：一次扫描求出所有交点
+    const QList<QPainterPath> grid = generateGrid(gridSize);
+    QElapsedTimer timer;
+    timer.start();
+    const QVector<PathIntersection::Hit> hits = PathIntersection::findAll(grid, TOLERANCE);
+    const double gridMs = timer.nsecsElapsed() / 1.0e6;
+    qDebug().noquote() << QString("网格 %1 条线段: %2 个交点, %3 ms")
+                          .arg(2 * gridSize * gridSize).arg(hits.size()).arg(gridMs, 0, 'f', 2);
+    if (hits.size() != gridSize * gridSize) {
+        failures.fail("网格交点数应为", gridSize * gridSize);
+    }
+
+    // 随机线段与暴力求交对照，端点取整数坐标以覆盖竖直线段和端点重合的情况
+    QRandomGenerator random(23);
+    for (int trial = 0; trial < 20; ++trial) {
+        QList<QPainterPath> paths;
+        QList<QLineF> lines;
+        for (int i = 0; i < RANDOM_SEGMENT_COUNT; ++i) {
+            const QPointF a(random.bounded(100), random.bounded(100));
+            const QPointF b = i % 3 == 0 ? QPointF(a.x(), random.bounded(100))
+                                         : QPointF(random.bounded(100), random.bounded(100));
+            if (a == b) {
+                continue;
+            }
+            QPainterPath path;
+            path.moveTo(a);
+            path.lineTo(b);
+            paths.append(path);
+            lines.append(QLineF(a, b));
+        }
+        const int expected = bruteForceCount(lines);
+        const int found = PathIntersection::findAll(paths, TOLERANCE).size();
+        if (found != expected) {
+            failures.fail("随机线段第", trial, "组交点数", found, "暴力求交", expected);
+        }
+    }
+
+    // 圆与直线：交点在曲线上求精，误差远小于展平容差
+    QPainterPath line(QPointF(-100, 10));
+    line.lineTo(100, 10);
+    const QList<QPointF> circleLine = PathEditor::getIntersectionPoints(circle(QPointF(0, 0), 50), line);
+    qDebug() << "圆与直线:" << circleLine;
+    if (circleLine.size() != 2) {
+        failures.fail("圆与直线应有2个交点");
+    }
+    for (const QPointF &point : circleLine) {
+        // 三次贝塞尔近似的圆半径误差约为万分之三
+        if (qAbs(QLineF(QPointF(0, 0), point).length() - 50) > 0.02 || qAbs(point.y() - 10) > 1e-6) {
+            failures.fail("圆与直线交点不在两条路径上", point);
+        }
+    }
+
+    // 圆与圆：两条曲线之间的交点
+    const QList<QPointF> circleCircle = PathEditor::intersections(circle(QPointF(0, 0), 50), circle(QPointF(60, 0), 50));
+    qDebug() << "圆与圆:" << circleCircle;
+    if (circleCircle.size() != 2) {
+        failures.fail("两圆应有2个交点");
+    }
+    for (const QPointF &point : circleCircle) {
+        if (qAbs(point.x() - 30) > 0.02 || qAbs(qAbs(point.y()) - 40) > 0.02) {
+            failures.fail("两圆交点偏离(30, ±40)", point);
+        }
+    }
+
+    // 自相交：8字形路径
+    QPainterPath figureEight;
+    figureEight.moveTo(0, 0);
+    figureEight.lineTo(10, 10);
+    figureEight.lineTo(10, 0);
+    figureEight.lineTo(0, 10);
+    figureEight.closeSubpath();
+    const QVector<PathIntersection::Hit> selfHits = PathIntersection::findAll(QList<QPainterPath>() << figureEight,
+                                                                              TOLERANCE, true);
+    if (selfHits.size() != 1 || QLineF(selfHits.first().point, QPointF(5, 5)).length() > 1e-9) {
+        failures.fail("8字形路径应在(5, 5)自相交一次");
+    }
+
+    return failures.report();
+}
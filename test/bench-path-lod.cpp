@@ -0,0 +1,241 @@
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QGraphicsView>
+#include <QPolygonF>
+#include <QStringList>
+#include <QtMath>
+#include <QDebug>
+#include <cmath>
+#include <limits>
+#include "../src/core/drawing-shape.h"
+#include "../src/core/layer-manager.h"
+#include "../src/core/svghandler.h"
+#include "../src/ui/drawingscene.h"
+#include "bench-common.h"
+
+// 每种缩放比例测量的帧数
+static const int FRAME_COUNT = 30;
+// 生成场景中每条等高线的折线段数
+static const int CONTOUR_SEGMENTS = 400;
+// 正确性检查覆盖的最深层级（缩小到1/256）
+static const int CHECK_LEVEL_COUNT = 8;
+// 距离比较的浮点余量
+static const qreal DISTANCE_EPSILON = 1e-6;
+
+// 第index条图纸路径：每4条中一条带圆角的零件轮廓，其余为等高线
+static QPainterPath createDrawingPath(QRandomGenerator &random, int index, qreal extent)
+{
+    QPainterPath painterPath;
+    const QPointF center(random.bounded(extent), random.bounded(extent));
+    const qreal radius = 40 + random.bounded(160.0);
+
+    if (index % 4 == 0) {
+        // 零件轮廓：由曲线组成的闭合外形和一个圆孔
+        painterPath.addRoundedRect(QRectF(center, QSizeF(radius * 2, radius)), radius / 5, radius / 5);
+        painterPath.addEllipse(center + QPointF(radius, radius / 2), radius / 6, radius / 6);
+    } else {
+        // 等高线：半径带噪声的闭合折线
+        for (int k = 0; k <= CONTOUR_SEGMENTS; ++k) {
+            const qreal angle = 2 * M_PI * k / CONTOUR_SEGMENTS;
+            const qreal r = radius * (1.0 + 0.1 * qSin(angle * 7) + random.bounded(0.02));
+            const QPointF point = center + QPointF(r * qCos(angle), r * qSin(angle));
+            if (k == 0) {
+                painterPath.moveTo(point);
+            } else {
+                painterPath.lineTo(point);
+            }
+        }
+    }
+    return painterPath;
+}
+
+// 类似CAD图纸的场景：大量密集的等高线折线和带圆角的零件轮廓
+static void populateScene(DrawingScene &scene, int pathCount)
+{
+    QRandomGenerator random(5);
+    const qreal extent = 300.0 * qSqrt(pathCount);
+
+    for (int i = 0; i < pathCount; ++i) {
+        QPainterPath painterPath = createDrawingPath(random, i, extent);
+
+        DrawingPath *path = new DrawingPath;
+        path->setPath(painterPath);
+        path->setFillBrush(Qt::NoBrush);
+        path->setStrokePen(QPen(QColor::fromHsv(i % 360, 200, 160), 1.0));
+        scene.addItem(path);
+    }
+}
+
+// 点到一组折线的最短距离
+static qreal distanceToPolygons(const QPointF &point, const QList<QPolygonF> &polygons)
+{
+    qreal best = std::numeric_limits<qreal>::max();
+    for (const QPolygonF &polygon : polygons) {
+        if (polygon.size() == 1) {
+            best = qMin(best, QLineF(point, polygon.first()).length());
+        }
+        for (int i = 1; i < polygon.size(); ++i) {
+            const QPointF a = polygon[i - 1];
+            const QPointF ab = polygon[i] - a;
+            const qreal lengthSquared = QPointF::dotProduct(ab, ab);
+            const qreal t = lengthSquared > 0
+                ? qBound<qreal>(0.0, QPointF::dotProduct(point - a, ab) / lengthSquared, 1.0) : 0.0;
+            best = qMin(best, QLineF(point, a + t * ab).length());
+        }
+    }
+    return best;
+}
+
+// 两条路径展平后顶点到对方的最大距离（双向）
+static qreal pathDeviation(const QPainterPath &a, const QPainterPath &b)
+{
+    const QList<QPolygonF> polygonsA = a.toSubpathPolygons();
+    const QList<QPolygonF> polygonsB = b.toSubpathPolygons();
+    qreal deviation = 0;
+    for (const QPolygonF &polygon : polygonsA) {
+        for (const QPointF &point : polygon) {
+            deviation = qMax(deviation, distanceToPolygons(point, polygonsB));
+        }
+    }
+    for (const QPolygonF &polygon : polygonsB) {
+        for (const QPointF &point : polygon) {
+            deviation = qMax(deviation, distanceToPolygons(point, polygonsA));
+        }
+    }
+    return deviation;
+}
+
+// 缩放为1/2^level时的简化路径与源路径的局部误差不超过容差 * 2^level
+static void checkLevels(BenchCommon::Failures &failures, const char *label, const QPainterPath &source)
+{
+    DrawingPath shape;
+    shape.setPath(source);
+    const QPainterPath original = shape.path();
+    const qreal tolerance = DrawingPath::lodTolerance();
+
+    for (int level = 0; level <= CHECK_LEVEL_COUNT; ++level) {
+        const qreal scale = std::ldexp(1.0, -level);
+        const QPainterPath lod = shape.lodPath(QTransform::fromScale(scale, scale));
+        const qreal allowed = std::ldexp(tolerance, level);
+        const qreal deviation = pathDeviation(original, lod);
+        failures.check(deviation <= allowed + DISTANCE_EPSILON,
+                       label, "层级", level, "误差", deviation, "超过", allowed);
+    }
+}
+
+// 细节层次的正确性：各层级误差在容差内，修改路径后不再使用旧的简化路径
+static void checkLodPaths(BenchCommon::Failures &failures)
+{
+    QRandomGenerator random(7);
+    const qreal extent = 1000;
+    const QPainterPath outline = createDrawingPath(random, 0, extent);
+    const QPainterPath contour = createDrawingPath(random, 1, extent);
+    checkLevels(failures, "零件轮廓", outline);
+    checkLevels(failures, "等高线", contour);
+
+    DrawingPath shape;
+    shape.setPath(contour);
+    const qreal scale = std::ldexp(1.0, -CHECK_LEVEL_COUNT);
+    const QTransform world = QTransform::fromScale(scale, scale);
+    const QPainterPath before = shape.lodPath(world);
+    failures.check(before.elementCount() < contour.elementCount(), "最深层级没有简化等高线");
+
+    // 平移整条路径后旧的简化路径误差远超容差
+    const QPainterPath moved = contour.translated(extent, 0);
+    shape.setPath(moved);
+    const qreal allowed = std::ldexp(DrawingPath::lodTolerance(), CHECK_LEVEL_COUNT);
+    const qreal deviation = pathDeviation(shape.path(), shape.lodPath(world));
+    failures.check(deviation <= allowed + DISTANCE_EPSILON, "setPath后仍使用旧的简化路径，误差", deviation);
+}
+
+// 以给定缩放比例显示整个场景，同步重绘若干帧，返回每秒帧数
+static double measureFps(QGraphicsView &view, qreal zoom)
+{
+    view.resetTransform();
+    view.scale(zoom, zoom);
+    view.centerOn(view.scene()->itemsBoundingRect().center());
+    // 第一帧建立简化路径缓存，不计入
+    view.viewport()->repaint();
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < FRAME_COUNT; ++i) {
+        view.viewport()->repaint();
+    }
+    const qint64 elapsed = qMax<qint64>(1, timer.nsecsElapsed());
+    return FRAME_COUNT * 1.0e9 / elapsed;
+}
+
+static void benchmark(DrawingScene &scene, const QString &label)
+{
+    QGraphicsView view(&scene);
+    view.setRenderHint(QPainter::Antialiasing);
+    view.resize(1280, 800);
+    view.show();
+    QApplication::processEvents();
+
+    // 从刚好容纳整个场景的比例开始，逐级放大到1:1
+    const QRectF bounds = scene.itemsBoundingRect();
+    const qreal fitZoom = qMin(1.0, qMin(1280 / bounds.width(), 800 / bounds.height()));
+    const qreal defaultTolerance = DrawingPath::lodTolerance();
+
+    qDebug() << label << "图形数:" << scene.items().size();
+    for (qreal zoom = fitZoom; zoom <= 1.0; zoom *= 4) {
+        DrawingPath::setLodTolerance(0);
+        const double fullFps = measureFps(view, zoom);
+        DrawingPath::setLodTolerance(defaultTolerance);
+        const double lodFps = measureFps(view, zoom);
+
+        qDebug() << "  缩放:" << zoom
+                 << "完整路径(FPS):" << fullFps
+                 << "细节层次(FPS):" << lodFps
+                 << "加速比:" << lodFps / fullFps;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    BenchCommon::useOffscreenPlatform();
+    QApplication app(argc, argv);
+
+    qDebug() << "=== 路径细节层次绘制基准测试 ===";
+    BenchCommon::Failures failures;
+    checkLodPaths(failures);
+
+    // 参数为数字时生成该数量路径的图纸，其余参数作为SVG文件测量；没有参数时使用默认规模
+    QList<int> pathCounts;
+    QStringList fileNames;
+    for (int i = 1; i < argc; ++i) {
+        const QString argument = QString::fromLocal8Bit(argv[i]);
+        bool isCount = false;
+        const int pathCount = argument.toInt(&isCount);
+        if (isCount) {
+            pathCounts.append(pathCount);
+        } else {
+            fileNames.append(argument);
+        }
+    }
+    if (argc == 1) {
+        pathCounts << 2000 << 10000;
+    }
+
+    for (const QString &fileName : fileNames) {
+        DrawingScene scene;
+        LayerManager::instance()->setScene(&scene);
+        if (!SvgHandler::importFromSvg(&scene, fileName)) {
+            qDebug() << "无法导入" << fileName;
+            LayerManager::destroyInstance();
+            return 1;
+        }
+        benchmark(scene, fileName);
+        LayerManager::destroyInstance();
+    }
+
+    for (int pathCount : pathCounts) {
+        DrawingScene scene;
+        populateScene(scene, pathCount);
+        benchmark(scene, "生成的图纸");
+    }
+    return failures.report();
+}
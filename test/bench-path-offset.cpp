@@ -0,0 +1,119 @@
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QPainterPathStroker>
+#include <QtMath>
+#include <QDebug>
+#include "../src/core/path-offset.h"
+#include "../src/core/patheditor.h"
+#include "bench-common.h"
+
+// 压力测试星形的顶点数
+static const int DEFAULT_STAR_POINTS = 5000;
+// 面积允许的相对误差
+static const qreal AREA_TOLERANCE = 0.01;
+
+// 有向面积之和：结果中外轮廓为正、洞为负
+static qreal signedArea(const QPainterPath &path)
+{
+    qreal area = 0.0;
+    for (const QPolygonF &polygon : path.toSubpathPolygons()) {
+        for (int i = 0; i < polygon.size(); ++i) {
+            const QPointF &a = polygon[i];
+            const QPointF &b = polygon[(i + 1) % polygon.size()];
+            area += a.x() * b.y() - b.x() * a.y();
+        }
+    }
+    return area / 2.0;
+}
+
+static bool checkArea(const QString &label, const QPainterPath &path, qreal expected)
+{
+    const qreal area = signedArea(path);
+    const qreal error = expected > 0 ? qAbs(area - expected) / expected : qAbs(area);
+    qDebug().noquote() << QString("  %1: 面积 %2, 期望 %3, 元素 %4")
+                          .arg(label).arg(area, 0, 'f', 2).arg(expected, 0, 'f', 2).arg(path.elementCount());
+    if (expected > 0 ? error > AREA_TOLERANCE : error > 1.0) {
+        qDebug() << "  FAIL:" << label;
+        return false;
+    }
+    return true;
+}
+
+static QPainterPath star(int points, qreal outer, qreal inner)
+{
+    QPainterPath path;
+    for (int i = 0; i < points * 2; ++i) {
+        const qreal angle = M_PI * i / points;
+        const qreal radius = i % 2 == 0 ? outer : inner;
+        const QPointF point(radius * qCos(angle), radius * qSin(angle));
+        if (i == 0) {
+            path.moveTo(point);
+        } else {
+            path.lineTo(point);
+        }
+    }
+    path.closeSubpath();
+    return path;
+}
+
+int main(int argc, char *argv[])
+{
+    BenchCommon::useOffscreenPlatform();
+    QApplication app(argc, argv);
+
+    const int starPoints = argc > 1 ? QString::fromLocal8Bit(argv[1]).toInt() : DEFAULT_STAR_POINTS;
+    BenchCommon::Failures failures;
+
+    qDebug() << "=== 路径偏移基准测试 ===";
+
+    QPainterPath rect;
+    rect.addRect(0, 0, 100, 50);
+    failures += !checkArea("矩形外扩10 尖角", PathOffset::offset(rect, 10, Qt::MiterJoin), 120.0 * 70.0);
+    failures += !checkArea("矩形外扩10 圆角", PathOffset::offset(rect, 10, Qt::RoundJoin), 5000.0 + 3000.0 + M_PI * 100.0);
+    failures += !checkArea("矩形外扩10 斜角", PathOffset::offset(rect, 10, Qt::BevelJoin), 5000.0 + 3000.0 + 200.0);
+    failures += !checkArea("矩形外扩10 超出尖角限制", PathOffset::offset(rect, 10, Qt::MiterJoin, 1.2), 5000.0 + 3000.0 + 200.0);
+    failures += !checkArea("矩形内缩10", PathOffset::offset(rect, -10, Qt::MiterJoin), 80.0 * 30.0);
+    failures += !checkArea("矩形内缩30", PathOffset::offset(rect, -30), 0.0);
+
+    QPainterPath circle;
+    circle.addEllipse(QPointF(0, 0), 50, 50);
+    failures += !checkArea("圆外扩10", PathOffset::offset(circle, 10), M_PI * 60.0 * 60.0);
+    failures += !checkArea("圆内缩20", PathOffset::offset(circle, -20), M_PI * 30.0 * 30.0);
+    failures += !checkArea("圆内缩60", PathOffset::offset(circle, -60), 0.0);
+
+    // 洞在外扩时被填满，内缩时变大
+    QPainterPath donut;
+    donut.addEllipse(QPointF(0, 0), 50, 50);
+    donut.addEllipse(QPointF(0, 0), 10, 10);
+    donut.setFillRule(Qt::OddEvenFill);
+    failures += !checkArea("圆环外扩15", PathOffset::offset(donut, 15), M_PI * 65.0 * 65.0);
+    failures += !checkArea("圆环内缩5", PathOffset::offset(donut, -5), M_PI * (45.0 * 45.0 - 15.0 * 15.0));
+
+    QPainterPath line;
+    line.moveTo(0, 0);
+    line.lineTo(100, 0);
+    failures += !checkArea("线段描边 平头", PathOffset::outline(line, 10, Qt::MiterJoin, Qt::FlatCap), 1000.0);
+    failures += !checkArea("线段描边 方头", PathOffset::outline(line, 10, Qt::MiterJoin, Qt::SquareCap), 1100.0);
+    failures += !checkArea("线段描边 圆头", PathOffset::outline(line, 10, Qt::MiterJoin, Qt::RoundCap), 1000.0 + 25.0 * M_PI);
+    failures += !checkArea("矩形描边 尖角", PathOffset::outline(rect, 10, Qt::MiterJoin), 110.0 * 60.0 - 90.0 * 40.0);
+
+    // 大规模：星形外扩，与QPainterPathStroker（原来的实现）对比耗时和元素数
+    const QPainterPath bigStar = star(starPoints, 1000.0, 800.0);
+    QElapsedTimer timer;
+    timer.start();
+    QPainterPathStroker stroker;
+    stroker.setWidth(40.0);
+    stroker.setJoinStyle(Qt::RoundJoin);
+    const QPainterPath stroked = stroker.createStroke(bigStar).united(bigStar);
+    const double strokerMs = timer.nsecsElapsed() / 1.0e6;
+    timer.start();
+    const QPainterPath offset = PathOffset::offset(bigStar, 20.0, Qt::RoundJoin);
+    const double offsetMs = timer.nsecsElapsed() / 1.0e6;
+    qDebug() << "星形" << starPoints << "个顶点外扩20: QPainterPathStroker" << strokerMs << "ms, 元素" << stroked.elementCount()
+             << "; 偏移引擎" << offsetMs << "ms, 元素" << offset.elementCount();
+    if (offset.isEmpty() || !offset.contains(QPointF(1015.0, 0.0)) || offset.contains(QPointF(1025.0, 0.0))) {
+        failures.fail("星形外扩结果不正确");
+    }
+
+    return failures.report();
+}
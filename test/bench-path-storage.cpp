@@ -0,0 +1,123 @@
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QtMath>
+#include <QDebug>
+#include <memory>
+#include <vector>
+#include "../src/core/drawing-shape.h"
+#include "bench-common.h"
+
+static const int DEFAULT_PATH_COUNT = 2000;
+static const int DEFAULT_NODES_PER_PATH = 500;
+
+// 直线和三次曲线交替的闭合路径，模拟导入的大文档
+static QPainterPath generatePath(QRandomGenerator &random, int nodeCount)
+{
+    QPainterPath path;
+    path.setFillRule(Qt::WindingFill);
+    QPointF position(random.bounded(10000), random.bounded(10000));
+    path.moveTo(position);
+    while (path.elementCount() + 3 < nodeCount) {
+        const QPointF step(random.generateDouble() * 20 - 10, random.generateDouble() * 20 - 10);
+        if (random.bounded(2) == 0) {
+            position += step;
+            path.lineTo(position);
+        } else {
+            path.cubicTo(position + step * 0.3, position + step * 0.7 + QPointF(5, -5), position + step);
+            position += step;
+        }
+    }
+    path.closeSubpath();
+    return path;
+}
+
+static bool samePath(const QPainterPath &a, const QPainterPath &b)
+{
+    if (a.elementCount() != b.elementCount() || a.fillRule() != b.fillRule()) {
+        return false;
+    }
+    for (int i = 0; i < a.elementCount(); ++i) {
+        const QPainterPath::Element &ea = a.elementAt(i);
+        const QPainterPath::Element &eb = b.elementAt(i);
+        if (ea.type != eb.type || ea.x != eb.x || ea.y != eb.y) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    BenchCommon::useOffscreenPlatform();
+    QApplication app(argc, argv);
+
+    const int pathCount = argc > 1 ? QString::fromLocal8Bit(argv[1]).toInt() : DEFAULT_PATH_COUNT;
+    const int nodesPerPath = argc > 2 ? QString::fromLocal8Bit(argv[2]).toInt() : DEFAULT_NODES_PER_PATH;
+    BenchCommon::Failures failures;
+
+    qDebug() << "=== 路径几何存储基准测试 ===";
+    QRandomGenerator random(37);
+    QVector<QPainterPath> sources;
+    sources.reserve(pathCount);
+    for (int i = 0; i < pathCount; ++i) {
+        sources.append(generatePath(random, nodesPerPath));
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    std::vector<std::unique_ptr<DrawingPath>> shapes;
+    shapes.reserve(pathCount);
+    for (const QPainterPath &source : sources) {
+        shapes.emplace_back(new DrawingPath);
+        shapes.back()->setPath(source);
+    }
+    const qint64 setPathMs = timer.elapsed();
+
+    qint64 nodeCount = 0;
+    qint64 storedBytes = 0;
+    for (const auto &shape : shapes) {
+        nodeCount += shape->getNodePointCount();
+        storedBytes += shape->controlPoints().capacity() * qint64(sizeof(QPointF))
+                       + shape->controlPointCommands().capacity();
+    }
+
+    // 首次绘制时生成路径
+    timer.restart();
+    qint64 materializedBytes = 0;
+    for (int i = 0; i < pathCount; ++i) {
+        const QPainterPath path = shapes[i]->path();
+        materializedBytes += path.elementCount() * qint64(sizeof(QPainterPath::Element));
+        if (!samePath(path, sources[i])) {
+            failures.fail("路径", i, "生成结果与输入不一致");
+        }
+    }
+    const qint64 materializeMs = timer.elapsed();
+
+    // 原来的存储：QPainterPath和元素副本各一个Element，外加控制点和4字节的类型
+    const qreal legacyPerNode = 2 * sizeof(QPainterPath::Element) + sizeof(QPointF) + sizeof(QPainterPath::ElementType);
+    const qreal storedPerNode = nodeCount > 0 ? qreal(storedBytes) / nodeCount : 0;
+    const qreal paintedPerNode = nodeCount > 0 ? qreal(storedBytes + materializedBytes) / nodeCount : 0;
+    qDebug() << "路径数:" << pathCount << "节点数:" << nodeCount;
+    qDebug() << "setPath:" << setPathMs << "ms, 首次生成路径:" << materializeMs << "ms";
+    qDebug() << "每节点字节数 原来:" << legacyPerNode << "现在（未绘制）:" << storedPerNode
+             << "现在（已生成路径）:" << paintedPerNode;
+    if (storedPerNode >= legacyPerNode || paintedPerNode >= legacyPerNode) {
+        failures.fail("紧凑存储没有减少内存");
+    }
+
+    // 节点编辑：改一个控制点后路径跟着变，类型往返不变
+    DrawingPath &edited = *shapes.front();
+    const QPointF moved = edited.controlPoints().at(1) + QPointF(3, 4);
+    edited.setNodePoint(1, moved);
+    if (QPointF(edited.path().elementAt(1).x, edited.path().elementAt(1).y) != moved) {
+        failures.fail("移动控制点后路径没有更新");
+    }
+    const QVector<QPainterPath::ElementType> types = edited.controlPointTypes();
+    edited.setControlPointTypes(types);
+    if (edited.controlPointTypes() != types || edited.path().elementCount() != types.size()) {
+        failures.fail("控制点类型往返不一致");
+    }
+
+    return failures.report();
+}
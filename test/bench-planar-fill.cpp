@@ -0,0 +1,206 @@
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QMouseEvent>
+#include <QRandomGenerator>
+#include <QUndoStack>
+#include <QtMath>
+#include <QDebug>
+#include "../src/core/drawing-shape.h"
+#include "../src/tools/drawing-tool-fill.h"
+#include "../src/ui/drawingscene.h"
+#include "../src/ui/drawingview.h"
+#include "bench-common.h"
+
+// 线稿网格：每个格子的边都是单独的一笔，角上留有小缺口
+static const int GRID_COLUMNS = 50;
+static const int GRID_ROWS = 40;
+static const qreal CELL_SIZE = 40.0;
+static const qreal CORNER_GAP = 1.5;
+static const int POINTS_PER_STROKE = 10;
+static const int CLICK_COUNT = 40;
+// 单次点击的目标耗时
+static const qreal TARGET_MS = 50.0;
+
+static void addWobblyStroke(DrawingScene &scene, QRandomGenerator &random, const QPointF &from, const QPointF &to)
+{
+    const QPointF direction = to - from;
+    const QPointF normal(-direction.y(), direction.x());
+    const qreal length = qSqrt(QPointF::dotProduct(direction, direction));
+    QPainterPath painterPath(from);
+    for (int k = 1; k < POINTS_PER_STROKE; ++k) {
+        const qreal t = qreal(k) / (POINTS_PER_STROKE - 1);
+        const qreal wobble = k == POINTS_PER_STROKE - 1 ? 0.0 : random.bounded(1.0) - 0.5;
+        painterPath.lineTo(from + direction * t + normal / length * wobble);
+    }
+    DrawingPath *path = new DrawingPath;
+    path->setPath(painterPath);
+    path->setStrokePen(QPen(Qt::black, 1.5, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
+    path->setFillBrush(Qt::NoBrush);
+    scene.addItem(path);
+}
+
+static int populateGrid(DrawingScene &scene)
+{
+    QRandomGenerator random(5);
+    int count = 0;
+    for (int row = 0; row <= GRID_ROWS; ++row) {
+        for (int column = 0; column < GRID_COLUMNS; ++column) {
+            const qreal y = row * CELL_SIZE;
+            addWobblyStroke(scene, random, QPointF(column * CELL_SIZE + CORNER_GAP, y),
+                            QPointF((column + 1) * CELL_SIZE - CORNER_GAP, y));
+            count++;
+        }
+    }
+    for (int column = 0; column <= GRID_COLUMNS; ++column) {
+        for (int row = 0; row < GRID_ROWS; ++row) {
+            const qreal x = column * CELL_SIZE;
+            addWobblyStroke(scene, random, QPointF(x, row * CELL_SIZE + CORNER_GAP),
+                            QPointF(x, (row + 1) * CELL_SIZE - CORNER_GAP));
+            count++;
+        }
+    }
+    return count;
+}
+
+static qreal pathArea(const QPainterPath &path)
+{
+    qreal area = 0.0;
+    for (const QPolygonF &polygon : path.toSubpathPolygons()) {
+        qreal signedArea = 0.0;
+        for (int i = 0; i + 1 < polygon.size(); ++i) {
+            signedArea += polygon[i].x() * polygon[i + 1].y() - polygon[i + 1].x() * polygon[i].y();
+        }
+        area += qAbs(signedArea) / 2.0;
+    }
+    return area;
+}
+
+// 点击处新建的填充路径：放在线条之下
+static DrawingPath *fillAt(DrawingScene &scene, const QPointF &pos)
+{
+    for (QGraphicsItem *item : scene.items(pos)) {
+        DrawingPath *path = dynamic_cast<DrawingPath*>(item);
+        if (path && item->zValue() < 0) {
+            return path;
+        }
+    }
+    return nullptr;
+}
+
+int main(int argc, char *argv[])
+{
+    BenchCommon::useOffscreenPlatform();
+    QApplication app(argc, argv);
+
+    DrawingScene scene;
+    const int strokeCount = populateGrid(scene);
+    scene.setSceneRect(0, 0, GRID_COLUMNS * CELL_SIZE, GRID_ROWS * CELL_SIZE);
+    DrawingView view(&scene);
+    view.resize(1200, 800);
+    view.show();
+    QApplication::processEvents();
+
+    DrawingToolFill tool;
+    tool.activate(&scene, &view);
+    qDebug() << "=== 区域填充基准测试 ===" << "笔画数:" << strokeCount;
+
+    BenchCommon::Failures failures;
+    QRandomGenerator random(9);
+    QElapsedTimer timer;
+    double totalMs = 0.0;
+    double worstMs = 0.0;
+    const qreal expectedArea = CELL_SIZE * CELL_SIZE;
+
+    for (int i = 0; i < CLICK_COUNT; ++i) {
+        // 每次点不同的格子中心
+        const int column = (i * 7) % GRID_COLUMNS;
+        const int row = (i * 11 + random.bounded(3)) % GRID_ROWS;
+        const QPointF pos((column + 0.5) * CELL_SIZE, (row + 0.5) * CELL_SIZE);
+
+        QMouseEvent event(QEvent::MouseButtonPress, pos, view.viewport()->mapToGlobal(pos),
+                          Qt::LeftButton, Qt::LeftButton, Qt::NoModifier);
+        timer.start();
+        tool.mousePressEvent(&event, pos);
+        const double ms = timer.nsecsElapsed() / 1.0e6;
+        totalMs += ms;
+        worstMs = qMax(worstMs, ms);
+
+        DrawingPath *fill = fillAt(scene, pos);
+        if (!fill) {
+            failures.fail("格子", column, row, "没有生成填充区域");
+            continue;
+        }
+        // 角上的缺口被截成小斜角，面积应接近整个格子
+        const qreal area = pathArea(fill->path());
+        if (qAbs(area - expectedArea) > expectedArea * 0.05) {
+            failures.fail("格子", column, row, "填充面积", area, "应接近", expectedArea);
+        }
+    }
+
+    const double averageMs = totalMs / CLICK_COUNT;
+    qDebug() << "平均耗时(ms):" << averageMs << "最长(ms):" << worstMs;
+    if (averageMs > TARGET_MS) {
+        failures.fail("平均耗时超过", TARGET_MS, "ms");
+    }
+
+    // 每次填充一条撤销命令，全部撤销后回到原始笔画
+    const int commands = scene.undoStack()->count();
+    while (scene.undoStack()->canUndo()) {
+        scene.undoStack()->undo();
+    }
+    int remaining = 0;
+    for (QGraphicsItem *item : scene.items()) {
+        if (dynamic_cast<DrawingShape*>(item)) {
+            remaining++;
+        }
+    }
+    if (commands != CLICK_COUNT || remaining != strokeCount) {
+        failures.fail("撤销命令数", commands, "撤销后图形数", remaining, "应为", strokeCount);
+    }
+
+    // 点击单个封闭矩形内部：给矩形本身上色，不在它下面另建填充路径
+    DrawingRectangle *rect = new DrawingRectangle(QRectF(0, 0, 200, 100));
+    rect->setPos(GRID_COLUMNS * CELL_SIZE + 200, 200);
+    rect->setFillBrush(QBrush(Qt::white));
+    scene.addItem(rect);
+    const QPointF inside = rect->mapToScene(QPointF(100, 50));
+    QMouseEvent rectClick(QEvent::MouseButtonPress, inside, view.viewport()->mapToGlobal(inside),
+                          Qt::LeftButton, Qt::LeftButton, Qt::NoModifier);
+    tool.mousePressEvent(&rectClick, inside);
+    if (rect->fillBrush().color() != QColor(Qt::blue)) {
+        failures.fail("点击矩形内部没有给矩形上色", rect->fillBrush().color());
+    }
+    if (fillAt(scene, inside) || scene.undoStack()->canUndo()) {
+        failures.fail("点击矩形内部新建了填充路径");
+    }
+
+    // 四条斜线围成的菱形：区域按线段计算，不是各条线的包围盒
+    const QPointF center(GRID_COLUMNS * CELL_SIZE + 600, 200);
+    const qreal radius = 60.0;
+    const QPointF corners[4] = {center + QPointF(radius, 0), center + QPointF(0, radius),
+                                center - QPointF(radius, 0), center - QPointF(0, radius)};
+    for (int k = 0; k < 4; ++k) {
+        DrawingLine *edge = new DrawingLine(QLineF(corners[k], corners[(k + 1) % 4]));
+        edge->setStrokePen(QPen(Qt::black, 1.0));
+        scene.addItem(edge);
+    }
+    QMouseEvent diamondClick(QEvent::MouseButtonPress, center, view.viewport()->mapToGlobal(center),
+                             Qt::LeftButton, Qt::LeftButton, Qt::NoModifier);
+    tool.mousePressEvent(&diamondClick, center);
+    DrawingPath *diamond = fillAt(scene, center);
+    const qreal diamondArea = 2.0 * radius * radius;
+    if (!diamond) {
+        failures.fail("斜线围成的区域没有填充");
+    } else {
+        const qreal area = pathArea(diamond->path());
+        if (qAbs(area - diamondArea) > diamondArea * 0.05) {
+            failures.fail("菱形填充面积", area, "应接近", diamondArea);
+        }
+        if (diamond->path().contains(diamond->mapFromScene(center + QPointF(radius * 0.8, -radius * 0.8)))) {
+            failures.fail("菱形填充包含了线条包围盒的角");
+        }
+    }
+
+    tool.deactivate();
+    return failures.report();
+}
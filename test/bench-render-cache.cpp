@@ -0,0 +1,201 @@
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QGraphicsView>
+#include <QScrollBar>
+#include <QImage>
+#include <QPainter>
+#include <QtMath>
+#include <QDebug>
+#include "../src/core/drawing-shape.h"
+#include "../src/core/shape-render-cache.h"
+#include "../src/core/style-table.h"
+#include "../src/core/drawing-document.h"
+#include "../src/ui/drawingscene.h"
+#include "bench-common.h"
+
+// 每种模式测量的平移帧数
+static const int FRAME_COUNT = 120;
+// 每条路径的曲线段数
+static const int PATH_SEGMENTS = 24;
+// 正确性检查使用的图形数
+static const int CHECK_SHAPE_COUNT = 200;
+// 缓存图块按亚像素位置重采样，只有通道差超过该值的像素才算不一致
+static const int PIXEL_TOLERANCE = 160;
+// 允许不一致的像素比例（抗锯齿边缘）
+static const double MISMATCH_RATIO = 0.01;
+
+// 由多段曲线组成的复杂路径，重绘时的曲线细分开销较大
+static void populateScene(DrawingScene &scene, QList<DrawingShape*> &shapes, int shapeCount)
+{
+    QRandomGenerator random(11);
+    const qreal extent = 60.0 * qSqrt(shapeCount);
+
+    for (int i = 0; i < shapeCount; ++i) {
+        QPainterPath painterPath(QPointF(0, 0));
+        for (int k = 0; k < PATH_SEGMENTS; ++k) {
+            const qreal angle = 2 * M_PI * (k + 1) / PATH_SEGMENTS;
+            const qreal radius = 10 + random.bounded(20.0);
+            painterPath.cubicTo(QPointF(random.bounded(40.0), random.bounded(40.0)),
+                                QPointF(random.bounded(40.0), random.bounded(40.0)),
+                                QPointF(20 + radius * qCos(angle), 20 + radius * qSin(angle)));
+        }
+        painterPath.closeSubpath();
+
+        DrawingPath *path = new DrawingPath;
+        path->setPath(painterPath);
+        path->setPos(random.bounded(extent), random.bounded(extent));
+        path->setFillBrush(QColor::fromRgb(random.generate()));
+        path->setStrokePen(QPen(Qt::black, 1.0));
+        scene.addItem(path);
+        shapes.append(path);
+    }
+    scene.setSceneRect(scene.itemsBoundingRect());
+}
+
+// 按固定步长平移视图并同步重绘，返回平均帧时间（毫秒）
+static double measurePan(QGraphicsView &view, int frames)
+{
+    QScrollBar *scrollBar = view.horizontalScrollBar();
+    const int step = qMax(1, (scrollBar->maximum() - scrollBar->minimum()) / (frames + 1));
+    scrollBar->setValue(scrollBar->minimum());
+    view.viewport()->repaint();
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < frames; ++i) {
+        scrollBar->setValue(scrollBar->value() + (i % 2 == 0 ? step : -step / 2));
+        view.viewport()->repaint();
+    }
+    return timer.nsecsElapsed() / 1.0e6 / frames;
+}
+
+// 把整个场景按zoom渲染到白底图像
+static QImage renderScene(DrawingScene &scene, qreal zoom)
+{
+    const QRectF source = scene.sceneRect();
+    QImage image((source.size() * zoom).toSize(), QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::white);
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::Antialiasing);
+    scene.render(&painter, QRectF(image.rect()), source);
+    return image;
+}
+
+// 任一通道差超过PIXEL_TOLERANCE的像素数
+static int mismatchedPixels(const QImage &a, const QImage &b)
+{
+    int count = 0;
+    for (int y = 0; y < a.height(); ++y) {
+        const QRgb *lineA = reinterpret_cast<const QRgb*>(a.constScanLine(y));
+        const QRgb *lineB = reinterpret_cast<const QRgb*>(b.constScanLine(y));
+        for (int x = 0; x < a.width(); ++x) {
+            if (qAbs(qRed(lineA[x]) - qRed(lineB[x])) > PIXEL_TOLERANCE
+                || qAbs(qGreen(lineA[x]) - qGreen(lineB[x])) > PIXEL_TOLERANCE
+                || qAbs(qBlue(lineA[x]) - qBlue(lineB[x])) > PIXEL_TOLERANCE
+                || qAbs(qAlpha(lineA[x]) - qAlpha(lineB[x])) > PIXEL_TOLERANCE) {
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+static void compareImages(BenchCommon::Failures &failures, const char *label, const QImage &direct, const QImage &cached)
+{
+    if (direct.size() != cached.size()) {
+        failures.fail(label, "图像尺寸不一致");
+        return;
+    }
+    const int mismatched = mismatchedPixels(direct, cached);
+    failures.check(mismatched <= MISMATCH_RATIO * direct.width() * direct.height(),
+                   label, "缓存绘制与直接绘制不一致的像素:", mismatched);
+}
+
+// 缓存命中与直接绘制的结果一致，修改样式后不再使用旧图块
+static void checkCachedRendering(BenchCommon::Failures &failures, qreal zoom)
+{
+    DrawingScene scene;
+    QList<DrawingShape*> shapes;
+    populateScene(scene, shapes, CHECK_SHAPE_COUNT);
+    for (DrawingShape *shape : shapes) {
+        shape->setFillBrush(QColor(Qt::red));
+    }
+
+    const QImage direct = renderScene(scene, zoom);
+    for (DrawingShape *shape : shapes) {
+        shape->setRenderCacheEnabled(true);
+    }
+    renderScene(scene, zoom);
+    failures.check(ShapeRenderCache::instance()->tileCount() > 0, "缩放", zoom, "时没有缓存图块");
+    compareImages(failures, "缓存命中", direct, renderScene(scene, zoom));
+
+    // 同一样式的全部图形一起改色，缓存中的红色图块不能再被使用
+    StyleTable *styles = scene.document()->styleTable();
+    const int style = shapes.first()->styleId();
+    styles->setStyle(style, styles->pen(style), QColor(Qt::blue));
+    const QImage restyledCached = renderScene(scene, zoom);
+    for (DrawingShape *shape : shapes) {
+        shape->setRenderCacheEnabled(false);
+    }
+    compareImages(failures, "修改样式后", renderScene(scene, zoom), restyledCached);
+
+    ShapeRenderCache::instance()->clear();
+}
+
+static void benchmark(int shapeCount, qreal zoom)
+{
+    DrawingScene scene;
+    QList<DrawingShape*> shapes;
+    populateScene(scene, shapes, shapeCount);
+
+    QGraphicsView view(&scene);
+    view.setRenderHint(QPainter::Antialiasing);
+    view.resize(1280, 800);
+    view.scale(zoom, zoom);
+    view.show();
+    QApplication::processEvents();
+
+    const double directMs = measurePan(view, FRAME_COUNT);
+
+    for (DrawingShape *shape : shapes) {
+        shape->setRenderCacheEnabled(true);
+    }
+    // 第一轮填充缓存，第二轮测量命中时的帧时间
+    const double warmupMs = measurePan(view, FRAME_COUNT);
+    const double cachedMs = measurePan(view, FRAME_COUNT);
+
+    qDebug() << "图形数:" << shapeCount << "缩放:" << zoom
+             << "直接绘制(ms/帧):" << directMs
+             << "首次缓存(ms/帧):" << warmupMs
+             << "缓存命中(ms/帧):" << cachedMs
+             << "缓存图块:" << ShapeRenderCache::instance()->tileCount()
+             << "缓存占用(KB):" << ShapeRenderCache::instance()->usage();
+
+    ShapeRenderCache::instance()->clear();
+}
+
+int main(int argc, char *argv[])
+{
+    BenchCommon::useOffscreenPlatform();
+    QApplication app(argc, argv);
+
+    QList<int> shapeCounts;
+    for (int i = 1; i < argc; ++i) {
+        shapeCounts.append(QString::fromLocal8Bit(argv[i]).toInt());
+    }
+    if (shapeCounts.isEmpty()) {
+        shapeCounts << 5000 << 50000;
+    }
+
+    qDebug() << "=== 栅格缓存平移基准测试 ===";
+    BenchCommon::Failures failures;
+    checkCachedRendering(failures, 1.0);
+    checkCachedRendering(failures, 0.25);
+
+    for (int shapeCount : shapeCounts) {
+        benchmark(shapeCount, 1.0);
+        benchmark(shapeCount, 0.25);
+    }
+    return failures.report();
+}
@@ -0,0 +1,146 @@
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QLineF>
+#include <QtMath>
+#include <QDebug>
+#include "../src/core/polyline-simplifier.h"
+#include "../src/core/patheditor.h"
+#include "bench-common.h"
+
+// 点数从1k到MAX_POINT_COUNT，每级乘10
+static const int DEFAULT_MAX_POINT_COUNT = 10000000;
+// 对照用的递归实现只在这个规模以内运行
+static const int RECURSIVE_BASELINE_LIMIT = 100000;
+static const qreal TOLERANCE = 0.5;
+
+// 原来的做法：递归，每层复制子列表
+static QList<QPointF> recursiveDouglasPeucker(const QList<QPointF> &points, qreal epsilon)
+{
+    if (points.size() <= 2) {
+        return points;
+    }
+    const QLineF chord(points.first(), points.last());
+    qreal maxDistance = 0;
+    int maxIndex = 0;
+    for (int i = 1; i < points.size() - 1; ++i) {
+        const QPointF d = chord.p2() - chord.p1();
+        const qreal lengthSquared = QPointF::dotProduct(d, d);
+        const qreal t = lengthSquared > 0 ? qBound(0.0, QPointF::dotProduct(points[i] - chord.p1(), d) / lengthSquared, 1.0) : 0.0;
+        const qreal distance = QLineF(points[i], chord.p1() + d * t).length();
+        if (distance > maxDistance) {
+            maxDistance = distance;
+            maxIndex = i;
+        }
+    }
+    if (maxDistance <= epsilon) {
+        return QList<QPointF>() << points.first() << points.last();
+    }
+    QList<QPointF> left = recursiveDouglasPeucker(points.mid(0, maxIndex + 1), epsilon);
+    const QList<QPointF> right = recursiveDouglasPeucker(points.mid(maxIndex), epsilon);
+    left.removeLast();
+    return left + right;
+}
+
+// 平滑随机游走，模拟画笔笔画
+static QVector<QPointF> generatePolyline(int count)
+{
+    QRandomGenerator random(17);
+    QVector<QPointF> points;
+    points.reserve(count);
+    QPointF position(0, 0);
+    qreal heading = 0.0;
+    for (int i = 0; i < count; ++i) {
+        heading += (random.generateDouble() - 0.5) * 0.2;
+        position += QPointF(qCos(heading), qSin(heading));
+        points.append(position);
+    }
+    return points;
+}
+
+// 被删除的点到所在保留线段的最大距离
+static qreal maxDeviation(const QVector<QPointF> &points, const QVector<int> &kept)
+{
+    qreal result = 0.0;
+    for (int k = 0; k + 1 < kept.size(); ++k) {
+        const QPointF a = points[kept[k]];
+        const QPointF d = points[kept[k + 1]] - a;
+        const qreal lengthSquared = QPointF::dotProduct(d, d);
+        for (int i = kept[k] + 1; i < kept[k + 1]; ++i) {
+            const qreal t = lengthSquared > 0 ? qBound(0.0, QPointF::dotProduct(points[i] - a, d) / lengthSquared, 1.0) : 0.0;
+            result = qMax(result, QLineF(points[i], a + d * t).length());
+        }
+    }
+    return result;
+}
+
+int main(int argc, char *argv[])
+{
+    BenchCommon::useOffscreenPlatform();
+    QApplication app(argc, argv);
+
+    const int maxCount = argc > 1 ? QString::fromLocal8Bit(argv[1]).toInt() : DEFAULT_MAX_POINT_COUNT;
+    BenchCommon::Failures failures;
+
+    qDebug() << "=== 折线简化基准测试 ===";
+    for (int count = 1000; count <= maxCount; count *= 10) {
+        const QVector<QPointF> points = generatePolyline(count);
+        QElapsedTimer timer;
+
+        timer.start();
+        const QVector<int> dp = PolylineSimplifier::simplify(points.constData(), points.size(), TOLERANCE,
+                                                             PathEditor::DouglasPeucker);
+        const double dpMs = timer.nsecsElapsed() / 1.0e6;
+
+        timer.start();
+        const QVector<int> vw = PolylineSimplifier::simplify(points.constData(), points.size(), TOLERANCE,
+                                                             PathEditor::VisvalingamWhyatt);
+        const double vwMs = timer.nsecsElapsed() / 1.0e6;
+
+        QString baseline = "-";
+        if (count <= RECURSIVE_BASELINE_LIMIT) {
+            timer.start();
+            const QList<QPointF> recursive = recursiveDouglasPeucker(QList<QPointF>(points.begin(), points.end()), TOLERANCE);
+            baseline = QString("%1 ms").arg(timer.nsecsElapsed() / 1.0e6, 0, 'f', 2);
+            if (recursive.size() != dp.size()) {
+                failures.fail("与递归实现保留的点数不同", recursive.size(), dp.size());
+            }
+        }
+
+        const qreal deviation = maxDeviation(points, dp);
+        qDebug().noquote() << QString("  %1 点: Douglas-Peucker %2 ms (保留 %3, 误差 %4), Visvalingam %5 ms (保留 %6), 递归 %7")
+                              .arg(count).arg(dpMs, 0, 'f', 2).arg(dp.size()).arg(deviation, 0, 'f', 3)
+                              .arg(vwMs, 0, 'f', 2).arg(vw.size()).arg(baseline);
+        if (deviation > TOLERANCE) {
+            failures.fail("Douglas-Peucker误差超出容差");
+        }
+        if (vw.isEmpty() || vw.first() != 0 || vw.last() != count - 1) {
+            failures.fail("Visvalingam没有保留首尾两点");
+        }
+    }
+
+    // 路径简化：直线段被简化，曲线段原样保留
+    QPainterPath path;
+    path.moveTo(0, 0);
+    for (int i = 1; i <= 100; ++i) {
+        path.lineTo(i, 0.01 * (i % 2));
+    }
+    path.cubicTo(120, 50, 150, 50, 170, 0);
+    for (int i = 1; i <= 100; ++i) {
+        path.lineTo(170 + i, 0);
+    }
+    path.closeSubpath();
+    const QPainterPath simplified = PathEditor::simplifyPath(path, TOLERANCE);
+    int curves = 0;
+    for (int i = 0; i < simplified.elementCount(); ++i) {
+        if (simplified.elementAt(i).type == QPainterPath::CurveToElement) {
+            curves++;
+        }
+    }
+    qDebug() << "路径简化:" << path.elementCount() << "个元素 ->" << simplified.elementCount() << "个元素, 曲线" << curves;
+    if (curves != 1 || simplified.elementCount() > 10) {
+        failures.fail("路径简化没有保留曲线或没有简化直线段");
+    }
+
+    return failures.report();
+}
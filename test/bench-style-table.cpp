@@ -0,0 +1,111 @@
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QtMath>
+#include <QDebug>
+#include <memory>
+#include <vector>
+#include "../src/core/drawing-shape.h"
+#include "../src/core/drawing-document.h"
+#include "../src/ui/drawingscene.h"
+#include "bench-common.h"
+
+static const int DEFAULT_SHAPE_COUNT = 100000;
+static const int STYLE_COUNT = 3;
+
+// 模拟SVG导入：每个元素都重新解析出一份画笔和画刷
+static QPen parsedPen(int style)
+{
+    QPen pen(QColor::fromHsv(style * 100, 200, 200), 1.0 + style);
+    pen.setJoinStyle(Qt::RoundJoin);
+    return pen;
+}
+
+static QBrush parsedBrush(int style)
+{
+    return QBrush(QColor::fromHsv(style * 100 + 50, 120, 240));
+}
+
+int main(int argc, char *argv[])
+{
+    BenchCommon::useOffscreenPlatform();
+    QApplication app(argc, argv);
+
+    const int shapeCount = argc > 1 ? QString::fromLocal8Bit(argv[1]).toInt() : DEFAULT_SHAPE_COUNT;
+    BenchCommon::Failures failures;
+    DrawingScene scene;
+    StyleTable *styles = scene.document()->styleTable();
+
+    qDebug() << "=== 共享样式表基准测试 ===";
+    QElapsedTimer timer;
+    timer.start();
+    std::vector<std::unique_ptr<DrawingRectangle>> shapes;
+    shapes.reserve(shapeCount);
+    for (int i = 0; i < shapeCount; ++i) {
+        shapes.emplace_back(new DrawingRectangle(QRectF(i % 1000, i / 1000, 1, 1)));
+        shapes.back()->setStrokePen(parsedPen(i % STYLE_COUNT));
+        shapes.back()->setFillBrush(parsedBrush(i % STYLE_COUNT));
+        scene.addItem(shapes.back().get());
+    }
+    qDebug() << "图形数:" << shapeCount << "创建、设置样式并加入场景:" << timer.elapsed() << "ms";
+    qDebug() << "样式记录数:" << styles->styleCount();
+    if (styles->styleCount() != STYLE_COUNT) {
+        failures.fail("相同样式没有合并，样式数", styles->styleCount());
+    }
+
+    // 按样式选择：只访问使用者列表
+    const int style = shapes.front()->styleId();
+    timer.restart();
+    const int selected = styles->users(style).size();
+    const qint64 selectNs = timer.nsecsElapsed();
+    timer.restart();
+    int scanned = 0;
+    for (const auto &shape : shapes) {
+        if (shape->strokePen() == parsedPen(0) && shape->fillBrush() == parsedBrush(0)) {
+            ++scanned;
+        }
+    }
+    qDebug() << "按样式选择:" << selected << "个," << selectNs / 1000.0 << "us, 逐个比较:" << timer.elapsed() << "ms";
+    if (selected != scanned) {
+        failures.fail("使用者列表", selected, "与逐个比较", scanned, "不一致");
+    }
+
+    // 修改一次样式，所有使用者一起更新
+    const QBrush edited(Qt::red);
+    timer.restart();
+    styles->setStyle(style, styles->pen(style), edited);
+    qDebug() << "修改样式:" << timer.elapsed() << "ms";
+    for (int i = 0; i < shapeCount; i += STYLE_COUNT) {
+        if (shapes[i]->fillBrush() != edited) {
+            failures.fail("图形", i, "没有随样式更新");
+            break;
+        }
+    }
+    if (shapes.size() > 1 && shapes[1]->fillBrush() == edited) {
+        failures.fail("其他样式的图形被修改");
+    }
+
+    // 改成与已有样式相同时合并
+    styles->setStyle(style, parsedPen(1), parsedBrush(1));
+    if (styles->styleCount() != STYLE_COUNT - 1 || shapes.front()->styleId() != shapes[1]->styleId()) {
+        failures.fail("相同样式没有合并");
+    }
+
+    // 移出场景的图形带走自己的样式，不再占用文档的样式表
+    DrawingRectangle *removed = shapes.back().get();
+    const QPen removedPen = removed->strokePen();
+    const QBrush removedBrush = removed->fillBrush();
+    scene.removeItem(removed);
+    if (removed->styleTable() || removed->strokePen() != removedPen || removed->fillBrush() != removedBrush) {
+        failures.fail("移出场景后样式丢失");
+    }
+    if (styles->users(shapes[1]->styleId()).contains(removed)) {
+        failures.fail("移出场景的图形仍在使用者列表中");
+    }
+
+    shapes.clear();
+    if (styles->styleCount() != 0) {
+        failures.fail("图形删除后样式没有回收，剩余", styles->styleCount());
+    }
+
+    return failures.report();
+}
@@ -0,0 +1,152 @@
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QTemporaryFile>
+#include <QFile>
+#include <QFileInfo>
+#include <QXmlStreamReader>
+#include <QRandomGenerator>
+#include <QDebug>
+#include "../src/core/svghandler.h"
+#include "../src/core/drawing-shape.h"
+#include "../src/core/layer-manager.h"
+#include "../src/ui/drawingscene.h"
+#include "bench-common.h"
+
+// 读取/proc/self/status中的内存字段（KB），其他平台返回-1
+static qint64 readStatusKb(const char *field)
+{
+    QFile status("/proc/self/status");
+    if (!status.open(QIODevice::ReadOnly)) {
+        return -1;
+    }
+    const QByteArray key = QByteArray(field) + ':';
+    for (const QByteArray &line : status.readAll().split('\n')) {
+        if (line.startsWith(key)) {
+            return line.mid(key.size()).trimmed().split(' ').first().toLongLong();
+        }
+    }
+    return -1;
+}
+
+// 把峰值RSS重置为当前RSS（Linux 4.0+），这样每个规模的峰值只反映导出本身
+static void resetPeakRss()
+{
+    QFile clearRefs("/proc/self/clear_refs");
+    if (clearRefs.open(QIODevice::WriteOnly)) {
+        clearRefs.write("5");
+    }
+}
+
+// 生成由路径、矩形和椭圆组成的场景
+static void populateScene(DrawingScene &scene, int nodeCount)
+{
+    QRandomGenerator random(42);
+    auto coordinate = [&random]() { return random.bounded(0, 200000) / 10.0; };
+
+    for (int i = 0; i < nodeCount; ++i) {
+        DrawingShape *shape = nullptr;
+        QPointF origin(coordinate(), coordinate());
+
+        switch (i % 3) {
+        case 0: {
+            DrawingPath *path = new DrawingPath;
+            QPainterPath painterPath(origin);
+            painterPath.lineTo(origin + QPointF(random.bounded(100), random.bounded(100)));
+            painterPath.cubicTo(origin + QPointF(10.25, 40.5), origin + QPointF(60.125, -20.75),
+                                origin + QPointF(80, 30));
+            painterPath.closeSubpath();
+            path->setPath(painterPath);
+            shape = path;
+            break;
+        }
+        case 1:
+            shape = new DrawingRectangle(QRectF(origin, QSizeF(random.bounded(1, 200), random.bounded(1, 200))));
+            break;
+        default:
+            shape = new DrawingEllipse(QRectF(origin, QSizeF(random.bounded(1, 200), random.bounded(1, 200))));
+            break;
+        }
+
+        shape->setStrokePen(QPen(QColor::fromRgb(random.generate()), 1.5));
+        shape->setFillBrush(QColor::fromRgb(random.generate()));
+        scene.addItem(shape);
+    }
+}
+
+// 流式读回导出的文件，统计元素数量，同时验证输出是合法的XML
+static int countElements(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return -1;
+    }
+    QXmlStreamReader reader(&file);
+    int count = 0;
+    while (!reader.atEnd()) {
+        if (reader.readNext() == QXmlStreamReader::StartElement) {
+            count++;
+        }
+    }
+    return reader.hasError() ? -1 : count;
+}
+
+static bool benchmark(int nodeCount)
+{
+    DrawingScene scene;
+    LayerManager::instance()->setScene(&scene);
+    populateScene(scene, nodeCount);
+
+    QTemporaryFile file;
+    if (!file.open()) {
+        qDebug() << "无法创建临时文件";
+        return false;
+    }
+    file.close();
+
+    const qint64 rssBefore = readStatusKb("VmRSS");
+    resetPeakRss();
+
+    QElapsedTimer timer;
+    timer.start();
+    bool ok = SvgHandler::exportToSvg(&scene, file.fileName());
+    const double ms = timer.nsecsElapsed() / 1.0e6;
+
+    const qint64 peak = readStatusKb("VmHWM");
+    const qint64 fileKb = QFileInfo(file.fileName()).size() / 1024;
+
+    // svg、defs、g三个容器元素加上每个图形一个元素
+    const int elements = countElements(file.fileName());
+    ok = ok && elements == nodeCount + 3;
+
+    qDebug() << "节点数:" << nodeCount
+             << "耗时(ms):" << ms
+             << "文件(KB):" << fileKb
+             << "导出前RSS(KB):" << rssBefore
+             << "峰值RSS(KB):" << peak
+             << "导出增量(KB):" << (peak >= 0 && rssBefore >= 0 ? peak - rssBefore : -1)
+             << (ok ? "" : "输出校验失败");
+
+    LayerManager::destroyInstance();
+    return ok;
+}
+
+int main(int argc, char *argv[])
+{
+    QApplication app(argc, argv);
+
+    QList<int> nodeCounts;
+    for (int i = 1; i < argc; ++i) {
+        nodeCounts.append(QString::fromLocal8Bit(argv[i]).toInt());
+    }
+    if (nodeCounts.isEmpty()) {
+        nodeCounts << 10000 << 100000 << 1000000;
+    }
+
+    qDebug() << "=== SVG流式导出基准测试 ===";
+
+    BenchCommon::Failures failures;
+    for (int nodeCount : nodeCounts) {
+        failures += !benchmark(nodeCount);
+    }
+    return failures.report();
+}
@@ -0,0 +1,173 @@
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QPainterPath>
+#include <QRandomGenerator>
+#include <QDebug>
+#include "../src/core/svg-path-parser.h"
+#include "bench-common.h"
+
+// 坐标比较的容差
+static const qreal COORDINATE_EPSILON = 1e-9;
+
+// 生成包含所有路径命令（含紧凑写法的弧标志位）的合成路径
+static QString buildSyntheticPath(int segmentCount)
+{
+    QRandomGenerator random(42);
+    QString data;
+    data.reserve(segmentCount * 24);
+    data += QStringLiteral("M 0,0");
+
+    auto number = [&random]() {
+        return QString::number(random.bounded(-5000, 5000) / 100.0);
+    };
+
+    for (int i = 0; i < segmentCount; ++i) {
+        switch (i % 10) {
+        case 0: data += QStringLiteral(" L ") + number() + ',' + number(); break;
+        case 1: data += QStringLiteral(" l") + number() + ' ' + number(); break;
+        case 2: data += QStringLiteral(" H ") + number(); break;
+        case 3: data += QStringLiteral(" v") + number(); break;
+        case 4: data += QStringLiteral(" C ") + number() + ',' + number() + ' ' + number() + ','
+                        + number() + ' ' + number() + ',' + number(); break;
+        case 5: data += QStringLiteral(" s") + number() + ',' + number() + ' ' + number() + ',' + number(); break;
+        case 6: data += QStringLiteral(" Q ") + number() + ',' + number() + ' ' + number() + ',' + number(); break;
+        case 7: data += QStringLiteral(" t") + number() + ',' + number(); break;
+        case 8: data += QStringLiteral(" a25,25 0 01") + number() + ',' + number(); break;
+        default: data += QStringLiteral(" L1e1,-2.5e-1z M") + number() + ' ' + number(); break;
+        }
+    }
+    return data;
+}
+
+// 逐个元素比较解析结果与直接用QPainterPath构造的期望路径
+static bool samePath(const QPainterPath &actual, const QPainterPath &expected, const char *data,
+                     BenchCommon::Failures &failures)
+{
+    if (actual.elementCount() != expected.elementCount()) {
+        failures.fail("路径", data, "元素数", actual.elementCount(), "应为", expected.elementCount());
+        return false;
+    }
+    for (int i = 0; i < actual.elementCount(); ++i) {
+        const QPainterPath::Element a = actual.elementAt(i);
+        const QPainterPath::Element e = expected.elementAt(i);
+        if (a.type != e.type || qAbs(a.x - e.x) > COORDINATE_EPSILON || qAbs(a.y - e.y) > COORDINATE_EPSILON) {
+            failures.fail("路径", data, "第", i, "个元素", a.type, a.x, a.y, "应为", e.type, e.x, e.y);
+            return false;
+        }
+    }
+    return true;
+}
+
+static void checkPath(const char *data, const QPainterPath &expected, BenchCommon::Failures &failures)
+{
+    QPainterPath actual;
+    SvgPathParser::parse(QString::fromLatin1(data), actual);
+    samePath(actual, expected, data, failures);
+}
+
+// 各种紧凑写法的解析结果
+static void checkCorpus(BenchCommon::Failures &failures)
+{
+    QPainterPath expected;
+
+    // 省略的重复命令：M之后的坐标对按L处理，m之后按l处理
+    expected = QPainterPath(QPointF(0, 0));
+    expected.lineTo(10, 10);
+    expected.lineTo(20, 0);
+    checkPath("M0 0 10 10 20 0", expected, failures);
+
+    expected = QPainterPath(QPointF(1, 1));
+    expected.lineTo(3, 3);
+    expected.lineTo(6, 6);
+    checkPath("m1 1 2 2 3 3", expected, failures);
+
+    expected = QPainterPath(QPointF(0, 0));
+    expected.lineTo(1, 0);
+    expected.lineTo(3, 0);
+    expected.lineTo(3, 4);
+    expected.lineTo(3, 9);
+    checkPath("M0,0h1 2v4 5", expected, failures);
+
+    expected = QPainterPath(QPointF(0, 0));
+    expected.cubicTo(1, 2, 3, 4, 5, 6);
+    expected.cubicTo(7, 8, 9, 10, 11, 12);
+    checkPath("M0 0C1 2 3 4 5 6 7 8 9 10 11 12", expected, failures);
+
+    // 闭合后的相对命令从子路径起点算起
+    expected = QPainterPath(QPointF(10, 10));
+    expected.lineTo(20, 20);
+    expected.closeSubpath();
+    expected.moveTo(15, 15);
+    expected.lineTo(16, 15);
+    checkPath("M10 10 20 20zm5 5h1", expected, failures);
+
+    // S和T反射前一条曲线的控制点
+    expected = QPainterPath(QPointF(0, 0));
+    expected.cubicTo(10, 0, 20, 10, 30, 10);
+    expected.cubicTo(40, 10, 50, 20, 60, 20);
+    checkPath("M0 0C10 0 20 10 30 10S50 20 60 20", expected, failures);
+
+    expected = QPainterPath(QPointF(0, 0));
+    expected.quadTo(10, 10, 20, 0);
+    expected.quadTo(30, -10, 40, 0);
+    checkPath("M0 0Q10 10 20 0T40 0", expected, failures);
+
+    // 指数
+    expected = QPainterPath(QPointF(10, -0.25));
+    expected.lineTo(100, 3);
+    expected.lineTo(0.015, 2e-3);
+    checkPath("M1e1-2.5e-1L1E+2,3e0 1.5e-2 2E-3", expected, failures);
+
+    // ".5.5"这样前一个数字遇到第二个小数点结束
+    expected = QPainterPath(QPointF(0.5, 0.5));
+    expected.lineTo(-0.5, -0.5);
+    expected.lineTo(1.5, 0.5);
+    expected.lineTo(2, 1);
+    checkPath("M.5.5L-.5-.5 1.5.5l.5.5", expected, failures);
+
+    // 弧的标志位不加分隔符：a25 25 0 0150 0是大弧0、顺时针1、终点(50,0)
+    expected = QPainterPath(QPointF(0, 0));
+    SvgPathParser::appendArc(expected, QPointF(0, 0), QPointF(50, 0), 25, 25, 0, false, true);
+    checkPath("M0 0a25 25 0 0150 0", expected, failures);
+    checkPath("M0,0A25,25,0,0,1,50,0", expected, failures);
+
+    expected = QPainterPath(QPointF(0, 0));
+    SvgPathParser::appendArc(expected, QPointF(0, 0), QPointF(50, 10), 30, 20, 15, true, true);
+    SvgPathParser::appendArc(expected, QPointF(50, 10), QPointF(80, 10), 30, 20, 15, false, false);
+    checkPath("M0 0a30 20 15 1150 10 30 20 15 0030 0", expected, failures);
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    BenchCommon::Failures failures;
+    checkCorpus(failures);
+
+    const int segmentCount = argc > 1 ? QString::fromLocal8Bit(argv[1]).toInt() : 1000000;
+    const int runs = 5;
+
+    qDebug() << "=== SVG路径解析基准测试 ===";
+    QString data = buildSyntheticPath(segmentCount);
+    const double megabytes = data.toUtf8().size() / (1024.0 * 1024.0);
+    qDebug() << "路径段数:" << segmentCount << "数据大小(MB):" << megabytes;
+
+    double bestMs = 0;
+    int elementCount = 0;
+    for (int run = 0; run < runs; ++run) {
+        QPainterPath path;
+        QElapsedTimer timer;
+        timer.start();
+        SvgPathParser::parse(data, path);
+        double ms = timer.nsecsElapsed() / 1.0e6;
+        elementCount = path.elementCount();
+        if (run == 0 || ms < bestMs) {
+            bestMs = ms;
+        }
+        qDebug() << "第" << run + 1 << "次:" << ms << "ms";
+    }
+
+    qDebug() << "生成路径元素数:" << elementCount;
+    qDebug() << "最佳耗时:" << bestMs << "ms";
+    qDebug() << "吞吐量:" << megabytes / (bestMs / 1000.0) << "MB/s";
+    return failures.report();
+}
@@ -0,0 +1,189 @@
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QScrollBar>
+#include <QImage>
+#include <QtMath>
+#include <QDebug>
+#include "../src/core/drawing-shape.h"
+#include "../src/ui/drawingscene.h"
+#include "../src/ui/drawingview.h"
+#include "../src/ui/tile-renderer.h"
+#include "bench-common.h"
+
+// 每种模式测量的平移帧数
+static const int FRAME_COUNT = 60;
+// 每条路径的曲线段数
+static const int PATH_SEGMENTS = 24;
+
+static void populateScene(DrawingScene &scene, int shapeCount)
+{
+    QRandomGenerator random(13);
+    const qreal extent = 60.0 * qSqrt(shapeCount);
+
+    for (int i = 0; i < shapeCount; ++i) {
+        QPainterPath painterPath(QPointF(0, 0));
+        for (int k = 0; k < PATH_SEGMENTS; ++k) {
+            const qreal angle = 2 * M_PI * (k + 1) / PATH_SEGMENTS;
+            const qreal radius = 10 + random.bounded(20.0);
+            painterPath.cubicTo(QPointF(random.bounded(40.0), random.bounded(40.0)),
+                                QPointF(random.bounded(40.0), random.bounded(40.0)),
+                                QPointF(20 + radius * qCos(angle), 20 + radius * qSin(angle)));
+        }
+        painterPath.closeSubpath();
+
+        DrawingPath *path = new DrawingPath;
+        path->setPath(painterPath);
+        path->setPos(random.bounded(extent), random.bounded(extent));
+        path->setFillBrush(QColor::fromRgb(random.generate()));
+        scene.addItem(path);
+    }
+    scene.setSceneRect(scene.itemsBoundingRect());
+}
+
+// 等待全部图块渲染完成，返回等待时间（毫秒）
+static double waitForTiles(DrawingView &view)
+{
+    TileRenderer *renderer = TileRenderer::forViewport(view.viewport());
+    QElapsedTimer timer;
+    timer.start();
+    while (renderer && renderer->pendingCount() > 0) {
+        QApplication::processEvents(QEventLoop::WaitForMoreEvents, 10);
+        view.viewport()->repaint();
+    }
+    return timer.nsecsElapsed() / 1.0e6;
+}
+
+// 等待合并间隔过去、快照更新，再等待受影响的图块重绘完成
+static void waitForSnapshot(DrawingView &view)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while (timer.elapsed() < 2 * TileRenderer::SNAPSHOT_INTERVAL_MS) {
+        QApplication::processEvents(QEventLoop::AllEvents, 5);
+    }
+    view.viewport()->repaint();
+    waitForTiles(view);
+    view.viewport()->repaint();
+}
+
+// 平移若干帧，返回GUI线程上每帧重绘的平均耗时（毫秒）
+static double measurePan(DrawingView &view)
+{
+    QScrollBar *scrollBar = view.horizontalScrollBar();
+    const int step = qMax(1, (scrollBar->maximum() - scrollBar->minimum()) / (FRAME_COUNT + 1));
+    scrollBar->setValue(scrollBar->minimum());
+
+    QElapsedTimer timer;
+    qint64 elapsed = 0;
+    for (int i = 0; i < FRAME_COUNT; ++i) {
+        scrollBar->setValue(scrollBar->value() + step);
+        timer.start();
+        view.viewport()->repaint();
+        elapsed += timer.nsecsElapsed();
+        // 模拟事件循环空闲，让完成的图块回到GUI线程
+        QApplication::processEvents();
+    }
+    return elapsed / 1.0e6 / FRAME_COUNT;
+}
+
+// 与同步绘制结果逐像素比较，返回明显不同的像素比例
+static double compareImages(const QImage &a, const QImage &b)
+{
+    if (a.size() != b.size()) {
+        return 1.0;
+    }
+    qint64 different = 0;
+    for (int y = 0; y < a.height(); ++y) {
+        for (int x = 0; x < a.width(); ++x) {
+            const QRgb pa = a.pixel(x, y);
+            const QRgb pb = b.pixel(x, y);
+            if (qAbs(qRed(pa) - qRed(pb)) + qAbs(qGreen(pa) - qGreen(pb)) + qAbs(qBlue(pa) - qBlue(pb)) > 24) {
+                different++;
+            }
+        }
+    }
+    return double(different) / (a.width() * a.height());
+}
+
+// 返回失败数
+static int benchmark(int shapeCount)
+{
+    DrawingScene scene;
+    populateScene(scene, shapeCount);
+
+    DrawingView view(&scene);
+    view.resize(1280, 800);
+    view.show();
+    QApplication::processEvents();
+
+    view.viewport()->repaint();
+    const QImage syncImage = view.viewport()->grab().toImage();
+    const double syncMs = measurePan(view);
+
+    QElapsedTimer timer;
+    timer.start();
+    view.setTiledRendering(true);
+    const double snapshotMs = timer.nsecsElapsed() / 1.0e6;
+
+    view.horizontalScrollBar()->setValue(view.horizontalScrollBar()->minimum());
+    view.viewport()->repaint();
+    const double firstFrameMs = waitForTiles(view);
+    const QImage tiledImage = view.viewport()->grab().toImage();
+    const double tiledMs = measurePan(view);
+    const double settleMs = waitForTiles(view);
+
+    qDebug() << "图形数:" << shapeCount
+             << "同步绘制(ms/帧):" << syncMs
+             << "建立快照(ms):" << snapshotMs
+             << "首屏图块(ms):" << firstFrameMs
+             << "分块合成(ms/帧):" << tiledMs
+             << "平移后补齐图块(ms):" << settleMs
+             << "与同步绘制不同的像素:" << compareImages(syncImage, tiledImage) * 100 << "%";
+
+    // 选中并移动视口内最底层的图形：它仍按层叠顺序由图块绘制，不能盖住上面的图形
+    BenchCommon::Failures failures;
+    DrawingShape *bottom = nullptr;
+    for (QGraphicsItem *item : view.items(view.viewport()->rect())) {
+        if (DrawingShape *shape = dynamic_cast<DrawingShape*>(item)) {
+            bottom = shape;
+        }
+    }
+    if (bottom) {
+        bottom->setSelected(true);
+        bottom->moveBy(5, 5);
+        timer.restart();
+        waitForSnapshot(view);
+        const double editMs = timer.nsecsElapsed() / 1.0e6;
+        const QImage tiledEdit = view.viewport()->grab().toImage();
+        view.setTiledRendering(false);
+        view.viewport()->repaint();
+        const QImage syncEdit = view.viewport()->grab().toImage();
+        const double editDiff = compareImages(syncEdit, tiledEdit);
+        qDebug() << "移动选中的底层图形后更新(ms):" << editMs << "与同步绘制不同的像素:" << editDiff * 100 << "%";
+        failures.check(editDiff <= qMax(0.01, 2 * compareImages(syncImage, tiledImage)),
+                       "选中图形的层叠顺序与同步绘制不同");
+    }
+    return failures.count();
+}
+
+int main(int argc, char *argv[])
+{
+    BenchCommon::useOffscreenPlatform();
+    QApplication app(argc, argv);
+
+    QList<int> shapeCounts;
+    for (int i = 1; i < argc; ++i) {
+        shapeCounts.append(QString::fromLocal8Bit(argv[i]).toInt());
+    }
+    if (shapeCounts.isEmpty()) {
+        shapeCounts << 5000 << 50000;
+    }
+
+    qDebug() << "=== 分块后台渲染基准测试 ===";
+    BenchCommon::Failures failures;
+    for (int shapeCount : shapeCounts) {
+        failures += benchmark(shapeCount);
+    }
+    return failures.report();
+}
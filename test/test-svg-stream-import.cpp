@@ -0,0 +1,134 @@
+#include <QApplication>
+#include <QDir>
+#include <QEventLoop>
+#include <QDebug>
+#include <QStringList>
+#include "../src/core/svghandler.h"
+#include "../src/core/svg-import-job.h"
+#include "../src/core/drawing-shape.h"
+#include "../src/core/layer-manager.h"
+#include "../src/ui/drawingscene.h"
+#include "bench-common.h"
+
+// 把场景中的每个图形描述为一行文本，排序后比较（图层Z值会随导入次数变化，不参与比较）
+static QStringList describeScene(DrawingScene &scene)
+{
+    QStringList lines;
+    for (QGraphicsItem *item : scene.items()) {
+        DrawingShape *shape = qgraphicsitem_cast<DrawingShape*>(item);
+        if (!shape) {
+            continue;
+        }
+
+        QRectF bounds = shape->sceneBoundingRect();
+        QTransform t = shape->transform();
+        QPen pen = shape->strokePen();
+        QBrush brush = shape->fillBrush();
+
+        QString line = QString("type=%1 bounds=%2,%3,%4,%5 transform=%6,%7,%8,%9,%10,%11 "
+                               "pen=%12/%13/%14 brush=%15/%16 effect=%17")
+            .arg(shape->shapeType())
+            .arg(bounds.x(), 0, 'f', 3).arg(bounds.y(), 0, 'f', 3)
+            .arg(bounds.width(), 0, 'f', 3).arg(bounds.height(), 0, 'f', 3)
+            .arg(t.m11(), 0, 'f', 4).arg(t.m12(), 0, 'f', 4).arg(t.m21(), 0, 'f', 4)
+            .arg(t.m22(), 0, 'f', 4).arg(t.dx(), 0, 'f', 3).arg(t.dy(), 0, 'f', 3)
+            .arg(pen.style()).arg(pen.color().name(QColor::HexArgb)).arg(pen.widthF())
+            .arg(brush.style()).arg(brush.color().name(QColor::HexArgb))
+            .arg(shape->graphicsEffect() ? shape->graphicsEffect()->metaObject()->className() : "none");
+
+        if (shape->shapeType() == DrawingShape::Path) {
+            DrawingPath *path = static_cast<DrawingPath*>(shape);
+            line += QString(" elements=%1 marker=%2").arg(path->path().elementCount()).arg(path->markerId());
+        }
+
+        lines.append(line);
+    }
+
+    lines.sort();
+    return lines;
+}
+
+static bool compareLines(const char *label, bool domResult, const QStringList &domLines,
+                         bool result, const QStringList &lines)
+{
+    if (domResult != result) {
+        qDebug() << "  返回值不一致: DOM =" << domResult << label << "=" << result;
+        return false;
+    }
+
+    if (domLines != lines) {
+        qDebug() << "  图形不一致: DOM" << domLines.size() << "个，" << label << lines.size() << "个";
+        for (int i = 0; i < qMax(domLines.size(), lines.size()); ++i) {
+            QString a = i < domLines.size() ? domLines[i] : QString("<无>");
+            QString b = i < lines.size() ? lines[i] : QString("<无>");
+            if (a != b) {
+                qDebug() << "    DOM :" << a;
+                qDebug() << "    " << label << ":" << b;
+            }
+        }
+        return false;
+    }
+
+    return true;
+}
+
+static bool compareFile(const QString &fileName)
+{
+    // 每次导入使用独立的图层管理器，避免图层跨场景残留
+    DrawingScene domScene;
+    LayerManager::instance()->setScene(&domScene);
+    bool domResult = SvgHandler::importFromSvgDocument(&domScene, fileName);
+    QStringList domLines = describeScene(domScene);
+    LayerManager::destroyInstance();
+
+    DrawingScene streamScene;
+    LayerManager::instance()->setScene(&streamScene);
+    bool streamResult = SvgHandler::importFromSvg(&streamScene, fileName);
+    QStringList streamLines = describeScene(streamScene);
+    LayerManager::destroyInstance();
+
+    // 并行导入：等待任务在事件循环中完成
+    DrawingScene jobScene;
+    LayerManager::instance()->setScene(&jobScene);
+    bool jobResult = false;
+    {
+        SvgImportJob job(&jobScene);
+        QEventLoop loop;
+        QObject::connect(&job, &SvgImportJob::finished, &loop, [&](bool success) {
+            jobResult = success;
+            loop.quit();
+        });
+        if (job.start(fileName)) {
+            loop.exec();
+        }
+    }
+    QStringList jobLines = describeScene(jobScene);
+    LayerManager::destroyInstance();
+
+    bool ok = compareLines("流式", domResult, domLines, streamResult, streamLines);
+    ok = compareLines("并行", domResult, domLines, jobResult, jobLines) && ok;
+    if (ok) {
+        qDebug() << "  一致，图形数量:" << domLines.size();
+    }
+    return ok;
+}
+
+int main(int argc, char *argv[])
+{
+    QApplication app(argc, argv);
+
+    QDir dir(argc > 1 ? QString::fromLocal8Bit(argv[1]) : QString(VECTORQT_SVG_TEST_DIR));
+    QStringList files = dir.entryList(QStringList() << "*.svg", QDir::Files, QDir::Name);
+
+    qDebug() << "=== 流式/并行SVG导入与DOM导入对比 ===";
+    qDebug() << "测试目录:" << dir.absolutePath() << "文件数:" << files.size();
+
+    BenchCommon::Failures failures;
+    for (const QString &file : files) {
+        qDebug() << file;
+        failures += !compareFile(dir.absoluteFilePath(file));
+    }
+
+    qDebug() << "\n=== 测试完成 ===";
+    return failures.report();
+}
@@ -0,0 +1,288 @@
+#include <QApplication>
+#include <QTemporaryDir>
+#include <QFileInfo>
+#include <QFile>
+#include <cstddef>
+#include <QDebug>
+#include <QStringList>
+#include "../src/core/vfp-document.h"
+#include "../src/core/vfp-format.h"
+#include "../src/core/drawing-shape.h"
+#include "../src/core/drawing-group.h"
+#include "../src/core/drawing-layer.h"
+#include "../src/core/layer-manager.h"
+#include "../src/ui/drawingscene.h"
+#include "bench-common.h"
+
+// 填充矩形的数量，足够分成多个目录页
+static const int FILLER_COUNT = 6000;
+
+// 按层叠顺序把每个图形描述为一行文本，层叠顺序也参与比较
+static QStringList describeScene(DrawingScene &scene)
+{
+    QStringList lines;
+    for (QGraphicsItem *item : scene.items(Qt::AscendingOrder)) {
+        DrawingShape *shape = dynamic_cast<DrawingShape*>(item);
+        if (!shape) {
+            continue;
+        }
+
+        QRectF bounds = shape->sceneBoundingRect();
+        QTransform t = shape->transform();
+        QPen pen = shape->strokePen();
+        QBrush brush = shape->fillBrush();
+
+        lines.append(QString("type=%1 parent=%2 bounds=%3,%4,%5,%6 transform=%7,%8,%9,%10 "
+                             "pen=%11/%12 brush=%13/%14 visible=%15")
+            .arg(shape->shapeType()).arg(shape->parentItem() ? "group" : "none")
+            .arg(bounds.x(), 0, 'f', 3).arg(bounds.y(), 0, 'f', 3)
+            .arg(bounds.width(), 0, 'f', 3).arg(bounds.height(), 0, 'f', 3)
+            .arg(t.m11(), 0, 'f', 4).arg(t.m12(), 0, 'f', 4).arg(t.dx(), 0, 'f', 3).arg(t.dy(), 0, 'f', 3)
+            .arg(pen.color().name(QColor::HexArgb)).arg(pen.widthF())
+            .arg(brush.style()).arg(brush.color().name(QColor::HexArgb))
+            .arg(shape->isVisible()));
+    }
+    return lines;
+}
+
+// 图层管理器是单例，切换到新场景前把图层从上一个场景中摘下来
+static void useScene(DrawingScene &scene)
+{
+    LayerManager::instance()->setScene(&scene);
+    for (DrawingLayer *layer : LayerManager::instance()->layers()) {
+        for (DrawingShape *shape : layer->shapes()) {
+            layer->removeShape(shape);
+        }
+        layer->setScene(&scene);
+    }
+}
+
+static void populateScene(DrawingScene &scene)
+{
+    useScene(scene);
+    DrawingLayer *background = LayerManager::instance()->layers().last();
+    DrawingLayer *top = LayerManager::instance()->createLayer("前景");
+
+    for (int i = 0; i < FILLER_COUNT; ++i) {
+        DrawingRectangle *rect = new DrawingRectangle(QRectF((i % 100) * 20, (i / 100) * 20, 15, 15));
+        rect->setFillBrush(QColor::fromHsv(i % 360, 200, 200));
+        background->addShape(rect);
+    }
+
+    DrawingRectangle *rounded = new DrawingRectangle(QRectF(10, 10, 120, 80));
+    rounded->setCornerRadius(12);
+    rounded->applyTransform(QTransform().rotate(30));
+    top->addShape(rounded);
+
+    DrawingEllipse *ellipse = new DrawingEllipse(QRectF(200, 40, 90, 60));
+    ellipse->setStrokePen(QPen(Qt::red, 3));
+    top->addShape(ellipse);
+
+    DrawingPath *path = new DrawingPath;
+    QPainterPath painterPath(QPointF(0, 0));
+    painterPath.lineTo(50, 10);
+    painterPath.cubicTo(60, 40, 90, -20, 120, 30);
+    painterPath.closeSubpath();
+    path->setPath(painterPath);
+    path->setPos(300, 300);
+    top->addShape(path);
+
+    DrawingPolyline *polyline = new DrawingPolyline;
+    polyline->addPoint(QPointF(0, 0));
+    polyline->addPoint(QPointF(40, 60));
+    polyline->addPoint(QPointF(80, 10));
+    polyline->setPos(500, 100);
+    top->addShape(polyline);
+
+    DrawingPolygon *polygon = new DrawingPolygon;
+    polygon->addPoint(QPointF(0, 0));
+    polygon->addPoint(QPointF(60, 0));
+    polygon->addPoint(QPointF(30, 50));
+    polygon->setPos(600, 200);
+    polygon->setVisible(false);
+    top->addShape(polygon);
+
+    DrawingText *text = new DrawingText("矢量 VectorQt");
+    text->setPosition(QPointF(100, 500));
+    top->addShape(text);
+
+    DrawingLine *line = new DrawingLine(QLineF(0, 0, 200, 0));
+    line->setPos(50, 700);
+    top->addShape(line);
+
+    DrawingGroup *group = new DrawingGroup;
+    top->addShape(group);
+    DrawingRectangle *first = new DrawingRectangle(QRectF(0, 0, 30, 30));
+    first->setPos(800, 800);
+    DrawingEllipse *second = new DrawingEllipse(QRectF(0, 0, 40, 20));
+    second->setPos(850, 820);
+    group->addItem(first);
+    group->addItem(second);
+}
+
+// 图层管理器中的图层按顺序描述为文本
+static QStringList describeLayers()
+{
+    QStringList lines;
+    for (DrawingLayer *layer : LayerManager::instance()->layers()) {
+        lines.append(QString("name=%1 visible=%2 locked=%3 opacity=%4")
+            .arg(layer->name()).arg(layer->isVisible()).arg(layer->isLocked()).arg(layer->opacity()));
+    }
+    return lines;
+}
+
+static bool compareLines(const char *label, const QStringList &expected, const QStringList &lines)
+{
+    if (expected == lines) {
+        return true;
+    }
+
+    qDebug() << "  图形不一致:" << label << "期望" << expected.size() << "个，实际" << lines.size() << "个";
+    for (int i = 0; i < qMax(expected.size(), lines.size()); ++i) {
+        QString a = i < expected.size() ? expected[i] : QString("<无>");
+        QString b = i < lines.size() ? lines[i] : QString("<无>");
+        if (a != b) {
+            qDebug() << "    期望:" << a;
+            qDebug() << "    实际:" << b;
+            break;
+        }
+    }
+    return false;
+}
+
+// 打开文件并解码全部图形
+static bool loadScene(DrawingScene &scene, VfpDocument &document, const QString &fileName)
+{
+    useScene(scene);
+    if (!document.open(fileName)) {
+        qDebug() << "  无法打开" << fileName;
+        return false;
+    }
+
+    // 只解码可见区域时不应解码全部图形
+    document.materializeRect(QRectF(0, 0, 100, 100));
+    if (document.pendingCount() == 0) {
+        qDebug() << "  可见区域解码了全部图形";
+        return false;
+    }
+
+    document.materializeAll();
+    return true;
+}
+
+// 复制文件并把第一个图形表项的子孙数改为value，value为0时改为图形总数（刚好越界一个）
+static bool corruptDescendants(const QString &source, const QString &target, quint32 value)
+{
+    QFile::remove(target);
+    if (!QFile::copy(source, target)) {
+        return false;
+    }
+    QFile file(target);
+    if (!file.open(QIODevice::ReadWrite)) {
+        return false;
+    }
+    VfpFileHeader header;
+    VfpDirectoryHeader directory;
+    VfpPageRef page;
+    if (file.read(reinterpret_cast<char*>(&header), sizeof(header)) != sizeof(header)
+        || !file.seek(qint64(header.directoryOffset))
+        || file.read(reinterpret_cast<char*>(&directory), sizeof(directory)) != sizeof(directory)
+        || file.read(reinterpret_cast<char*>(&page), sizeof(page)) != sizeof(page)
+        || !file.seek(qint64(page.offset + offsetof(VfpShapeEntry, descendants)))) {
+        return false;
+    }
+    if (value == 0) {
+        value = directory.shapeCount;
+    }
+    return file.write(reinterpret_cast<const char*>(&value), sizeof(value)) == sizeof(value);
+}
+
+int main(int argc, char *argv[])
+{
+    QApplication app(argc, argv);
+    QTemporaryDir dir;
+    const QString fileName = dir.filePath("drawing.vfp");
+    BenchCommon::Failures failures;
+
+    qDebug() << "=== VFP文档保存/加载测试 ===";
+
+    DrawingScene original;
+    populateScene(original);
+    const QStringList expected = describeScene(original);
+    VfpDocument writer(&original);
+    if (!writer.save(fileName)) {
+        qDebug() << "完整保存失败";
+        return 1;
+    }
+    const qint64 fullSize = QFileInfo(fileName).size();
+    qDebug() << "完整保存:" << expected.size() << "个图形，" << fullSize << "字节";
+
+    // 重新打开后与原场景一致
+    DrawingScene loaded;
+    VfpDocument document(&loaded);
+    failures += !loadScene(loaded, document, fileName) || !compareLines("重新打开", expected, describeScene(loaded));
+
+    // 修改一个图形后增量保存，文件只增长少量数据
+    DrawingScene partial;
+    VfpDocument partialDocument(&partial);
+    useScene(partial);
+    partialDocument.open(fileName);
+    partialDocument.materializeRect(QRectF(0, 0, 100, 100));
+    DrawingRectangle *changed = nullptr;
+    for (QGraphicsItem *item : partial.items(Qt::AscendingOrder)) {
+        changed = dynamic_cast<DrawingRectangle*>(item);
+        if (changed) {
+            break;
+        }
+    }
+    if (!changed) {
+        qDebug() << "可见区域没有解码出矩形";
+        return 1;
+    }
+    changed->setFillBrush(QColor(Qt::green));
+    const int pending = partialDocument.pendingCount();
+    if (!partialDocument.save(fileName) || partialDocument.pendingCount() != pending) {
+        failures.fail("增量保存失败");
+    }
+    const qint64 growth = QFileInfo(fileName).size() - fullSize;
+    qDebug() << "增量保存: 增长" << growth << "字节";
+    if (growth <= 0 || growth > fullSize / 2) {
+        failures.fail("增量保存写入了过多数据");
+    }
+
+    partialDocument.materializeAll();
+    const QStringList modified = describeScene(partial);
+    DrawingScene reloaded;
+    VfpDocument reloadedDocument(&reloaded);
+    failures += !loadScene(reloaded, reloadedDocument, fileName)
+                || !compareLines("增量保存后重新打开", modified, describeScene(reloaded));
+
+    // 子孙数损坏的文件应当打开失败，而不是卡死或越界；失败时场景和图层都保持不变。
+    // 先改掉文件中图层的名称和属性，打开失败后不应重新创建或改回
+    DrawingLayer *foreground = LayerManager::instance()->layer("前景");
+    if (foreground) {
+        LayerManager::instance()->setLayerName(foreground, "前景（已改名）");
+        LayerManager::instance()->setLayerVisible(foreground, false);
+        LayerManager::instance()->setLayerOpacity(foreground, 0.5);
+    }
+    const QString corruptName = dir.filePath("corrupt.vfp");
+    for (quint32 value : {0xffffffffu, 0x7fffffffu, 0u}) {
+        DrawingScene corruptScene;
+        VfpDocument corruptDocument(&corruptScene);
+        useScene(corruptScene);
+        const QStringList layersBefore = describeLayers();
+        if (!corruptDescendants(fileName, corruptName, value)) {
+            failures.fail("无法构造损坏的文件");
+        } else if (corruptDocument.open(corruptName)) {
+            failures.fail("子孙数为", value, "的损坏文件被打开");
+        } else {
+            failures += !compareLines("打开失败后的图层", layersBefore, describeLayers());
+            failures.check(describeScene(corruptScene).isEmpty(), "打开失败后场景中有图形");
+            failures.check(!corruptDocument.isOpen() && corruptDocument.shapeCount() == 0
+                           && corruptDocument.pendingCount() == 0, "打开失败后文档仍有内容");
+        }
+    }
+
+    qDebug() << "\n=== 测试完成 ===";
+    return failures.report();
+}